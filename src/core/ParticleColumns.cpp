@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ParticleColumns.hpp"
+
+#include "Particle.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/gather.hpp>
+#include <boost/mpi/datatype.hpp>
+
+#include <cassert>
+#include <stdexcept>
+
+namespace {
+/** Scalar type and number of scalars of a column entry. */
+template <class T> struct ColumnTraits {
+  using scalar_type = T;
+  static constexpr int width = 1;
+};
+
+template <class T, std::size_t N> struct ColumnTraits<Utils::Vector<T, N>> {
+  using scalar_type = T;
+  static constexpr int width = static_cast<int>(N);
+};
+
+/**
+ * @brief Gather a column on the master node or on all nodes.
+ *
+ * On the receiving nodes, @p column is replaced by the concatenation
+ * of the columns of all nodes.
+ *
+ * @param column Local entries
+ * @param sizes  Number of entries per node, only needed on the receiving
+ *               nodes
+ * @param all    Gather on all nodes instead of the master node only
+ */
+template <class T>
+void gather_column(std::vector<T> &column, std::vector<int> const &sizes,
+                   bool all) {
+  using Traits = ColumnTraits<T>;
+  using scalar_type = typename Traits::scalar_type;
+  auto const type = boost::mpi::get_mpi_datatype<scalar_type>();
+  auto const n_local = static_cast<int>(column.size()) * Traits::width;
+
+  if (not all and comm_cart.rank() != 0) {
+    MPI_Gatherv(reinterpret_cast<scalar_type *>(column.data()), n_local, type,
+                nullptr, nullptr, nullptr, type, 0, comm_cart);
+    return;
+  }
+
+  std::vector<int> counts(sizes.size());
+  std::vector<int> displs(sizes.size());
+  int offset = 0;
+  for (std::size_t i = 0; i < sizes.size(); i++) {
+    counts[i] = sizes[i] * Traits::width;
+    displs[i] = offset;
+    offset += counts[i];
+  }
+
+  std::vector<T> result(offset / Traits::width);
+  if (all) {
+    MPI_Allgatherv(reinterpret_cast<scalar_type *>(column.data()), n_local,
+                   type, reinterpret_cast<scalar_type *>(result.data()),
+                   counts.data(), displs.data(), type, comm_cart);
+  } else {
+    MPI_Gatherv(reinterpret_cast<scalar_type *>(column.data()), n_local, type,
+                reinterpret_cast<scalar_type *>(result.data()), counts.data(),
+                displs.data(), type, 0, comm_cart);
+  }
+  column = std::move(result);
+}
+
+ParticleColumns local_particle_columns(unsigned fields) {
+  auto const particles = cell_structure.local_cells().particles();
+  ParticleColumns columns;
+
+  for (auto const &p : particles) {
+    columns.id.push_back(p.p.identity);
+    if (fields & PARTICLE_FIELD_POSITION)
+      columns.pos.push_back(
+          unfolded_position(p.r.p, p.l.i, box_geo.length()));
+    if (fields & (PARTICLE_FIELD_FOLDED_POSITION | PARTICLE_FIELD_IMAGE)) {
+      auto pos = p.r.p;
+      auto image = p.l.i;
+      fold_position(pos, image, box_geo);
+      if (fields & PARTICLE_FIELD_FOLDED_POSITION)
+        columns.pos.push_back(pos);
+      if (fields & PARTICLE_FIELD_IMAGE)
+        columns.image.push_back(image);
+    }
+    if (fields & PARTICLE_FIELD_TYPE)
+      columns.type.push_back(p.p.type);
+    if (fields & PARTICLE_FIELD_CHARGE)
+      columns.q.push_back(p.p.q);
+    if (fields & PARTICLE_FIELD_VELOCITY)
+      columns.v.push_back(p.m.v);
+    if (fields & PARTICLE_FIELD_FORCE)
+      columns.f.push_back(p.f.f);
+    if (fields & PARTICLE_FIELD_MASS)
+      columns.mass.push_back(p.p.mass);
+    if (fields & PARTICLE_FIELD_VIRTUAL)
+      columns.is_virtual.push_back(static_cast<char>(p.p.is_virtual));
+  }
+
+  return columns;
+}
+
+void gather_particle_columns(ParticleColumns &columns, unsigned fields,
+                             bool all = false) {
+  auto const n_local = static_cast<int>(columns.size());
+  std::vector<int> sizes;
+  if (all) {
+    boost::mpi::all_gather(comm_cart, n_local, sizes);
+  } else if (comm_cart.rank() == 0) {
+    boost::mpi::gather(comm_cart, n_local, sizes, 0);
+  } else {
+    boost::mpi::gather(comm_cart, n_local, 0);
+  }
+
+  gather_column(columns.id, sizes, all);
+  if (fields & (PARTICLE_FIELD_POSITION | PARTICLE_FIELD_FOLDED_POSITION))
+    gather_column(columns.pos, sizes, all);
+  if (fields & PARTICLE_FIELD_TYPE)
+    gather_column(columns.type, sizes, all);
+  if (fields & PARTICLE_FIELD_CHARGE)
+    gather_column(columns.q, sizes, all);
+  if (fields & PARTICLE_FIELD_VELOCITY)
+    gather_column(columns.v, sizes, all);
+  if (fields & PARTICLE_FIELD_FORCE)
+    gather_column(columns.f, sizes, all);
+  if (fields & PARTICLE_FIELD_IMAGE)
+    gather_column(columns.image, sizes, all);
+  if (fields & PARTICLE_FIELD_MASS)
+    gather_column(columns.mass, sizes, all);
+  if (fields & PARTICLE_FIELD_VIRTUAL)
+    gather_column(columns.is_virtual, sizes, all);
+}
+} // namespace
+
+ParticleColumns all_gather_particle_columns(unsigned fields) {
+  auto columns = local_particle_columns(fields);
+  gather_particle_columns(columns, fields, true);
+
+  return columns;
+}
+
+void mpi_gather_particle_columns_slave(unsigned fields) {
+  auto columns = local_particle_columns(fields);
+  gather_particle_columns(columns, fields);
+}
+
+REGISTER_CALLBACK(mpi_gather_particle_columns_slave)
+
+ParticleColumns mpi_gather_particle_columns(unsigned fields) {
+  assert(comm_cart.rank() == 0);
+  if ((fields & PARTICLE_FIELD_POSITION) and
+      (fields & PARTICLE_FIELD_FOLDED_POSITION)) {
+    throw std::invalid_argument(
+        "Folded and unfolded positions cannot be gathered at the same time.");
+  }
+
+  mpi_call(mpi_gather_particle_columns_slave, fields);
+  auto columns = local_particle_columns(fields);
+  gather_particle_columns(columns, fields);
+
+  return columns;
+}
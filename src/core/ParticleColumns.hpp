@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_PARTICLE_COLUMNS_HPP
+#define CORE_PARTICLE_COLUMNS_HPP
+
+#include <utils/Vector.hpp>
+
+#include <cstddef>
+#include <vector>
+
+/** Particle properties that can be requested from
+ *  @ref mpi_gather_particle_columns. Flags can be combined.
+ */
+enum ParticleField : unsigned {
+  /** Unfolded positions */
+  PARTICLE_FIELD_POSITION = 1u << 0u,
+  /** Positions folded into the primary simulation box */
+  PARTICLE_FIELD_FOLDED_POSITION = 1u << 1u,
+  PARTICLE_FIELD_TYPE = 1u << 2u,
+  PARTICLE_FIELD_CHARGE = 1u << 3u,
+  PARTICLE_FIELD_VELOCITY = 1u << 4u,
+  PARTICLE_FIELD_MASS = 1u << 5u,
+  PARTICLE_FIELD_VIRTUAL = 1u << 6u,
+  PARTICLE_FIELD_FORCE = 1u << 7u,
+  /** Image boxes corresponding to the folded positions */
+  PARTICLE_FIELD_IMAGE = 1u << 8u,
+};
+
+/**
+ * @brief Selected properties of all particles, stored column-wise.
+ *
+ * The ids are always present. Columns of properties that were not
+ * requested are empty, all other columns have one entry per particle,
+ * in the same order as @ref ParticleColumns::id.
+ */
+struct ParticleColumns {
+  std::vector<int> id;
+  /** Folded or unfolded positions, depending on the request */
+  std::vector<Utils::Vector3d> pos;
+  std::vector<int> type;
+  std::vector<double> q;
+  std::vector<Utils::Vector3d> v;
+  std::vector<Utils::Vector3d> f;
+  std::vector<Utils::Vector3i> image;
+  std::vector<double> mass;
+  std::vector<char> is_virtual;
+
+  std::size_t size() const { return id.size(); }
+};
+
+/**
+ * @brief Gather selected properties of all particles on the master node.
+ *
+ * Only the requested properties are sent, with one MPI_Gatherv per
+ * property, instead of full particle copies including bonds and
+ * exclusions as with @ref PartCfg. This should be preferred for analysis
+ * which only needs a few properties of every particle.
+ *
+ * *WARNING* Particles are returned in an arbitrary order.
+ *
+ * This function has to be called on the master node.
+ *
+ * @param fields Combination of @ref ParticleField flags. Unfolded and
+ *               folded positions cannot be requested at the same time.
+ *
+ * @returns The particle properties.
+ */
+ParticleColumns mpi_gather_particle_columns(unsigned fields);
+
+/**
+ * @brief Gather selected properties of all particles on all nodes.
+ *
+ * Same as @ref mpi_gather_particle_columns, but the result is available
+ * on all nodes. This function has to be called on all nodes.
+ */
+ParticleColumns all_gather_particle_columns(unsigned fields);
+
+#endif
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Correlator.hpp"
+#include "communication.hpp"
 #include "integrate.hpp"
 
 #include <utils/serialization/multi_array.hpp>
@@ -25,142 +26,138 @@
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/mpi/collectives/gather.hpp>
+#include <boost/mpi/collectives/scatter.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
 
+#include <algorithm>
 #include <limits>
+#include <unordered_map>
 
 namespace {
-int min(int i, unsigned int j) { return std::min(i, static_cast<int>(j)); }
-} // namespace
-
-namespace Accumulators {
-/** The minimal version of compression function */
-std::vector<double> compress_do_nothing(std::vector<double> const &A1,
-                                        std::vector<double> const &A2) {
-  return {};
-}
-
-/** Compress computing arithmetic mean: A_compressed=(A1+A2)/2 */
-std::vector<double> compress_linear(std::vector<double> const &A1,
-                                    std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A1.size());
-
-  std::transform(A1.begin(), A1.end(), A2.begin(), A_compressed.begin(),
-                 [](double a, double b) -> double { return 0.5 * (a + b); });
+using Accumulators::CorrelationParameters;
+using Accumulators::CorrelatorEngine;
+
+/** Hierarchy of a distributed correlation on this node. */
+struct Shard {
+  CorrelationParameters params;
+  CorrelatorEngine engine;
+  /** Buffers for the new values of A and B */
+  std::vector<double> A, B;
+};
 
-  return A_compressed;
-}
+/** Shards of the distributed correlations, by correlation id */
+std::unordered_map<int, Shard> shards;
 
-/** Compress discarding the 1st argument and return the 2nd */
-std::vector<double> compress_discard1(std::vector<double> const &A1,
-                                      std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A2);
-  return A_compressed;
+std::string serialize_engine(CorrelatorEngine const &engine) {
+  std::stringstream ss;
+  boost::archive::binary_oarchive oa(ss);
+  oa << engine;
+  return ss.str();
 }
 
-/** Compress discarding the 2nd argument and return the 1st */
-std::vector<double> compress_discard2(std::vector<double> const &A1,
-                                      std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A1);
-  return A_compressed;
+void deserialize_engine(std::string const &state, CorrelatorEngine &engine) {
+  namespace iostreams = boost::iostreams;
+  iostreams::array_source src(state.data(), state.size());
+  iostreams::stream<iostreams::array_source> ss(src);
+  boost::archive::binary_iarchive ia(ss);
+  ia >> engine;
 }
 
-std::vector<double> scalar_product(std::vector<double> const &A,
-                                   std::vector<double> const &B,
-                                   Utils::Vector3d) {
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in scalar product: The vector sizes do not match");
+/** @brief Distribute the new values of A and B to the nodes.
+ *
+ *  @param params   Parameters of the correlation
+ *  @param A_new    New value of A, only used on the head node
+ *  @param B_new    New value of B, only used on the head node
+ *  @param A_counts Number of components of A per node (head node only)
+ *  @param A_displs Offsets of the components of A per node (head node only)
+ *  @param B_counts Number of components of B per node (head node only)
+ *  @param B_displs Offsets of the components of B per node (head node only)
+ *  @param[out] A   Slice of A of this node
+ *  @param[out] B   Slice of B of this node
+ */
+void scatter_values(CorrelationParameters const &params, double const *A_new,
+                    double const *B_new, int const *A_counts,
+                    int const *A_displs, int const *B_counts,
+                    int const *B_displs, std::vector<double> &A,
+                    std::vector<double> &B) {
+  MPI_Scatterv(A_new, A_counts, A_displs, MPI_DOUBLE, A.data(),
+               static_cast<int>(A.size()), MPI_DOUBLE, 0, comm_cart);
+  if (params.corr_operation == "tensor_product") {
+    /* Every node needs all of B */
+    if (comm_cart.rank() == 0) {
+      std::copy_n(B_new, B.size(), B.begin());
+    }
+    MPI_Bcast(B.data(), static_cast<int>(B.size()), MPI_DOUBLE, 0, comm_cart);
+  } else {
+    MPI_Scatterv(B_new, B_counts, B_displs, MPI_DOUBLE, B.data(),
+                 static_cast<int>(B.size()), MPI_DOUBLE, 0, comm_cart);
   }
-
-  return std::vector<double>(
-      1, std::inner_product(A.begin(), A.end(), B.begin(), 0.0));
 }
 
-std::vector<double> componentwise_product(std::vector<double> const &A,
-                                          std::vector<double> const &B,
-                                          Utils::Vector3d) {
-  std::vector<double> C(A.size());
-  if (!(A.size() == B.size())) {
-    throw std::runtime_error(
-        "Error in componentwise product: The vector sizes do not match");
-  }
-
-  std::transform(A.begin(), A.end(), B.begin(), C.begin(), std::multiplies<>());
+/** Flat copy of the correlation sums of an engine. */
+std::vector<double> local_sums(CorrelatorEngine const &engine) {
+  auto const &sums = engine.sums();
+  return std::vector<double>(sums.data(), sums.data() + sums.num_elements());
+}
+} // namespace
 
-  return C;
+void mpi_correlator_create_slave(int id, CorrelationParameters const &params) {
+  auto &shard = shards[id];
+  shard.params = params;
+  shard.engine = CorrelatorEngine(
+      params, correlation_slice(params, comm_cart.rank(), comm_cart.size()));
+  shard.A.resize(shard.engine.dim_A());
+  shard.B.resize(shard.engine.dim_B());
 }
 
-std::vector<double> tensor_product(std::vector<double> const &A,
-                                   std::vector<double> const &B,
-                                   Utils::Vector3d) {
-  std::vector<double> C(A.size() * B.size());
-  auto C_it = C.begin();
+REGISTER_CALLBACK(mpi_correlator_create_slave)
 
-  for (auto A_it = A.begin(); A_it != A.begin(); ++A_it) {
-    for (double B_it : B) {
-      *(C_it++) = *A_it * B_it;
-    }
-  }
-  assert(C_it == C.end());
+void mpi_correlator_destroy_slave(int id) { shards.erase(id); }
+
+REGISTER_CALLBACK(mpi_correlator_destroy_slave)
 
-  return C;
+void mpi_correlator_update_slave(int id, Utils::Vector3d const &args) {
+  auto &shard = shards.at(id);
+  scatter_values(shard.params, nullptr, nullptr, nullptr, nullptr, nullptr,
+                 nullptr, shard.A, shard.B);
+  shard.engine.update(shard.A.data(), shard.B.data(), args);
 }
 
-std::vector<double> square_distance_componentwise(std::vector<double> const &A,
-                                                  std::vector<double> const &B,
-                                                  Utils::Vector3d) {
-  if (!(A.size() == B.size())) {
-    throw std::runtime_error(
-        "Error in square distance componentwise: The vector sizes do not "
-        "match.");
-  }
+REGISTER_CALLBACK(mpi_correlator_update_slave)
 
-  std::vector<double> C(A.size());
+void mpi_correlator_finalize_slave(int id, Utils::Vector3d const &args) {
+  shards.at(id).engine.finalize(args);
+}
 
-  std::transform(
-      A.begin(), A.end(), B.begin(), C.begin(),
-      [](double a, double b) -> double { return (a - b) * (a - b); });
+REGISTER_CALLBACK(mpi_correlator_finalize_slave)
 
-  return C;
+void mpi_correlator_gather_sums_slave(int id) {
+  boost::mpi::gather(comm_cart, local_sums(shards.at(id).engine), 0);
 }
 
-// note: the argument name wsquare denotes that it value is w^2 while the user
-// sets w
-std::vector<double> fcs_acf(std::vector<double> const &A,
-                            std::vector<double> const &B,
-                            Utils::Vector3d wsquare) {
-  if (!(A.size() == B.size())) {
-    throw std::runtime_error(
-        "Error in square distance componentwise: The vector sizes do not "
-        "match.");
-  }
+REGISTER_CALLBACK(mpi_correlator_gather_sums_slave)
 
-  auto const C_size = A.size() / 3;
-  if (3 * C_size != A.size()) {
-    throw std::runtime_error("Invalid dimensions.");
-  }
-
-  std::vector<double> C(C_size, 0);
+void mpi_correlator_get_state_slave(int id) {
+  boost::mpi::gather(comm_cart, serialize_engine(shards.at(id).engine), 0);
+}
 
-  for (unsigned i = 0; i < C_size; i++) {
-    for (int j = 0; j < 3; j++) {
-      auto const &a = A[3 * i + j];
-      auto const &b = B[3 * i + j];
+REGISTER_CALLBACK(mpi_correlator_get_state_slave)
 
-      C[i] -= (a - b) * (a - b) / wsquare[j];
-    }
-  }
+void mpi_correlator_set_state_slave(int id) {
+  std::string state;
+  boost::mpi::scatter(comm_cart, state, 0);
+  deserialize_engine(state, shards.at(id).engine);
+}
 
-  std::transform(C.begin(), C.end(), C.begin(),
-                 [](double c) -> double { return std::exp(c); });
+REGISTER_CALLBACK(mpi_correlator_set_state_slave)
 
-  return C;
-}
+namespace Accumulators {
+namespace {
+/** Identifier of the next distributed correlation */
+int next_correlator_id = 0;
+} // namespace
 
 /* global variables */
 
@@ -189,6 +186,8 @@ constexpr const char init_errors[][64] = {
 };
 
 int Correlator::get_correlation_time(double *correlation_time) {
+  auto const result = correlation_sums();
+  auto const &n_sweeps = m_engine.sweeps();
   // We calculate the correlation time for each m_dim_corr by normalizing the
   // correlation, integrating it and finding out where C(tau)=tau
   for (unsigned j = 0; j < m_dim_corr; j++) {
@@ -202,10 +201,10 @@ int Correlator::get_correlation_time(double *correlation_time) {
     for (unsigned k = 1; k < m_n_result - 1; k++) {
       if (n_sweeps[k] == 0)
         break;
-      C_tau += (result[k][j] / (double)n_sweeps[k] -
+      C_tau += (result[k * m_dim_corr + j] / (double)n_sweeps[k] -
                 A_accumulated_average[j] * B_accumulated_average[j] / n_data /
                     n_data) /
-               (result[0][j] / n_sweeps[0]) * m_dt * (tau[k] - tau[k - 1]);
+               (result[j] / n_sweeps[0]) * m_dt * (tau[k] - tau[k - 1]);
 
       if (exp(-tau[k] * m_dt / C_tau) + 2 * sqrt(tau[k] * m_dt / n_data) >
           exp(-tau[k - 1] * m_dt / C_tau) +
@@ -275,15 +274,12 @@ void Correlator::initialize() {
   }
   if (corr_operation_name == "componentwise_product") {
     m_dim_corr = dim_A;
-    corr_operation = &componentwise_product;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else if (corr_operation_name == "tensor_product") {
     m_dim_corr = dim_A * dim_B;
-    corr_operation = &tensor_product;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else if (corr_operation_name == "square_distance_componentwise") {
     m_dim_corr = dim_A;
-    corr_operation = &square_distance_componentwise;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else if (corr_operation_name == "fcs_acf") {
     // note: user provides w=(wx,wy,wz) but we want to use
@@ -298,65 +294,71 @@ void Correlator::initialize() {
     if (dim_A % 3)
       throw std::runtime_error(init_errors[18]);
     m_dim_corr = dim_A / 3;
-    corr_operation = &fcs_acf;
   } else if (corr_operation_name == "scalar_product") {
     m_dim_corr = 1;
-    corr_operation = &scalar_product;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else {
     throw std::runtime_error(init_errors[11]);
   }
 
+  if (corr_operation_name != "tensor_product" and dim_A != dim_B) {
+    throw std::runtime_error(init_errors[8]);
+  }
+
   // Choose the compression function
+  auto const is_compression = [](std::string const &name) {
+    return name == "discard2" or name == "discard1" or name == "linear";
+  };
   if (compressA_name.empty()) { // this is the default
     compressA_name = "discard2";
-    compressA = &compress_discard2;
-  } else if (compressA_name == "discard2") {
-    compressA = &compress_discard2;
-  } else if (compressA_name == "discard1") {
-    compressA = &compress_discard1;
-  } else if (compressA_name == "linear") {
-    compressA = &compress_linear;
-  } else {
+  } else if (not is_compression(compressA_name)) {
     throw std::runtime_error(init_errors[12]);
   }
 
   if (compressB_name.empty()) {
     compressB_name = compressA_name;
-    compressB = compressA;
-  } else if (compressB_name == "discard2") {
-    compressB = &compress_discard2;
-  } else if (compressB_name == "discard1") {
-    compressB = &compress_discard1;
-  } else if (compressB_name == "linear") {
-    compressB = &compress_linear;
-  } else {
+  } else if (not is_compression(compressB_name)) {
     throw std::runtime_error(init_errors[13]);
   }
 
-  A.resize(std::array<int, 2>{{hierarchy_depth, m_tau_lin + 1}});
-  std::fill_n(A.data(), A.num_elements(), std::vector<double>(dim_A, 0));
-  B.resize(std::array<int, 2>{{hierarchy_depth, m_tau_lin + 1}});
-  std::fill_n(B.data(), B.num_elements(), std::vector<double>(dim_B, 0));
+  m_params.tau_lin = m_tau_lin;
+  m_params.hierarchy_depth = hierarchy_depth;
+  m_params.dim_A = static_cast<int>(dim_A);
+  m_params.dim_B = static_cast<int>(dim_B);
+  m_params.corr_operation = corr_operation_name;
+  m_params.compress1 = compressA_name;
+  m_params.compress2 = compressB_name;
+  assert(correlation_dimension(m_params) == m_dim_corr);
+
+  if (m_distributed) {
+    m_id = next_correlator_id++;
+    mpi_call(mpi_correlator_create_slave, m_id, m_params);
+
+    auto const n_nodes = comm_cart.size();
+    A_counts.resize(n_nodes);
+    A_displs.resize(n_nodes);
+    B_counts.resize(n_nodes);
+    B_displs.resize(n_nodes);
+    for (int node = 0; node < n_nodes; node++) {
+      auto const slice = correlation_slice(m_params, node, n_nodes);
+      A_counts[node] = slice.A_end - slice.A_begin;
+      A_displs[node] = slice.A_begin;
+      B_counts[node] = slice.B_end - slice.B_begin;
+      B_displs[node] = slice.B_begin;
+    }
+    m_engine =
+        CorrelatorEngine(m_params, correlation_slice(m_params, 0, n_nodes));
+    m_A_local.resize(m_engine.dim_A());
+    m_B_local.resize(m_engine.dim_B());
+  } else {
+    m_engine = CorrelatorEngine(m_params, correlation_slice(m_params, 0, 1));
+  }
 
   n_data = 0;
   A_accumulated_average = std::vector<double>(dim_A, 0);
   B_accumulated_average = std::vector<double>(dim_B, 0);
 
-  m_n_result = m_tau_lin + 1 + (m_tau_lin + 1) / 2 * (hierarchy_depth - 1);
-  n_sweeps = std::vector<unsigned int>(m_n_result, 0);
-  n_vals = std::vector<unsigned int>(hierarchy_depth, 0);
-
-  result.resize(std::array<int, 2>{{m_n_result, m_dim_corr}});
-
-  for (int i = 0; i < m_n_result; i++) {
-    for (int j = 0; j < m_dim_corr; j++) {
-      // and initialize the values
-      result[i][j] = 0;
-    }
-  }
-
-  newest = std::vector<unsigned int>(hierarchy_depth, m_tau_lin);
+  m_n_result = m_engine.n_result();
 
   tau.resize(m_n_result);
   for (int i = 0; i < m_tau_lin + 1; i++) {
@@ -371,191 +373,87 @@ void Correlator::initialize() {
   }
 }
 
+Correlator::~Correlator() {
+  /* At exit, the shards are released with the slave processes. */
+  if (m_distributed and mpi_callbacks_active()) {
+    mpi_call(mpi_correlator_destroy_slave, m_id);
+  }
+}
+
 void Correlator::update() {
-  if (finalized) {
+  if (m_engine.finalized()) {
     throw std::runtime_error(
         "No data can be added after finalize() was called.");
   }
-  // We must now go through the hierarchy and make sure there is space for the
-  // new datapoint. For every hierarchy level we have to decide if it is
-  // necessary to move something
-  int highest_level_to_compress = -1;
-
-  t++;
-
-  // Let's find out how far we have to go back in the hierarchy to make space
-  // for the new value
-  int i = 0;
-  while (true) {
-    if (((t - ((m_tau_lin + 1) * ((1 << (i + 1)) - 1) + 1)) % (1 << (i + 1)) ==
-         0)) {
-      if (i < (int(hierarchy_depth) - 1) && n_vals[i] > m_tau_lin) {
-        highest_level_to_compress += 1;
-        i++;
-      } else
-        break;
-    } else
-      break;
-  }
-
-  // Now we know we must make space on the levels 0..highest_level_to_compress
-  // Now let's compress the data level by level.
-
-  for (int i = highest_level_to_compress; i >= 0; i--) {
-    // We increase the index indicating the newest on level i+1 by one (plus
-    // folding)
-    newest[i + 1] = (newest[i + 1] + 1) % (m_tau_lin + 1);
-    n_vals[i + 1] += 1;
-    A[i + 1][newest[i + 1]] =
-        (*compressA)(A[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     A[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-    B[i + 1][newest[i + 1]] =
-        (*compressB)(B[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     B[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-  }
 
-  newest[0] = (newest[0] + 1) % (m_tau_lin + 1);
-  n_vals[0]++;
-
-  A[0][newest[0]] = A_obs->operator()();
-  if (A_obs != B_obs) {
-    B[0][newest[0]] = B_obs->operator()();
-  } else {
-    B[0][newest[0]] = A[0][newest[0]];
-  }
+  auto const A_new = A_obs->operator()();
+  auto const B_new = (A_obs != B_obs) ? B_obs->operator()() : A_new;
 
   // Now we update the cumulated averages and variances of A and B
   n_data++;
   for (unsigned k = 0; k < dim_A; k++) {
-    A_accumulated_average[k] += A[0][newest[0]][k];
+    A_accumulated_average[k] += A_new[k];
   }
 
   for (unsigned k = 0; k < dim_B; k++) {
-    B_accumulated_average[k] += B[0][newest[0]][k];
+    B_accumulated_average[k] += B_new[k];
   }
 
-  // Now update the lowest level correlation estimates
-  for (unsigned j = 0; j < min(m_tau_lin + 1, n_vals[0]); j++) {
-    auto const index_new = newest[0];
-    auto const index_old = (newest[0] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-    auto const temp =
-        (corr_operation)(A[0][index_old], B[0][index_new], m_correlation_args);
-    assert(temp.size() == m_dim_corr);
-
-    n_sweeps[j]++;
-    for (unsigned k = 0; k < m_dim_corr; k++) {
-      result[j][k] += temp[k];
-    }
-  }
-  // Now for the higher ones
-  for (int i = 1; i < highest_level_to_compress + 2; i++) {
-    for (unsigned j = (m_tau_lin + 1) / 2 + 1;
-         j < min(m_tau_lin + 1, n_vals[i]); j++) {
-      auto const index_new = newest[i];
-      auto const index_old = (newest[i] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-      auto const index_res =
-          m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
-      auto const temp = (corr_operation)(A[i][index_old], B[i][index_new],
-                                         m_correlation_args);
-      assert(temp.size() == m_dim_corr);
-
-      n_sweeps[index_res]++;
-      for (unsigned k = 0; k < m_dim_corr; k++) {
-        result[index_res][k] += temp[k];
-      }
-    }
+  if (m_distributed) {
+    mpi_call(mpi_correlator_update_slave, m_id, m_correlation_args);
+    scatter_values(m_params, A_new.data(), B_new.data(), A_counts.data(),
+                   A_displs.data(), B_counts.data(), B_displs.data(),
+                   m_A_local, m_B_local);
+    m_engine.update(m_A_local.data(), m_B_local.data(), m_correlation_args);
+  } else {
+    m_engine.update(A_new.data(), B_new.data(), m_correlation_args);
   }
 
   m_last_update = sim_time;
 }
 
 int Correlator::finalize() {
-  if (finalized) {
+  if (m_engine.finalized()) {
     throw std::runtime_error("Correlator::finalize() can only be called once.");
   }
-  // We must now go through the hierarchy and make sure there is space for the
-  // new datapoint. For every hierarchy level we have to decide if it is
-  // necessary to move something
-  int highest_level_to_compress;
-
-  // mark the correlation as finalized
-  finalized = true;
-
-  for (int ll = 0; ll < hierarchy_depth - 1; ll++) {
-    int vals_ll; // number of values remaining in the lowest level
-    if (n_vals[ll] > m_tau_lin + 1)
-      vals_ll = m_tau_lin + n_vals[ll] % 2;
-    else
-      vals_ll = n_vals[ll];
-
-    while (vals_ll) {
-      // Check, if we will want to push the value from the lowest level
-      if (vals_ll % 2) {
-        highest_level_to_compress = ll;
-      } else {
-        highest_level_to_compress = -1;
-      }
 
-      int i = ll + 1; // lowest level for which we have to check for compression
-      // Let's find out how far we have to go back in the hierarchy to make
-      // space for the new value
-      while (highest_level_to_compress > -1) {
-        if (n_vals[i] % 2) {
-          if (i < (hierarchy_depth - 1) && n_vals[i] > m_tau_lin) {
-            highest_level_to_compress += 1;
-            i++;
-          } else {
-            break;
-          }
-        } else {
-          break;
-        }
-      }
-      vals_ll -= 1;
-
-      // Now we know we must make space on the levels
-      // 0..highest_level_to_compress
-      // Now let's compress the data level by level.
-
-      for (int i = highest_level_to_compress; i >= ll; i--) {
-        // We increase the index indicating the newest on level i+1 by one (plus
-        // folding)
-        newest[i + 1] = (newest[i + 1] + 1) % (m_tau_lin + 1);
-        n_vals[i + 1] += 1;
-
-        (*compressA)(A[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     A[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-        (*compressB)(B[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     B[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-      }
-      newest[ll] = (newest[ll] + 1) % (m_tau_lin + 1);
-
-      // We only need to update correlation estimates for the higher levels
-      for (int i = ll + 1; i < highest_level_to_compress + 2; i++) {
-        for (int j = (m_tau_lin + 1) / 2 + 1; j < min(m_tau_lin + 1, n_vals[i]);
-             j++) {
-          auto const index_new = newest[i];
-          auto const index_old =
-              (newest[i] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-          auto const index_res =
-              m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
-
-          auto const temp = (corr_operation)(A[i][index_old], B[i][index_new],
-                                             m_correlation_args);
-          assert(temp.size() == m_dim_corr);
-
-          n_sweeps[index_res]++;
-          for (unsigned k = 0; k < m_dim_corr; k++) {
-            result[index_res][k] += temp[k];
-          }
-        }
+  if (m_distributed) {
+    mpi_call(mpi_correlator_finalize_slave, m_id, m_correlation_args);
+  }
+  m_engine.finalize(m_correlation_args);
+
+  return 0;
+}
+
+std::vector<double> Correlator::correlation_sums() {
+  if (not m_distributed) {
+    return local_sums(m_engine);
+  }
+
+  mpi_call(mpi_correlator_gather_sums_slave, m_id);
+  std::vector<std::vector<double>> node_sums;
+  boost::mpi::gather(comm_cart, local_sums(m_engine), node_sums, 0);
+
+  std::vector<double> sums(m_n_result * m_dim_corr, 0.);
+  auto const n_nodes = static_cast<int>(node_sums.size());
+  for (int node = 0; node < n_nodes; node++) {
+    auto const slice = correlation_slice(m_params, node, n_nodes);
+    auto const width = slice.C_end - slice.C_begin;
+    for (int i = 0; i < m_n_result; i++) {
+      for (int k = 0; k < width; k++) {
+        /* partial sums of the scalar product are added up */
+        sums[i * m_dim_corr + slice.C_begin + k] +=
+            node_sums[node][i * width + k];
       }
     }
   }
-  return 0;
+
+  return sums;
 }
 
 std::vector<double> Correlator::get_correlation() {
+  auto const result = correlation_sums();
+  auto const &n_sweeps = m_engine.sweeps();
   std::vector<double> res;
 
   // time + n_sweeps + corr_1...corr_n
@@ -567,7 +465,7 @@ std::vector<double> Correlator::get_correlation() {
     res[cols * i + 1] = n_sweeps[i];
     for (int k = 0; k < m_dim_corr; k++) {
       if (n_sweeps[i] > 0) {
-        res[cols * i + 2 + k] = result[i][k] / n_sweeps[i];
+        res[cols * i + 2 + k] = result[i * m_dim_corr + k] / n_sweeps[i];
       } else {
         res[cols * i + 2 + k] = 0;
       }
@@ -577,17 +475,19 @@ std::vector<double> Correlator::get_correlation() {
 }
 
 std::string Correlator::get_internal_state() const {
+  std::vector<std::string> engine_states;
+  if (m_distributed) {
+    mpi_call(mpi_correlator_get_state_slave, m_id);
+    boost::mpi::gather(comm_cart, serialize_engine(m_engine), engine_states, 0);
+  } else {
+    engine_states.push_back(serialize_engine(m_engine));
+  }
+
   std::stringstream ss;
   boost::archive::binary_oarchive oa(ss);
 
-  oa << t;
   oa << m_n_result;
-  oa << A;
-  oa << B;
-  oa << result;
-  oa << n_sweeps;
-  oa << n_vals;
-  oa << newest;
+  oa << engine_states;
   oa << A_accumulated_average;
   oa << B_accumulated_average;
   oa << n_data;
@@ -601,18 +501,29 @@ void Correlator::set_internal_state(std::string const &state) {
   iostreams::stream<iostreams::array_source> ss(src);
   boost::archive::binary_iarchive ia(ss);
 
-  ia >> t;
+  std::vector<std::string> engine_states;
+
   ia >> m_n_result;
-  ia >> A;
-  ia >> B;
-  ia >> result;
-  ia >> n_sweeps;
-  ia >> n_vals;
-  ia >> newest;
+  ia >> engine_states;
   ia >> A_accumulated_average;
   ia >> B_accumulated_average;
   ia >> n_data;
   ia >> m_last_update;
+
+  auto const n_engines = m_distributed ? comm_cart.size() : 1;
+  if (engine_states.size() != static_cast<std::size_t>(n_engines)) {
+    throw std::runtime_error("The state of a distributed correlator can only "
+                             "be restored on the same number of nodes.");
+  }
+
+  if (m_distributed) {
+    mpi_call(mpi_correlator_set_state_slave, m_id);
+    std::string engine_state;
+    boost::mpi::scatter(comm_cart, engine_states, engine_state, 0);
+    deserialize_engine(engine_state, m_engine);
+  } else {
+    deserialize_engine(engine_states.front(), m_engine);
+  }
 }
 
 } // namespace Accumulators
@@ -113,7 +113,6 @@
 #ifndef _STATISTICS_CORRELATION_H
 #define _STATISTICS_CORRELATION_H
 
-#include <boost/multi_array.hpp>
 #include <boost/serialization/access.hpp>
 
 #include <cmath>
@@ -123,6 +122,7 @@
 #include <utility>
 
 #include "AccumulatorBase.hpp"
+#include "CorrelatorEngine.hpp"
 #include "integrate.hpp"
 #include "observables/Observable.hpp"
 #include <utils/Vector.hpp>
@@ -136,7 +136,15 @@ namespace Accumulators {
  *  linear array, which we fill from index 0 to @c tau_lin. The index
  *  <tt>newest[i]</tt> always indicates the latest entry of the hierarchic
  *  "past" For every new entry in is incremented and if @c tau_lin is reached,
- *  it starts again from the beginning.
+ *  it starts again from the beginning. The hierarchy and the correlation
+ *  estimates are kept by a @ref CorrelatorEngine.
+ *
+ *  In the distributed mode, the components of A and B are split into
+ *  contiguous blocks (see @ref correlation_slice) and every node keeps
+ *  the hierarchy of its block. The observables are still evaluated on
+ *  the head node, but only the new values are sent to the nodes, and the
+ *  cost of the correlation and the memory of the hierarchy are shared
+ *  by all nodes. This pays off for observables with many components.
  */
 class Correlator : public AccumulatorBase {
   using obs_ptr = std::shared_ptr<Observables::Observable>;
@@ -160,12 +168,15 @@ public:
    *      the linear compression method)
    *  @param correlation_args_ optional arguments for the correlation function
    *      (currently only used when @p corr_operation is "fcs_acf")
+   *  @param distributed_ whether the correlation is computed in parallel
+   *      on all nodes
    *
    */
   Correlator(int tau_lin, double tau_max, int delta_N, std::string compress1_,
              std::string compress2_, std::string corr_operation, obs_ptr obs1,
-             obs_ptr obs2, Utils::Vector3d correlation_args_ = {})
-      : AccumulatorBase(delta_N), finalized(false), t(0),
+             obs_ptr obs2, Utils::Vector3d correlation_args_ = {},
+             bool distributed_ = false)
+      : AccumulatorBase(delta_N), m_distributed(distributed_),
         m_correlation_args(correlation_args_), m_tau_lin(tau_lin),
         m_dt(delta_N * time_step), m_tau_max(tau_max),
         compressA_name(std::move(compress1_)),
@@ -175,6 +186,8 @@ public:
     initialize();
   }
 
+  ~Correlator() override;
+
 private:
   void initialize();
 
@@ -215,6 +228,7 @@ public:
   double dt() const { return m_dt; }
   int dim_corr() const { return m_dim_corr; }
   int n_result() const { return m_n_result; }
+  bool distributed() const { return m_distributed; }
 
   Utils::Vector3d const &correlation_args() const { return m_correlation_args; }
   void set_correlation_args(Utils::Vector3d const &args) {
@@ -233,8 +247,13 @@ public:
   void set_internal_state(std::string const &);
 
 private:
-  bool finalized; ///< whether the correlation is finalized
-  unsigned int t; ///< global time in number of frames
+  /** Sums of the correlation estimates of all components,
+   *  (n_result x dim_corr) in row-major order.
+   */
+  std::vector<double> correlation_sums();
+
+  bool m_distributed; ///< whether the correlation is computed on all nodes
+  int m_id;           ///< identifier of the distributed correlation
 
   Utils::Vector3d m_correlation_args; ///< additional arguments, which the
                                       ///< correlation may need (currently
@@ -257,17 +276,17 @@ private:
   std::shared_ptr<Observables::Observable> B_obs;
 
   std::vector<int> tau; ///< time differences
-  boost::multi_array<std::vector<double>, 2> A;
-  boost::multi_array<std::vector<double>, 2> B;
 
-  boost::multi_array<double, 2> result; ///< output quantity
+  CorrelationParameters m_params;
+  /** Hierarchy of this node, of all components if not distributed */
+  CorrelatorEngine m_engine;
 
-  /// number of correlation sweeps at a particular value of tau
-  std::vector<unsigned int> n_sweeps;
-  /// number of data values already present at a particular value of tau
-  std::vector<unsigned int> n_vals;
-  /// index of the newest entry in each hierarchy level
-  std::vector<unsigned int> newest;
+  /// number of components of A and B sent to each node
+  std::vector<int> A_counts, B_counts;
+  /// offsets of the components of A and B sent to each node
+  std::vector<int> A_displs, B_displs;
+  /// slices of the new values of A and B of the head node
+  std::vector<double> m_A_local, m_B_local;
 
   std::vector<double> A_accumulated_average; ///< all A values are added up here
   std::vector<double> B_accumulated_average; ///< all B values are added up here
@@ -277,19 +296,6 @@ private:
 
   unsigned int dim_A; ///< dimensionality of A
   unsigned int dim_B; ///< dimensionality of B
-
-  using correlation_operation_type =
-      std::vector<double> (*)(std::vector<double> const &,
-                              std::vector<double> const &, Utils::Vector3d);
-
-  correlation_operation_type corr_operation;
-
-  using compression_function = std::vector<double> (*)(
-      std::vector<double> const &A1, std::vector<double> const &A2);
-
-  // compressing functions
-  compression_function compressA;
-  compression_function compressB;
 };
 
 } // namespace Accumulators
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "CorrelatorEngine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace Accumulators {
+namespace {
+int min(int i, unsigned int j) { return std::min(i, static_cast<int>(j)); }
+
+/* The kernels below work on contiguous rows and are written as plain
+ * loops over the components, so that the compiler can vectorize them. */
+
+/** Compress computing arithmetic mean: A_compressed=(A1+A2)/2 */
+void compress_linear(double const *A1, double const *A2, std::size_t dim,
+                     double *A_compressed) {
+  for (std::size_t k = 0; k < dim; k++) {
+    A_compressed[k] = 0.5 * (A1[k] + A2[k]);
+  }
+}
+
+/** Compress discarding the 1st argument and return the 2nd */
+void compress_discard1(double const *, double const *A2, std::size_t dim,
+                       double *A_compressed) {
+  std::copy_n(A2, dim, A_compressed);
+}
+
+/** Compress discarding the 2nd argument and return the 1st */
+void compress_discard2(double const *A1, double const *, std::size_t dim,
+                       double *A_compressed) {
+  std::copy_n(A1, dim, A_compressed);
+}
+
+void scalar_product(double const *A, double const *B, std::size_t dim_A,
+                    std::size_t, Utils::Vector3d const &, double *C) {
+  double sum = 0.;
+  for (std::size_t k = 0; k < dim_A; k++) {
+    sum += A[k] * B[k];
+  }
+  C[0] += sum;
+}
+
+void componentwise_product(double const *A, double const *B, std::size_t dim_A,
+                           std::size_t, Utils::Vector3d const &, double *C) {
+  for (std::size_t k = 0; k < dim_A; k++) {
+    C[k] += A[k] * B[k];
+  }
+}
+
+void tensor_product(double const *A, double const *B, std::size_t dim_A,
+                    std::size_t dim_B, Utils::Vector3d const &, double *C) {
+  for (std::size_t i = 0; i < dim_A; i++) {
+    auto const a = A[i];
+    auto C_row = C + i * dim_B;
+    for (std::size_t j = 0; j < dim_B; j++) {
+      C_row[j] += a * B[j];
+    }
+  }
+}
+
+void square_distance_componentwise(double const *A, double const *B,
+                                   std::size_t dim_A, std::size_t,
+                                   Utils::Vector3d const &, double *C) {
+  for (std::size_t k = 0; k < dim_A; k++) {
+    auto const d = A[k] - B[k];
+    C[k] += d * d;
+  }
+}
+
+// note: the argument name wsquare denotes that it value is w^2 while the user
+// sets w
+void fcs_acf(double const *A, double const *B, std::size_t dim_A, std::size_t,
+             Utils::Vector3d const &wsquare, double *C) {
+  auto const C_size = dim_A / 3;
+  for (std::size_t i = 0; i < C_size; i++) {
+    double c = 0.;
+    for (int j = 0; j < 3; j++) {
+      auto const d = A[3 * i + j] - B[3 * i + j];
+      c -= d * d / wsquare[j];
+    }
+    C[i] += std::exp(c);
+  }
+}
+
+CorrelatorEngine::correlation_operation_type
+correlation_operation_by_name(std::string const &name) {
+  if (name == "componentwise_product")
+    return &componentwise_product;
+  if (name == "tensor_product")
+    return &tensor_product;
+  if (name == "square_distance_componentwise")
+    return &square_distance_componentwise;
+  if (name == "fcs_acf")
+    return &fcs_acf;
+  if (name == "scalar_product")
+    return &scalar_product;
+
+  throw std::runtime_error("Unknown correlation operation '" + name + "'");
+}
+
+CorrelatorEngine::compression_function
+compression_function_by_name(std::string const &name) {
+  if (name == "discard2")
+    return &compress_discard2;
+  if (name == "discard1")
+    return &compress_discard1;
+  if (name == "linear")
+    return &compress_linear;
+
+  throw std::runtime_error("Unknown compression function '" + name + "'");
+}
+} // namespace
+
+int correlation_dimension(CorrelationParameters const &params) {
+  if (params.corr_operation == "tensor_product")
+    return params.dim_A * params.dim_B;
+  if (params.corr_operation == "fcs_acf")
+    return params.dim_A / 3;
+  if (params.corr_operation == "scalar_product")
+    return 1;
+
+  return params.dim_A;
+}
+
+CorrelationSlice correlation_slice(CorrelationParameters const &params,
+                                   int part, int n_parts) {
+  auto const width = (params.corr_operation == "fcs_acf") ? 3 : 1;
+  auto const n_units = static_cast<long>(params.dim_A / width);
+  auto const begin = static_cast<int>(n_units * part / n_parts);
+  auto const end = static_cast<int>(n_units * (part + 1) / n_parts);
+
+  CorrelationSlice slice;
+  slice.A_begin = width * begin;
+  slice.A_end = width * end;
+  if (params.corr_operation == "tensor_product") {
+    slice.B_begin = 0;
+    slice.B_end = params.dim_B;
+    slice.C_begin = begin * params.dim_B;
+    slice.C_end = end * params.dim_B;
+  } else if (params.corr_operation == "scalar_product") {
+    slice.B_begin = slice.A_begin;
+    slice.B_end = slice.A_end;
+    slice.C_begin = 0;
+    slice.C_end = 1;
+  } else {
+    slice.B_begin = slice.A_begin;
+    slice.B_end = slice.A_end;
+    slice.C_begin = begin;
+    slice.C_end = end;
+  }
+
+  return slice;
+}
+
+CorrelatorEngine::CorrelatorEngine(CorrelationParameters const &params,
+                                   CorrelationSlice const &slice)
+    : m_tau_lin(params.tau_lin), m_hierarchy_depth(params.hierarchy_depth),
+      m_slice(slice),
+      corr_operation(correlation_operation_by_name(params.corr_operation)),
+      compressA(compression_function_by_name(params.compress1)),
+      compressB(compression_function_by_name(params.compress2)) {
+  A.resize(std::array<int, 3>{{m_hierarchy_depth, m_tau_lin + 1, dim_A()}});
+  std::fill_n(A.data(), A.num_elements(), 0.);
+  B.resize(std::array<int, 3>{{m_hierarchy_depth, m_tau_lin + 1, dim_B()}});
+  std::fill_n(B.data(), B.num_elements(), 0.);
+
+  auto const n_result =
+      m_tau_lin + 1 + (m_tau_lin + 1) / 2 * (m_hierarchy_depth - 1);
+  n_sweeps = std::vector<unsigned int>(n_result, 0);
+  n_vals = std::vector<unsigned int>(m_hierarchy_depth, 0);
+  newest = std::vector<unsigned int>(m_hierarchy_depth, m_tau_lin);
+
+  result.resize(
+      std::array<int, 2>{{n_result, m_slice.C_end - m_slice.C_begin}});
+  std::fill_n(result.data(), result.num_elements(), 0.);
+}
+
+void CorrelatorEngine::compress(int i) {
+  // We increase the index indicating the newest on level i+1 by one (plus
+  // folding)
+  newest[i + 1] = (newest[i + 1] + 1) % (m_tau_lin + 1);
+  n_vals[i + 1] += 1;
+
+  auto const first = (newest[i] + 1) % (m_tau_lin + 1);
+  auto const second = (newest[i] + 2) % (m_tau_lin + 1);
+  (*compressA)(A_row(i, first), A_row(i, second), dim_A(),
+               A_row(i + 1, newest[i + 1]));
+  (*compressB)(B_row(i, first), B_row(i, second), dim_B(),
+               B_row(i + 1, newest[i + 1]));
+}
+
+void CorrelatorEngine::correlate(int i, unsigned int j, unsigned int index_res,
+                                 Utils::Vector3d const &args) {
+  auto const index_new = newest[i];
+  auto const index_old = (newest[i] - j + m_tau_lin + 1) % (m_tau_lin + 1);
+
+  n_sweeps[index_res]++;
+  (*corr_operation)(A_row(i, index_old), B_row(i, index_new), dim_A(), dim_B(),
+                    args, result.data() + index_res * dim_corr());
+}
+
+void CorrelatorEngine::update(double const *A_new, double const *B_new,
+                              Utils::Vector3d const &args) {
+  assert(not m_finalized);
+  // We must now go through the hierarchy and make sure there is space for the
+  // new datapoint. For every hierarchy level we have to decide if it is
+  // necessary to move something
+  int highest_level_to_compress = -1;
+
+  t++;
+
+  // Let's find out how far we have to go back in the hierarchy to make space
+  // for the new value
+  int i = 0;
+  while (true) {
+    if (((t - ((m_tau_lin + 1) * ((1 << (i + 1)) - 1) + 1)) % (1 << (i + 1)) ==
+         0)) {
+      if (i < (m_hierarchy_depth - 1) && n_vals[i] > m_tau_lin) {
+        highest_level_to_compress += 1;
+        i++;
+      } else
+        break;
+    } else
+      break;
+  }
+
+  // Now we know we must make space on the levels 0..highest_level_to_compress
+  // Now let's compress the data level by level.
+  for (int i = highest_level_to_compress; i >= 0; i--) {
+    compress(i);
+  }
+
+  newest[0] = (newest[0] + 1) % (m_tau_lin + 1);
+  n_vals[0]++;
+
+  std::copy_n(A_new, dim_A(), A_row(0, newest[0]));
+  std::copy_n(B_new, dim_B(), B_row(0, newest[0]));
+
+  // Now update the lowest level correlation estimates
+  for (unsigned j = 0; j < min(m_tau_lin + 1, n_vals[0]); j++) {
+    correlate(0, j, j, args);
+  }
+  // Now for the higher ones
+  for (int i = 1; i < highest_level_to_compress + 2; i++) {
+    for (unsigned j = (m_tau_lin + 1) / 2 + 1;
+         j < min(m_tau_lin + 1, n_vals[i]); j++) {
+      auto const index_res =
+          m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
+      correlate(i, j, index_res, args);
+    }
+  }
+}
+
+void CorrelatorEngine::finalize(Utils::Vector3d const &args) {
+  // mark the correlation as finalized
+  m_finalized = true;
+
+  // Push the values left on every level to the next one, as if more data
+  // had been added, and update the correlation estimates of the higher levels
+  for (int ll = 0; ll < m_hierarchy_depth - 1; ll++) {
+    auto const n_stored = min(m_tau_lin + 1, n_vals[ll]);
+    // The values are compressed pairwise in the order they were added, so
+    // the oldest value of a level that was compressed before is already
+    // part of a compressed pair if the number of values is even.
+    auto const n_compressed =
+        (static_cast<int>(n_vals[ll]) > m_tau_lin + 1) ? 1 - n_vals[ll] % 2 : 0;
+    // Let newest point to the value before the oldest one that was not
+    // compressed yet, which is where compress() starts.
+    newest[ll] = (newest[ll] + m_tau_lin + 1 - n_stored + n_compressed) %
+                 (m_tau_lin + 1);
+
+    // A single value left over has no partner to be compressed with.
+    for (int n_pairs = (n_stored - n_compressed) / 2; n_pairs > 0; n_pairs--) {
+      // Let's find out how far we have to go back in the hierarchy to make
+      // space for the new value
+      int highest_level_to_compress = ll;
+      int i = ll + 1;
+      while (i < (m_hierarchy_depth - 1) && n_vals[i] > m_tau_lin &&
+             n_vals[i] % 2) {
+        highest_level_to_compress += 1;
+        i++;
+      }
+
+      // Now we know we must make space on the levels
+      // ll..highest_level_to_compress
+      // Now let's compress the data level by level.
+      for (int i = highest_level_to_compress; i >= ll; i--) {
+        compress(i);
+      }
+      newest[ll] = (newest[ll] + 2) % (m_tau_lin + 1);
+
+      // We only need to update correlation estimates for the higher levels
+      for (int i = ll + 1; i < highest_level_to_compress + 2; i++) {
+        for (int j = (m_tau_lin + 1) / 2 + 1; j < min(m_tau_lin + 1, n_vals[i]);
+             j++) {
+          auto const index_res =
+              m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
+          correlate(i, j, index_res, args);
+        }
+      }
+    }
+  }
+}
+
+} // namespace Accumulators
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_CORRELATOR_ENGINE_HPP
+#define CORE_ACCUMULATORS_CORRELATOR_ENGINE_HPP
+
+#include <utils/Vector.hpp>
+
+#include <boost/multi_array.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Accumulators {
+
+/** Parameters of the multiple tau correlation, shared by all
+ *  @ref CorrelatorEngine instances of a distributed correlation.
+ */
+struct CorrelationParameters {
+  int tau_lin = 0;
+  int hierarchy_depth = 0;
+  int dim_A = 0;
+  int dim_B = 0;
+  std::string corr_operation;
+  std::string compress1;
+  std::string compress2;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &tau_lin &hierarchy_depth &dim_A &dim_B &corr_operation &compress1
+        &compress2;
+  }
+};
+
+/** Contiguous part of a correlation, in units of components of
+ *  A, B and of the correlation result.
+ */
+struct CorrelationSlice {
+  int A_begin = 0;
+  int A_end = 0;
+  int B_begin = 0;
+  int B_end = 0;
+  int C_begin = 0;
+  int C_end = 0;
+};
+
+/** @brief Number of correlation components.
+ *
+ *  @param params Parameters of the correlation
+ *  @return Dimension of the correlation result.
+ */
+int correlation_dimension(CorrelationParameters const &params);
+
+/** @brief Part of a correlation handled by one of @p n_parts workers.
+ *
+ *  The components of A are distributed in contiguous blocks, such that
+ *  every block can be correlated independently: for the componentwise
+ *  operations the blocks of B and of the result are the corresponding
+ *  components, for "fcs_acf" blocks are aligned to the triplets of
+ *  coordinates, for "tensor_product" every worker needs all of B and
+ *  computes the rows of the result belonging to its block of A, and for
+ *  "scalar_product" every worker computes a partial sum which has to be
+ *  added up.
+ *
+ *  @param params  Parameters of the correlation
+ *  @param part    Index of the worker
+ *  @param n_parts Number of workers
+ */
+CorrelationSlice correlation_slice(CorrelationParameters const &params,
+                                   int part, int n_parts);
+
+/** @brief Multiple tau correlation of a slice of A and B.
+ *
+ *  The hierarchy of past values is kept in a flat ring buffer of
+ *  @c hierarchy_depth x (@c tau_lin + 1) rows of the slice, and the
+ *  correlation operations and compression functions work in place
+ *  on these rows, so that no memory is allocated when new values are
+ *  added. The bookkeeping only depends on the number of values, which
+ *  allows to correlate disjoint slices of A and B independently, and
+ *  to concatenate the results.
+ */
+class CorrelatorEngine {
+public:
+  /** Correlation operation, accumulates the correlation of
+   *  @p A and @p B into @p C.
+   */
+  using correlation_operation_type = void (*)(double const *A,
+                                              double const *B,
+                                              std::size_t dim_A,
+                                              std::size_t dim_B,
+                                              Utils::Vector3d const &args,
+                                              double *C);
+  /** Compression function, writes the compressed value of
+   *  @p A1 and @p A2 to @p A_compressed.
+   */
+  using compression_function = void (*)(double const *A1, double const *A2,
+                                        std::size_t dim, double *A_compressed);
+
+  CorrelatorEngine() = default;
+  CorrelatorEngine(CorrelationParameters const &params,
+                   CorrelationSlice const &slice);
+
+  /** Add a new value of the slices of A and B, and update
+   *  the correlation estimates.
+   *
+   *  @param A_new New value of the slice of A
+   *  @param B_new New value of the slice of B
+   *  @param args  Additional arguments of the correlation operation
+   */
+  void update(double const *A_new, double const *B_new,
+              Utils::Vector3d const &args);
+
+  /** Correlate the values left in the hierarchy. */
+  void finalize(Utils::Vector3d const &args);
+
+  bool finalized() const { return m_finalized; }
+  CorrelationSlice const &slice() const { return m_slice; }
+  int n_result() const { return static_cast<int>(n_sweeps.size()); }
+  int dim_A() const { return m_slice.A_end - m_slice.A_begin; }
+  int dim_B() const { return m_slice.B_end - m_slice.B_begin; }
+  int dim_corr() const { return static_cast<int>(result.shape()[1]); }
+
+  /** Sums of the correlation estimates, (n_result x dim_corr) */
+  boost::multi_array<double, 2> const &sums() const { return result; }
+  /** Number of correlation sweeps at a particular value of tau */
+  std::vector<unsigned int> const &sweeps() const { return n_sweeps; }
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &m_finalized &t &A &B &result &n_sweeps &n_vals &newest;
+  }
+
+private:
+  double *A_row(int level, unsigned int index) {
+    return A.data() + (level * (m_tau_lin + 1) + index) * dim_A();
+  }
+  double *B_row(int level, unsigned int index) {
+    return B.data() + (level * (m_tau_lin + 1) + index) * dim_B();
+  }
+  /** Compress the two oldest values of level @p i into the
+   *  next slot of level <tt>i + 1</tt>.
+   */
+  void compress(int i);
+  /** Correlate the newest value of level @p i with the value
+   *  @p j positions in the past.
+   */
+  void correlate(int i, unsigned int j, unsigned int index_res,
+                 Utils::Vector3d const &args);
+
+  bool m_finalized = false;
+  unsigned int t = 0; ///< global time in number of frames
+  int m_tau_lin = 0;
+  int m_hierarchy_depth = 0;
+  CorrelationSlice m_slice;
+
+  correlation_operation_type corr_operation = nullptr;
+  compression_function compressA = nullptr;
+  compression_function compressB = nullptr;
+
+  /** Past values of A, (hierarchy_depth x (tau_lin + 1) x dim_A) */
+  boost::multi_array<double, 3> A;
+  /** Past values of B, (hierarchy_depth x (tau_lin + 1) x dim_B) */
+  boost::multi_array<double, 3> B;
+  boost::multi_array<double, 2> result; ///< sums of the correlations
+
+  std::vector<unsigned int> n_sweeps;
+  /// number of data values already present at a particular value of tau
+  std::vector<unsigned int> n_vals;
+  /// index of the newest entry in each hierarchy level
+  std::vector<unsigned int> newest;
+};
+
+} // namespace Accumulators
+
+#endif
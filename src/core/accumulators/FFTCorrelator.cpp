@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "FFTCorrelator.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace Accumulators {
+FFTCorrelator::FFTCorrelator(int delta_N, double dt, int n_lags,
+                             std::string corr_operation, int dim_A, int dim_B,
+                             obs_ptr obs1, obs_ptr obs2)
+    : AccumulatorBase(delta_N), m_dt(dt), m_n_lags(n_lags),
+      m_corr_operation(std::move(corr_operation)), m_dim_A(dim_A),
+      m_dim_B(dim_B), A_obs(std::move(obs1)), B_obs(std::move(obs2)) {
+  if (m_dt <= 0.) {
+    throw std::runtime_error("dt must be > 0");
+  }
+  if (m_n_lags < 1) {
+    throw std::runtime_error("the number of lag times must be >= 1");
+  }
+  if (m_dim_A < 1 or m_dim_B < 1) {
+    throw std::runtime_error("dimensions of A and B must be >= 1");
+  }
+  if (A_obs and not B_obs) {
+    B_obs = A_obs;
+  }
+  if ((A_obs and A_obs->n_values() != m_dim_A) or
+      (B_obs and B_obs->n_values() != m_dim_B)) {
+    throw std::runtime_error(
+        "dimensions of A and B do not match the observables");
+  }
+
+  if (m_corr_operation == "componentwise_product") {
+    m_operation = Operation::COMPONENTWISE_PRODUCT;
+    m_dim_corr = m_dim_A;
+  } else if (m_corr_operation == "tensor_product") {
+    m_operation = Operation::TENSOR_PRODUCT;
+    m_dim_corr = m_dim_A * m_dim_B;
+  } else if (m_corr_operation == "scalar_product") {
+    m_operation = Operation::SCALAR_PRODUCT;
+    m_dim_corr = 1;
+  } else if (m_corr_operation == "square_distance_componentwise") {
+    m_operation = Operation::SQUARE_DISTANCE_COMPONENTWISE;
+    m_dim_corr = m_dim_A;
+  } else {
+    throw std::runtime_error("correlation operation '" + m_corr_operation +
+                             "' is not supported by the FFT correlator");
+  }
+
+  if (m_operation != Operation::TENSOR_PRODUCT and m_dim_A != m_dim_B) {
+    throw std::runtime_error("dimension of B must match dimension of A");
+  }
+
+  m_A_previous.resize(m_n_lags * m_dim_A);
+  m_A_current.resize(m_n_lags * m_dim_A);
+  m_B_previous.resize(m_n_lags * m_dim_B);
+  m_B_current.resize(m_n_lags * m_dim_B);
+  m_sums.resize(m_n_lags * m_dim_corr);
+
+  /* The block and its predecessor have at most 2 n_lags frames,
+   * lags up to n_lags - 1 have to be free of aliasing. */
+  m_fft = Utils::FFT(Utils::next_pow2(3 * m_n_lags - 1));
+  m_buffer.resize(m_fft.size());
+}
+
+void FFTCorrelator::update() {
+  if (not A_obs) {
+    throw std::runtime_error("The FFT correlator has no observables.");
+  }
+
+  auto const A = A_obs->operator()();
+  if (A_obs != B_obs) {
+    auto const B = B_obs->operator()();
+    add_frame(A.data(), B.data());
+  } else {
+    add_frame(A.data(), A.data());
+  }
+}
+
+void FFTCorrelator::add_frames(std::vector<double> const &A,
+                               std::vector<double> const &B) {
+  auto const n_frames = A.size() / m_dim_A;
+  if (A.size() != n_frames * m_dim_A) {
+    throw std::runtime_error("size of A is not a multiple of its dimension");
+  }
+  if (B.empty() and m_dim_A != m_dim_B) {
+    throw std::runtime_error("B is required for a cross-correlation");
+  }
+  if (not B.empty() and B.size() != n_frames * m_dim_B) {
+    throw std::runtime_error("A and B must have the same number of frames");
+  }
+
+  auto const &B_frames = B.empty() ? A : B;
+  for (std::size_t i = 0; i < n_frames; i++) {
+    add_frame(A.data() + i * m_dim_A, B_frames.data() + i * m_dim_B);
+  }
+}
+
+void FFTCorrelator::add_frame(double const *A, double const *B) {
+  std::copy_n(A, m_dim_A, m_A_current.begin() + m_n_current * m_dim_A);
+  std::copy_n(B, m_dim_B, m_B_current.begin() + m_n_current * m_dim_B);
+  m_n_current++;
+  m_n_frames++;
+
+  if (m_n_current == m_n_lags) {
+    correlate_block(m_sums);
+    std::swap(m_A_previous, m_A_current);
+    std::swap(m_B_previous, m_B_current);
+    m_n_current = 0;
+    m_has_previous = true;
+  }
+}
+
+void FFTCorrelator::spectra(int a, int b, std::complex<double> *X,
+                            std::complex<double> *Y) const {
+  auto const n = static_cast<int>(m_fft.size());
+  auto const M = m_n_lags;
+
+  /* Pack A into the real and B into the imaginary part */
+  std::fill(m_buffer.begin(), m_buffer.end(), 0.);
+  if (a >= 0) {
+    if (m_has_previous) {
+      for (int t = 0; t < M; t++) {
+        m_buffer[t].real(m_A_previous[t * m_dim_A + a]);
+      }
+    }
+    for (int t = 0; t < m_n_current; t++) {
+      m_buffer[M + t].real(m_A_current[t * m_dim_A + a]);
+    }
+  }
+  if (b >= 0) {
+    for (int t = 0; t < m_n_current; t++) {
+      m_buffer[M + t].imag(m_B_current[t * m_dim_B + b]);
+    }
+  }
+
+  m_fft.forward(m_buffer.data());
+
+  /* Separate the spectra of the two real sequences */
+  for (int k = 0; k < n; k++) {
+    auto const z = m_buffer[k];
+    auto const z_conj = std::conj(m_buffer[(n - k) % n]);
+    X[k] = 0.5 * (z + z_conj);
+    Y[k] = std::complex<double>(0., -0.5) * (z - z_conj);
+  }
+}
+
+void FFTCorrelator::correlate(std::complex<double> const *X,
+                              std::complex<double> const *Y, double *sums,
+                              int stride) const {
+  auto const n = m_fft.size();
+  for (std::size_t k = 0; k < n; k++) {
+    m_buffer[k] = std::conj(X[k]) * Y[k];
+  }
+
+  m_fft.backward(m_buffer.data());
+
+  auto const norm = 1. / static_cast<double>(n);
+  for (int tau = 0; tau < m_n_lags; tau++) {
+    sums[tau * stride] += norm * m_buffer[tau].real();
+  }
+}
+
+void FFTCorrelator::correlate_block(std::vector<double> &sums) const {
+  auto const n = m_fft.size();
+  auto const M = m_n_lags;
+  auto const q = m_n_current;
+
+  if (m_operation == Operation::TENSOR_PRODUCT) {
+    auto const n_columns = std::max(m_dim_A, m_dim_B);
+    m_spectra_A.resize(n_columns * n);
+    m_spectra_B.resize(n_columns * n);
+    for (int i = 0; i < n_columns; i++) {
+      spectra((i < m_dim_A) ? i : -1, (i < m_dim_B) ? i : -1,
+              m_spectra_A.data() + i * n, m_spectra_B.data() + i * n);
+    }
+    for (int i = 0; i < m_dim_A; i++) {
+      for (int j = 0; j < m_dim_B; j++) {
+        correlate(m_spectra_A.data() + i * n, m_spectra_B.data() + j * n,
+                  sums.data() + i * m_dim_B + j, m_dim_corr);
+      }
+    }
+    return;
+  }
+
+  m_spectra_A.resize(n);
+  m_spectra_B.resize(n);
+  std::vector<double> correlation(M);
+  std::vector<double> A2(M + q + 1, 0.);
+  std::vector<double> B2(q + 1, 0.);
+  for (int k = 0; k < m_dim_A; k++) {
+    spectra(k, k, m_spectra_A.data(), m_spectra_B.data());
+
+    switch (m_operation) {
+    case Operation::COMPONENTWISE_PRODUCT:
+      correlate(m_spectra_A.data(), m_spectra_B.data(), sums.data() + k,
+                m_dim_corr);
+      break;
+    case Operation::SCALAR_PRODUCT:
+      correlate(m_spectra_A.data(), m_spectra_B.data(), sums.data(),
+                m_dim_corr);
+      break;
+    case Operation::SQUARE_DISTANCE_COMPONENTWISE: {
+      /* (A(t) - B(t + tau))^2 = A(t)^2 + B(t + tau)^2 - 2 A(t) B(t + tau),
+       * the squares are summed with prefix sums over the blocks. */
+      std::fill(correlation.begin(), correlation.end(), 0.);
+      correlate(m_spectra_A.data(), m_spectra_B.data(), correlation.data(), 1);
+
+      for (int t = 0; t < M + q; t++) {
+        auto const x = (t < M) ? (m_has_previous ? m_A_previous[t * m_dim_A + k]
+                                                 : 0.)
+                               : m_A_current[(t - M) * m_dim_A + k];
+        A2[t + 1] = A2[t] + x * x;
+      }
+      for (int j = 0; j < q; j++) {
+        auto const y = m_B_current[j * m_dim_B + k];
+        B2[j + 1] = B2[j] + y * y;
+      }
+
+      for (int tau = 0; tau < M; tau++) {
+        /* first frame of the block which has a partner at distance tau */
+        auto const j0 = m_has_previous ? 0 : std::min(tau, q);
+        auto const A_sum = A2[M + q - tau] - A2[M + j0 - tau];
+        auto const B_sum = B2[q] - B2[j0];
+        sums[tau * m_dim_corr + k] += A_sum + B_sum - 2. * correlation[tau];
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+}
+
+std::vector<double> FFTCorrelator::get_correlation() const {
+  auto sums = m_sums;
+  if (m_n_current > 0) {
+    correlate_block(sums);
+  }
+
+  int const cols = 2 + m_dim_corr;
+  std::vector<double> res(m_n_lags * cols);
+  for (int tau = 0; tau < m_n_lags; tau++) {
+    auto const n_pairs = std::max(0l, m_n_frames - tau);
+    res[cols * tau + 0] = tau * m_dt;
+    res[cols * tau + 1] = static_cast<double>(n_pairs);
+    for (int k = 0; k < m_dim_corr; k++) {
+      res[cols * tau + 2 + k] =
+          (n_pairs > 0) ? sums[tau * m_dim_corr + k] / n_pairs : 0.;
+    }
+  }
+
+  return res;
+}
+
+std::string FFTCorrelator::get_internal_state() const {
+  std::stringstream ss;
+  boost::archive::binary_oarchive oa(ss);
+
+  oa << m_n_frames;
+  oa << m_n_current;
+  oa << m_has_previous;
+  oa << m_A_previous;
+  oa << m_A_current;
+  oa << m_B_previous;
+  oa << m_B_current;
+  oa << m_sums;
+
+  return ss.str();
+}
+
+void FFTCorrelator::set_internal_state(std::string const &state) {
+  namespace iostreams = boost::iostreams;
+  iostreams::array_source src(state.data(), state.size());
+  iostreams::stream<iostreams::array_source> ss(src);
+  boost::archive::binary_iarchive ia(ss);
+
+  ia >> m_n_frames;
+  ia >> m_n_current;
+  ia >> m_has_previous;
+  ia >> m_A_previous;
+  ia >> m_A_current;
+  ia >> m_B_previous;
+  ia >> m_B_current;
+  ia >> m_sums;
+}
+} // namespace Accumulators
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ACCUMULATORS_FFT_CORRELATOR_HPP
+#define CORE_ACCUMULATORS_FFT_CORRELATOR_HPP
+
+#include "AccumulatorBase.hpp"
+#include "observables/Observable.hpp"
+
+#include <utils/math/fft.hpp>
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Accumulators {
+
+/**
+ * @brief Full resolution correlation of time series with FFT.
+ *
+ * Computes @f$ C(\tau) = \left< A(t) \otimes B(t + \tau) \right> @f$
+ * for all lag times @f$ \tau = 0, \ldots, (n_{\mathrm{lags}} - 1) \Delta t @f$
+ * via the Wiener-Khinchin theorem. The series is processed in blocks of
+ * @f$ n_{\mathrm{lags}} @f$ frames: when a block is complete, all pairs of
+ * frames @f$ (t, t + \tau) @f$ with @f$ t + \tau @f$ in the block are
+ * correlated with one FFT of the block and its predecessor. Only two
+ * blocks are kept in memory, which allows to correlate series that do
+ * not fit in memory at a cost of @f$ O(\log n_{\mathrm{lags}}) @f$ per
+ * frame and component, instead of @f$ O(n_{\mathrm{lags}}) @f$ for the
+ * direct evaluation.
+ *
+ * Frames can be taken from observables during the integration, like
+ * with @ref Correlator, or be added in batches, e.g. from a
+ * @ref TimeSeries or from a file.
+ *
+ * The supported operations are the linear ones of @ref Correlator:
+ * "componentwise_product", "tensor_product", "scalar_product" and
+ * "square_distance_componentwise".
+ */
+class FFTCorrelator : public AccumulatorBase {
+  using obs_ptr = std::shared_ptr<Observables::Observable>;
+
+public:
+  /**
+   * @param delta_N        Number of time steps between subsequent updates
+   * @param dt             Time between subsequent frames
+   * @param n_lags         Number of lag times, including zero
+   * @param corr_operation How to correlate A and B
+   * @param dim_A          Number of components of A
+   * @param dim_B          Number of components of B
+   * @param obs1           Observable A for the updates, optional
+   * @param obs2           Observable B for the updates, optional
+   */
+  FFTCorrelator(int delta_N, double dt, int n_lags, std::string corr_operation,
+                int dim_A, int dim_B, obs_ptr obs1 = {}, obs_ptr obs2 = {});
+
+  /** Add the current values of the observables. */
+  void update() override;
+
+  /** @brief Add frames of A and B.
+   *
+   *  @param A Frames of A, (n_frames x dim_A) in row-major order
+   *  @param B Frames of B, (n_frames x dim_B) in row-major order,
+   *           or empty to correlate A with itself
+   */
+  void add_frames(std::vector<double> const &A, std::vector<double> const &B);
+
+  /** @brief Correlation of all frames added so far.
+   *
+   *  Same layout as @ref Correlator::get_correlation: for every lag time
+   *  the lag time, the number of pairs of frames and the components of
+   *  the correlation.
+   */
+  std::vector<double> get_correlation() const;
+
+  int n_lags() const { return m_n_lags; }
+  int dim_corr() const { return m_dim_corr; }
+  double dt() const { return m_dt; }
+  long n_frames() const { return m_n_frames; }
+  std::string const &correlation_operation() const {
+    return m_corr_operation;
+  }
+
+  std::string get_internal_state() const;
+  void set_internal_state(std::string const &);
+
+private:
+  enum class Operation {
+    COMPONENTWISE_PRODUCT,
+    TENSOR_PRODUCT,
+    SCALAR_PRODUCT,
+    SQUARE_DISTANCE_COMPONENTWISE
+  };
+
+  void add_frame(double const *A, double const *B);
+  /** Add the correlations of all pairs of frames ending in the
+   *  current block to @p sums.
+   */
+  void correlate_block(std::vector<double> &sums) const;
+  /** @brief Spectra of a column of A and a column of B.
+   *
+   *  A is taken from the previous and the current block, B only from the
+   *  current block, both are zero padded to the length of the FFT.
+   *
+   *  @param a          Column of A, or -1 for none
+   *  @param b          Column of B, or -1 for none
+   *  @param[out] X     Spectrum of A
+   *  @param[out] Y     Spectrum of B
+   */
+  void spectra(int a, int b, std::complex<double> *X,
+               std::complex<double> *Y) const;
+  /** Add the correlation of two spectra for all lag times to
+   *  @p sums, with a stride of @p stride.
+   */
+  void correlate(std::complex<double> const *X, std::complex<double> const *Y,
+                 double *sums, int stride) const;
+
+  double m_dt;
+  int m_n_lags;
+  std::string m_corr_operation;
+  Operation m_operation;
+  int m_dim_A;
+  int m_dim_B;
+  int m_dim_corr;
+  obs_ptr A_obs;
+  obs_ptr B_obs;
+
+  long m_n_frames = 0;   ///< number of frames added so far
+  int m_n_current = 0;   ///< number of frames in the current block
+  bool m_has_previous = false;
+  /// previous and current block of A, (n_lags x dim_A)
+  std::vector<double> m_A_previous, m_A_current;
+  /// previous and current block of B, (n_lags x dim_B)
+  std::vector<double> m_B_previous, m_B_current;
+  /// sums over the completed blocks, (n_lags x dim_corr)
+  std::vector<double> m_sums;
+
+  Utils::FFT m_fft;
+  mutable std::vector<std::complex<double>> m_buffer;
+  /// spectra of all columns of A and B of the current block
+  mutable std::vector<std::complex<double>> m_spectra_A, m_spectra_B;
+};
+
+} // namespace Accumulators
+
+#endif
@@ -44,9 +44,12 @@
 
 #include <boost/iterator/indirect_iterator.hpp>
 #include <boost/range/adaptor/uniqued.hpp>
+#include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/algorithm/sort.hpp>
 
+#include <algorithm>
 #include <cstdio>
+#include <functional>
 
 /** list of all cells. */
 std::vector<Cell> cells;
@@ -128,6 +131,68 @@ std::vector<std::pair<int, int>> mpi_get_pairs(double distance) {
   return pairs;
 }
 
+namespace {
+int count_particles_within_distance(
+    std::vector<Utils::Vector3d> const &positions,
+    std::vector<int> const &ignored_ids, double distance) {
+  cells_update_ghosts(GHOSTTRANS_POSITION | GHOSTTRANS_PROPRTS);
+
+  auto const distance2 = distance * distance;
+  auto const is_ignored = [&ignored_ids](Particle const &p) {
+    return std::find(ignored_ids.begin(), ignored_ids.end(), p.identity()) !=
+           ignored_ids.end();
+  };
+
+  int count = 0;
+  if (cell_structure.type == CELL_STRUCTURE_DOMDEC and
+      distance <= cells_neighbor_range()) {
+    /* The node owning a position finds all particles within the
+     * distance in the neighbor cells, including the ghosts. */
+    for (auto const &pos : positions) {
+      Particle probe;
+      probe.r.p = folded_position(pos, box_geo);
+      auto const cell = cell_structure.particle_to_cell(probe);
+      if (cell == nullptr)
+        continue;
+      for (auto const neighbor : cell->m_neighbors.all()) {
+        for (auto const &p : neighbor->particles()) {
+          if ((p.r.p - probe.r.p).norm2() < distance2 and not is_ignored(p))
+            count++;
+        }
+      }
+    }
+  } else {
+    for (auto const &p : cell_structure.local_cells().particles()) {
+      if (is_ignored(p))
+        continue;
+      for (auto const &pos : positions) {
+        if (get_mi_vector(p.r.p, pos, box_geo).norm2() < distance2)
+          count++;
+      }
+    }
+  }
+
+  return count;
+}
+
+int mpi_particles_within_distance_slave(std::vector<Utils::Vector3d> positions,
+                                        std::vector<int> ignored_ids,
+                                        double distance) {
+  return count_particles_within_distance(positions, ignored_ids, distance);
+}
+} // namespace
+
+REGISTER_CALLBACK_REDUCTION(mpi_particles_within_distance_slave,
+                            std::plus<int>())
+
+bool mpi_particles_within_distance(
+    std::vector<Utils::Vector3d> const &positions,
+    std::vector<int> const &ignored_ids, double distance) {
+  return mpi_call(Communication::Result::reduction, std::plus<int>(),
+                  mpi_particles_within_distance_slave, positions, ignored_ids,
+                  distance) > 0;
+}
+
 /************************************************************/
 /** \name Private Functions */
 /************************************************************/
@@ -268,6 +333,12 @@ int cells_get_n_particles() {
       0, [](int n, const Cell *c) { return n + c->particles().size(); });
 }
 
+double cells_neighbor_range() {
+  auto const range = *boost::min_element(cell_structure.max_range);
+  return (cell_structure.type == CELL_STRUCTURE_DOMDEC) ? range - skin
+                                                        : range;
+}
+
 /*************************************************/
 
 namespace {
@@ -40,6 +40,8 @@
 
 #include "CellStructure.hpp"
 
+#include <utils/Vector.hpp>
+
 #include <utility>
 #include <vector>
 
@@ -133,6 +135,17 @@ void cells_update_ghosts(unsigned data_parts);
 /** Calculate and return the total number of particles on this node. */
 int cells_get_n_particles();
 
+/** @brief Distance up to which the neighbor cells contain all pairs.
+ *
+ *  With the domain decomposition, the particles are only resorted after
+ *  they moved more than half the skin, so they can be outside of the cell
+ *  they are stored in. Only pairs closer than the cell size minus the
+ *  skin are guaranteed to be stored in neighboring cells. With the
+ *  N-square cell system, this is the range of the minimum image
+ *  convention.
+ */
+double cells_neighbor_range();
+
 /**
  * @brief Get pairs closer than @p distance from the cells.
  *
@@ -140,6 +153,24 @@ int cells_get_n_particles();
  */
 std::vector<std::pair<int, int>> mpi_get_pairs(double distance);
 
+/**
+ * @brief Check whether particles are closer to positions than a distance.
+ *
+ * With the domain decomposition only the neighbor cells of the positions
+ * are searched, if the distance is not larger than
+ * @ref cells_neighbor_range.
+ * Otherwise every node searches its local particles.
+ *
+ * @param positions   Positions to check
+ * @param ignored_ids Particles which are not considered
+ * @param distance    Distance
+ * @return Whether a particle which is not ignored is closer than
+ *         @p distance to one of the positions.
+ */
+bool mpi_particles_within_distance(
+    std::vector<Utils::Vector3d> const &positions,
+    std::vector<int> const &ignored_ids, double distance);
+
 /** Check if a particle resorting is required. */
 void check_resort_particles();
 
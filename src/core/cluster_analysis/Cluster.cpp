@@ -34,6 +34,8 @@ namespace ClusterAnalysis {
 
 // Center of mass of an aggregate
 Utils::Vector3d Cluster::center_of_mass() {
+  if (statistics)
+    return statistics->center_of_mass;
   return center_of_mass_subcluster(particles);
 }
 
@@ -92,6 +94,8 @@ double Cluster::longest_distance() {
 
 // Radius of gyration
 double Cluster::radius_of_gyration() {
+  if (statistics)
+    return statistics->radius_of_gyration;
   return radius_of_gyration_subcluster(particles);
 }
 
@@ -26,6 +26,10 @@
 #include <vector>
 
 #include "Particle.hpp"
+#include "find_clusters.hpp"
+
+#include <boost/optional.hpp>
+
 #include <tuple>
 
 namespace ClusterAnalysis {
@@ -35,6 +39,8 @@ class Cluster {
 public:
   /** @brief Ids of the particles in the cluster */
   std::vector<int> particles;
+  /** @brief Properties computed during the parallel analysis, if any */
+  boost::optional<ClusterStatistics> statistics;
   /** @brief add a particle to the cluster */
   void add_particle(const Particle &p) { particles.push_back(p.p.identity); }
   /** @brief Calculate the center of mass of the cluster */
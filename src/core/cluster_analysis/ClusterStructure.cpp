@@ -25,8 +25,34 @@
 #include <stdexcept>
 #include <utils/for_each_pair.hpp>
 
+#include <boost/optional.hpp>
+
 namespace ClusterAnalysis {
 
+namespace {
+/** Description of a pair criterion for the parallel analysis, if it is one
+ *  of the known criteria */
+boost::optional<ClusterCriterion>
+cluster_criterion(PairCriteria::PairCriterion const &pc) {
+  ClusterCriterion criterion;
+  if (auto const c = dynamic_cast<PairCriteria::DistanceCriterion const *>(&pc)) {
+    criterion.type = ClusterCriterion::DISTANCE;
+    criterion.cut_off = c->get_cut_off();
+  } else if (auto const c =
+                 dynamic_cast<PairCriteria::EnergyCriterion const *>(&pc)) {
+    criterion.type = ClusterCriterion::ENERGY;
+    criterion.cut_off = c->get_cut_off();
+  } else if (auto const c =
+                 dynamic_cast<PairCriteria::BondCriterion const *>(&pc)) {
+    criterion.type = ClusterCriterion::BOND;
+    criterion.bond_type = c->get_bond_type();
+  } else {
+    return {};
+  }
+  return criterion;
+}
+} // namespace
+
 ClusterStructure::ClusterStructure() { clear(); }
 
 void ClusterStructure::clear() {
@@ -44,6 +70,16 @@ void ClusterStructure::run_for_all_pairs() {
   // clear data structs
   clear();
 
+  if (!m_pair_criterion) {
+    runtimeErrorMsg() << "No cluster criterion defined";
+    return;
+  }
+  auto const criterion = cluster_criterion(*m_pair_criterion);
+  if (criterion and cell_system_supports(*criterion, false)) {
+    run_in_parallel(*criterion, false);
+    return;
+  }
+
   // Iterate over pairs
   Utils::for_each_pair(partCfg().begin(), partCfg().end(),
                        [this](const Particle &p1, const Particle &p2) {
@@ -54,6 +90,17 @@ void ClusterStructure::run_for_all_pairs() {
 
 void ClusterStructure::run_for_bonded_particles() {
   clear();
+
+  if (!m_pair_criterion) {
+    runtimeErrorMsg() << "No cluster criterion defined";
+    return;
+  }
+  auto const criterion = cluster_criterion(*m_pair_criterion);
+  if (criterion and cell_system_supports(*criterion, true)) {
+    run_in_parallel(*criterion, true);
+    return;
+  }
+
   for (const auto &p : partCfg()) {
     int j = 0;
     while (j < p.bl.n) {
@@ -71,6 +118,22 @@ void ClusterStructure::run_for_bonded_particles() {
   merge_clusters();
 }
 
+void ClusterStructure::run_in_parallel(ClusterCriterion const &criterion,
+                                       bool bonded_only) {
+  auto const result = mpi_find_clusters(criterion, bonded_only);
+
+  // Particle ids are sorted, so are the particles of the clusters
+  for (auto const &it : result.cluster_ids) {
+    cluster_id[it.first] = it.second;
+    auto &cluster = clusters[it.second];
+    if (!cluster) {
+      cluster = std::make_shared<Cluster>();
+      cluster->statistics = result.statistics.at(it.second);
+    }
+    cluster->particles.push_back(it.first);
+  }
+}
+
 void ClusterStructure::add_pair(const Particle &p1, const Particle &p2) {
   // * check, if there's a neighbor
   //   * No: Then go on to the next particle
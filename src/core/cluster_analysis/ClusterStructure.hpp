@@ -27,6 +27,7 @@
 
 #include "Cluster.hpp"
 #include "Particle.hpp"
+#include "find_clusters.hpp"
 #include "pair_criteria/pair_criteria.hpp"
 
 namespace ClusterAnalysis {
@@ -42,7 +43,12 @@ public:
   std::map<int, int> cluster_id;
   /** @brief Clear data structures */
   void clear();
-  /** @brief Run cluster analysis, consider all particle pairs */
+  /** @brief Run cluster analysis, consider all particle pairs.
+   *
+   *  If the pair criterion vanishes beyond the range of the cell system,
+   *  the analysis runs in parallel with @ref mpi_find_clusters, otherwise
+   *  all pairs of particles are checked on the head node.
+   */
   void run_for_all_pairs();
   /** @brief Run cluster analysis, consider pairs of particles connected by a
    * bonded interaction */
@@ -69,6 +75,8 @@ private:
   /** @brief pair criterion which decides whether two particles are neighbors */
   std::shared_ptr<PairCriteria::PairCriterion> m_pair_criterion;
 
+  /** @brief Run the parallel cluster analysis and store its result */
+  void run_in_parallel(ClusterCriterion const &criterion, bool bonded_only);
   /** @brief Consider an individual pair of particles during cluster analysis */
   void add_pair(const Particle &p1, const Particle &p2);
   /** Merge clusters and populate their structures */
@@ -0,0 +1,401 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "find_clusters.hpp"
+
+#include "algorithm/link_cell.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "errorhandling.hpp"
+#include "grid.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "pair_criteria/pair_criteria.hpp"
+
+#include <utils/NoOp.hpp>
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/iterator/indirect_iterator.hpp>
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/collectives/gather.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace ClusterAnalysis {
+namespace {
+/** Union-find on particle ids, the root of a set is its smallest id. */
+class UnionFind {
+public:
+  bool contains(int id) const { return m_parent.count(id) != 0; }
+
+  /** Add an id as a set of its own, if it is not contained yet. */
+  void insert(int id) { m_parent.emplace(id, id); }
+
+  /** Root of a contained id, with path halving. */
+  int find(int id) {
+    while (true) {
+      auto &parent = m_parent.at(id);
+      if (parent == id)
+        return id;
+      parent = m_parent.at(parent);
+      id = parent;
+    }
+  }
+
+  void unite(int a, int b) {
+    insert(a);
+    insert(b);
+    a = find(a);
+    b = find(b);
+    if (a < b)
+      m_parent[b] = a;
+    else if (b < a)
+      m_parent[a] = b;
+  }
+
+private:
+  std::unordered_map<int, int> m_parent;
+};
+
+/** Sums over the particles of a cluster on one node. */
+struct PartialSums {
+  int label = 0;
+  int min_id = 0;
+  int size = 0;
+  double mass = 0.;
+  /** Sum of the mass weighted distances to the reference */
+  Utils::Vector3d weighted_sum = {};
+  /** Sum of the distances to the reference */
+  Utils::Vector3d sum = {};
+  /** Sum of the square distances to the reference */
+  double square_sum = 0.;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &label &min_id &size &mass &weighted_sum &sum &square_sum;
+  }
+};
+
+std::unique_ptr<PairCriteria::PairCriterion>
+make_pair_criterion(ClusterCriterion const &criterion) {
+  switch (criterion.type) {
+  case ClusterCriterion::DISTANCE: {
+    auto pc = std::make_unique<PairCriteria::DistanceCriterion>();
+    pc->set_cut_off(criterion.cut_off);
+    return pc;
+  }
+  case ClusterCriterion::ENERGY: {
+    auto pc = std::make_unique<PairCriteria::EnergyCriterion>();
+    pc->set_cut_off(criterion.cut_off);
+    return pc;
+  }
+  case ClusterCriterion::BOND: {
+    auto pc = std::make_unique<PairCriteria::BondCriterion>();
+    pc->set_bond_type(criterion.bond_type);
+    return pc;
+  }
+  }
+  return {};
+}
+
+/** @brief Call @p add_pair for all pairs of a local particle and a local
+ *  or ghost particle which are neighbors.
+ */
+template <class Kernel>
+void for_each_cluster_pair(ClusterCriterion const &criterion,
+                           bool bonded_only, Kernel &&add_pair) {
+  auto const pair_criterion = make_pair_criterion(criterion);
+
+  if (bonded_only or criterion.type == ClusterCriterion::BOND) {
+    for (auto &p : cell_structure.local_cells().particles()) {
+      int i = 0;
+      while (i < p.bl.n) {
+        auto const bond_type = p.bl.e[i];
+        auto const n_partners = bonded_ia_params[bond_type].num;
+        auto const considered = bonded_only
+                                    ? (n_partners == 1)
+                                    : (n_partners >= 1 and
+                                       bond_type == criterion.bond_type);
+        if (considered) {
+          auto const partner = cell_structure.get_local_particle(p.bl.e[i + 1]);
+          if (partner == nullptr) {
+            runtimeErrorMsg() << "cluster analysis: bond partner "
+                              << p.bl.e[i + 1] << " of particle "
+                              << p.identity() << " not found";
+          } else if ((criterion.type == ClusterCriterion::BOND)
+                         ? (bond_type == criterion.bond_type)
+                         : pair_criterion->decide(p, *partner)) {
+            add_pair(p, *partner);
+          }
+        }
+        i += 1 + n_partners;
+      }
+    }
+    return;
+  }
+
+  /* The criterion decides, the distance is not needed. */
+  Algorithm::link_cell(
+      boost::make_indirect_iterator(cell_structure.m_local_cells.begin()),
+      boost::make_indirect_iterator(cell_structure.m_local_cells.end()),
+      Utils::NoOp{},
+      [&pair_criterion, &add_pair](Particle const &p1, Particle const &p2,
+                                   double) {
+        if (pair_criterion->decide(p1, p2))
+          add_pair(p1, p2);
+      },
+      [](Particle const &, Particle const &) { return 0.; });
+}
+
+/** @brief Cluster analysis on all nodes.
+ *
+ *  @return The clusters on the head node, empty on the other nodes.
+ */
+ClusterResult find_clusters(ClusterCriterion const &criterion,
+                            bool bonded_only) {
+  auto const is_head_node = (comm_cart.rank() == 0);
+  cells_update_ghosts(GHOSTTRANS_POSITION | GHOSTTRANS_PROPRTS);
+
+  /* Local clusters, including the ghosts next to the domain. */
+  UnionFind local;
+  std::vector<int> ghost_ids;
+  for_each_cluster_pair(
+      criterion, bonded_only,
+      [&local, &ghost_ids](Particle const &p1, Particle const &p2) {
+        local.unite(p1.identity(), p2.identity());
+        if (p1.l.ghost)
+          ghost_ids.push_back(p1.identity());
+        if (p2.l.ghost)
+          ghost_ids.push_back(p2.identity());
+      });
+  std::sort(ghost_ids.begin(), ghost_ids.end());
+  ghost_ids.erase(std::unique(ghost_ids.begin(), ghost_ids.end()),
+                  ghost_ids.end());
+
+  /* Join the clusters across domain boundaries: a ghost belongs to the same
+   * cluster as its local root, and is the local particle of another node.
+   * Only the boundary particles are sent to the head node. */
+  std::vector<std::pair<int, int>> boundary;
+  for (auto const id : ghost_ids) {
+    boundary.emplace_back(id, local.find(id));
+  }
+  Utils::Mpi::gather_buffer(boundary, comm_cart);
+
+  std::vector<std::pair<int, int>> boundary_labels;
+  if (is_head_node) {
+    UnionFind global;
+    for (auto const &edge : boundary) {
+      global.unite(edge.first, edge.second);
+    }
+    for (auto const &edge : boundary) {
+      boundary_labels.emplace_back(edge.first, global.find(edge.first));
+      boundary_labels.emplace_back(edge.second, global.find(edge.second));
+    }
+  }
+  boost::mpi::broadcast(comm_cart, boundary_labels, 0);
+
+  /* The pairs of a local particle and a ghost are only found on one of the
+   * two nodes, the owner of the ghost may not have any pair with it. */
+  for (auto const &label : boundary_labels) {
+    auto const p = cell_structure.get_local_particle(label.first);
+    if (p and not p->l.ghost)
+      local.insert(label.first);
+  }
+
+  /* Clusters without boundary particles keep their local root. */
+  std::unordered_map<int, int> root_labels;
+  for (auto const &label : boundary_labels) {
+    if (local.contains(label.first))
+      root_labels[local.find(label.first)] = label.second;
+  }
+  auto const label_of = [&local, &root_labels](int id) {
+    auto const root = local.find(id);
+    auto const it = root_labels.find(root);
+    return (it == root_labels.end()) ? root : it->second;
+  };
+
+  std::vector<std::pair<int, int>> local_labels;
+  for (auto const &p : cell_structure.local_cells().particles()) {
+    if (local.contains(p.identity()))
+      local_labels.emplace_back(p.identity(), label_of(p.identity()));
+  }
+
+  /* Reference positions: one particle per cluster, so that the distances
+   * within the clusters can be taken with the minimum image convention. */
+  std::unordered_map<int, Utils::Vector3d> references;
+  {
+    std::vector<std::pair<int, Utils::Vector3d>> candidates;
+    std::unordered_set<int> seen;
+    for (auto const &p : cell_structure.local_cells().particles()) {
+      if (not local.contains(p.identity()))
+        continue;
+      auto const label = label_of(p.identity());
+      if (seen.insert(label).second)
+        candidates.emplace_back(label, folded_position(p.r.p, box_geo));
+    }
+
+    std::vector<std::pair<int, Utils::Vector3d>> all_references;
+    if (is_head_node) {
+      std::vector<std::vector<std::pair<int, Utils::Vector3d>>> all_candidates;
+      boost::mpi::gather(comm_cart, candidates, all_candidates, 0);
+      for (auto const &node_candidates : all_candidates) {
+        for (auto const &candidate : node_candidates) {
+          if (references.insert(candidate).second)
+            all_references.push_back(candidate);
+        }
+      }
+    } else {
+      boost::mpi::gather(comm_cart, candidates, 0);
+    }
+    boost::mpi::broadcast(comm_cart, all_references, 0);
+    references.insert(all_references.begin(), all_references.end());
+  }
+
+  /* Sums over the local particles of the clusters */
+  std::unordered_map<int, PartialSums> sums;
+  for (auto const &p : cell_structure.local_cells().particles()) {
+    if (not local.contains(p.identity()))
+      continue;
+    auto const label = label_of(p.identity());
+    auto const d = get_mi_vector(p.r.p, references.at(label), box_geo);
+    auto it = sums.find(label);
+    if (it == sums.end()) {
+      it = sums.emplace(label, PartialSums{}).first;
+      it->second.label = label;
+      it->second.min_id = p.identity();
+    }
+    auto &s = it->second;
+    s.min_id = std::min(s.min_id, p.identity());
+    s.size++;
+    s.mass += p.p.mass;
+    s.weighted_sum += p.p.mass * d;
+    s.sum += d;
+    s.square_sum += d.norm2();
+  }
+  std::vector<PartialSums> local_sums;
+  for (auto const &s : sums) {
+    local_sums.push_back(s.second);
+  }
+
+  Utils::Mpi::gather_buffer(local_labels, comm_cart);
+  if (not is_head_node) {
+    boost::mpi::gather(comm_cart, local_sums, 0);
+    return {};
+  }
+
+  std::vector<std::vector<PartialSums>> all_sums;
+  boost::mpi::gather(comm_cart, local_sums, all_sums, 0);
+  std::map<int, PartialSums> totals;
+  for (auto const &node_sums : all_sums) {
+    for (auto const &s : node_sums) {
+      auto it = totals.find(s.label);
+      if (it == totals.end()) {
+        totals.emplace(s.label, s);
+        continue;
+      }
+      auto &t = it->second;
+      t.min_id = std::min(t.min_id, s.min_id);
+      t.size += s.size;
+      t.mass += s.mass;
+      t.weighted_sum += s.weighted_sum;
+      t.sum += s.sum;
+      t.square_sum += s.square_sum;
+    }
+  }
+
+  /* Number the clusters by their smallest particle id */
+  std::vector<std::pair<int, int>> order;
+  for (auto const &t : totals) {
+    order.emplace_back(t.second.min_id, t.first);
+  }
+  std::sort(order.begin(), order.end());
+
+  ClusterResult result;
+  std::unordered_map<int, int> cluster_id_of_label;
+  for (std::size_t i = 0; i < order.size(); i++) {
+    auto const cid = static_cast<int>(i + 1);
+    auto const &t = totals.at(order[i].second);
+    cluster_id_of_label[order[i].second] = cid;
+
+    auto const com = t.weighted_sum / t.mass;
+    ClusterStatistics stats;
+    stats.size = t.size;
+    stats.mass = t.mass;
+    stats.center_of_mass = references.at(order[i].second) + com;
+    for (int j = 0; j < 3; j++) {
+      stats.center_of_mass[j] =
+          std::fmod(stats.center_of_mass[j], box_geo.length()[j]);
+    }
+    auto const rg2 = t.square_sum / t.size - 2. * (com * t.sum) / t.size +
+                     com.norm2();
+    stats.radius_of_gyration = std::sqrt(std::max(rg2, 0.));
+    result.statistics[cid] = stats;
+  }
+
+  result.cluster_ids.reserve(local_labels.size());
+  for (auto const &label : local_labels) {
+    result.cluster_ids.emplace_back(label.first,
+                                    cluster_id_of_label.at(label.second));
+  }
+  std::sort(result.cluster_ids.begin(), result.cluster_ids.end());
+
+  return result;
+}
+} // namespace
+} // namespace ClusterAnalysis
+
+namespace {
+void mpi_find_clusters_slave(ClusterAnalysis::ClusterCriterion const &criterion,
+                             bool bonded_only) {
+  ClusterAnalysis::find_clusters(criterion, bonded_only);
+}
+} // namespace
+
+REGISTER_CALLBACK(mpi_find_clusters_slave)
+
+namespace ClusterAnalysis {
+bool cell_system_supports(ClusterCriterion const &criterion,
+                          bool bonded_only) {
+  if (bonded_only or criterion.type == ClusterCriterion::BOND)
+    return true;
+
+  /* Energies vanish beyond the cutoffs, which is only a neighbor
+   * criterion if the threshold is positive. */
+  if (criterion.type == ClusterCriterion::ENERGY and criterion.cut_off <= 0.)
+    return false;
+
+  if (cell_structure.type != CELL_STRUCTURE_DOMDEC)
+    return true;
+
+  auto const range = (criterion.type == ClusterCriterion::DISTANCE)
+                         ? criterion.cut_off
+                         : maximal_cutoff_nonbonded();
+  return range <= cells_neighbor_range();
+}
+
+ClusterResult mpi_find_clusters(ClusterCriterion const &criterion,
+                                bool bonded_only) {
+  mpi_call(mpi_find_clusters_slave, criterion, bonded_only);
+  return find_clusters(criterion, bonded_only);
+}
+} // namespace ClusterAnalysis
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CLUSTER_ANALYSIS_FIND_CLUSTERS_HPP
+#define CLUSTER_ANALYSIS_FIND_CLUSTERS_HPP
+
+#include <utils/Vector.hpp>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ClusterAnalysis {
+
+/** @brief Pair criterion of the parallel cluster analysis.
+ *
+ *  Plain description of one of the criteria in
+ *  @ref pair_criteria/pair_criteria.hpp, which can be sent to all nodes.
+ */
+struct ClusterCriterion {
+  enum Type : int { DISTANCE, ENERGY, BOND };
+  Type type = DISTANCE;
+  double cut_off = 0.;
+  int bond_type = -1;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &type &cut_off &bond_type;
+  }
+};
+
+/** @brief Properties of a cluster, computed on the nodes owning
+ *  the particles.
+ */
+struct ClusterStatistics {
+  int size = 0;
+  double mass = 0.;
+  Utils::Vector3d center_of_mass = {};
+  double radius_of_gyration = 0.;
+};
+
+/** @brief Result of @ref mpi_find_clusters. */
+struct ClusterResult {
+  /** Pairs of particle id and cluster id, for all particles
+   *  in a cluster, sorted by particle id */
+  std::vector<std::pair<int, int>> cluster_ids;
+  /** Statistics of the clusters by cluster id */
+  std::map<int, ClusterStatistics> statistics;
+};
+
+/** @brief Check if a criterion can be evaluated with the cell system.
+ *
+ *  All pairs fulfilling the criterion have to be found in the neighbor
+ *  cells, i.e. the criterion has to be false beyond
+ *  @ref cells_neighbor_range. Pairs of bonded particles are always found.
+ *
+ *  @param criterion   Pair criterion
+ *  @param bonded_only Consider only pairs of bonded particles
+ */
+bool cell_system_supports(ClusterCriterion const &criterion, bool bonded_only);
+
+/** @brief Parallel cluster analysis.
+ *
+ *  Every node finds the pairs of its particles with the cell system and
+ *  the ghosts, and merges them into clusters with a local union-find.
+ *  Clusters reaching into the ghost layer are joined on the head node,
+ *  which only has to handle the particles at the domain boundaries.
+ *  The cluster properties are summed up on the nodes owning the
+ *  particles, relative to a reference particle of each cluster, so that
+ *  no particle data has to be gathered. Cluster ids are numbered from 1,
+ *  in the order of the smallest particle id of each cluster.
+ *
+ *  Has to be called on the head node only.
+ *
+ *  @param criterion   Pair criterion
+ *  @param bonded_only Consider only pairs of particles connected by a
+ *                     pair bond
+ *  @return The clusters, only valid on the head node.
+ */
+ClusterResult mpi_find_clusters(ClusterCriterion const &criterion,
+                                bool bonded_only);
+
+} // namespace ClusterAnalysis
+
+#endif
@@ -26,22 +26,29 @@
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "grid.hpp"
+#include "integrate.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "virtual_sites/VirtualSitesRelative.hpp"
 
-#include <utils/mpi/all_compare.hpp>
-#include <utils/mpi/gather_buffer.hpp>
+#include <utils/mpi/cart_comm.hpp>
 
 #include <boost/algorithm/clamp.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/nonblocking.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/vector.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <numeric>
 #include <vector>
 
 /// Data type holding the info about a single collision
 typedef struct {
-  int pp1; // 1st particle id
-  int pp2; // 2nd particle id
+  int pp1;   // 1st particle id
+  int pp2;   // 2nd particle id
+  int vs_id; // id of the 1st virtual site, the 2nd one has vs_id + 1
 } collision_struct;
 
 namespace boost {
@@ -50,6 +57,7 @@ template <typename Archive>
 void serialize(Archive &ar, collision_struct &c, const unsigned int) {
   ar &c.pp1;
   ar &c.pp2;
+  ar &c.vs_id;
 }
 } // namespace serialization
 } // namespace boost
@@ -73,6 +81,47 @@ Particle &get_part(int id) {
 
   return *p;
 }
+
+/** @brief Ids of the virtual sites created on collision.
+ *
+ *  Every node takes the ids from its own blocks, so that the nodes do
+ *  not have to agree on the ids of the new particles during the
+ *  integration. The blocks of all nodes are interleaved above the
+ *  largest particle id at the start of the integration: block @c k of
+ *  node @c i starts at <tt>first_id + (k * n_nodes + i) * block_size</tt>.
+ *  On a single node the ids are consecutive.
+ */
+class ParticleIdBlocks {
+public:
+  static constexpr int block_size = 64;
+
+  void reset(int first_id) {
+    m_first_id = first_id;
+    m_next = m_end = 0;
+    m_n_blocks = 0;
+  }
+
+  /** @brief Take @p n consecutive ids and return the first one. */
+  int take(int n) {
+    assert(n <= block_size);
+    if (m_end - m_next < n) {
+      m_next = m_first_id + (m_n_blocks * n_nodes + this_node) * block_size;
+      m_end = m_next + block_size;
+      m_n_blocks++;
+    }
+    auto const id = m_next;
+    m_next += n;
+    return id;
+  }
+
+private:
+  int m_first_id = 0;
+  int m_next = 0;
+  int m_end = 0;
+  int m_n_blocks = 0;
+};
+
+ParticleIdBlocks vs_ids;
 } // namespace
 
 /** @brief Return true if a bond between the centers of the colliding particles
@@ -248,7 +297,17 @@ bool validate_collision_parameters() {
 void prepare_local_collision_queue() { local_collision_queue.clear(); }
 
 void queue_collision(const int part1, const int part2) {
-  local_collision_queue.push_back({part1, part2});
+  local_collision_queue.push_back({part1, part2, -1});
+}
+
+void collision_detection_on_integration_start() {
+  if (collision_params.mode &
+      (COLLISION_MODE_VS | COLLISION_MODE_GLUE_TO_SURF)) {
+    auto const max_id = boost::mpi::all_reduce(
+        comm_cart, cell_structure.get_max_local_particle_id(),
+        boost::mpi::maximum<int>());
+    vs_ids.reset(max_id + 1);
+  }
 }
 
 /** @brief Calculate position of vs for GLUE_TO_SURFACE mode
@@ -364,64 +423,221 @@ void coldet_do_three_particle_bond(Particle &p, Particle &p1, Particle &p2) {
 }
 
 #ifdef VIRTUAL_SITES_RELATIVE
-void place_vs_and_relate_to_particle(const int current_vs_pid,
+/** @brief Create a virtual site related to a particle.
+ *
+ *  The virtual site is only added to the cell system after all collisions
+ *  have been handled, so that the particle storage does not change while
+ *  pointers to the colliding particles are in use.
+ */
+Particle make_vs_related_to_particle(const int vs_id,
                                      const Utils::Vector3d &pos,
-                                     int relate_to) {
+                                     Particle const &relate_to) {
   Particle new_part;
-  new_part.p.identity = current_vs_pid;
+  new_part.p.identity = vs_id;
   new_part.r.p = pos;
-  auto p_vs = cell_structure.add_particle(std::move(new_part));
+  local_vs_relate_to(new_part, relate_to);
+  new_part.p.is_virtual = true;
+  new_part.p.type = collision_params.vs_particle_type;
 
-  local_vs_relate_to(*p_vs, get_part(relate_to));
-
-  p_vs->p.is_virtual = true;
-  p_vs->p.type = collision_params.vs_particle_type;
+  return new_part;
 }
 
-void bind_at_poc_create_bond_between_vs(const int current_vs_pid,
-                                        const collision_struct &c) {
+/** @brief Add the bond between the virtual sites of a collision.
+ *
+ *  @param vs    Virtual site to add the bond to
+ *  @param c     The collision
+ *  @param first Whether @p vs belongs to the 1st particle of the collision
+ */
+void bind_at_poc_create_bond_between_vs(Particle &vs, const collision_struct &c,
+                                        bool first) {
   switch (bonded_ia_params[collision_params.bond_vs].num) {
   case 1: {
-    // Create bond between the virtual particles
-    const int bondG[] = {collision_params.bond_vs, current_vs_pid - 2};
-    // Only add bond if vs was created on this node
-    if (cell_structure.get_local_particle(current_vs_pid - 1))
-      add_bond(get_part(current_vs_pid - 1), bondG);
+    // Create bond between the virtual particles on the 2nd one
+    if (not first) {
+      const int bondG[] = {collision_params.bond_vs, c.vs_id};
+      add_bond(vs, bondG);
+    }
     break;
   }
   case 2: {
-    // Create 1st bond between the virtual particles
+    // Create the bond on both virtual particles
     const int bondG[] = {collision_params.bond_vs, c.pp1, c.pp2};
-    // Only add bond if vs was created on this node
-    if (cell_structure.get_local_particle(current_vs_pid - 1))
-      add_bond(get_part(current_vs_pid - 1), bondG);
-    if (cell_structure.get_local_particle(current_vs_pid - 2))
-      add_bond(get_part(current_vs_pid - 2), bondG);
+    add_bond(vs, bondG);
     break;
   }
   }
 }
 
-void glue_to_surface_bind_part_to_vs(const Particle *const p1,
-                                     const Particle *const p2,
-                                     const int vs_pid_plus_one,
-                                     const collision_struct &c) {
-  // Create bond between the virtual particles
-  const int bondG[] = {collision_params.bond_vs, vs_pid_plus_one - 1};
+/** @brief Handle a collision in mode @ref COLLISION_MODE_VS.
+ *
+ *  Each virtual site is created on the node of the particle it relates
+ *  to, with the ids chosen by the node which detected the collision.
+ */
+void bind_at_point_of_collision(const collision_struct &c,
+                                std::vector<Particle> &new_particles) {
+  auto p1 = cell_structure.get_local_particle(c.pp1);
+  auto p2 = cell_structure.get_local_particle(c.pp2);
+  if (!p1 or !p2)
+    return;
 
-  if (p1->p.type == collision_params.part_type_after_glueing) {
-    add_bond(get_part(p1->p.identity), bondG);
-  } else {
-    add_bond(get_part(p2->p.identity), bondG);
+  // Positions of the virtual sites
+  Utils::Vector3d pos1, pos2;
+  bind_at_point_of_collision_calc_vs_pos(p1, p2, pos1, pos2);
+
+  auto handle_particle = [&](Particle &p, Utils::Vector3d const &pos,
+                             bool first) {
+    if (p.l.ghost)
+      return;
+    // Enable rotation on the particle to which the vs is attached
+    p.p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
+
+    auto vs = make_vs_related_to_particle(c.vs_id + (first ? 0 : 1), pos, p);
+    bind_at_poc_create_bond_between_vs(vs, c, first);
+    new_particles.push_back(std::move(vs));
+  };
+
+  handle_particle(*p1, pos1, true);
+  handle_particle(*p2, pos2, false);
+}
+
+/** @brief Handle a collision in mode @ref COLLISION_MODE_GLUE_TO_SURF.
+ *
+ *  The collision is handled entirely on the node of the particle to be
+ *  glued, which sees all collisions of that particle. This guarantees
+ *  that a particle can only be glued once, even if it collides more
+ *  than once in a single time step.
+ */
+void glue_to_surface(const collision_struct &c,
+                     std::vector<Particle> &new_particles) {
+  auto p1 = cell_structure.get_local_particle(c.pp1);
+  auto p2 = cell_structure.get_local_particle(c.pp2);
+  if (!p1 or !p2)
+    return;
+
+  // If particles are made inert by a type change on collision:
+  // We skip the pair if one of the particles has already reacted
+  if (collision_params.part_type_after_glueing !=
+      collision_params.part_type_to_be_glued) {
+    if ((p1->p.type == collision_params.part_type_after_glueing) ||
+        (p2->p.type == collision_params.part_type_after_glueing)) {
+      return;
+    }
   }
+
+  Utils::Vector3d pos;
+  const Particle &attach_vs_to = glue_to_surface_calc_vs_pos(*p1, *p2, pos);
+  Particle &glued = (&attach_vs_to == p1) ? *p2 : *p1;
+
+  if (glued.l.ghost)
+    return;
+
+  // Add a bond between the centers of the colliding particles
+  const int bond_centers[] = {collision_params.bond_centers,
+                              attach_vs_to.identity()};
+  add_bond(glued, bond_centers);
+
+  // Change type of particle being attached, to make it inert
+  glued.p.type = collision_params.part_type_after_glueing;
+
+  // Create the vs and bind the glued particle to it
+  auto const vs_id = vs_ids.take(1);
+  new_particles.push_back(make_vs_related_to_particle(vs_id, pos, attach_vs_to));
+  const int bond_vs[] = {collision_params.bond_vs, vs_id};
+  add_bond(glued, bond_vs);
 }
 
 #endif
 
-std::vector<collision_struct> gather_global_collision_queue() {
-  std::vector<collision_struct> res = local_collision_queue;
-  Utils::Mpi::gather_buffer(res, comm_cart);
-  boost::mpi::broadcast(comm_cart, res, 0);
+/** @brief Ranks of the nodes which can hold ghosts of the local particles.
+ *
+ *  These are also the nodes the local ghosts belong to.
+ */
+std::vector<int> neighbor_ranks() {
+  std::vector<int> ranks;
+
+  if (cell_structure.type == CELL_STRUCTURE_DOMDEC) {
+    auto const node_pos = calc_node_pos(comm_cart);
+    for (int i = -1; i <= 1; i++)
+      for (int j = -1; j <= 1; j++)
+        for (int k = -1; k <= 1; k++) {
+          Utils::Vector3i const offset = {i, j, k};
+          Utils::Vector3i pos;
+          for (int d = 0; d < 3; d++) {
+            pos[d] = (node_pos[d] + offset[d] + node_grid[d]) % node_grid[d];
+          }
+          ranks.push_back(Utils::Mpi::cart_rank<3>(comm_cart, pos));
+        }
+  } else {
+    ranks.resize(n_nodes);
+    std::iota(ranks.begin(), ranks.end(), 0);
+  }
+
+  std::sort(ranks.begin(), ranks.end());
+  ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+  ranks.erase(std::remove(ranks.begin(), ranks.end(), this_node), ranks.end());
+
+  return ranks;
+}
+
+/** @brief Whether a particle can be a ghost on a neighboring node.
+ *
+ *  This is the case for the ghosts and for the local particles within
+ *  the range of the cell system of the domain boundary. The skin accounts
+ *  for the movement since the ghost layer was set up.
+ */
+bool is_boundary_particle(Particle const &p) {
+  if (p.l.ghost)
+    return true;
+  for (int d = 0; d < 3; d++) {
+    auto const range = cell_structure.max_range[d] + skin;
+    if (p.r.p[d] - local_geo.my_left()[d] < range or
+        local_geo.my_right()[d] - p.r.p[d] < range)
+      return true;
+  }
+  return false;
+}
+
+/** @brief Collisions to be handled on this node.
+ *
+ *  Only the collisions across node boundaries are sent to the neighboring
+ *  nodes, which hold the other particle. In the three particle binding
+ *  mode, the third particle can be on a neighboring node even if both
+ *  colliding particles are local, so all collisions of particles which
+ *  are ghosts on a neighboring node are sent. The result contains the
+ *  local queue and the collisions received from the neighbors, ordered by
+ *  the rank of the node which detected them, so that the collisions of a
+ *  particle are handled in the same order on all nodes that see it.
+ *  Every node exchanges its queue with its neighbors in every step, even
+ *  if it is empty.
+ */
+std::vector<collision_struct> exchange_boundary_collisions() {
+  auto const three_particles =
+      (collision_params.mode & COLLISION_MODE_BIND_THREE_PARTICLES) != 0;
+  std::vector<collision_struct> boundary;
+  std::copy_if(local_collision_queue.begin(), local_collision_queue.end(),
+               std::back_inserter(boundary),
+               [three_particles](collision_struct const &c) {
+                 auto const &p1 = get_part(c.pp1);
+                 auto const &p2 = get_part(c.pp2);
+                 if (three_particles)
+                   return is_boundary_particle(p1) or is_boundary_particle(p2);
+                 return p1.l.ghost or p2.l.ghost;
+               });
+
+  std::map<int, std::vector<collision_struct>> queues;
+  queues[this_node] = local_collision_queue;
+
+  std::vector<boost::mpi::request> requests;
+  for (auto const rank : neighbor_ranks()) {
+    requests.push_back(comm_cart.isend(rank, 0, boundary));
+    requests.push_back(comm_cart.irecv(rank, 0, queues[rank]));
+  }
+  boost::mpi::wait_all(requests.begin(), requests.end());
+
+  std::vector<collision_struct> res;
+  for (auto const &kv : queues) {
+    res.insert(res.end(), kv.second.begin(), kv.second.end());
+  }
 
   return res;
 }
@@ -516,164 +732,67 @@ void handle_collisions() {
     }
   }
 
-// Virtual sites based collision schemes
-#ifdef VIRTUAL_SITES_RELATIVE
-  if ((collision_params.mode & COLLISION_MODE_VS) ||
-      (collision_params.mode & COLLISION_MODE_GLUE_TO_SURF)) {
-    // Gather the global collision queue, because only one node has a collision
-    // across node boundaries in its queue.
-    // The other node might still have to change particle properties on its
-    // non-ghost particle
-    auto gathered_queue = gather_global_collision_queue();
-
-    // Sync max_seen_part
-    auto const global_max_seen_particle = boost::mpi::all_reduce(
-        comm_cart, cell_structure.get_max_local_particle_id(),
-        boost::mpi::maximum<int>());
-
-    int current_vs_pid = global_max_seen_particle + 1;
-
-    // Iterate over global collision queue
-    for (auto &c : gathered_queue) {
-
-      // Get particle pointers
-      Particle *p1 = cell_structure.get_local_particle(c.pp1);
-      Particle *p2 = cell_structure.get_local_particle(c.pp2);
-
-      // Only nodes take part in particle creation and binding
-      // that see both particles
+  // The other modes also change the particles on the node of the
+  // collision partner
+  if (!(collision_params.mode &
+        (COLLISION_MODE_VS | COLLISION_MODE_GLUE_TO_SURF |
+         COLLISION_MODE_BIND_THREE_PARTICLES))) {
+    local_collision_queue.clear();
+    return;
+  }
 
-      // If we cannot access both particles, both are ghosts,
-      // or one is ghost and one is not accessible
-      // we only increase the counter for the ext id to use based on the
-      // number of particles created by other nodes
-      if (((!p1 or p1->l.ghost) and (!p2 or p2->l.ghost)) or !p1 or !p2) {
-        // Increase local counters
-        if (collision_params.mode & COLLISION_MODE_VS) {
-          current_vs_pid++;
-        }
-        // For glue to surface, we have only one vs
-        current_vs_pid++;
-        if (collision_params.mode == COLLISION_MODE_GLUE_TO_SURF) {
-          if (p1)
-            if (p1->p.type == collision_params.part_type_to_be_glued) {
-              p1->p.type = collision_params.part_type_after_glueing;
-            }
-          if (p2)
-            if (p2->p.type == collision_params.part_type_to_be_glued) {
-              p2->p.type = collision_params.part_type_after_glueing;
-            }
-        } // mode glue to surface
-
-      } else { // We consider the pair because one particle
-               // is local to the node and the other is local or ghost
-        // If we are in the two vs mode
-        // Virtual site related to first particle in the collision
-        if (collision_params.mode & COLLISION_MODE_VS) {
-          Utils::Vector3d pos1, pos2;
-
-          // Enable rotation on the particles to which vs will be attached
-          p1->p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
-          p2->p.rotation = ROTATION_X | ROTATION_Y | ROTATION_Z;
-
-          // Positions of the virtual sites
-          bind_at_point_of_collision_calc_vs_pos(p1, p2, pos1, pos2);
-
-          auto handle_particle = [&](Particle *p, Utils::Vector3d const &pos) {
-            if (not p->l.ghost) {
-              place_vs_and_relate_to_particle(current_vs_pid, pos,
-                                              p->identity());
-              // Particle storage locations may have changed due to
-              // added particle
-              p1 = cell_structure.get_local_particle(c.pp1);
-              p2 = cell_structure.get_local_particle(c.pp2);
-            }
-          };
-
-          // place virtual sites on the node where the base particle is not a
-          // ghost
-          handle_particle(p1, pos1);
-          // Increment counter
-          current_vs_pid++;
-
-          handle_particle(p2, pos2);
-          // Increment counter
-          current_vs_pid++;
-          // Create bonds between the vs.
-
-          bind_at_poc_create_bond_between_vs(current_vs_pid, c);
-        } // mode VS
-
-        if (collision_params.mode & COLLISION_MODE_GLUE_TO_SURF) {
-          // If particles are made inert by a type change on collision:
-          // We skip the pair if one of the particles has already reacted
-          // but we still increase the particle counters, as other nodes
-          // can not always know whether or not a vs is placed
-          if (collision_params.part_type_after_glueing !=
-              collision_params.part_type_to_be_glued) {
-            if ((p1->p.type == collision_params.part_type_after_glueing) ||
-                (p2->p.type == collision_params.part_type_after_glueing)) {
-              current_vs_pid++;
-              continue;
-            }
-          }
+#ifdef VIRTUAL_SITES_RELATIVE
+  if (collision_params.mode & COLLISION_MODE_VS) {
+    for (auto &c : local_collision_queue) {
+      c.vs_id = vs_ids.take(2);
+    }
+  }
+#endif
 
-          Utils::Vector3d pos;
-          const Particle &attach_vs_to =
-              glue_to_surface_calc_vs_pos(*p1, *p2, pos);
-
-          // Add a bond between the centers of the colliding particles
-          // The bond is placed on the node that has p1
-          if (!p1->l.ghost) {
-            int bondG[2];
-            bondG[0] = collision_params.bond_centers;
-            bondG[1] = c.pp2;
-            add_bond(get_part(c.pp1), bondG);
-          }
+  // Only the neighbors can hold particles of the local collisions, so the
+  // nodes do not have to agree on whether there were collisions at all.
+  auto const queue = exchange_boundary_collisions();
+  if (queue.empty()) {
+    local_collision_queue.clear();
+    return;
+  }
 
-          // Change type of particle being attached, to make it inert
-          if (p1->p.type == collision_params.part_type_to_be_glued) {
-            p1->p.type = collision_params.part_type_after_glueing;
-          }
-          if (p2->p.type == collision_params.part_type_to_be_glued) {
-            p2->p.type = collision_params.part_type_after_glueing;
-          }
+// Virtual sites based collision schemes
+#ifdef VIRTUAL_SITES_RELATIVE
+  std::vector<Particle> new_particles;
 
-          // Vs placement happens on the node that has p1
-          if (!attach_vs_to.l.ghost) {
-            place_vs_and_relate_to_particle(current_vs_pid, pos,
-                                            attach_vs_to.identity());
-            // Particle storage locations may have changed due to
-            // added particle
-            p1 = cell_structure.get_local_particle(c.pp1);
-            p2 = cell_structure.get_local_particle(c.pp2);
-            current_vs_pid++;
-          } else { // Just update the books
-            current_vs_pid++;
-          }
-          glue_to_surface_bind_part_to_vs(p1, p2, current_vs_pid, c);
-        }
-      } // we considered the pair
-    }   // Loop over all collisions in the queue
-#ifdef ADDITIONAL_CHECKS
-    if (!Utils::Mpi::all_compare(comm_cart, current_vs_pid)) {
-      throw std::runtime_error("Nodes disagree about current_vs_pid");
+  if (collision_params.mode & COLLISION_MODE_VS) {
+    for (auto const &c : queue) {
+      bind_at_point_of_collision(c, new_particles);
     }
-#endif
+  }
 
-    // If any node had a collision, all nodes need to resort
-    if (!gathered_queue.empty()) {
-      cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
-      cells_update_ghosts(GHOSTTRANS_PROPRTS | GHOSTTRANS_BONDS);
+  if (collision_params.mode & COLLISION_MODE_GLUE_TO_SURF) {
+    for (auto const &c : queue) {
+      glue_to_surface(c, new_particles);
     }
-  }    // are we in one of the vs_based methods
-#endif // defined VIRTUAL_SITES_RELATIVE
+  }
+#endif
 
   // three-particle-binding part
   if (collision_params.mode & (COLLISION_MODE_BIND_THREE_PARTICLES)) {
-    auto gathered_queue = gather_global_collision_queue();
-    three_particle_binding_domain_decomposition(gathered_queue);
-  } // if TPB
+    three_particle_binding_domain_decomposition(queue);
+  }
+
+#ifdef VIRTUAL_SITES_RELATIVE
+  if ((collision_params.mode & COLLISION_MODE_VS) ||
+      (collision_params.mode & COLLISION_MODE_GLUE_TO_SURF)) {
+    // Add the new virtual sites in one go
+    for (auto &p : new_particles) {
+      cell_structure.add_particle(std::move(p));
+    }
+
+    // The new particles are sorted into the cells, and the ghosts get the
+    // new particles, bonds and types, with the ghost update of the next
+    // step, where all nodes agree on the resort
+    cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+  }
+#endif
 
   local_collision_queue.clear();
 }
@@ -102,6 +102,11 @@ void prepare_local_collision_queue();
 /// Handle the collisions recorded in the queue
 void handle_collisions();
 
+/** @brief Reserve the ids of the virtual sites created on collision.
+ *  Has to be called on all nodes at the start of the integration.
+ */
+void collision_detection_on_integration_start();
+
 /** @brief Validates collision parameters and creates particle types if needed
  */
 bool validate_collision_parameters();
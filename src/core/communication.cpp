@@ -51,7 +51,9 @@
 #include "integrate.hpp"
 #include "integrators/steepest_descent.hpp"
 #include "io/mpiio/mpiio.hpp"
+#include "nonbonded_interactions/isotropic_pair.hpp"
 #include "nonbonded_interactions/nonbonded_tab.hpp"
+#include "nonbonded_interactions/pair_spline_table.hpp"
 #include "npt.hpp"
 #include "partCfg_global.hpp"
 #include "particle_data.hpp"
@@ -89,6 +91,8 @@ boost::mpi::communicator comm_cart;
 
 namespace Communication {
 std::unique_ptr<MpiCallbacks> m_callbacks;
+/** Whether the slave nodes are in the callback loop */
+bool callbacks_active = false;
 
 /* We use a singleton callback class for now. */
 MpiCallbacks &mpiCallbacks() {
@@ -218,6 +222,10 @@ void mpi_init() {
 
   ErrorHandling::init_error_handling(mpiCallbacks());
 
+  /* The callback loop is left when the callbacks are destroyed at exit. */
+  Communication::callbacks_active = true;
+  std::atexit([]() { Communication::callbacks_active = false; });
+
   on_program_start();
 }
 
@@ -319,7 +327,14 @@ void mpi_bcast_ia_params(int i, int j) {
   mpi_call(mpi_bcast_ia_params_slave, i, j);
 
   if (j >= 0) {
-    /* non-bonded interaction parameters */
+    /* non-bonded interaction parameters, the list of active
+       potentials and the spline table have to follow them */
+    update_isotropic_potentials(*get_ia_param(i, j));
+    if (not update_pair_spline_table(*get_ia_param(i, j))) {
+      get_ia_param(i, j)->spline_table.tolerance = 0.;
+      runtimeErrorMsg() << "tabulation of the interactions between types "
+                        << i << " and " << j << " failed, it is disabled";
+    }
     boost::mpi::broadcast(comm_cart, *get_ia_param(i, j), 0);
   } else {
     /* bonded interaction parameters */
@@ -664,6 +679,8 @@ void mpi_loop() {
     mpiCallbacks().loop();
 }
 
+bool mpi_callbacks_active() { return Communication::callbacks_active; }
+
 std::vector<int> mpi_resort_particles(int global_flag) {
   mpi_call(mpi_resort_particles_slave, global_flag, 0);
   cells_resort_particles(global_flag);
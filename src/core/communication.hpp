@@ -149,6 +149,14 @@ auto mpi_call(Tag tag, TagArg &&tag_arg, R (*fp)(Args...), ArgRef &&... args) {
 /** Process requests from master node. Slave nodes main loop. */
 void mpi_loop();
 
+/** @brief Whether the slave nodes still process the requests of the
+ *  master node.
+ *
+ *  This is no longer the case once the program exits, so that objects
+ *  destroyed at exit must not use @ref mpi_call.
+ */
+bool mpi_callbacks_active();
+
 /** Move particle to a position on a node.
  *  Also calls \ref on_particle_change.
  *  \param id    the particle to move.
@@ -36,6 +36,7 @@ using Utils::get_linear_index;
 
 #include "event.hpp"
 
+#include <boost/algorithm/clamp.hpp>
 #include <boost/mpi/collectives.hpp>
 #include <boost/range/algorithm/reverse.hpp>
 
@@ -770,4 +771,40 @@ int calc_processor_min_num_cells(const Utils::Vector3i &grid) {
   return min;
 }
 
+std::vector<Cell *> dd_local_cells_around(Utils::Vector3d const &pos) {
+  /* ranges of the local cell indices next to the images of the position */
+  std::array<std::vector<std::pair<int, int>>, 3> ranges;
+  for (int i = 0; i < 3; i++) {
+    for (int shift = -1; shift <= 1; shift++) {
+      if (shift != 0 and not box_geo.periodic(i))
+        continue;
+      auto const x = pos[i] + shift * box_geo.length()[i];
+      auto cpos = static_cast<int>(std::floor(x * dd.inv_cell_size[i])) + 1 -
+                  dd.cell_offset[i];
+      /* particles outside of a non-periodic box are in the boundary cells */
+      if (not box_geo.periodic(i))
+        cpos = boost::algorithm::clamp(cpos, 0, dd.cell_grid[i] + 1);
+      auto const first = std::max(cpos - 1, 1);
+      auto const last = std::min(cpos + 1, dd.cell_grid[i]);
+      if (first <= last)
+        ranges[i].emplace_back(first, last);
+    }
+  }
+
+  std::vector<Cell *> res;
+  for (auto const &x_range : ranges[0])
+    for (auto const &y_range : ranges[1])
+      for (auto const &z_range : ranges[2])
+        for (int x = x_range.first; x <= x_range.second; x++)
+          for (int y = y_range.first; y <= y_range.second; y++)
+            for (int z = z_range.first; z <= z_range.second; z++) {
+              res.push_back(&cells[get_linear_index(
+                  x, y, z,
+                  {dd.ghost_cell_grid[0], dd.ghost_cell_grid[1],
+                   dd.ghost_cell_grid[2]})]);
+            }
+
+  return res;
+}
+
 /************************************************************/
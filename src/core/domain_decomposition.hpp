@@ -179,6 +179,17 @@ int dd_fill_comm_cell_lists(Cell **part_lists, int const lc[3],
  */
 void dd_assign_prefetches(GhostCommunicator *comm);
 
+/** @brief Local cells next to a position.
+ *
+ *  These are the local cells within one cell of any periodic image of the
+ *  position, which contain all local particles that are closer to the
+ *  position than the cell size minus the skin. A cell can occur more than
+ *  once if the node has few cells.
+ *
+ *  @param pos  Folded position
+ */
+std::vector<Cell *> dd_local_cells_around(Utils::Vector3d const &pos);
+
 /*@}*/
 
 #endif
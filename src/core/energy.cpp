@@ -26,16 +26,24 @@
 #include "communication.hpp"
 #include "constraints.hpp"
 #include "cuda_interface.hpp"
+#include "domain_decomposition.hpp"
 #include "electrostatics_magnetostatics/magnetic_non_p3m_methods.hpp"
 #include "energy_inline.hpp"
 #include "event.hpp"
 #include "forces.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
 
 #include "short_range_loop.hpp"
 
 #include "electrostatics_magnetostatics/coulomb.hpp"
 #include "electrostatics_magnetostatics/dipole.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
 ActorList energyActors;
 
 Observable_stat energy{};
@@ -139,3 +147,137 @@ double calculate_current_potential_energy_of_system() {
 
   return sum_all_energies - kinetic_energy;
 }
+
+namespace {
+/** Add the short-range energies of the interactions involving at least
+ *  one of the particles @p p_ids (sorted) to the @ref energy observable.
+ */
+void add_short_range_energy_contribution(std::vector<int> const &p_ids) {
+  auto const is_touched = [&p_ids](int p_id) {
+    return std::binary_search(p_ids.begin(), p_ids.end(), p_id);
+  };
+
+  /* Non-bonded pairs: every pair is evaluated on the node of the particle
+   * with the smaller id, if both particles are in the set. */
+  if (cell_structure.min_range != INACTIVE_CUTOFF) {
+    auto const distance = [](Particle const &p1, Particle const &p2) {
+      if (cell_structure.type == CELL_STRUCTURE_NSQUARE)
+        return get_mi_vector(p1.r.p, p2.r.p, box_geo);
+      return Utils::Vector3d(p1.r.p - p2.r.p);
+    };
+    auto const add_pairs = [&](Particle const &p1, Cell const &cell) {
+      for (auto const &p2 : cell.particles()) {
+        if (p2.p.identity == p1.p.identity or
+            (p2.p.identity < p1.p.identity and is_touched(p2.p.identity)))
+          continue;
+        auto const d = distance(p1, p2);
+        auto const dist2 = d.norm2();
+        add_non_bonded_pair_energy(p1, p2, d, sqrt(dist2), dist2);
+      }
+    };
+
+    for (auto const p_id : p_ids) {
+      auto const p = cell_structure.get_local_particle(p_id);
+      if (not p or p->l.ghost)
+        continue;
+
+      auto cell = find_current_cell(*p);
+      auto neighbors = cell->m_neighbors.all();
+      if (std::find(neighbors.begin(), neighbors.end(), cell) ==
+          neighbors.end()) {
+        add_pairs(*p, *cell);
+      }
+      for (auto const neighbor : neighbors) {
+        add_pairs(*p, *neighbor);
+      }
+    }
+  }
+
+  /* Bonds are stored with one of their partners, so the bond lists of the
+   * local particles which can be bonded to the set have to be checked, but
+   * only the bonds which involve the set are evaluated. */
+  auto const add_bonds = [&](Particle const &p) {
+    auto involved = is_touched(p.p.identity);
+    for (int i = 0; i < p.bl.n and not involved;) {
+      auto const n_partners = bonded_ia_params[p.bl.e[i++]].num;
+      for (int j = 0; j < n_partners; j++) {
+        involved |= is_touched(p.bl.e[i++]);
+      }
+    }
+    if (involved)
+      add_bonded_energy(&p);
+  };
+
+  if (cell_structure.type == CELL_STRUCTURE_DOMDEC) {
+    /* Bond partners are closer than the cell size minus the skin, so they
+     * are in the cells around any copy of a particle of the set on this
+     * node, including the ghosts. */
+    std::vector<Cell *> bond_cells;
+    for (auto const p_id : p_ids) {
+      auto const p = cell_structure.get_local_particle(p_id);
+      if (not p)
+        continue;
+
+      auto const around =
+          dd_local_cells_around(folded_position(p->r.p, box_geo));
+      bond_cells.insert(bond_cells.end(), around.begin(), around.end());
+    }
+    std::sort(bond_cells.begin(), bond_cells.end());
+    bond_cells.erase(std::unique(bond_cells.begin(), bond_cells.end()),
+                     bond_cells.end());
+
+    for (auto const cell : bond_cells) {
+      for (auto const &p : cell->particles()) {
+        add_bonds(p);
+      }
+    }
+  } else {
+    for (auto const &p : cell_structure.local_cells().particles()) {
+      add_bonds(p);
+    }
+  }
+
+  /* Constraints */
+  for (auto const p_id : p_ids) {
+    auto const p = cell_structure.get_local_particle(p_id);
+    if (not p or p->l.ghost)
+      continue;
+
+    auto const pos = folded_position(p->r.p, box_geo);
+    for (auto const &constraint : Constraints::constraints) {
+      constraint->add_energy(*p, pos, sim_time, energy);
+    }
+  }
+}
+
+double
+mpi_calculate_potential_energy_contribution_slave(std::vector<int> p_ids) {
+  if (!interactions_sanity_checks())
+    return 0.;
+
+  init_energies(&energy);
+  on_observable_calc();
+
+  add_short_range_energy_contribution(p_ids);
+  calc_long_range_energies(cell_structure.local_cells().particles());
+
+  /* The kinetic energy is not computed, so this is the potential energy */
+  return std::accumulate(energy.data.begin(), energy.data.end(), 0.);
+}
+} // namespace
+
+REGISTER_CALLBACK_REDUCTION(mpi_calculate_potential_energy_contribution_slave,
+                            std::plus<double>())
+
+double calculate_potential_energy_contribution_of_particles(
+    std::vector<int> p_ids) {
+  /* Energies computed by actors are only available for the whole system */
+  if (not energyActors.empty())
+    return calculate_current_potential_energy_of_system();
+
+  std::sort(p_ids.begin(), p_ids.end());
+  p_ids.erase(std::unique(p_ids.begin(), p_ids.end()), p_ids.end());
+
+  return mpi_call(Communication::Result::reduction, std::plus<double>(),
+                  mpi_calculate_potential_energy_contribution_slave, p_ids);
+}
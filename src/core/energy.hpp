@@ -32,6 +32,8 @@
 #include "actor/ActorList.hpp"
 #include "statistics.hpp"
 
+#include <vector>
+
 /** \name Exported Variables */
 /************************************************************/
 /*@{*/
@@ -62,6 +64,24 @@ void calc_long_range_energies(const ParticleRange &particles);
 /** Calculate the total energy */
 double calculate_current_potential_energy_of_system();
 
+/** @brief Calculate the potential energy of the interactions of a set of
+ *  particles.
+ *
+ *  Contains at least all short-range non-bonded, bonded and constraint
+ *  energies in which one of the particles takes part, and the full long-range
+ *  energies. The remaining interactions do not depend on the particles, so
+ *  the difference of this energy between two configurations which only
+ *  differ in these particles is the difference of the total energies.
+ *  The non-bonded pairs are only searched in the cells around the
+ *  particles. If energies are computed by actors (e.g. on the GPU),
+ *  the total energy is returned.
+ *
+ *  @param p_ids Ids of the particles, particles which do not exist are
+ *               ignored
+ */
+double
+calculate_potential_energy_contribution_of_particles(std::vector<int> p_ids);
+
 /*@}*/
 
 #endif
@@ -39,23 +39,10 @@
 #include "bonded_interactions/subt_lj.hpp"
 #include "bonded_interactions/umbrella.hpp"
 #include "errorhandling.hpp"
-#include "nonbonded_interactions/bmhtf-nacl.hpp"
-#include "nonbonded_interactions/buckingham.hpp"
-#include "nonbonded_interactions/gaussian.hpp"
 #include "nonbonded_interactions/gay_berne.hpp"
-#include "nonbonded_interactions/hat.hpp"
-#include "nonbonded_interactions/hertzian.hpp"
-#include "nonbonded_interactions/lj.hpp"
-#include "nonbonded_interactions/ljcos.hpp"
-#include "nonbonded_interactions/ljcos2.hpp"
-#include "nonbonded_interactions/ljgen.hpp"
-#include "nonbonded_interactions/morse.hpp"
+#include "nonbonded_interactions/isotropic_pair.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
-#include "nonbonded_interactions/nonbonded_tab.hpp"
-#include "nonbonded_interactions/smooth_step.hpp"
-#include "nonbonded_interactions/soft_sphere.hpp"
 #include "nonbonded_interactions/thole.hpp"
-#include "nonbonded_interactions/wca.hpp"
 #ifdef ELECTROSTATICS
 #include "bonded_interactions/bonded_coulomb.hpp"
 #include "bonded_interactions/bonded_coulomb_sr.hpp"
@@ -89,82 +76,13 @@ inline double calc_non_bonded_pair_energy(Particle const &p1,
     return 0;
 #endif
 
-  double ret = 0;
-
-#ifdef LENNARD_JONES
-  /* Lennard-Jones */
-  ret += lj_pair_energy(ia_params, dist);
-#endif
-#ifdef WCA
-  /* WCA */
-  ret += wca_pair_energy(ia_params, dist);
-#endif
-
-#ifdef LENNARD_JONES_GENERIC
-  /* Generic Lennard-Jones */
-  ret += ljgen_pair_energy(ia_params, dist);
-#endif
-
-#ifdef SMOOTH_STEP
-  /* smooth step */
-  ret += SmSt_pair_energy(ia_params, dist);
-#endif
-
-#ifdef HERTZIAN
-  /* Hertzian potential */
-  ret += hertzian_pair_energy(ia_params, dist);
-#endif
-
-#ifdef GAUSSIAN
-  /* Gaussian potential */
-  ret += gaussian_pair_energy(ia_params, dist);
-#endif
-
-#ifdef BMHTF_NACL
-  /* BMHTF NaCl */
-  ret += BMHTF_pair_energy(ia_params, dist);
-#endif
-
-#ifdef MORSE
-  /* Morse */
-  ret += morse_pair_energy(ia_params, dist);
-#endif
-
-#ifdef BUCKINGHAM
-  /* Buckingham */
-  ret += buck_pair_energy(ia_params, dist);
-#endif
-
-#ifdef SOFT_SPHERE
-  /* soft-sphere */
-  ret += soft_pair_energy(ia_params, dist);
-#endif
-
-#ifdef HAT
-  /* hat */
-  ret += hat_pair_energy(ia_params, dist);
-#endif
-
-#ifdef LJCOS2
-  /* Lennard-Jones */
-  ret += ljcos2_pair_energy(ia_params, dist);
-#endif
+  double ret = isotropic_pair_energy(ia_params, dist);
 
 #ifdef THOLE
   /* Thole damping */
   ret += thole_pair_energy(p1, p2, ia_params, d, dist);
 #endif
 
-#ifdef TABULATED
-  /* tabulated */
-  ret += tabulated_pair_energy(ia_params, dist);
-#endif
-
-#ifdef LJCOS
-  /* Lennard-Jones cosine */
-  ret += ljcos_pair_energy(ia_params, dist);
-#endif
-
 #ifdef GAY_BERNE
   /* Gay-Berne */
   ret += gb_pair_energy(p1.r.calc_director(), p2.r.calc_director(), ia_params,
@@ -127,6 +127,10 @@ void on_integration_start() {
   // necessary calculates them
   immersed_boundaries.init_volume_conservation();
 
+#ifdef COLLISION_DETECTION
+  collision_detection_on_integration_start();
+#endif
+
   /* Prepare the thermostat */
   if (reinit_thermo) {
     thermo_init();
@@ -41,22 +41,9 @@
 #include "immersed_boundary/ibm_tribend.hpp"
 #include "immersed_boundary/ibm_triel.hpp"
 #include "integrators/langevin_inline.hpp"
-#include "nonbonded_interactions/bmhtf-nacl.hpp"
-#include "nonbonded_interactions/buckingham.hpp"
-#include "nonbonded_interactions/gaussian.hpp"
 #include "nonbonded_interactions/gay_berne.hpp"
-#include "nonbonded_interactions/hat.hpp"
-#include "nonbonded_interactions/hertzian.hpp"
-#include "nonbonded_interactions/lj.hpp"
-#include "nonbonded_interactions/ljcos.hpp"
-#include "nonbonded_interactions/ljcos2.hpp"
-#include "nonbonded_interactions/ljgen.hpp"
-#include "nonbonded_interactions/morse.hpp"
-#include "nonbonded_interactions/nonbonded_tab.hpp"
-#include "nonbonded_interactions/smooth_step.hpp"
-#include "nonbonded_interactions/soft_sphere.hpp"
+#include "nonbonded_interactions/isotropic_pair.hpp"
 #include "nonbonded_interactions/thole.hpp"
-#include "nonbonded_interactions/wca.hpp"
 #include "npt.hpp"
 #include "object-in-fluid/oif_global_forces.hpp"
 #include "object-in-fluid/oif_local_forces.hpp"
@@ -130,67 +117,11 @@ inline Utils::Vector3d calc_non_bonded_pair_force_parts(
     return {};
 #endif
   Utils::Vector3d force{};
-  double force_factor = 0;
-/* Lennard-Jones */
-#ifdef LENNARD_JONES
-  force_factor += lj_pair_force_factor(ia_params, dist);
-#endif
-/* WCA */
-#ifdef WCA
-  force_factor += wca_pair_force_factor(ia_params, dist);
-#endif
-/* Lennard-Jones generic */
-#ifdef LENNARD_JONES_GENERIC
-  force_factor += ljgen_pair_force_factor(ia_params, dist);
-#endif
-/* smooth step */
-#ifdef SMOOTH_STEP
-  force_factor += SmSt_pair_force_factor(ia_params, dist);
-#endif
-/* Hertzian force */
-#ifdef HERTZIAN
-  force_factor += hertzian_pair_force_factor(ia_params, dist);
-#endif
-/* Gaussian force */
-#ifdef GAUSSIAN
-  force_factor += gaussian_pair_force_factor(ia_params, dist);
-#endif
-/* BMHTF NaCl */
-#ifdef BMHTF_NACL
-  force_factor += BMHTF_pair_force_factor(ia_params, dist);
-#endif
-/* Buckingham*/
-#ifdef BUCKINGHAM
-  force_factor += buck_pair_force_factor(ia_params, dist);
-#endif
-/* Morse*/
-#ifdef MORSE
-  force_factor += morse_pair_force_factor(ia_params, dist);
-#endif
-/*soft-sphere potential*/
-#ifdef SOFT_SPHERE
-  force_factor += soft_pair_force_factor(ia_params, dist);
-#endif
-/*hat potential*/
-#ifdef HAT
-  force_factor += hat_pair_force_factor(ia_params, dist);
-#endif
-/* Lennard-Jones cosine */
-#ifdef LJCOS
-  force_factor += ljcos_pair_force_factor(ia_params, dist);
-#endif
-/* Lennard-Jones cosine */
-#ifdef LJCOS2
-  force_factor += ljcos2_pair_force_factor(ia_params, dist);
-#endif
+  auto const force_factor = isotropic_pair_force_factor(ia_params, dist);
 /* Thole damping */
 #ifdef THOLE
   force += thole_pair_force(p1, p2, ia_params, d, dist);
 #endif
-/* tabulated */
-#ifdef TABULATED
-  force_factor += tabulated_pair_force_factor(ia_params, dist);
-#endif
 /* Gay-Berne */
 #ifdef GAY_BERNE
   // The gb force function isn't inlined, probably due to its size
@@ -31,6 +31,10 @@
 #include <utils/constants.hpp>
 #include <utils/index.hpp>
 
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
 Lattice::Lattice(double agrid, double offset, int halo_size,
                  Utils::Vector3d const &local_box,
                  Utils::Vector3d const &my_right,
@@ -113,6 +117,71 @@ void Lattice::map_position_to_lattice(const Utils::Vector3d &pos,
   node_index[7] = node_index[4] + halo_grid[0] + 1;
 }
 
+namespace {
+/** Three-point interpolation kernel for the center site, @cite duenweg09a.
+ *  @param u Distance to the lattice site in units of agrid, |u| <= 1/2
+ */
+double three_point_polynomial_smallerequal_than_half(double u) {
+  return 1. / 3. * (1. + std::sqrt(1. - 3. * u * u));
+}
+
+/** Three-point interpolation kernel for the outer sites, @cite duenweg09a.
+ *  @param u Distance to the lattice site in units of agrid, 1/2 < |u| <= 3/2
+ */
+double three_point_polynomial_larger_than_half(double u) {
+  auto const abs_u = std::fabs(u);
+  return 1. / 6. *
+         (5. - 3. * abs_u - std::sqrt(-2. + 6. * abs_u - 3. * u * u));
+}
+} // namespace
+
+void Lattice::map_position_to_quadratic_stencil(
+    const Utils::Vector3d &pos, Utils::Vector<std::size_t, 27> &node_index,
+    Utils::Vector<double, 9> &delta) const {
+  Utils::Vector3i ind{};
+  auto const epsilon = std::numeric_limits<double>::epsilon();
+
+  /* determine the lattice site closest to the position
+     and the distance of the position to this site */
+  for (int dir = 0; dir < 3; dir++) {
+    auto const lpos = pos[dir] - (my_right[dir] - local_box[dir]);
+    auto const rel = lpos / agrid + offset;
+    ind[dir] = static_cast<int>(std::floor(rel + 0.5));
+
+    /* stencil is not completely inside the halo region,
+       adjust if this is due to round off errors */
+    if (ind[dir] < 1) {
+      if (std::fabs(rel - 0.5) < epsilon) {
+        ind[dir] = 1;
+      } else {
+        throw std::runtime_error("position not inside a local plaquette");
+      }
+    } else if (ind[dir] > grid[dir]) {
+      if (lpos - local_box[dir] < epsilon * local_box[dir])
+        ind[dir] = grid[dir];
+      else
+        throw std::runtime_error("position not inside a local plaquette");
+    }
+
+    auto const dist = rel - ind[dir];
+    delta[3 * dir + 0] = three_point_polynomial_larger_than_half(dist + 1.);
+    delta[3 * dir + 1] = three_point_polynomial_smallerequal_than_half(dist);
+    delta[3 * dir + 2] = three_point_polynomial_larger_than_half(dist - 1.);
+  }
+
+  auto const first = Utils::get_linear_index(ind - Utils::Vector3i{1, 1, 1},
+                                             halo_grid);
+  auto const yperiod = static_cast<std::size_t>(halo_grid[0]);
+  auto const zperiod = static_cast<std::size_t>(halo_grid[0] * halo_grid[1]);
+  for (int z = 0; z < 3; z++) {
+    for (int y = 0; y < 3; y++) {
+      for (int x = 0; x < 3; x++) {
+        node_index[(z * 3 + y) * 3 + x] = first + z * zperiod + y * yperiod + x;
+      }
+    }
+  }
+}
+
 Utils::Vector3i Lattice::local_index(Utils::Vector3i const &global_index) const
     noexcept {
   return {global_index[0] - local_index_offset[0] + halo_size,
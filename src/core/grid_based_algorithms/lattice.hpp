@@ -95,6 +95,26 @@ public:
                                Utils::Vector<std::size_t, 8> &node_index,
                                Utils::Vector6d &delta) const;
 
+  /** Map a spatial position to the 27 lattice sites of the three-point
+   *  interpolation stencil @cite duenweg09a.
+   *
+   * The stencil is centered on the lattice site closest to the position.
+   * <br><em>Remarks:</em>
+   * <ul>
+   * <li>The spatial position has to be in the local domain, the stencil
+   * then extends at most into the first halo layer.</li>
+   * <li>The lattice sites of the stencil are returned as local indices,
+   * with the x index running fastest</li>
+   * </ul>
+   * @param pos        spatial position (Input)
+   * @param node_index local indices of the stencil sites (Output)
+   * @param delta      one-dimensional weights of the left, center and right
+   *                   site for each direction, 9 entries (Output)
+   */
+  void map_position_to_quadratic_stencil(
+      Utils::Vector3d const &pos, Utils::Vector<std::size_t, 27> &node_index,
+      Utils::Vector<double, 9> &delta) const;
+
   /**
    * @brief Determine if given global index is node-local.
    * @param index Global lattice index.
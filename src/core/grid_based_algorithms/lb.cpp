@@ -36,6 +36,7 @@
 #include "global.hpp"
 #include "grid.hpp"
 #include "grid_based_algorithms/lb_boundaries.hpp"
+#include "grid_based_algorithms/lb_refinement.hpp"
 #include "halo.hpp"
 #include "integrate.hpp"
 #include "lb-d3q19.hpp"
@@ -125,6 +126,7 @@ void lb_on_param_change(LBParam param) {
     break;
   }
   lb_reinit_parameters(lbpar);
+  lb_refined_patch_reinit();
 }
 
 #ifdef ADDITIONAL_CHECKS
@@ -177,8 +179,47 @@ LB_Fluid lbfluid_post;
 
 std::vector<LB_FluidNode> lbfields;
 
+/** Local non-boundary nodes (halo excluded), in memory order. */
+static std::vector<Lattice::index_t> lb_fluid_nodes;
+
+#ifdef LB_BOUNDARIES
+/** Link along which a population streams from a local node into a
+ *  boundary node.
+ */
+struct LB_BoundaryLink {
+  /** boundary node the population streamed into */
+  Lattice::index_t boundary_node;
+  /** local node the population is bounced back to */
+  Lattice::index_t source_node;
+  /** velocity index of the population */
+  int direction;
+  /** boundary flag of @ref boundary_node */
+  int boundary;
+  /** population shift due to the boundary slip velocity,
+   *  in units of the fluid density */
+  double population_shift;
+};
+
+/** Links from fluid nodes into boundary nodes. */
+static std::vector<LB_BoundaryLink> lb_boundary_links;
+/** Links between boundary nodes, their populations are cleared. */
+static std::vector<LB_BoundaryLink> lb_boundary_boundary_links;
+#endif // LB_BOUNDARIES
+
 HaloCommunicator update_halo_comm = HaloCommunicator(0);
 
+/** MPI datatypes for the halo push communication. Entry <tt>2 * dir</tt>
+ *  selects the populations leaving a plane perpendicular to @c dir
+ *  towards the left neighbor, entry <tt>2 * dir + 1</tt> those towards
+ *  the right neighbor.
+ */
+static std::array<MPI_Datatype, 6> push_halo_types = {
+    {MPI_DATATYPE_NULL, MPI_DATATYPE_NULL, MPI_DATATYPE_NULL,
+     MPI_DATATYPE_NULL, MPI_DATATYPE_NULL, MPI_DATATYPE_NULL}};
+
+/** Whether the populations on the halo sites are up to date. */
+static bool halo_populations_valid = false;
+
 /** measures the MD time since the last fluid update */
 static double fluidstep = 0.0;
 
@@ -200,6 +241,73 @@ void lb_initialize_fields(std::vector<LB_FluidNode> &fields,
     field.boundary = false;
 #endif // LB_BOUNDARIES
   }
+  lb_rebuild_node_lists(fields, lb_lattice);
+}
+
+void lb_rebuild_node_lists(const std::vector<LB_FluidNode> &lb_fields,
+                           const Lattice &lb_lattice) {
+  lb_fluid_nodes.clear();
+  for (int z = 1; z <= lb_lattice.grid[2]; z++) {
+    for (int y = 1; y <= lb_lattice.grid[1]; y++) {
+      for (int x = 1; x <= lb_lattice.grid[0]; x++) {
+        auto const index = get_linear_index(x, y, z, lb_lattice.halo_grid);
+#ifdef LB_BOUNDARIES
+        if (lb_fields[index].boundary)
+          continue;
+#endif // LB_BOUNDARIES
+        lb_fluid_nodes.push_back(index);
+      }
+    }
+  }
+
+#ifdef LB_BOUNDARIES
+  lb_boundary_links.clear();
+  lb_boundary_boundary_links.clear();
+
+  const std::array<int, 3> period = {
+      {1, lb_lattice.halo_grid[0],
+       lb_lattice.halo_grid[0] * lb_lattice.halo_grid[1]}};
+
+  for (int z = 0; z < lb_lattice.grid[2] + 2; z++) {
+    for (int y = 0; y < lb_lattice.grid[1] + 2; y++) {
+      for (int x = 0; x < lb_lattice.grid[0] + 2; x++) {
+        auto const k = get_linear_index(x, y, z, lb_lattice.halo_grid);
+        auto const &node = lb_fields[k];
+        if (!node.boundary)
+          continue;
+
+        for (int i = 0; i < D3Q19::n_vel; i++) {
+          /* only populations coming from a local node are bounced back */
+          if (x - D3Q19::c[i][0] <= 0 ||
+              x - D3Q19::c[i][0] >= lb_lattice.grid[0] + 1 ||
+              y - D3Q19::c[i][1] <= 0 ||
+              y - D3Q19::c[i][1] >= lb_lattice.grid[1] + 1 ||
+              z - D3Q19::c[i][2] <= 0 ||
+              z - D3Q19::c[i][2] >= lb_lattice.grid[2] + 1)
+            continue;
+
+          auto const neighbor =
+              k - boost::inner_product(period, D3Q19::c[i], 0);
+
+          double population_shift = 0;
+          for (int l = 0; l < 3; l++) {
+            population_shift -= 2 * D3Q19::c[i][l] * D3Q19::w[i] *
+                                node.slip_velocity[l] /
+                                D3Q19::c_sound_sq<double>;
+          }
+
+          LB_BoundaryLink const link{k, neighbor, i, node.boundary,
+                                     population_shift};
+          if (lb_fields[neighbor].boundary) {
+            lb_boundary_boundary_links.push_back(link);
+          } else {
+            lb_boundary_links.push_back(link);
+          }
+        }
+      }
+    }
+  }
+#endif // LB_BOUNDARIES
 }
 
 /** (Re-)allocate memory for the fluid and initialize pointers. */
@@ -229,6 +337,9 @@ void lb_set_equilibrium_populations(const Lattice &lb_lattice,
 }
 
 void lb_init(const LB_Parameters &lb_parameters) {
+  /* the refined patch is defined in terms of the old lattice */
+  lb_refined_patch_remove();
+
   if (lb_parameters.agrid <= 0.0) {
     runtimeErrorMsg()
         << "Lattice Boltzmann agrid not set when initializing fluid";
@@ -254,6 +365,8 @@ void lb_init(const LB_Parameters &lb_parameters) {
 
   /* prepare the halo communication */
   lb_prepare_communication(update_halo_comm, lblattice);
+  lb_prepare_push_communication(lblattice);
+  halo_populations_valid = false;
 
   /* initialize derived parameters */
   lb_reinit_parameters(lbpar);
@@ -323,271 +436,129 @@ void lb_reinit_parameters(LB_Parameters &lb_parameters) {
   }
 }
 
-/** Halo communication for push scheme */
+/** Halo communication for push scheme.
+ *  Only the 5 populations crossing a face of the local domain are sent,
+ *  using the datatypes from @ref lb_prepare_push_communication.
+ */
 static void halo_push_communication(LB_Fluid &lb_fluid,
                                     const Lattice &lb_lattice) {
-  Lattice::index_t index;
-  int x, y, z, count;
-  int rnode, snode;
-  double *buffer;
   MPI_Status status;
-
-  auto const yperiod = lb_lattice.halo_grid[0];
-  auto const zperiod = lb_lattice.halo_grid[0] * lb_lattice.halo_grid[1];
-
   auto const node_neighbors = calc_node_neighbors(comm_cart);
-
-  /***************
-   * X direction *
-   ***************/
-  count = 5 * lb_lattice.halo_grid[1] * lb_lattice.halo_grid[2];
-  std::vector<double> sbuf(count);
-  std::vector<double> rbuf(count);
-
-  /* send to right, recv from left i = 1, 7, 9, 11, 13 */
-  snode = node_neighbors[1];
-  rnode = node_neighbors[0];
-
-  buffer = sbuf.data();
-  index = get_linear_index(lb_lattice.grid[0] + 1, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      buffer[0] = lb_fluid[1][index];
-      buffer[1] = lb_fluid[7][index];
-      buffer[2] = lb_fluid[9][index];
-      buffer[3] = lb_fluid[11][index];
-      buffer[4] = lb_fluid[13][index];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(1, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      lb_fluid[1][index] = buffer[0];
-      lb_fluid[7][index] = buffer[1];
-      lb_fluid[9][index] = buffer[2];
-      lb_fluid[11][index] = buffer[3];
-      lb_fluid[13][index] = buffer[4];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  /* send to left, recv from right i = 2, 8, 10, 12, 14 */
-  snode = node_neighbors[0];
-  rnode = node_neighbors[1];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      buffer[0] = lb_fluid[2][index];
-      buffer[1] = lb_fluid[8][index];
-      buffer[2] = lb_fluid[10][index];
-      buffer[3] = lb_fluid[12][index];
-      buffer[4] = lb_fluid[14][index];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(lb_lattice.grid[0], 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-      lb_fluid[2][index] = buffer[0];
-      lb_fluid[8][index] = buffer[1];
-      lb_fluid[10][index] = buffer[2];
-      lb_fluid[12][index] = buffer[3];
-      lb_fluid[14][index] = buffer[4];
-      buffer += 5;
-
-      index += yperiod;
-    }
-  }
-
-  /***************
-   * Y direction *
-   ***************/
-  count = 5 * lb_lattice.halo_grid[0] * lb_lattice.halo_grid[2];
-  sbuf.resize(count);
-  rbuf.resize(count);
-
-  /* send to right, recv from left i = 3, 7, 10, 15, 17 */
-  snode = node_neighbors[3];
-  rnode = node_neighbors[2];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, lb_lattice.grid[1] + 1, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[3][index];
-      buffer[1] = lb_fluid[7][index];
-      buffer[2] = lb_fluid[10][index];
-      buffer[3] = lb_fluid[15][index];
-      buffer[4] = lb_fluid[17][index];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lb_lattice.halo_grid[0];
-  }
-
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, 1, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[3][index] = buffer[0];
-      lb_fluid[7][index] = buffer[1];
-      lb_fluid[10][index] = buffer[2];
-      lb_fluid[15][index] = buffer[3];
-      lb_fluid[17][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lb_lattice.halo_grid[0];
-  }
-
-  /* send to left, recv from right i = 4, 8, 9, 16, 18 */
-  snode = node_neighbors[2];
-  rnode = node_neighbors[3];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[4][index];
-      buffer[1] = lb_fluid[8][index];
-      buffer[2] = lb_fluid[9][index];
-      buffer[3] = lb_fluid[16][index];
-      buffer[4] = lb_fluid[18][index];
-      buffer += 5;
-
-      ++index;
-    }
-    index += zperiod - lb_lattice.halo_grid[0];
+  auto const base = lb_fluid[0].data();
+
+  for (int dir = 0; dir < 3; dir++) {
+    Utils::Vector3i right_halo{};
+    Utils::Vector3i right_boundary{};
+    Utils::Vector3i left_boundary{};
+    right_halo[dir] = lb_lattice.grid[dir] + 1;
+    right_boundary[dir] = lb_lattice.grid[dir];
+    left_boundary[dir] = 1;
+
+    /* send to right, recv from left */
+    MPI_Sendrecv(base + get_linear_index(right_halo, lb_lattice.halo_grid), 1,
+                 push_halo_types[2 * dir + 1], node_neighbors[2 * dir + 1],
+                 REQ_HALO_SPREAD,
+                 base + get_linear_index(left_boundary, lb_lattice.halo_grid),
+                 1, push_halo_types[2 * dir + 1], node_neighbors[2 * dir],
+                 REQ_HALO_SPREAD, comm_cart, &status);
+
+    /* send to left, recv from right */
+    MPI_Sendrecv(base, 1, push_halo_types[2 * dir], node_neighbors[2 * dir],
+                 REQ_HALO_SPREAD,
+                 base +
+                     get_linear_index(right_boundary, lb_lattice.halo_grid),
+                 1, push_halo_types[2 * dir], node_neighbors[2 * dir + 1],
+                 REQ_HALO_SPREAD, comm_cart, &status);
   }
+}
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, lb_lattice.grid[1], 0, lb_lattice.halo_grid);
-  for (z = 0; z < lb_lattice.halo_grid[2]; z++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[4][index] = buffer[0];
-      lb_fluid[8][index] = buffer[1];
-      lb_fluid[9][index] = buffer[2];
-      lb_fluid[16][index] = buffer[3];
-      lb_fluid[18][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
+void lb_clear_halo_force_density(std::vector<LB_FluidNode> &lb_fields,
+                                 const Lattice &lb_lattice) {
+  auto const &halo_grid = lb_lattice.halo_grid;
+  for (int z = 0; z < halo_grid[2]; z++) {
+    for (int y = 0; y < halo_grid[1]; y++) {
+      auto const interior_row = (z > 0 and z <= lb_lattice.grid[2]) and
+                                (y > 0 and y <= lb_lattice.grid[1]);
+      /* only the first and last site of interior rows are halo sites */
+      auto const step = interior_row ? lb_lattice.grid[0] + 1 : 1;
+      for (int x = 0; x < halo_grid[0]; x += step) {
+        lb_fields[get_linear_index(x, y, z, halo_grid)].force_density = {};
+      }
     }
-    index += zperiod - lb_lattice.halo_grid[0];
   }
+}
 
-  /***************
-   * Z direction *
-   ***************/
-  count = 5 * lb_lattice.halo_grid[0] * lb_lattice.halo_grid[1];
-  sbuf.resize(count);
-  rbuf.resize(count);
-
-  /* send to right, recv from left i = 5, 11, 14, 15, 18 */
-  snode = node_neighbors[5];
-  rnode = node_neighbors[4];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, lb_lattice.grid[2] + 1, lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[5][index];
-      buffer[1] = lb_fluid[11][index];
-      buffer[2] = lb_fluid[14][index];
-      buffer[3] = lb_fluid[15][index];
-      buffer[4] = lb_fluid[18][index];
-      buffer += 5;
-
-      ++index;
-    }
-  }
+void lb_collect_halo_force_density(std::vector<LB_FluidNode> &lb_fields,
+                                   const Lattice &lb_lattice) {
+  MPI_Status status;
+  auto const &halo_grid = lb_lattice.halo_grid;
+  auto const node_neighbors = calc_node_neighbors(comm_cart);
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, 0, 1, lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[5][index] = buffer[0];
-      lb_fluid[11][index] = buffer[1];
-      lb_fluid[14][index] = buffer[2];
-      lb_fluid[15][index] = buffer[3];
-      lb_fluid[18][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
+  std::vector<double> sbuf;
+  std::vector<double> rbuf;
+
+  for (int dir = 0; dir < 3; dir++) {
+    /* the halo sites of the directions already treated have been
+       added to the interior, so only the interior range is sent for
+       them, the full range including the halo otherwise */
+    Utils::Vector3i begin{};
+    Utils::Vector3i end = halo_grid;
+    for (int i = 0; i < dir; i++) {
+      begin[i] = 1;
+      end[i] = lb_lattice.grid[i] + 1;
     }
-  }
 
-  /* send to left, recv from right i = 6, 12, 13, 16, 17 */
-  snode = node_neighbors[4];
-  rnode = node_neighbors[5];
-
-  buffer = sbuf.data();
-  index = get_linear_index(0, 0, 0, lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      buffer[0] = lb_fluid[6][index];
-      buffer[1] = lb_fluid[12][index];
-      buffer[2] = lb_fluid[13][index];
-      buffer[3] = lb_fluid[16][index];
-      buffer[4] = lb_fluid[17][index];
-      buffer += 5;
-
-      ++index;
-    }
-  }
+    /* send a halo plane to snode, add the plane received
+       from rnode to the boundary plane recv_plane */
+    auto exchange = [&](int send_plane, int recv_plane, int snode, int rnode) {
+      auto begin_send = begin, end_send = end;
+      begin_send[dir] = send_plane;
+      end_send[dir] = send_plane + 1;
+      auto const count = 3 * (end_send[0] - begin_send[0]) *
+                         (end_send[1] - begin_send[1]) *
+                         (end_send[2] - begin_send[2]);
+      sbuf.resize(count);
+      rbuf.resize(count);
+
+      auto buffer = sbuf.data();
+      Utils::Vector3i ind;
+      for (ind[2] = begin_send[2]; ind[2] < end_send[2]; ind[2]++) {
+        for (ind[1] = begin_send[1]; ind[1] < end_send[1]; ind[1]++) {
+          for (ind[0] = begin_send[0]; ind[0] < end_send[0]; ind[0]++) {
+            auto &force_density =
+                lb_fields[get_linear_index(ind, halo_grid)].force_density;
+            std::copy(force_density.begin(), force_density.end(), buffer);
+            force_density = {};
+            buffer += 3;
+          }
+        }
+      }
 
-  MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
-               rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
-               comm_cart, &status);
-
-  buffer = rbuf.data();
-  index = get_linear_index(0, 0, lb_lattice.grid[2], lb_lattice.halo_grid);
-  for (y = 0; y < lb_lattice.halo_grid[1]; y++) {
-    for (x = 0; x < lb_lattice.halo_grid[0]; x++) {
-      lb_fluid[6][index] = buffer[0];
-      lb_fluid[12][index] = buffer[1];
-      lb_fluid[13][index] = buffer[2];
-      lb_fluid[16][index] = buffer[3];
-      lb_fluid[17][index] = buffer[4];
-      buffer += 5;
-
-      ++index;
-    }
+      MPI_Sendrecv(sbuf.data(), count, MPI_DOUBLE, snode, REQ_HALO_SPREAD,
+                   rbuf.data(), count, MPI_DOUBLE, rnode, REQ_HALO_SPREAD,
+                   comm_cart, &status);
+
+      buffer = rbuf.data();
+      auto begin_recv = begin_send, end_recv = end_send;
+      begin_recv[dir] = recv_plane;
+      end_recv[dir] = recv_plane + 1;
+      for (ind[2] = begin_recv[2]; ind[2] < end_recv[2]; ind[2]++) {
+        for (ind[1] = begin_recv[1]; ind[1] < end_recv[1]; ind[1]++) {
+          for (ind[0] = begin_recv[0]; ind[0] < end_recv[0]; ind[0]++) {
+            lb_fields[get_linear_index(ind, halo_grid)].force_density +=
+                Utils::Vector3d{buffer[0], buffer[1], buffer[2]};
+            buffer += 3;
+          }
+        }
+      }
+    };
+
+    /* send to right, recv from left */
+    exchange(lb_lattice.grid[dir] + 1, 1, node_neighbors[2 * dir + 1],
+             node_neighbors[2 * dir]);
+    /* send to left, recv from right */
+    exchange(0, lb_lattice.grid[dir], node_neighbors[2 * dir],
+             node_neighbors[2 * dir + 1]);
   }
 }
 
@@ -610,6 +581,7 @@ void lb_sanity_checks(const LB_Parameters &lb_parameters) {
   if (cell_structure.type != CELL_STRUCTURE_DOMDEC) {
     runtimeErrorMsg() << "LB requires domain-decomposition cellsystem";
   }
+  lb_refined_patch_sanity_checks();
 }
 
 uint64_t lb_fluid_get_rng_state() {
@@ -682,6 +654,72 @@ void lb_prepare_communication(HaloCommunicator &halo_comm,
   release_halo_communication(&comm);
 }
 
+void lb_prepare_push_communication(const Lattice &lb_lattice) {
+  /* populations crossing the left and the right face in each direction */
+  const std::array<std::array<int, 5>, 6> populations = {
+      {{{2, 8, 10, 12, 14}},
+       {{1, 7, 9, 11, 13}},
+       {{4, 8, 9, 16, 18}},
+       {{3, 7, 10, 15, 17}},
+       {{6, 12, 13, 16, 17}},
+       {{5, 11, 14, 15, 18}}}};
+  auto const &halo_grid = lb_lattice.halo_grid;
+
+  for (int dir = 0; dir < 3; dir++) {
+    /* one population on a lattice plane perpendicular to dir */
+    MPI_Datatype plane;
+    switch (dir) {
+    case 0:
+      MPI_Type_vector(halo_grid[1] * halo_grid[2], 1, halo_grid[0], MPI_DOUBLE,
+                      &plane);
+      break;
+    case 1:
+      MPI_Type_vector(halo_grid[2], halo_grid[0], halo_grid[0] * halo_grid[1],
+                      MPI_DOUBLE, &plane);
+      break;
+    default:
+      MPI_Type_contiguous(halo_grid[0] * halo_grid[1], MPI_DOUBLE, &plane);
+    }
+
+    /* the populations are stored one after another (see lb_realloc_fluid) */
+    for (int side = 0; side < 2; side++) {
+      auto &type = push_halo_types[2 * dir + side];
+      if (type != MPI_DATATYPE_NULL) {
+        MPI_Type_free(&type);
+      }
+
+      std::array<int, 5> block_lengths;
+      std::array<MPI_Aint, 5> displacements;
+      for (int j = 0; j < 5; j++) {
+        block_lengths[j] = 1;
+        displacements[j] =
+            static_cast<MPI_Aint>(populations[2 * dir + side][j]) *
+            lb_lattice.halo_grid_volume * sizeof(double);
+      }
+      MPI_Type_create_hindexed(5, block_lengths.data(), displacements.data(),
+                               plane, &type);
+      MPI_Type_commit(&type);
+    }
+
+    MPI_Type_free(&plane);
+  }
+}
+
+void lb_update_halo_populations() {
+  if (halo_populations_valid)
+    return;
+
+  halo_communication(&update_halo_comm,
+                     reinterpret_cast<char *>(lbfluid[0].data()));
+  halo_populations_valid = true;
+
+#ifdef ADDITIONAL_CHECKS
+  lb_check_halo_regions(lbfluid, lblattice);
+#endif
+}
+
+void lb_invalidate_halo_populations() { halo_populations_valid = false; }
+
 /***********************************************************************/
 /** \name Mapping between hydrodynamic fields and particle populations */
 /***********************************************************************/
@@ -782,8 +820,8 @@ std::array<double, 19> lb_calc_modes(Lattice::index_t index,
 }
 
 template <typename T>
-inline std::array<T, 19> lb_relax_modes(Lattice::index_t index,
-                                        const std::array<T, 19> &modes,
+inline std::array<T, 19> lb_relax_modes(const std::array<T, 19> &modes,
+                                        const Utils::Vector3d &force_density,
                                         const LB_Parameters &lb_parameters) {
   T density, momentum_density[3], stress_eq[6];
 
@@ -792,9 +830,9 @@ inline std::array<T, 19> lb_relax_modes(Lattice::index_t index,
    * equilibrium value */
   density = modes[0] + lb_parameters.density;
 
-  momentum_density[0] = modes[1] + 0.5 * lbfields[index].force_density[0];
-  momentum_density[1] = modes[2] + 0.5 * lbfields[index].force_density[1];
-  momentum_density[2] = modes[3] + 0.5 * lbfields[index].force_density[2];
+  momentum_density[0] = modes[1] + 0.5 * force_density[0];
+  momentum_density[1] = modes[2] + 0.5 * force_density[1];
+  momentum_density[2] = modes[3] + 0.5 * force_density[2];
 
   using Utils::sqr;
   auto const momentum_density2 = sqr(momentum_density[0]) +
@@ -878,11 +916,9 @@ lb_thermalize_modes(Lattice::index_t index, const std::array<T, 19> &modes,
 }
 
 template <typename T>
-std::array<T, 19> lb_apply_forces(Lattice::index_t index,
-                                  const std::array<T, 19> &modes,
-                                  const LB_Parameters &lb_parameters,
-                                  const std::vector<LB_FluidNode> &lb_fields) {
-  const auto &f = lb_fields[index].force_density;
+std::array<T, 19> lb_apply_forces(const std::array<T, 19> &modes,
+                                  const Utils::Vector3d &f,
+                                  const LB_Parameters &lb_parameters) {
 
   auto const density = modes[0] + lb_parameters.density;
 
@@ -936,6 +972,16 @@ std::array<T, 19> lb_calc_n_from_m(const std::array<T, 19> &modes) {
   return ret;
 }
 
+std::array<double, 19>
+lb_calc_collided_populations(std::array<double, 19> const &modes,
+                             Utils::Vector3d const &force_density,
+                             LB_Parameters const &lb_parameters) {
+  auto const relaxed_modes =
+      lb_relax_modes(modes, force_density, lb_parameters);
+  return lb_calc_n_from_m(
+      lb_apply_forces(relaxed_modes, force_density, lb_parameters));
+}
+
 template <typename T>
 inline void lb_stream(LB_Fluid &lbfluid, Lattice::index_t index,
                       const std::array<T, 19> &populations,
@@ -953,57 +999,42 @@ inline void lb_stream(LB_Fluid &lbfluid, Lattice::index_t index,
 /* Collisions and streaming (push scheme) */
 inline void lb_collide_stream() {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
-  /* loop over all lattice cells (halo excluded) */
 #ifdef LB_BOUNDARIES
   for (auto &lbboundary : LBBoundaries::lbboundaries) {
     (*lbboundary).reset_force();
   }
 #endif // LB_BOUNDARIES
 
-  Lattice::index_t index = lblattice.halo_offset;
-  for (int z = 1; z <= lblattice.grid[2]; z++) {
-    for (int y = 1; y <= lblattice.grid[1]; y++) {
-      for (int x = 1; x <= lblattice.grid[0]; x++) {
-        // as we only want to apply this to non-boundary nodes we can throw out
-        // the if-clause if we have a non-bounded domain
-#ifdef LB_BOUNDARIES
-        if (!lbfields[index].boundary)
-#endif // LB_BOUNDARIES
-        {
-          /* calculate modes locally */
-          auto const modes = lb_calc_modes(index, lbfluid);
+  /* loop over all fluid nodes, boundary nodes are not in the list */
+  for (auto const index : lb_fluid_nodes) {
+    /* calculate modes locally */
+    auto const modes = lb_calc_modes(index, lbfluid);
 
-          /* deterministic collisions */
-          auto const relaxed_modes = lb_relax_modes(index, modes, lbpar);
+    /* deterministic collisions */
+    auto const relaxed_modes =
+        lb_relax_modes(modes, lbfields[index].force_density, lbpar);
 
-          /* fluctuating hydrodynamics */
-          auto const thermalized_modes = lb_thermalize_modes(
-              index, relaxed_modes, lbpar, rng_counter_fluid);
+    /* fluctuating hydrodynamics */
+    auto const thermalized_modes =
+        lb_thermalize_modes(index, relaxed_modes, lbpar, rng_counter_fluid);
 
-          /* apply forces */
-          auto const modes_with_forces =
-              lb_apply_forces(index, thermalized_modes, lbpar, lbfields);
+    /* apply forces */
+    auto const modes_with_forces = lb_apply_forces(
+        thermalized_modes, lbfields[index].force_density, lbpar);
 
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
-          // Safeguard the node forces so that we can later use them for the IBM
-          // particle update
-          lbfields[index].force_density_buf = lbfields[index].force_density;
+    // Safeguard the node forces so that we can later use them for the IBM
+    // particle update
+    lbfields[index].force_density_buf = lbfields[index].force_density;
 #endif
 
-          /* reset the force density */
-          lbfields[index].force_density = lbpar.ext_force_density;
-
-          auto const populations = lb_calc_n_from_m(modes_with_forces);
+    /* reset the force density */
+    lbfields[index].force_density = lbpar.ext_force_density;
 
-          /* transform back to populations and streaming */
-          lb_stream(lbfluid_post, index, populations, lblattice);
-        }
+    auto const populations = lb_calc_n_from_m(modes_with_forces);
 
-        ++index; /* next node */
-      }
-      index += 2; /* skip halo region */
-    }
-    index += 2 * lblattice.halo_grid[0]; /* skip halo region */
+    /* transform back to populations and streaming */
+    lb_stream(lbfluid_post, index, populations, lblattice);
   }
 
   /* exchange halo regions */
@@ -1011,18 +1042,15 @@ inline void lb_collide_stream() {
 
 #ifdef LB_BOUNDARIES
   /* boundary conditions for links */
-  lb_bounce_back(lbfluid_post, lbpar, lbfields);
+  lb_bounce_back(lbfluid_post, lbpar);
 #endif // LB_BOUNDARIES
 
   /* swap the pointers for old and new population fields */
   std::swap(lbfluid, lbfluid_post);
 
-  halo_communication(&update_halo_comm,
-                     reinterpret_cast<char *>(lbfluid[0].data()));
-
-#ifdef ADDITIONAL_CHECKS
-  lb_check_halo_regions(lbfluid, lblattice);
-#endif
+  /* the halo of the new populations is only communicated when it is
+     read, see lb_update_halo_populations() */
+  halo_populations_valid = false;
 }
 
 /** Update the lattice Boltzmann fluid.
@@ -1038,7 +1066,9 @@ void lattice_boltzmann_update() {
   if (fluidstep >= factor) {
     fluidstep = 0;
 
+    lb_refined_patch_prepare_update();
     lb_collide_stream();
+    lb_refined_patch_update();
   }
 }
 
@@ -1329,72 +1359,26 @@ Utils::Vector6d lb_calc_stress(std::array<double, 19> const &modes,
 }
 
 #ifdef LB_BOUNDARIES
-void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters,
-                    const std::vector<LB_FluidNode> &lb_fields) {
-  int k, i, l;
-  int yperiod = lblattice.halo_grid[0];
-  int zperiod = lblattice.halo_grid[0] * lblattice.halo_grid[1];
-  int next[19];
-  double population_shift;
-  next[0] = 0;                     // ( 0, 0, 0) =
-  next[1] = 1;                     // ( 1, 0, 0) +
-  next[2] = -1;                    // (-1, 0, 0)
-  next[3] = yperiod;               // ( 0, 1, 0) +
-  next[4] = -yperiod;              // ( 0,-1, 0)
-  next[5] = zperiod;               // ( 0, 0, 1) +
-  next[6] = -zperiod;              // ( 0, 0,-1)
-  next[7] = (1 + yperiod);         // ( 1, 1, 0) +
-  next[8] = -(1 + yperiod);        // (-1,-1, 0)
-  next[9] = (1 - yperiod);         // ( 1,-1, 0)
-  next[10] = -(1 - yperiod);       // (-1, 1, 0) +
-  next[11] = (1 + zperiod);        // ( 1, 0, 1) +
-  next[12] = -(1 + zperiod);       // (-1, 0,-1)
-  next[13] = (1 - zperiod);        // ( 1, 0,-1)
-  next[14] = -(1 - zperiod);       // (-1, 0, 1) +
-  next[15] = (yperiod + zperiod);  // ( 0, 1, 1) +
-  next[16] = -(yperiod + zperiod); // ( 0,-1,-1)
-  next[17] = (yperiod - zperiod);  // ( 0, 1,-1)
-  next[18] = -(yperiod - zperiod); // ( 0,-1, 1) +
-  int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
-                   9, 12, 11, 14, 13, 16, 15, 18, 17};
-
-  /* bottom-up sweep */
-  for (int z = 0; z < lblattice.grid[2] + 2; z++) {
-    for (int y = 0; y < lblattice.grid[1] + 2; y++) {
-      for (int x = 0; x < lblattice.grid[0] + 2; x++) {
-        k = get_linear_index(x, y, z, lblattice.halo_grid);
-
-        if (lb_fields[k].boundary) {
-          for (i = 0; i < 19; i++) {
-            population_shift = 0;
-            for (l = 0; l < 3; l++) {
-              population_shift -= lb_parameters.density * 2 * D3Q19::c[i][l] *
-                                  D3Q19::w[i] * lb_fields[k].slip_velocity[l] /
-                                  D3Q19::c_sound_sq<double>;
-            }
-
-            if (x - D3Q19::c[i][0] > 0 &&
-                x - D3Q19::c[i][0] < lblattice.grid[0] + 1 &&
-                y - D3Q19::c[i][1] > 0 &&
-                y - D3Q19::c[i][1] < lblattice.grid[1] + 1 &&
-                z - D3Q19::c[i][2] > 0 &&
-                z - D3Q19::c[i][2] < lblattice.grid[2] + 1) {
-              if (!lb_fields[k - next[i]].boundary) {
-                for (l = 0; l < 3; l++) {
-                  (*LBBoundaries::lbboundaries[lb_fields[k].boundary - 1])
-                      .force()[l] += // TODO
-                      (2 * lbfluid[i][k] + population_shift) * D3Q19::c[i][l];
-                }
-                lbfluid[reverse[i]][k - next[i]] =
-                    lbfluid[i][k] + population_shift;
-              } else {
-                lbfluid[reverse[i]][k - next[i]] = lbfluid[i][k] = 0.0;
-              }
-            }
-          }
-        }
-      }
+void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters) {
+  static constexpr int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
+                                    9, 12, 11, 14, 13, 16, 15, 18, 17};
+
+  for (auto const &link : lb_boundary_links) {
+    auto const i = link.direction;
+    auto const k = link.boundary_node;
+    auto const population_shift =
+        lb_parameters.density * link.population_shift;
+
+    auto &force = (*LBBoundaries::lbboundaries[link.boundary - 1]).force();
+    for (int l = 0; l < 3; l++) {
+      force[l] += (2 * lbfluid[i][k] + population_shift) * D3Q19::c[i][l];
     }
+    lbfluid[reverse[i]][link.source_node] = lbfluid[i][k] + population_shift;
+  }
+
+  for (auto const &link : lb_boundary_boundary_links) {
+    lbfluid[reverse[link.direction]][link.source_node] =
+        lbfluid[link.direction][link.boundary_node] = 0.0;
   }
 }
 #endif
@@ -218,6 +218,21 @@ Utils::Vector6d lb_calc_stress(std::array<double, 19> const &modes,
 std::array<double, 19> lb_calc_modes(Lattice::index_t index,
                                      const LB_Fluid &lb_fluid);
 
+/** Deterministic collision of the modes of a node.
+ *
+ *  Relaxes the modes and applies the force density, without thermal
+ *  fluctuations.
+ *
+ *  @param modes          Modes of the node
+ *  @param force_density  Force density on the node
+ *  @param lb_parameters  Parameters of the lattice
+ *  @retval Post-collision populations of the node.
+ */
+std::array<double, 19>
+lb_calc_collided_populations(std::array<double, 19> const &modes,
+                             Utils::Vector3d const &force_density,
+                             LB_Parameters const &lb_parameters);
+
 /**
  * @brief Get the populations as a function of density, flux density and stress.
  * @param density fluid density
@@ -248,15 +263,31 @@ uint64_t lb_fluid_get_rng_state();
 void lb_fluid_set_rng_state(uint64_t counter);
 void lb_prepare_communication(HaloCommunicator &halo_comm,
                               const Lattice &lb_lattice);
+/** Set up the MPI datatypes of the halo push communication,
+ *  which only exchanges the populations crossing the faces
+ *  of the local domain.
+ */
+void lb_prepare_push_communication(const Lattice &lb_lattice);
+
+/** Communicate the populations on the halo sites if they are out of date.
+ *  The collide-stream step does not need the halo, so it is only
+ *  exchanged before it is read, e.g. by the interpolation for the
+ *  particle coupling. Has to be called on all nodes.
+ */
+void lb_update_halo_populations();
+/** Mark the populations on the halo sites as out of date,
+ *  e.g. after populations were set on individual nodes.
+ */
+void lb_invalidate_halo_populations();
 
 #ifdef LB_BOUNDARIES
 /** Bounce back boundary conditions.
  * The populations that have propagated into a boundary node
  * are bounced back to the node they came from. This results
  * in no slip boundary conditions, cf. @cite ladd01a.
+ * Only the links precomputed by @ref lb_rebuild_node_lists are visited.
  */
-void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters,
-                    const std::vector<LB_FluidNode> &lb_fields);
+void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters);
 
 #endif /* LB_BOUNDARIES */
 
@@ -267,8 +298,31 @@ void lb_collect_boundary_forces(double *result);
 void lb_initialize_fields(std::vector<LB_FluidNode> &fields,
                           LB_Parameters const &lb_parameters,
                           Lattice const &lb_lattice);
+
+/** Rebuild the list of fluid nodes and of the links into boundary nodes.
+ *  Has to be called whenever the boundary flags of @p lb_fields change.
+ *  @param lb_fields   Fluid nodes including the boundary flags
+ *  @param lb_lattice  Lattice instance
+ */
+void lb_rebuild_node_lists(const std::vector<LB_FluidNode> &lb_fields,
+                           const Lattice &lb_lattice);
 void lb_on_param_change(LBParam param);
 
+/** Reset the force density on the halo sites of the lattice. */
+void lb_clear_halo_force_density(std::vector<LB_FluidNode> &lb_fields,
+                                 const Lattice &lb_lattice);
+
+/** Add the force density on the halo sites to the corresponding
+ *  sites of the neighboring nodes and reset it on the halo.
+ *  This is the reverse of the halo communication and needed when
+ *  forces are spread from local positions only, e.g. by the quadratic
+ *  interpolation scheme. Has to be called on all nodes.
+ *  @param lb_fields   Fluid nodes
+ *  @param lb_lattice  Lattice instance
+ */
+void lb_collect_halo_force_density(std::vector<LB_FluidNode> &lb_fields,
+                                   const Lattice &lb_lattice);
+
 /*@}*/
 
 #endif /* _LB_H */
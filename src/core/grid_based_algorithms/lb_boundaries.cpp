@@ -249,6 +249,8 @@ void lb_init_boundaries() {
         }
       }
     }
+
+    lb_rebuild_node_lists(lbfields, lblattice);
 #endif
   }
 }
@@ -23,6 +23,9 @@
 #include "grid.hpp"
 #include "lb.hpp"
 #include "lb_interpolation.hpp"
+#include "lb_refinement.hpp"
+
+#include <functional>
 
 using Utils::get_linear_index;
 
@@ -115,10 +118,13 @@ void mpi_lb_set_population(Utils::Vector3i const &index,
         get_linear_index(lblattice.local_index(index), lblattice.halo_grid);
     lb_set_population(linear_index, population);
   });
+  lb_invalidate_halo_populations();
 }
 
 REGISTER_CALLBACK(mpi_lb_set_population)
 
+REGISTER_CALLBACK(lb_update_halo_populations)
+
 void mpi_lb_set_force_density(Utils::Vector3i const &index,
                               Utils::Vector3d const &force_density) {
   detail::lb_set(index, [&](auto index) {
@@ -148,6 +154,25 @@ auto mpi_lb_get_stress(Utils::Vector3i const &index) {
 
 REGISTER_CALLBACK_ONE_RANK(mpi_lb_get_stress)
 
+namespace {
+int mpi_lb_set_refined_patch_slave(Utils::Vector3i begin,
+                                   Utils::Vector3i end) {
+  return lb_refined_patch_set(begin, end);
+}
+} // namespace
+
+REGISTER_CALLBACK_REDUCTION(mpi_lb_set_refined_patch_slave, std::plus<int>())
+
+int mpi_lb_set_refined_patch(Utils::Vector3i const &begin,
+                             Utils::Vector3i const &end) {
+  return mpi_call(Communication::Result::reduction, std::plus<int>(),
+                  mpi_lb_set_refined_patch_slave, begin, end);
+}
+
+REGISTER_CALLBACK(lb_refined_patch_remove)
+
+void mpi_lb_remove_refined_patch() { mpi_call_all(lb_refined_patch_remove); }
+
 void mpi_bcast_lb_params_slave(LBParam field, LB_Parameters const &params) {
   lbpar = params;
   lb_on_param_change(field);
@@ -40,6 +40,14 @@ void mpi_lb_set_population(Utils::Vector3i const &index,
 void mpi_lb_set_force_density(Utils::Vector3i const &index,
                               Utils::Vector3d const &force_density);
 
+/** @brief Set the refined patch on all ranks.
+ *  @return Number of ranks holding the fine lattice.
+ */
+int mpi_lb_set_refined_patch(Utils::Vector3i const &begin,
+                             Utils::Vector3i const &end);
+/** @brief Remove the refined patch on all ranks. */
+void mpi_lb_remove_refined_patch();
+
 /* collective sync functions */
 void mpi_bcast_lb_params(LBParam field);
 
@@ -40,4 +40,15 @@ enum class LBParam {
   TAU                /**< LB time step */
 };
 
+/** @brief Fluid fields written by the parallel VTK writer.
+ *
+ *  The values can be combined as a bitmask.
+ */
+enum LBVTKField : int {
+  LB_VTK_DENSITY = 1 << 0,  /**< fluid density */
+  LB_VTK_VELOCITY = 1 << 1, /**< fluid velocity */
+  LB_VTK_STRESS = 1 << 2,   /**< fluid stress tensor */
+  LB_VTK_BOUNDARY = 1 << 3  /**< boundary flag */
+};
+
 #endif /* LB_CONSTANTS_HPP */
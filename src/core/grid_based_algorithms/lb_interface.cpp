@@ -27,6 +27,7 @@
 #include "lb.hpp"
 #include "lb_collective_interface.hpp"
 #include "lb_interpolation.hpp"
+#include "lb_vtk.hpp"
 #include "lbgpu.hpp"
 
 #include <utils/index.hpp>
@@ -113,8 +114,7 @@ void lb_lbfluid_sanity_checks() {
 void lb_lbfluid_on_integration_start() {
   lb_lbfluid_sanity_checks();
   if (lattice_switch == ActiveLB::CPU) {
-    halo_communication(&update_halo_comm,
-                       reinterpret_cast<char *>(lbfluid[0].data()));
+    lb_update_halo_populations();
   }
 }
 
@@ -463,6 +463,32 @@ void lb_lbfluid_set_lattice_switch(ActiveLB local_lattice_switch) {
   mpi_bcast_parameter(FIELD_LATTICE_SWITCH);
 }
 
+void lb_lbfluid_set_refined_patch(const Utils::Vector3i &begin,
+                                  const Utils::Vector3i &end) {
+  if (lattice_switch != ActiveLB::CPU) {
+    throw std::runtime_error(
+        "LB grid refinement is only implemented for the CPU LB.");
+  }
+  if (not(begin >= Utils::Vector3i{} and begin < end and
+          end <= lblattice.global_grid)) {
+    throw std::invalid_argument(
+        "The refined patch has to be a non-empty region of the LB lattice.");
+  }
+  if (mpi_lb_set_refined_patch(begin, end) != 1) {
+    mpi_lb_remove_refined_patch();
+    throw std::runtime_error("The refined patch and one node around it have "
+                             "to be in the local domain of a single rank.");
+  }
+}
+
+void lb_lbfluid_remove_refined_patch() {
+  if (lattice_switch != ActiveLB::CPU) {
+    throw std::runtime_error(
+        "LB grid refinement is only implemented for the CPU LB.");
+  }
+  mpi_lb_remove_refined_patch();
+}
+
 void lb_lbfluid_set_kT(double kT) {
   if (lattice_switch == ActiveLB::GPU) {
 #ifdef CUDA
@@ -629,6 +655,36 @@ void lb_lbfluid_print_vtk_velocity(const std::string &filename,
   fclose(fp);
 }
 
+void lb_lbfluid_write_vtk(const std::string &basename, int fields,
+                          std::vector<int> bb1, std::vector<int> bb2,
+                          int stride) {
+  if (lattice_switch != ActiveLB::CPU) {
+    throw std::runtime_error(
+        "Parallel VTK output is only implemented for the CPU LB.");
+  }
+  if (stride < 1) {
+    throw std::invalid_argument("VTK output stride has to be positive.");
+  }
+  if (bb1.size() != 3 or bb2.size() != 3) {
+    throw std::invalid_argument("VTK output region needs three dimensions.");
+  }
+
+  Utils::Vector3i bb_low{};
+  Utils::Vector3i bb_high = lblattice.global_grid - Utils::Vector3i{1, 1, 1};
+  if (std::none_of(bb1.begin(), bb1.end(), [](int i) { return i == -1; }) and
+      std::none_of(bb2.begin(), bb2.end(), [](int i) { return i == -1; })) {
+    for (int i = 0; i < 3; i++) {
+      bb_low[i] = std::min(bb1[i], bb2[i]);
+      bb_high[i] = std::max(bb1[i], bb2[i]);
+      if (bb_low[i] < 0 or bb_high[i] >= lblattice.global_grid[i]) {
+        throw std::out_of_range("VTK output region exceeds the LB lattice.");
+      }
+    }
+  }
+
+  mpi_lb_write_vtk_parallel(basename, fields, bb_low, bb_high, stride);
+}
+
 void lb_lbfluid_print_boundary(const std::string &filename) {
   FILE *fp = fopen(filename.c_str(), "w");
 
@@ -1233,11 +1289,10 @@ Utils::Vector3d lb_lbfluid_calc_fluid_momentum() {
 const Utils::Vector3d
 lb_lbfluid_get_interpolated_velocity(const Utils::Vector3d &pos) {
   auto const folded_pos = folded_position(pos, box_geo);
-  auto const interpolation_order = lb_lbinterpolation_get_interpolation_order();
   if (lattice_switch == ActiveLB::GPU) {
 #ifdef CUDA
     Utils::Vector3d interpolated_u{};
-    switch (interpolation_order) {
+    switch (lb_lbinterpolation_get_interpolation_order()) {
     case (InterpolationOrder::linear):
       lb_get_interpolated_velocity_gpu<8>(folded_pos.data(),
                                           interpolated_u.data(), 1);
@@ -1251,14 +1306,9 @@ lb_lbfluid_get_interpolated_velocity(const Utils::Vector3d &pos) {
 #endif
   }
   if (lattice_switch == ActiveLB::CPU) {
-    switch (interpolation_order) {
-    case (InterpolationOrder::quadratic):
-      throw std::runtime_error("The non-linear interpolation scheme is not "
-                               "implemented for the CPU LB.");
-    case (InterpolationOrder::linear):
-      return mpi_call(::Communication::Result::one_rank,
-                      mpi_lb_get_interpolated_velocity, folded_pos);
-    }
+    mpi_call_all(lb_update_halo_populations);
+    return mpi_call(::Communication::Result::one_rank,
+                    mpi_lb_get_interpolated_velocity, folded_pos);
   }
   throw NoLBActive();
 }
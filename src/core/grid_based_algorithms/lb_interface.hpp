@@ -129,6 +129,24 @@ void lb_lbfluid_set_ext_force_density(const Utils::Vector3d &force_density);
  */
 void lb_lbfluid_set_kT(double kT);
 
+/**
+ * @brief Cover a region of the CPU LB lattice with a refined patch.
+ *
+ * The lattice spacing and time step of the patch are halved. The patch
+ * and one layer of nodes around it have to be in the local domain of a
+ * single rank.
+ *
+ * @param begin  First node of the patch
+ * @param end    Node after the last one of the patch
+ */
+void lb_lbfluid_set_refined_patch(const Utils::Vector3i &begin,
+                                  const Utils::Vector3i &end);
+
+/**
+ * @brief Remove the refined patch of the CPU LB.
+ */
+void lb_lbfluid_remove_refined_patch();
+
 /**
  * @brief Perform LB parameter and boundary velocity checks.
  */
@@ -229,6 +247,22 @@ void lb_lbfluid_print_vtk_velocity(const std::string &filename,
                                    std::vector<int> = {-1, -1, -1},
                                    std::vector<int> = {-1, -1, -1});
 
+/** @brief Write fluid fields of the CPU LB in parallel.
+ *
+ *  Each rank writes its part of the region as a binary VTK image data
+ *  piece, which are referenced by the index file <tt>basename.pvti</tt>.
+ *
+ *  @param basename  Output path without extension
+ *  @param fields    Bitmask of @ref LBVTKField values
+ *  @param bb1       Corner of the region (global node index),
+ *                   <tt>{-1, -1, -1}</tt> for the full lattice
+ *  @param bb2       Opposite corner of the region (inclusive)
+ *  @param stride    Only every @p stride-th node in each direction is written
+ */
+void lb_lbfluid_write_vtk(const std::string &basename, int fields,
+                          std::vector<int> bb1 = {-1, -1, -1},
+                          std::vector<int> bb2 = {-1, -1, -1}, int stride = 1);
+
 void lb_lbfluid_print_boundary(const std::string &filename);
 void lb_lbfluid_print_velocity(const std::string &filename);
 
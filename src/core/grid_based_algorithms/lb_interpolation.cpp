@@ -23,6 +23,7 @@
 #include "grid.hpp"
 #include "grid_based_algorithms/lattice.hpp"
 #include "grid_based_algorithms/lb_interpolation.hpp"
+#include "grid_based_algorithms/lb_refinement.hpp"
 #include <utils/Vector.hpp>
 
 #include "lb.hpp"
@@ -70,6 +71,21 @@ void lattice_interpolation(Lattice const &lattice, Utils::Vector3d const &pos,
   }
 }
 
+template <typename Op>
+void quadratic_interpolation(QuadraticStencil const &stencil, Op &&op) {
+  auto const &delta = stencil.delta;
+  for (int z = 0; z < 3; z++) {
+    for (int y = 0; y < 3; y++) {
+      for (int x = 0; x < 3; x++) {
+        auto const index = stencil.node_index[(z * 3 + y) * 3 + x];
+        auto const w = delta[x] * delta[3 + y] * delta[6 + z];
+
+        op(index, w);
+      }
+    }
+  }
+}
+
 Utils::Vector3d node_u(Lattice::index_t index) {
 #ifdef LB_BOUNDARIES
   if (lbfields[index].boundary) {
@@ -81,10 +97,66 @@ Utils::Vector3d node_u(Lattice::index_t index) {
   return Utils::Vector3d{modes[1], modes[2], modes[3]} / local_density;
 }
 
+/** Interpolation on the fine lattice of the refined patch. */
+template <typename Op>
+void refined_patch_interpolation(Utils::Vector3d const &pos, Op &&op) {
+  auto const &lattice = lb_refined_patch_lattice();
+  if (interpolation_order == InterpolationOrder::quadratic) {
+    QuadraticStencil stencil;
+    lattice.map_position_to_quadratic_stencil(pos, stencil.node_index,
+                                              stencil.delta);
+    quadratic_interpolation(stencil, std::forward<Op>(op));
+  } else {
+    lattice_interpolation(lattice, pos, std::forward<Op>(op));
+  }
+}
+
 } // namespace
 
+QuadraticStencil
+lb_lbinterpolation_get_quadratic_stencil(const Utils::Vector3d &pos) {
+  QuadraticStencil stencil;
+  lblattice.map_position_to_quadratic_stencil(pos, stencil.node_index,
+                                              stencil.delta);
+  return stencil;
+}
+
+const Utils::Vector3d
+lb_lbinterpolation_get_interpolated_velocity(const QuadraticStencil &stencil) {
+  Utils::Vector3d interpolated_u{};
+  quadratic_interpolation(stencil,
+                          [&interpolated_u](Lattice::index_t index, double w) {
+                            interpolated_u += w * node_u(index);
+                          });
+
+  return interpolated_u;
+}
+
+void lb_lbinterpolation_add_force_density(
+    const QuadraticStencil &stencil, const Utils::Vector3d &force_density) {
+  quadratic_interpolation(stencil,
+                          [&force_density](Lattice::index_t index, double w) {
+                            auto &field = lbfields[index];
+                            field.force_density += w * force_density;
+                          });
+}
+
 const Utils::Vector3d
 lb_lbinterpolation_get_interpolated_velocity(const Utils::Vector3d &pos) {
+  if (lb_refined_patch_couples(pos)) {
+    Utils::Vector3d interpolated_u{};
+    refined_patch_interpolation(
+        pos, [&interpolated_u](Lattice::index_t index, double w) {
+          interpolated_u += w * lb_refined_patch_node_velocity(index);
+        });
+    return interpolated_u;
+  }
+
+  if (interpolation_order == InterpolationOrder::quadratic) {
+    return lb_lbinterpolation_get_interpolated_velocity(
+        lb_lbinterpolation_get_quadratic_stencil(pos));
+  }
+
   Utils::Vector3d interpolated_u{};
 
   /* Calculate fluid velocity at particle's position.
@@ -99,10 +171,19 @@ lb_lbinterpolation_get_interpolated_velocity(const Utils::Vector3d &pos) {
 
 void lb_lbinterpolation_add_force_density(
     const Utils::Vector3d &pos, const Utils::Vector3d &force_density) {
+  if (lb_refined_patch_couples(pos)) {
+    refined_patch_interpolation(
+        pos, [&force_density](Lattice::index_t index, double w) {
+          lb_refined_patch_add_force_density(index, w * force_density);
+        });
+    return;
+  }
+
   switch (interpolation_order) {
   case (InterpolationOrder::quadratic):
-    throw std::runtime_error("The non-linear interpolation scheme is not "
-                             "implemented for the CPU LB.");
+    lb_lbinterpolation_add_force_density(
+        lb_lbinterpolation_get_quadratic_stencil(pos), force_density);
+    break;
   case (InterpolationOrder::linear):
     lattice_interpolation(lblattice, pos,
                           [&force_density](Lattice::index_t index, double w) {
@@ -19,13 +19,32 @@
 #ifndef LATTICE_INTERPOLATION_HPP
 #define LATTICE_INTERPOLATION_HPP
 
+#include "grid_based_algorithms/lattice.hpp"
+
 #include <utils/Vector.hpp>
+
+#include <cstddef>
+
 /**
  * @brief Interpolation order for the LB fluid interpolation.
- * @note For the CPU LB only linear interpolation is available.
  */
 enum class InterpolationOrder { linear, quadratic };
 
+/**
+ * @brief Lattice sites and weights of the quadratic interpolation
+ * of a position.
+ *
+ * Computing the stencil once per position allows to reuse it for the
+ * velocity interpolation and the force spreading of a particle.
+ */
+struct QuadraticStencil {
+  /** local indices of the 27 lattice sites, x running fastest */
+  Utils::Vector<std::size_t, 27> node_index;
+  /** one-dimensional weights of the left, center and right site
+   *  for each direction */
+  Utils::Vector<double, 9> delta;
+};
+
 /**
  * @brief Set the interpolation order for the LB.
  */
@@ -36,6 +55,9 @@ InterpolationOrder lb_lbinterpolation_get_interpolation_order();
 /**
  * @brief Calculates the fluid velocity at a given position of the
  * lattice.
+ *
+ * Positions within the refined patch are interpolated on its fine
+ * lattice.
  * @note It can lead to undefined behaviour if the
  * position is not within the local lattice. */
 const Utils::Vector3d
@@ -43,7 +65,33 @@ lb_lbinterpolation_get_interpolated_velocity(const Utils::Vector3d &p);
 
 /**
  * @brief Add a force density to the fluid at the given position.
+ *
+ * Positions within the refined patch spread the force density on its
+ * fine lattice.
+ * For the quadratic scheme, the force density can end up in the
+ * halo region, it has to be collected with
+ * @ref lb_collect_halo_force_density afterwards.
  */
 void lb_lbinterpolation_add_force_density(const Utils::Vector3d &p,
                                           const Utils::Vector3d &force_density);
+
+/**
+ * @brief Calculate the quadratic interpolation stencil of a position.
+ * @note The position has to be within the local box.
+ */
+QuadraticStencil
+lb_lbinterpolation_get_quadratic_stencil(const Utils::Vector3d &p);
+
+/**
+ * @brief Calculates the fluid velocity on a quadratic interpolation stencil.
+ */
+const Utils::Vector3d
+lb_lbinterpolation_get_interpolated_velocity(const QuadraticStencil &stencil);
+
+/**
+ * @brief Add a force density to the fluid on a quadratic interpolation
+ * stencil.
+ */
+void lb_lbinterpolation_add_force_density(const QuadraticStencil &stencil,
+                                          const Utils::Vector3d &force_density);
 #endif
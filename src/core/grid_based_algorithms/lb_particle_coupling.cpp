@@ -25,8 +25,10 @@
 #include "grid.hpp"
 #include "grid_based_algorithms/lattice.hpp"
 #include "integrate.hpp"
+#include "lb.hpp"
 #include "lb_interface.hpp"
 #include "lb_interpolation.hpp"
+#include "lb_refinement.hpp"
 #include "lbgpu.hpp"
 #include "particle_data.hpp"
 #include "random.hpp"
@@ -39,6 +41,8 @@
 #include <Random123/philox.h>
 #include <boost/mpi.hpp>
 
+#include <vector>
+
 LB_Particle_Coupling lb_particle_coupling;
 
 void mpi_bcast_lb_particle_coupling_slave() {
@@ -115,16 +119,51 @@ void lb_lbcoupling_set_rng_state(uint64_t counter) {
 }
 
 namespace {
+/**
+ * @brief Transform a force into a momentum transfer to the fluid.
+ * @param force Force in MD units.
+ * @return Force density in lattice units.
+ */
+Utils::Vector3d md_force_to_lb(Utils::Vector3d const &force) {
+  /* transform momentum transfer to lattice units
+     (eq. (12) @cite ahlrichs99a) */
+  return -(time_step / lb_lbfluid_get_lattice_speed()) * force;
+}
+
 /**
  * @brief Add a force to the lattice force density.
  * @param pos Position of the force
  * @param force Force in MD units.
  */
 void add_md_force(Utils::Vector3d const &pos, Utils::Vector3d const &force) {
-  /* transform momentum transfer to lattice units
-     (eq. (12) @cite ahlrichs99a) */
-  auto const delta_j = -(time_step / lb_lbfluid_get_lattice_speed()) * force;
-  lb_lbinterpolation_add_force_density(pos, delta_j);
+  lb_lbinterpolation_add_force_density(pos, md_force_to_lb(force));
+}
+
+/** Viscous coupling force of a particle.
+ *
+ *  @param[in] p               The coupled particle.
+ *  @param[in] interpolated_u  Fluid velocity at the particle position
+ *                             in MD units.
+ *  @param[in] f_random        Additional force to be included.
+ *
+ *  @return The viscous coupling force plus f_random.
+ */
+Utils::Vector3d viscous_force(Particle const &p,
+                              Utils::Vector3d const &interpolated_u,
+                              Utils::Vector3d const &f_random) {
+  Utils::Vector3d v_drift = interpolated_u;
+#ifdef ENGINE
+  if (p.p.swim.swimming) {
+    v_drift += p.p.swim.v_swim * p.r.calc_director();
+  }
+#endif
+
+#ifdef LB_ELECTROHYDRODYNAMICS
+  v_drift += p.p.mu_E;
+#endif
+
+  /* calculate viscous force (eq. (9) @cite ahlrichs99a) */
+  return -lb_lbcoupling_get_gamma() * (p.m.v - v_drift) + f_random;
 }
 } // namespace
 
@@ -145,19 +184,7 @@ Utils::Vector3d lb_viscous_coupling(Particle const &p,
       lb_lbinterpolation_get_interpolated_velocity(p.r.p) *
       lb_lbfluid_get_lattice_speed();
 
-  Utils::Vector3d v_drift = interpolated_u;
-#ifdef ENGINE
-  if (p.p.swim.swimming) {
-    v_drift += p.p.swim.v_swim * p.r.calc_director();
-  }
-#endif
-
-#ifdef LB_ELECTROHYDRODYNAMICS
-  v_drift += p.p.mu_E;
-#endif
-
-  /* calculate viscous force (eq. (9) @cite ahlrichs99a) */
-  auto const force = -lb_lbcoupling_get_gamma() * (p.m.v - v_drift) + f_random;
+  auto const force = viscous_force(p, interpolated_u, f_random);
 
   add_md_force(p.r.p, force);
 
@@ -228,7 +255,14 @@ void add_swimmer_force(Particle &p) {
     auto const director = p.r.calc_director();
     auto const source_position = p.r.p + direction * director;
 
-    if (not in_local_halo(source_position)) {
+    /* the quadratic scheme spreads from the local domain only,
+       the contributions to the halo are collected afterwards */
+    auto const in_range =
+        (lb_lbinterpolation_get_interpolation_order() ==
+         InterpolationOrder::linear)
+            ? in_local_halo(source_position)
+            : in_local_domain(source_position, local_geo);
+    if (not in_range) {
       return;
     }
 
@@ -260,30 +294,97 @@ void lb_lbcoupling_calc_particle_lattice_ia(
 #endif
   } else if (lattice_switch == ActiveLB::CPU) {
     if (lb_particle_coupling.couple_to_md) {
+      /* the interpolation reads the populations on the halo sites */
+      lb_update_halo_populations();
+
+      auto const kT = lb_lbfluid_get_kT();
+      /* Eq. (16) @cite ahlrichs99a.
+       * The factor 12 comes from the fact that we use random numbers
+       * from -0.5 to 0.5 (equally distributed) which have variance 1/12.
+       * time_step comes from the discretization.
+       */
+      auto const noise_amplitude =
+          (kT > 0.)
+              ? std::sqrt(12. * 2. * lb_lbcoupling_get_gamma() * kT / time_step)
+              : 0.0;
+
+      auto f_random = [noise_amplitude](int id) -> Utils::Vector3d {
+        if (noise_amplitude > 0.0) {
+          return Random::noise_uniform<RNGSalt::PARTICLES>(
+              lb_particle_coupling.rng_counter_coupling->value(), id);
+        }
+        return {};
+      };
+
       switch (lb_lbinterpolation_get_interpolation_order()) {
-      case (InterpolationOrder::quadratic):
-        throw std::runtime_error("The non-linear interpolation scheme is not "
-                                 "implemented for the CPU LB.");
-      case (InterpolationOrder::linear): {
-        auto const kT = lb_lbfluid_get_kT();
-        /* Eq. (16) @cite ahlrichs99a.
-         * The factor 12 comes from the fact that we use random numbers
-         * from -0.5 to 0.5 (equally distributed) which have variance 1/12.
-         * time_step comes from the discretization.
-         */
-        auto const noise_amplitude =
-            (kT > 0.) ? std::sqrt(12. * 2. * lb_lbcoupling_get_gamma() * kT /
-                                  time_step)
-                      : 0.0;
-
-        auto f_random = [noise_amplitude](int id) -> Utils::Vector3d {
-          if (noise_amplitude > 0.0) {
-            return Random::noise_uniform<RNGSalt::PARTICLES>(
-                lb_particle_coupling.rng_counter_coupling->value(), id);
+      case (InterpolationOrder::quadratic): {
+        /* The 27-point stencil of a particle in the local domain reaches
+         * into the first halo layer, so every particle is coupled by the
+         * node whose local domain contains it, and the force density
+         * spread into the halo is sent to the neighbors afterwards. */
+        lb_clear_halo_force_density(lbfields, lblattice);
+
+        std::vector<Particle *> coupled_particles;
+        auto select_particles = [&](ParticleRange const &range) {
+          for (auto &p : range) {
+            if (p.p.is_virtual and !couple_virtual)
+              continue;
+            if (in_local_domain(p.r.p, local_geo))
+              coupled_particles.push_back(&p);
           }
-          return {};
         };
+        select_particles(particles);
+        select_particles(more_particles);
+
+        /* The stencils are determined once, then all velocities are
+         * interpolated before any force density is spread, so that the
+         * fluid is only read in the first pass and only written in the
+         * second one. Particles in the refined patch are coupled to its
+         * fine lattice, which has its own stencils. */
+        std::vector<QuadraticStencil> stencils(coupled_particles.size());
+        std::vector<Utils::Vector3d> forces(coupled_particles.size());
+        auto const lattice_speed = lb_lbfluid_get_lattice_speed();
+        for (std::size_t i = 0; i < coupled_particles.size(); i++) {
+          auto const &p = *coupled_particles[i];
+          Utils::Vector3d interpolated_u;
+          if (lb_refined_patch_couples(p.r.p)) {
+            interpolated_u =
+                lb_lbinterpolation_get_interpolated_velocity(p.r.p);
+          } else {
+            stencils[i] = lb_lbinterpolation_get_quadratic_stencil(p.r.p);
+            interpolated_u =
+                lb_lbinterpolation_get_interpolated_velocity(stencils[i]);
+          }
+          forces[i] =
+              viscous_force(p, interpolated_u * lattice_speed,
+                            noise_amplitude * f_random(p.identity()));
+        }
+
+        for (std::size_t i = 0; i < coupled_particles.size(); i++) {
+          auto &p = *coupled_particles[i];
+          p.f.f += forces[i];
+          if (lb_refined_patch_couples(p.r.p)) {
+            lb_lbinterpolation_add_force_density(p.r.p,
+                                                 md_force_to_lb(forces[i]));
+          } else {
+            lb_lbinterpolation_add_force_density(stencils[i],
+                                                 md_force_to_lb(forces[i]));
+          }
+        }
+
+#ifdef ENGINE
+        for (auto range : {particles, more_particles}) {
+          for (auto &p : range) {
+            if (not p.p.is_virtual or couple_virtual)
+              add_swimmer_force(p);
+          }
+        }
+#endif
 
+        lb_collect_halo_force_density(lbfields, lblattice);
+        break;
+      }
+      case (InterpolationOrder::linear): {
         auto couple_particle = [&](Particle &p) -> void {
           if (p.p.is_virtual and !couple_virtual)
             return;
@@ -0,0 +1,557 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Static grid refinement of the CPU LB fluid.
+ *
+ *  The refinement factor is 2: every coarse node of the patch is covered
+ *  by 8 fine nodes, and the fine lattice does two steps per coarse step.
+ *  With this acoustic scaling the lattice velocities of both lattices
+ *  agree, the masses of the fine nodes are 1/8 of the coarse ones and
+ *  the lattice viscosity of the fine lattice is twice the coarse one.
+ *
+ *  The corresponding header file is lb_refinement.hpp.
+ */
+
+#include "grid_based_algorithms/lb_refinement.hpp"
+
+#include "errorhandling.hpp"
+#include "grid.hpp"
+#include "grid_based_algorithms/lb-d3q19.hpp"
+#include "grid_based_algorithms/lb.hpp"
+
+#include <utils/index.hpp>
+
+#include <boost/multi_array.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using Utils::get_linear_index;
+
+namespace {
+/** Hydrodynamic state of a node, used to transfer the fluid between
+ *  the lattices.
+ */
+struct NodeState {
+  double density;
+  Utils::Vector3d momentum_density;
+  /** non-equilibrium part of the stress, in the order
+   *  xx, xy, yy, xz, yz, zz */
+  Utils::Vector6d stress_neq;
+};
+
+struct RefinedPatch {
+  /** first coarse node of the patch (global node index) */
+  Utils::Vector3i begin;
+  /** coarse node after the last one of the patch (global node index) */
+  Utils::Vector3i end;
+  /** whether this rank holds the fine lattice */
+  bool is_owner;
+
+  /** parameters of the fine lattice, in its lattice units */
+  LB_Parameters lb_parameters;
+  /** ratio of the fine and coarse relaxation times of the bulk mode */
+  double relaxation_ratio_bulk;
+  /** ratio of the fine and coarse relaxation times of the shear modes */
+  double relaxation_ratio_shear;
+
+  Lattice lattice;
+  boost::multi_array<double, 2> populations_a;
+  boost::multi_array<double, 2> populations_b;
+  /** pre-collision populations of the fine nodes, stored as differences
+   *  to their equilibrium value at rest */
+  LB_Fluid fluid;
+  LB_Fluid fluid_post;
+  /** force density on the fine nodes from the particle coupling and
+   *  the covered coarse nodes, in lattice units of the coarse lattice */
+  std::vector<Utils::Vector3d> force_density;
+
+  /** state of the coarse nodes of the patch and the layer around it,
+   *  at the beginning and the end of the current coarse step */
+  std::vector<NodeState> coarse_states_old;
+  std::vector<NodeState> coarse_states_new;
+};
+
+std::unique_ptr<RefinedPatch> refined_patch;
+
+double relaxation_time(double gamma) { return 1. / (1. - gamma); }
+
+/** Parameters of the fine lattice, in its lattice units. */
+LB_Parameters refined_parameters(LB_Parameters const &coarse) {
+  auto fine = coarse;
+  fine.agrid = 0.5 * coarse.agrid;
+  fine.tau = 0.5 * coarse.tau;
+  fine.density = coarse.density / 8.;
+  fine.viscosity = 2. * coarse.viscosity;
+  fine.bulk_viscosity = 2. * coarse.bulk_viscosity;
+  /* tau_fine - 1/2 = 2 (tau_coarse - 1/2) for any relaxation time
+   * that is derived from a viscosity */
+  fine.gamma_bulk =
+      1. - 1. / (2. * relaxation_time(coarse.gamma_bulk) - 0.5);
+  fine.ext_force_density = coarse.ext_force_density / 16.;
+  fine.kT = 0.;
+  lb_reinit_parameters(fine);
+
+  return fine;
+}
+
+/** Momentum flux @f$ \vec{j} \otimes \vec{j} / \rho @f$. */
+Utils::Vector6d momentum_flux(double density,
+                              Utils::Vector3d const &momentum_density) {
+  auto const &j = momentum_density;
+  return Utils::Vector6d{j[0] * j[0], j[0] * j[1], j[1] * j[1],
+                         j[0] * j[2], j[1] * j[2], j[2] * j[2]} /
+         density;
+}
+
+NodeState calc_node_state(Utils::Vector19d const &population) {
+  NodeState state{};
+  Utils::Vector6d stress{};
+  for (int i = 0; i < D3Q19::n_vel; i++) {
+    auto const &c = D3Q19::c[i];
+    auto const f = population[i];
+    state.density += f;
+    state.momentum_density += f * Utils::Vector3d{c[0], c[1], c[2]};
+    stress += f * Utils::Vector6d{c[0] * c[0], c[0] * c[1], c[1] * c[1],
+                                  c[0] * c[2], c[1] * c[2], c[2] * c[2]};
+  }
+
+  auto const pressure = D3Q19::c_sound_sq<double> * state.density;
+  state.stress_neq =
+      stress - momentum_flux(state.density, state.momentum_density);
+  state.stress_neq[0] -= pressure;
+  state.stress_neq[2] -= pressure;
+  state.stress_neq[5] -= pressure;
+
+  return state;
+}
+
+Utils::Vector19d calc_population(NodeState const &state) {
+  /* the stress of the populations is given without the pressure */
+  return lb_get_population_from_density_momentum_density_stress(
+      state.density, state.momentum_density,
+      momentum_flux(state.density, state.momentum_density) +
+          state.stress_neq);
+}
+
+void add_weighted(NodeState &sum, NodeState const &state, double weight) {
+  sum.density += weight * state.density;
+  sum.momentum_density += weight * state.momentum_density;
+  sum.stress_neq += weight * state.stress_neq;
+}
+
+/** Scale a node state from one lattice to the other.
+ *  @param state         State to scale
+ *  @param mass_factor   Factor of the density and momentum density
+ *  @param factor_bulk   Factor of the trace of the non-equilibrium stress
+ *  @param factor_shear  Factor of the traceless part of the
+ *                       non-equilibrium stress
+ */
+NodeState scale(NodeState state, double mass_factor, double factor_bulk,
+                double factor_shear) {
+  auto &stress = state.stress_neq;
+  auto const isotropic = (stress[0] + stress[2] + stress[5]) / 3.;
+  state.density *= mass_factor;
+  state.momentum_density *= mass_factor;
+  stress *= factor_shear;
+  stress[0] += (factor_bulk - factor_shear) * isotropic;
+  stress[2] += (factor_bulk - factor_shear) * isotropic;
+  stress[5] += (factor_bulk - factor_shear) * isotropic;
+
+  return state;
+}
+
+Lattice::index_t coarse_index(Utils::Vector3i const &global_index) {
+  return get_linear_index(lblattice.local_index(global_index),
+                          lblattice.halo_grid);
+}
+
+/** Shape of the box of the patch and the coarse layer around it. */
+Utils::Vector3i coarse_box_shape(RefinedPatch const &patch) {
+  return patch.end - patch.begin + Utils::Vector3i{2, 2, 2};
+}
+
+bool is_fine_halo(Utils::Vector3i const &node, Lattice const &lattice) {
+  for (int d = 0; d < 3; d++) {
+    if (node[d] == 0 or node[d] == lattice.halo_grid[d] - 1)
+      return true;
+  }
+  return false;
+}
+
+Utils::Vector19d fine_population(RefinedPatch const &patch,
+                                 Lattice::index_t index) {
+  Utils::Vector19d population{};
+  for (int i = 0; i < D3Q19::n_vel; i++) {
+    population[i] = patch.fluid[i][index] + D3Q19::coefficients[i][0] *
+                                                patch.lb_parameters.density;
+  }
+  return population;
+}
+
+void set_fine_population(RefinedPatch &patch, Lattice::index_t index,
+                         Utils::Vector19d const &population) {
+  for (int i = 0; i < D3Q19::n_vel; i++) {
+    patch.fluid[i][index] = population[i] - D3Q19::coefficients[i][0] *
+                                                patch.lb_parameters.density;
+  }
+}
+
+void store_coarse_states(RefinedPatch const &patch,
+                         std::vector<NodeState> &states) {
+  auto const shape = coarse_box_shape(patch);
+  auto const origin = patch.begin - Utils::Vector3i{1, 1, 1};
+  states.resize(shape[0] * shape[1] * shape[2]);
+  for (int z = 0; z < shape[2]; z++) {
+    for (int y = 0; y < shape[1]; y++) {
+      for (int x = 0; x < shape[0]; x++) {
+        auto const index = coarse_index(origin + Utils::Vector3i{x, y, z});
+        states[get_linear_index(x, y, z, shape)] =
+            calc_node_state(lb_get_population(index));
+      }
+    }
+  }
+}
+
+/** Set fine nodes from the coarse states.
+ *
+ *  The coarse states are interpolated quadratically to the position of
+ *  the fine nodes and linearly in time. A linear interpolation in space
+ *  would smear out the curvature of the flow field on every step.
+ *
+ *  @param patch      Refined patch
+ *  @param time       Time in units of the coarse step since the state in
+ *                    @ref RefinedPatch::coarse_states_old
+ *  @param halo_only  Only set the halo nodes of the fine lattice
+ */
+void set_fine_nodes_from_coarse(RefinedPatch &patch, double time,
+                                bool halo_only) {
+  auto const shape = coarse_box_shape(patch);
+  auto const &grid = patch.lattice.halo_grid;
+  for (int z = 0; z < grid[2]; z++) {
+    for (int y = 0; y < grid[1]; y++) {
+      for (int x = 0; x < grid[0]; x++) {
+        Utils::Vector3i const node{x, y, z};
+        if (halo_only and not is_fine_halo(node, patch.lattice))
+          continue;
+
+        /* fine node n is at n / 2 + 1/4 in units of the coarse nodes of
+         * the box, the stencil around the closest coarse node is shifted
+         * into the box for the halo */
+        Utils::Vector3i first{};
+        std::array<std::array<double, 3>, 3> weights{};
+        for (int d = 0; d < 3; d++) {
+          auto const pos = 0.5 * node[d] + 0.25;
+          auto const center = std::min(
+              std::max(static_cast<int>(std::lround(pos)), 1), shape[d] - 2);
+          auto const u = pos - center;
+          first[d] = center - 1;
+          weights[d] = {{0.5 * u * (u - 1.), 1. - u * u, 0.5 * u * (u + 1.)}};
+        }
+
+        NodeState state{};
+        for (int k = 0; k < 3; k++) {
+          for (int j = 0; j < 3; j++) {
+            for (int i = 0; i < 3; i++) {
+              auto const w = weights[0][i] * weights[1][j] * weights[2][k];
+              auto const index =
+                  get_linear_index(first + Utils::Vector3i{i, j, k}, shape);
+              add_weighted(state, patch.coarse_states_old[index],
+                           (1. - time) * w);
+              add_weighted(state, patch.coarse_states_new[index], time * w);
+            }
+          }
+        }
+
+        set_fine_population(
+            patch, get_linear_index(node, grid),
+            calc_population(scale(state, 1. / 8.,
+                                  patch.relaxation_ratio_bulk / 16.,
+                                  patch.relaxation_ratio_shear / 16.)));
+      }
+    }
+  }
+}
+
+/** Collide and stream all fine nodes.
+ *  @param patch  Refined patch
+ *  @param time   Time of the step in units of the coarse step
+ */
+void fine_collide_stream(RefinedPatch &patch, double time) {
+  set_fine_nodes_from_coarse(patch, time, true);
+
+  auto const &grid = patch.lattice.halo_grid;
+  for (int z = 0; z < grid[2]; z++) {
+    for (int y = 0; y < grid[1]; y++) {
+      for (int x = 0; x < grid[0]; x++) {
+        Utils::Vector3i const node{x, y, z};
+        auto const index = get_linear_index(node, grid);
+
+        /* the force density of a coarse step is applied in two steps */
+        auto force_density = patch.lb_parameters.ext_force_density;
+        if (not is_fine_halo(node, patch.lattice)) {
+          force_density += 0.5 * patch.force_density[index];
+        }
+
+        auto const populations = lb_calc_collided_populations(
+            lb_calc_modes(index, patch.fluid), force_density,
+            patch.lb_parameters);
+
+        /* populations leaving the fine lattice are dropped, the halo
+         * is set from the coarse lattice before the next step */
+        for (int i = 0; i < D3Q19::n_vel; i++) {
+          auto const &c = D3Q19::c[i];
+          Utils::Vector3i const next = {x + static_cast<int>(c[0]),
+                                        y + static_cast<int>(c[1]),
+                                        z + static_cast<int>(c[2])};
+          if (next >= Utils::Vector3i{} and next < grid) {
+            patch.fluid_post[i][get_linear_index(next, grid)] = populations[i];
+          }
+        }
+      }
+    }
+  }
+
+  std::swap(patch.fluid, patch.fluid_post);
+}
+
+/** Overwrite the coarse nodes of the patch with the average of the fine
+ *  nodes covering them.
+ */
+void restrict_to_coarse(RefinedPatch const &patch) {
+  auto const shape = patch.end - patch.begin;
+  auto const &grid = patch.lattice.halo_grid;
+  for (int z = 0; z < shape[2]; z++) {
+    for (int y = 0; y < shape[1]; y++) {
+      for (int x = 0; x < shape[0]; x++) {
+        Utils::Vector3i const node{x, y, z};
+        NodeState sum{};
+        for (int k = 0; k < 2; k++) {
+          for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 2; i++) {
+              auto const child = Utils::Vector3i{1, 1, 1} + 2 * node +
+                                 Utils::Vector3i{i, j, k};
+              add_weighted(sum,
+                           calc_node_state(fine_population(
+                               patch, get_linear_index(child, grid))),
+                           1.);
+            }
+          }
+        }
+
+        lb_set_population(
+            coarse_index(patch.begin + node),
+            calc_population(scale(sum, 1., 2. / patch.relaxation_ratio_bulk,
+                                  2. / patch.relaxation_ratio_shear)));
+      }
+    }
+  }
+}
+
+/** Move the force density of a coarse node of the patch to its children.
+ */
+void transfer_force_density(RefinedPatch &patch, Utils::Vector3i const &node) {
+  auto &field = lbfields[coarse_index(patch.begin + node)];
+  auto const excess = field.force_density - lbpar.ext_force_density;
+  for (int k = 0; k < 2; k++) {
+    for (int j = 0; j < 2; j++) {
+      for (int i = 0; i < 2; i++) {
+        auto const child =
+            Utils::Vector3i{1, 1, 1} + 2 * node + Utils::Vector3i{i, j, k};
+        patch.force_density[get_linear_index(
+            child, patch.lattice.halo_grid)] += excess / 8.;
+      }
+    }
+  }
+  field.force_density = lbpar.ext_force_density;
+}
+
+RefinedPatch *local_patch() {
+  if (refined_patch and refined_patch->is_owner) {
+    return refined_patch.get();
+  }
+  return nullptr;
+}
+} // namespace
+
+bool lb_refined_patch_set(Utils::Vector3i const &begin,
+                          Utils::Vector3i const &end) {
+  refined_patch = std::make_unique<RefinedPatch>();
+  auto &patch = *refined_patch;
+  patch.begin = begin;
+  patch.end = end;
+
+  /* the patch and the coarse layer around it have to be local */
+  patch.is_owner = lblattice.is_local(begin - Utils::Vector3i{1, 1, 1}) and
+                   lblattice.is_local(end);
+  if (not patch.is_owner) {
+    return false;
+  }
+
+  auto const agrid = lblattice.agrid;
+  Utils::Vector3d extent{}, right{};
+  for (int d = 0; d < 3; d++) {
+    extent[d] = (end[d] - begin[d]) * agrid;
+    right[d] = end[d] * agrid;
+  }
+  patch.lattice =
+      Lattice(0.5 * agrid, 0.5 /*offset*/, 1 /*halo size*/, extent, right,
+              box_geo.length(), Utils::Vector3i{}, Utils::Vector3i{1, 1, 1});
+
+  const std::array<int, 2> size = {
+      {D3Q19::n_vel, patch.lattice.halo_grid_volume}};
+  patch.populations_a.resize(size);
+  patch.populations_b.resize(size);
+  for (int i = 0; i < size[0]; i++) {
+    patch.fluid[i] =
+        Utils::Span<double>(patch.populations_a[i].origin(), size[1]);
+    patch.fluid_post[i] =
+        Utils::Span<double>(patch.populations_b[i].origin(), size[1]);
+  }
+  patch.force_density.resize(size[1]);
+
+  lb_refined_patch_reinit();
+
+  return true;
+}
+
+void lb_refined_patch_remove() { refined_patch.reset(); }
+
+bool lb_refined_patch_is_active() { return static_cast<bool>(refined_patch); }
+
+void lb_refined_patch_reinit() {
+  auto patch = local_patch();
+  if (not patch)
+    return;
+
+  patch->lb_parameters = refined_parameters(lbpar);
+  patch->relaxation_ratio_bulk =
+      relaxation_time(patch->lb_parameters.gamma_bulk) /
+      relaxation_time(lbpar.gamma_bulk);
+  patch->relaxation_ratio_shear =
+      relaxation_time(patch->lb_parameters.gamma_shear) /
+      relaxation_time(lbpar.gamma_shear);
+
+  store_coarse_states(*patch, patch->coarse_states_old);
+  patch->coarse_states_new = patch->coarse_states_old;
+  set_fine_nodes_from_coarse(*patch, 0., false);
+  std::fill(patch->force_density.begin(), patch->force_density.end(),
+            Utils::Vector3d{});
+}
+
+void lb_refined_patch_sanity_checks() {
+  auto const patch = local_patch();
+  if (not patch)
+    return;
+
+  if (lbpar.kT > 0.) {
+    runtimeErrorMsg() << "LB grid refinement does not support thermal "
+                         "fluctuations";
+  }
+#ifdef LB_BOUNDARIES
+  auto const shape = coarse_box_shape(*patch);
+  auto const origin = patch->begin - Utils::Vector3i{1, 1, 1};
+  for (int z = 0; z < shape[2]; z++) {
+    for (int y = 0; y < shape[1]; y++) {
+      for (int x = 0; x < shape[0]; x++) {
+        auto const index = coarse_index(origin + Utils::Vector3i{x, y, z});
+        if (lbfields[index].boundary) {
+          runtimeErrorMsg() << "LB boundaries are not supported within "
+                               "one node of the refined patch";
+          return;
+        }
+      }
+    }
+  }
+#endif
+}
+
+void lb_refined_patch_prepare_update() {
+  auto patch = local_patch();
+  if (not patch)
+    return;
+
+  auto const shape = patch->end - patch->begin;
+  for (int z = 0; z < shape[2]; z++) {
+    for (int y = 0; y < shape[1]; y++) {
+      for (int x = 0; x < shape[0]; x++) {
+        transfer_force_density(*patch, {x, y, z});
+      }
+    }
+  }
+
+  store_coarse_states(*patch, patch->coarse_states_old);
+}
+
+void lb_refined_patch_update() {
+  auto patch = local_patch();
+  if (not patch)
+    return;
+
+  store_coarse_states(*patch, patch->coarse_states_new);
+
+  fine_collide_stream(*patch, 0.);
+  fine_collide_stream(*patch, 0.5);
+  std::fill(patch->force_density.begin(), patch->force_density.end(),
+            Utils::Vector3d{});
+
+  restrict_to_coarse(*patch);
+}
+
+bool lb_refined_patch_couples(Utils::Vector3d const &pos) {
+  auto const patch = local_patch();
+  if (not patch)
+    return false;
+
+  /* the quadratic stencil of positions closer than one fine lattice
+   * spacing to the edge of the patch reaches into the fine halo */
+  auto const agrid = lblattice.agrid;
+  for (int d = 0; d < 3; d++) {
+    if (pos[d] < patch->begin[d] * agrid + 0.5 * agrid or
+        pos[d] >= patch->end[d] * agrid - 0.5 * agrid)
+      return false;
+  }
+  return true;
+}
+
+Lattice const &lb_refined_patch_lattice() {
+  auto const patch = local_patch();
+  assert(patch);
+  return patch->lattice;
+}
+
+Utils::Vector3d lb_refined_patch_node_velocity(Lattice::index_t index) {
+  auto const patch = local_patch();
+  assert(patch);
+  auto const modes = lb_calc_modes(index, patch->fluid);
+  auto const density = patch->lb_parameters.density + modes[0];
+  return Utils::Vector3d{modes[1], modes[2], modes[3]} / density;
+}
+
+void lb_refined_patch_add_force_density(Lattice::index_t index,
+                                        Utils::Vector3d const &force_density) {
+  auto patch = local_patch();
+  assert(patch);
+  patch->force_density[index] += force_density;
+}
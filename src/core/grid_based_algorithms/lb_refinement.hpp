@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Static grid refinement of the CPU LB fluid.
+ *
+ *  A single axis-aligned patch of the coarse lattice is covered by a
+ *  lattice with half the lattice spacing, which is propagated with two
+ *  time steps of half the LB time step per coarse step (acoustic
+ *  scaling). The fine lattice is coupled to the coarse one as in
+ *  @cite dupuis03a: its halo sites are interpolated in space and time
+ *  from the coarse nodes around the patch, and the coarse nodes covered
+ *  by the patch are overwritten with the averaged fine nodes after every
+ *  coarse step. The non-equilibrium part of the populations is rescaled
+ *  with the ratio of the relaxation times in both directions.
+ *
+ *  The patch and one layer of coarse nodes around it have to be in the
+ *  local domain of a single rank, which holds the fine lattice. Particles
+ *  whose interpolation stencil lies within the fine lattice are coupled
+ *  to it instead of the coarse one.
+ *
+ *  Implementation in lb_refinement.cpp.
+ */
+
+#ifndef CORE_LB_REFINEMENT_HPP
+#define CORE_LB_REFINEMENT_HPP
+
+#include "grid_based_algorithms/lattice.hpp"
+
+#include <utils/Vector.hpp>
+
+/** @brief Cover a region of the coarse lattice with a refined patch.
+ *
+ *  Has to be called on all ranks. The fine lattice is initialized from
+ *  the current state of the coarse fluid.
+ *
+ *  @param begin  First coarse node of the patch (global node index)
+ *  @param end    Coarse node after the last one of the patch
+ *  @return Whether this rank holds the fine lattice.
+ */
+bool lb_refined_patch_set(Utils::Vector3i const &begin,
+                          Utils::Vector3i const &end);
+
+/** @brief Remove the refined patch, has to be called on all ranks. */
+void lb_refined_patch_remove();
+
+/** @brief Whether a refined patch is set. */
+bool lb_refined_patch_is_active();
+
+/** @brief Re-initialize the fine lattice from the coarse fluid.
+ *
+ *  Has to be called after the fluid parameters or the coarse populations
+ *  changed.
+ */
+void lb_refined_patch_reinit();
+
+/** @brief Check that the fluid is supported by the refined patch. */
+void lb_refined_patch_sanity_checks();
+
+/** @brief Prepare the refined patch for a coarse LB step.
+ *
+ *  Has to be called before the coarse nodes are collided. The force
+ *  density on the coarse nodes covered by the patch is moved to the fine
+ *  lattice, and the coarse state around the patch is stored for the
+ *  interpolation of the fine halo.
+ */
+void lb_refined_patch_prepare_update();
+
+/** @brief Propagate the refined patch by one coarse LB step.
+ *
+ *  Has to be called after the coarse nodes are collided and streamed.
+ */
+void lb_refined_patch_update();
+
+/** @brief Whether a position is coupled to the fine lattice.
+ *
+ *  This is the case if the linear and quadratic interpolation stencils
+ *  of the position lie within the fine lattice of this rank.
+ */
+bool lb_refined_patch_couples(Utils::Vector3d const &pos);
+
+/** @brief Fine lattice of the refined patch, only valid on the rank
+ *  holding it.
+ */
+Lattice const &lb_refined_patch_lattice();
+
+/** @brief Fluid velocity of a fine node.
+ *  @param index  Local index on @ref lb_refined_patch_lattice
+ *  @return Velocity in lattice units of the coarse lattice.
+ */
+Utils::Vector3d lb_refined_patch_node_velocity(Lattice::index_t index);
+
+/** @brief Add a force density to a fine node.
+ *
+ *  The force density is applied during the next coarse LB step.
+ *
+ *  @param index          Local index on @ref lb_refined_patch_lattice
+ *  @param force_density  Force density in lattice units of the coarse
+ *                        lattice
+ */
+void lb_refined_patch_add_force_density(Lattice::index_t index,
+                                        Utils::Vector3d const &force_density);
+
+#endif
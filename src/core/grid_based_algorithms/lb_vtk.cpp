@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "grid_based_algorithms/lb_vtk.hpp"
+
+#include "MpiCallbacks.hpp"
+#include "communication.hpp"
+#include "errorhandling.hpp"
+#include "grid_based_algorithms/lb.hpp"
+#include "grid_based_algorithms/lb_constants.hpp"
+
+#include <utils/index.hpp>
+
+#include <boost/mpi/collectives/gather.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+/** Range of written lattice nodes along one axis. */
+struct AxisRange {
+  /** first written node (local index, including halo) */
+  int first_node;
+  /** number of written nodes */
+  int n_nodes;
+  /** sample index of the first written node */
+  int first_sample;
+};
+
+/** Intersect the sampled region with the local lattice along one axis. */
+AxisRange local_axis_range(int dir, int bb_low, int bb_high, int stride) {
+  auto const local_begin = lblattice.local_index_offset[dir];
+  auto const local_end = local_begin + lblattice.grid[dir] - 1;
+
+  auto const begin = std::max(bb_low, local_begin);
+  auto const first = bb_low + ((begin - bb_low + stride - 1) / stride) * stride;
+  auto const last = std::min(bb_high, local_end);
+
+  if (first > last) {
+    return {0, 0, 0};
+  }
+
+  return {first - local_begin + lblattice.halo_size,
+          (last - first) / stride + 1, (first - bb_low) / stride};
+}
+
+/** A named data array of one piece. */
+struct DataArray {
+  std::string name;
+  int n_components;
+  std::vector<float> data;
+};
+
+std::string byte_order() {
+  const uint16_t probe = 1;
+  return (*reinterpret_cast<const char *>(&probe) == 1) ? "LittleEndian"
+                                                        : "BigEndian";
+}
+
+std::string extent_string(Utils::Vector<int, 6> const &extent) {
+  std::stringstream ss;
+  ss << extent[0] << " " << extent[1] << " " << extent[2] << " " << extent[3]
+     << " " << extent[4] << " " << extent[5];
+  return ss.str();
+}
+
+std::string vector_string(Utils::Vector3d const &v) {
+  std::stringstream ss;
+  ss << v[0] << " " << v[1] << " " << v[2];
+  return ss.str();
+}
+
+std::string file_name(std::string const &path) {
+  auto const pos = path.find_last_of('/');
+  return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+std::string piece_path(std::string const &basename, int rank) {
+  return basename + "_" + std::to_string(rank) + ".vti";
+}
+
+std::vector<DataArray> local_data_arrays(int fields,
+                                         std::array<AxisRange, 3> const &range,
+                                         int stride) {
+  auto const n_samples = range[0].n_nodes * range[1].n_nodes * range[2].n_nodes;
+  auto const agrid = lbpar.agrid;
+  auto const tau = lbpar.tau;
+  auto const density_conversion = 1. / (agrid * agrid * agrid);
+  auto const velocity_conversion = agrid / tau;
+  auto const stress_conversion = 1. / (tau * tau * agrid);
+  auto const p0 = lbpar.density * D3Q19::c_sound_sq<double>;
+
+  std::vector<DataArray> arrays;
+  if (fields & LB_VTK_DENSITY)
+    arrays.push_back({"density", 1, {}});
+  if (fields & LB_VTK_VELOCITY)
+    arrays.push_back({"velocity", 3, {}});
+  if (fields & LB_VTK_STRESS)
+    arrays.push_back({"stress", 9, {}});
+  if (fields & LB_VTK_BOUNDARY)
+    arrays.push_back({"boundary", 1, {}});
+  for (auto &array : arrays) {
+    array.data.reserve(array.n_components * n_samples);
+  }
+
+  Utils::Vector3i ind;
+  for (int k = 0; k < range[2].n_nodes; k++) {
+    ind[2] = range[2].first_node + k * stride;
+    for (int j = 0; j < range[1].n_nodes; j++) {
+      ind[1] = range[1].first_node + j * stride;
+      for (int i = 0; i < range[0].n_nodes; i++) {
+        ind[0] = range[0].first_node + i * stride;
+        auto const index = Utils::get_linear_index(ind, lblattice.halo_grid);
+        auto const &force_density = lbfields[index].force_density;
+        auto const modes = lb_calc_modes(index, lbfluid);
+        auto const density = lb_calc_density(modes, lbpar);
+
+        auto out = arrays.begin();
+        if (fields & LB_VTK_DENSITY) {
+          out->data.push_back(static_cast<float>(density * density_conversion));
+          ++out;
+        }
+        if (fields & LB_VTK_VELOCITY) {
+          auto const u = lb_calc_momentum_density(modes, force_density) /
+                         density * velocity_conversion;
+          for (auto const c : u)
+            out->data.push_back(static_cast<float>(c));
+          ++out;
+        }
+        if (fields & LB_VTK_STRESS) {
+          auto stress = lb_calc_stress(modes, force_density, lbpar);
+          stress[0] += p0;
+          stress[2] += p0;
+          stress[5] += p0;
+          stress *= stress_conversion;
+          for (auto const c : {stress[0], stress[1], stress[3], stress[1],
+                               stress[2], stress[4], stress[3], stress[4],
+                               stress[5]})
+            out->data.push_back(static_cast<float>(c));
+          ++out;
+        }
+        if (fields & LB_VTK_BOUNDARY) {
+#ifdef LB_BOUNDARIES
+          out->data.push_back(static_cast<float>(lbfields[index].boundary));
+#else
+          out->data.push_back(0.f);
+#endif
+        }
+      }
+    }
+  }
+
+  return arrays;
+}
+
+void write_piece(std::string const &path, std::vector<DataArray> const &arrays,
+                 Utils::Vector<int, 6> const &whole_extent,
+                 Utils::Vector<int, 6> const &extent,
+                 Utils::Vector3d const &origin,
+                 Utils::Vector3d const &spacing) {
+  std::ofstream out(path, std::ios::out | std::ios::binary);
+  if (!out) {
+    runtimeErrorMsg() << "Could not open file " << path << " for writing.";
+    return;
+  }
+
+  out << "<?xml version=\"1.0\"?>\n"
+      << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\""
+      << byte_order() << "\" header_type=\"UInt64\">\n"
+      << "  <ImageData WholeExtent=\"" << extent_string(whole_extent)
+      << "\" Origin=\"" << vector_string(origin) << "\" Spacing=\""
+      << vector_string(spacing) << "\">\n"
+      << "    <Piece Extent=\"" << extent_string(extent) << "\">\n"
+      << "      <CellData>\n";
+  uint64_t offset = 0;
+  for (auto const &array : arrays) {
+    out << "        <DataArray type=\"Float32\" Name=\"" << array.name
+        << "\" NumberOfComponents=\"" << array.n_components
+        << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+    offset += sizeof(uint64_t) + array.data.size() * sizeof(float);
+  }
+  out << "      </CellData>\n"
+      << "    </Piece>\n"
+      << "  </ImageData>\n"
+      << "  <AppendedData encoding=\"raw\">\n_";
+  for (auto const &array : arrays) {
+    const uint64_t n_bytes = array.data.size() * sizeof(float);
+    out.write(reinterpret_cast<const char *>(&n_bytes), sizeof(n_bytes));
+    out.write(reinterpret_cast<const char *>(array.data.data()),
+              static_cast<std::streamsize>(n_bytes));
+  }
+  out << "\n  </AppendedData>\n"
+      << "</VTKFile>\n";
+}
+
+void write_index(std::string const &basename,
+                 std::vector<DataArray> const &arrays,
+                 Utils::Vector<int, 6> const &whole_extent,
+                 std::vector<Utils::Vector<int, 6>> const &extents,
+                 Utils::Vector3d const &origin,
+                 Utils::Vector3d const &spacing) {
+  auto const path = basename + ".pvti";
+  std::ofstream out(path);
+  if (!out) {
+    runtimeErrorMsg() << "Could not open file " << path << " for writing.";
+    return;
+  }
+
+  out << "<?xml version=\"1.0\"?>\n"
+      << "<VTKFile type=\"PImageData\" version=\"1.0\" byte_order=\""
+      << byte_order() << "\" header_type=\"UInt64\">\n"
+      << "  <PImageData WholeExtent=\"" << extent_string(whole_extent)
+      << "\" GhostLevel=\"0\" Origin=\"" << vector_string(origin)
+      << "\" Spacing=\"" << vector_string(spacing) << "\">\n"
+      << "    <PCellData>\n";
+  for (auto const &array : arrays) {
+    out << "      <PDataArray type=\"Float32\" Name=\"" << array.name
+        << "\" NumberOfComponents=\"" << array.n_components << "\"/>\n";
+  }
+  out << "    </PCellData>\n";
+  for (int rank = 0; rank < extents.size(); rank++) {
+    auto const &extent = extents[rank];
+    /* empty pieces are not written */
+    if (extent[1] <= extent[0])
+      continue;
+    out << "    <Piece Extent=\"" << extent_string(extent) << "\" Source=\""
+        << file_name(piece_path(basename, rank)) << "\"/>\n";
+  }
+  out << "  </PImageData>\n"
+      << "</VTKFile>\n";
+}
+} // namespace
+
+void lb_write_vtk_parallel(std::string const &basename, int fields,
+                           Utils::Vector3i const &bb_low,
+                           Utils::Vector3i const &bb_high, int stride) {
+  std::array<AxisRange, 3> range;
+  Utils::Vector<int, 6> whole_extent;
+  Utils::Vector<int, 6> extent;
+  Utils::Vector3d origin;
+  Utils::Vector3d spacing;
+  bool empty = false;
+  for (int dir = 0; dir < 3; dir++) {
+    range[dir] = local_axis_range(dir, bb_low[dir], bb_high[dir], stride);
+    empty |= (range[dir].n_nodes == 0);
+
+    /* extents are given in VTK points, a lattice node is a VTK cell */
+    whole_extent[2 * dir] = 0;
+    whole_extent[2 * dir + 1] = (bb_high[dir] - bb_low[dir]) / stride + 1;
+    extent[2 * dir] = range[dir].first_sample;
+    extent[2 * dir + 1] = range[dir].first_sample + range[dir].n_nodes;
+
+    /* cells are centered on the sampled lattice nodes */
+    origin[dir] = (bb_low[dir] + 0.5 * (1 - stride)) * lbpar.agrid;
+    spacing[dir] = stride * lbpar.agrid;
+  }
+  if (empty) {
+    extent = {};
+  }
+
+  auto const arrays = local_data_arrays(fields, range, stride);
+
+  if (!empty) {
+    write_piece(piece_path(basename, comm_cart.rank()), arrays, whole_extent,
+                extent, origin, spacing);
+  }
+
+  std::vector<Utils::Vector<int, 6>> extents;
+  boost::mpi::gather(comm_cart, extent, extents, 0);
+
+  if (comm_cart.rank() == 0) {
+    write_index(basename, arrays, whole_extent, extents, origin, spacing);
+  }
+}
+
+REGISTER_CALLBACK(lb_write_vtk_parallel)
+
+void mpi_lb_write_vtk_parallel(std::string const &basename, int fields,
+                               Utils::Vector3i const &bb_low,
+                               Utils::Vector3i const &bb_high, int stride) {
+  mpi_call_all(lb_write_vtk_parallel, basename, fields, bb_low, bb_high,
+               stride);
+}
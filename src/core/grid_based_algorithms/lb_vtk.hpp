@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Parallel output of the CPU LB fluid fields in the VTK XML format.
+ *
+ *  Every rank writes the part of the requested region that lies in its
+ *  local lattice as a binary image data piece (<tt>.vti</tt>), the head
+ *  node writes a parallel index file (<tt>.pvti</tt>) referencing all
+ *  non-empty pieces. Lattice nodes are stored as VTK cells, so that the
+ *  pieces of neighboring ranks tile the region without overlap.
+ *
+ *  Implementation in lb_vtk.cpp.
+ */
+
+#ifndef CORE_LB_VTK_HPP
+#define CORE_LB_VTK_HPP
+
+#include <utils/Vector.hpp>
+
+#include <string>
+
+/** @brief Write LB fluid fields of a region of the lattice.
+ *
+ *  Has to be called on all ranks.
+ *
+ *  @param basename  Output path without extension; the index file is
+ *                   <tt>basename.pvti</tt>, the piece of rank @c i is
+ *                   <tt>basename_i.vti</tt>
+ *  @param fields    Bitmask of @ref LBVTKField values
+ *  @param bb_low    Lower corner of the region (global node index)
+ *  @param bb_high   Upper corner of the region (global node index, inclusive)
+ *  @param stride    Only every @p stride-th node in each direction is written
+ */
+void lb_write_vtk_parallel(std::string const &basename, int fields,
+                           Utils::Vector3i const &bb_low,
+                           Utils::Vector3i const &bb_high, int stride);
+
+/** @brief Collectively write LB fluid fields from the head node.
+ *  See @ref lb_write_vtk_parallel for the parameters.
+ */
+void mpi_lb_write_vtk_parallel(std::string const &basename, int fields,
+                               Utils::Vector3i const &bb_low,
+                               Utils::Vector3i const &bb_high, int stride);
+
+#endif
@@ -55,6 +55,7 @@
 #include "rotation.hpp"
 #include "signalhandling.hpp"
 #include "thermostat.hpp"
+#include "tuning.hpp"
 #include "virtual_sites.hpp"
 
 #include "integrators/brownian_inline.hpp"
@@ -68,6 +69,7 @@
 #include <utils/constants.hpp>
 
 #include <boost/range/algorithm/min_element.hpp>
+#include <algorithm>
 #include <cmath>
 #include <mpi.h>
 
@@ -371,10 +373,20 @@ int python_integrate(int n_steps, bool recalc_forces, bool reuse_forces_par) {
   for (int i = 0; i < n_steps;) {
     /* Integrate to either the next accumulator update, or the
      * end, depending on what comes first. */
-    auto const steps = std::min((n_steps - i), auto_update_next_update());
+    auto const steps =
+        std::min({(n_steps - i), auto_update_next_update(),
+                  online_tuning_steps_left()});
+    /* Time only steps without an initial force calculation */
+    auto const initial_forces =
+        (reuse_forces == -1) or (::recalc_forces and reuse_forces != 1);
+    auto const tick = MPI_Wtime();
     if (mpi_integrate(steps, reuse_forces))
       return ES_ERROR;
 
+    if (not initial_forces) {
+      online_tuning_update(steps, MPI_Wtime() - tick, n_verlet_updates);
+    }
+
     reuse_forces = 1;
 
     auto_update(steps);
@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ * Single-file particle checkpoints.
+ *
+ * File layout:
+ * - A @ref CheckpointHeader.
+ * - A table of @ref CheckpointHeader::n_columns @ref ColumnEntry,
+ *   which store the name, element size, number of elements and byte
+ *   offset of every column.
+ * - The columns. Every column stores the elements of all particles
+ *   contiguously, in the order of the particles. Particle-based columns
+ *   hold one element per particle. Bonds and exclusions are stored as
+ *   one column holding the number of entries per particle and one column
+ *   holding the concatenated entries.
+ *
+ * The particle structures are written in their in-memory representation,
+ * hence the file can only be read by a build with the same features on
+ * the same architecture. This is checked with the element sizes stored
+ * in the column table. The number of ranks is not stored: on reading,
+ * every rank reads a contiguous block of particles, which are then sent
+ * to the ranks owning them.
+ */
+
+#include "mpiio.hpp"
+
+#include "Particle.hpp"
+#include "cells.hpp"
+#include "errorhandling.hpp"
+#include "event.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Mpiio {
+namespace {
+constexpr char checkpoint_magic[8] = "ESPRCKP";
+constexpr std::uint32_t checkpoint_version = 1;
+
+struct CheckpointHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t n_columns;
+  std::uint64_t n_part;
+};
+
+struct ColumnEntry {
+  char name[24];
+  std::uint64_t element_size;
+  std::uint64_t count;
+  std::uint64_t offset;
+};
+
+/** Names of the columns, in the order of the file. */
+enum Column : int {
+  COL_PROPERTIES,
+  COL_POSITION,
+  COL_MOMENTUM,
+  COL_FORCE,
+  COL_IMAGE,
+  COL_BOND_COUNT,
+  COL_BONDS,
+#ifdef EXCLUSIONS
+  COL_EXCLUSION_COUNT,
+  COL_EXCLUSIONS,
+#endif
+  COL_N
+};
+
+const char *column_name(int col) {
+  static const char *names[] = {"properties",      "position",
+                                "momentum",        "force",
+                                "image",           "bond_count",
+                                "bonds",
+#ifdef EXCLUSIONS
+                                "exclusion_count", "exclusions"
+#endif
+  };
+  return names[col];
+}
+
+/** Column element sizes of this build. */
+std::uint64_t column_element_size(int col) {
+  switch (col) {
+  case COL_PROPERTIES:
+    return sizeof(ParticleProperties);
+  case COL_POSITION:
+    return sizeof(ParticlePosition);
+  case COL_MOMENTUM:
+    return sizeof(ParticleMomentum);
+  case COL_FORCE:
+    return sizeof(ParticleForce);
+  case COL_IMAGE:
+    return sizeof(Utils::Vector3i);
+  default:
+    return sizeof(int);
+  }
+}
+
+static_assert(std::is_trivially_copyable<ParticleProperties>::value, "");
+static_assert(std::is_trivially_copyable<ParticlePosition>::value, "");
+static_assert(std::is_trivially_copyable<ParticleMomentum>::value, "");
+static_assert(std::is_trivially_copyable<ParticleForce>::value, "");
+
+void checkpoint_error(const std::string &fn, const char *what) {
+  fprintf(stderr, "MPI-IO Error: %s \"%s\".\n", what, fn.c_str());
+  errexit();
+}
+
+/** Compute the column table from the global column sizes.
+ *  The columns are aligned to 8 bytes.
+ */
+std::vector<ColumnEntry>
+column_table(std::vector<std::uint64_t> const &counts) {
+  std::vector<ColumnEntry> table(COL_N);
+  std::uint64_t offset =
+      sizeof(CheckpointHeader) + COL_N * sizeof(ColumnEntry);
+  for (int col = 0; col < COL_N; ++col) {
+    auto &entry = table[col];
+    std::memset(entry.name, 0, sizeof(entry.name));
+    std::strncpy(entry.name, column_name(col), sizeof(entry.name) - 1);
+    entry.element_size = column_element_size(col);
+    entry.count = counts[col];
+    entry.offset = offset;
+    offset += entry.count * entry.element_size;
+    offset = (offset + 7u) & ~std::uint64_t{7u};
+  }
+  return table;
+}
+
+/** Collectively write the elements [pref, pref + data.size()) of a
+ *  column. */
+template <typename T>
+int write_column(MPI_File f, ColumnEntry const &entry, std::vector<T> const &data,
+                 std::uint64_t pref) {
+  MPI_Datatype type;
+  MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &type);
+  MPI_Type_commit(&type);
+  auto const ret = MPI_File_write_at_all(
+      f, static_cast<MPI_Offset>(entry.offset + pref * sizeof(T)),
+      data.data(), static_cast<int>(data.size()), type, MPI_STATUS_IGNORE);
+  MPI_Type_free(&type);
+  return ret;
+}
+
+/** Collectively read the elements [pref, pref + data.size()) of a
+ *  column. */
+template <typename T>
+int read_column(MPI_File f, ColumnEntry const &entry, std::vector<T> &data,
+                std::uint64_t pref) {
+  MPI_Datatype type;
+  MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &type);
+  MPI_Type_commit(&type);
+  auto const ret = MPI_File_read_at_all(
+      f, static_cast<MPI_Offset>(entry.offset + pref * sizeof(T)), data.data(),
+      static_cast<int>(data.size()), type, MPI_STATUS_IGNORE);
+  MPI_Type_free(&type);
+  return ret;
+}
+
+std::uint64_t exscan(std::uint64_t local) {
+  std::uint64_t pref = 0;
+  MPI_Exscan(&local, &pref, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  return (rank == 0) ? 0 : pref;
+}
+
+std::uint64_t all_sum(std::uint64_t local) {
+  std::uint64_t sum = 0;
+  MPI_Allreduce(&local, &sum, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+  return sum;
+}
+
+/** Lengths of the lists of the particles and their concatenation. */
+template <class F>
+void pack_lists(const ParticleRange &particles, F list,
+                std::vector<int> &counts, std::vector<int> &entries) {
+  for (auto const &p : particles) {
+    auto const &l = list(p);
+    counts.push_back(static_cast<int>(l.size()));
+    entries.insert(entries.end(), l.begin(), l.end());
+  }
+}
+} // namespace
+
+void mpi_mpiio_checkpoint_write(const char *filename,
+                                const ParticleRange &particles) {
+  std::string const fn(filename);
+
+  std::vector<ParticleProperties> properties;
+  std::vector<ParticlePosition> position;
+  std::vector<ParticleMomentum> momentum;
+  std::vector<ParticleForce> force;
+  std::vector<Utils::Vector3i> image;
+  for (auto const &p : particles) {
+    properties.push_back(p.p);
+    position.push_back(p.r);
+    momentum.push_back(p.m);
+    force.push_back(p.f);
+    image.push_back(p.l.i);
+  }
+  std::vector<int> bond_count, bonds;
+  pack_lists(particles, [](Particle const &p) -> IntList const & {
+    return p.bl;
+  }, bond_count, bonds);
+#ifdef EXCLUSIONS
+  std::vector<int> exclusion_count, exclusions;
+  pack_lists(particles, [](Particle const &p) -> IntList const & {
+    return p.el;
+  }, exclusion_count, exclusions);
+#endif
+
+  std::vector<std::uint64_t> local_counts(COL_N, properties.size());
+  local_counts[COL_BONDS] = bonds.size();
+#ifdef EXCLUSIONS
+  local_counts[COL_EXCLUSIONS] = exclusions.size();
+#endif
+  std::vector<std::uint64_t> counts(COL_N), prefs(COL_N);
+  for (int col = 0; col < COL_N; ++col) {
+    counts[col] = all_sum(local_counts[col]);
+    prefs[col] = exscan(local_counts[col]);
+  }
+  auto const table = column_table(counts);
+
+  MPI_File f;
+  auto ret = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(fn.c_str()),
+                           MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL,
+                           MPI_INFO_NULL, &f);
+  if (ret)
+    checkpoint_error(fn, "Could not open file");
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (rank == 0) {
+    CheckpointHeader header{};
+    std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+    header.version = checkpoint_version;
+    header.n_columns = COL_N;
+    header.n_part = counts[COL_PROPERTIES];
+    ret |= MPI_File_write_at(f, 0, &header, sizeof(header), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+    ret |= MPI_File_write_at(f, sizeof(header), table.data(),
+                             static_cast<int>(COL_N * sizeof(ColumnEntry)),
+                             MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+
+  ret |= write_column(f, table[COL_PROPERTIES], properties,
+                      prefs[COL_PROPERTIES]);
+  ret |= write_column(f, table[COL_POSITION], position, prefs[COL_POSITION]);
+  ret |= write_column(f, table[COL_MOMENTUM], momentum, prefs[COL_MOMENTUM]);
+  ret |= write_column(f, table[COL_FORCE], force, prefs[COL_FORCE]);
+  ret |= write_column(f, table[COL_IMAGE], image, prefs[COL_IMAGE]);
+  ret |= write_column(f, table[COL_BOND_COUNT], bond_count,
+                      prefs[COL_BOND_COUNT]);
+  ret |= write_column(f, table[COL_BONDS], bonds, prefs[COL_BONDS]);
+#ifdef EXCLUSIONS
+  ret |= write_column(f, table[COL_EXCLUSION_COUNT], exclusion_count,
+                      prefs[COL_EXCLUSION_COUNT]);
+  ret |= write_column(f, table[COL_EXCLUSIONS], exclusions,
+                      prefs[COL_EXCLUSIONS]);
+#endif
+  MPI_File_close(&f);
+  if (ret)
+    checkpoint_error(fn, "Could not write file");
+}
+
+void mpi_mpiio_checkpoint_read(const char *filename) {
+  std::string const fn(filename);
+
+  MPI_File f;
+  auto ret = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(fn.c_str()),
+                           MPI_MODE_RDONLY, MPI_INFO_NULL, &f);
+  if (ret)
+    checkpoint_error(fn, "Could not open file");
+
+  /* Every rank reads and validates the header, so that all ranks agree
+   * on the file layout without further communication. */
+  CheckpointHeader header{};
+  ret = MPI_File_read_at_all(f, 0, &header, sizeof(header), MPI_BYTE,
+                             MPI_STATUS_IGNORE);
+  if (ret or std::memcmp(header.magic, checkpoint_magic, sizeof(header.magic)))
+    checkpoint_error(fn, "Not a checkpoint file");
+  if (header.version != checkpoint_version or header.n_columns != COL_N)
+    checkpoint_error(fn, "Unsupported checkpoint version or features in");
+
+  std::vector<ColumnEntry> table(COL_N);
+  ret = MPI_File_read_at_all(f, sizeof(header), table.data(),
+                             static_cast<int>(COL_N * sizeof(ColumnEntry)),
+                             MPI_BYTE, MPI_STATUS_IGNORE);
+  for (int col = 0; col < COL_N; ++col) {
+    if (std::strncmp(table[col].name, column_name(col),
+                     sizeof(table[col].name)) or
+        table[col].element_size != column_element_size(col)) {
+      checkpoint_error(fn, "Particle layout differs from this build for");
+    }
+  }
+
+  /* Contiguous block of particles of this rank, independent of the
+   * number of ranks that wrote the file. */
+  int size, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  auto const n_part = header.n_part;
+  auto const begin = n_part * rank / size;
+  auto const n_local = n_part * (rank + 1) / size - begin;
+
+  std::vector<ParticleProperties> properties(n_local);
+  std::vector<ParticlePosition> position(n_local);
+  std::vector<ParticleMomentum> momentum(n_local);
+  std::vector<ParticleForce> force(n_local);
+  std::vector<Utils::Vector3i> image(n_local);
+  std::vector<int> bond_count(n_local);
+  ret |= read_column(f, table[COL_PROPERTIES], properties, begin);
+  ret |= read_column(f, table[COL_POSITION], position, begin);
+  ret |= read_column(f, table[COL_MOMENTUM], momentum, begin);
+  ret |= read_column(f, table[COL_FORCE], force, begin);
+  ret |= read_column(f, table[COL_IMAGE], image, begin);
+  ret |= read_column(f, table[COL_BOND_COUNT], bond_count, begin);
+
+  auto const read_lists = [&](std::vector<int> const &list_count, int col) {
+    std::uint64_t n_entries = 0;
+    for (auto const n : list_count)
+      n_entries += n;
+    std::vector<int> entries(n_entries);
+    ret |= read_column(f, table[col], entries, exscan(n_entries));
+    return entries;
+  };
+  auto const bonds = read_lists(bond_count, COL_BONDS);
+#ifdef EXCLUSIONS
+  std::vector<int> exclusion_count(n_local);
+  ret |= read_column(f, table[COL_EXCLUSION_COUNT], exclusion_count, begin);
+  auto const exclusions = read_lists(exclusion_count, COL_EXCLUSIONS);
+#endif
+  MPI_File_close(&f);
+  if (ret)
+    checkpoint_error(fn, "Could not read file");
+
+  cell_structure.remove_all_particles();
+
+  auto bond_it = bonds.begin();
+#ifdef EXCLUSIONS
+  auto exclusion_it = exclusions.begin();
+#endif
+  for (std::size_t i = 0; i < n_local; ++i) {
+    Particle p;
+    p.p = properties[i];
+    p.r = position[i];
+    p.m = momentum[i];
+    p.f = force[i];
+    p.l.i = image[i];
+    p.bl.resize(bond_count[i]);
+    std::copy_n(bond_it, bond_count[i], p.bl.begin());
+    bond_it += bond_count[i];
+#ifdef EXCLUSIONS
+    p.el.resize(exclusion_count[i]);
+    std::copy_n(exclusion_it, exclusion_count[i], p.el.begin());
+    exclusion_it += exclusion_count[i];
+#endif
+    cell_structure.add_particle(std::move(p));
+  }
+
+  /* Send the particles to the ranks owning them. */
+  cells_resort_particles(Cells::RESORT_GLOBAL);
+  on_particle_change();
+}
+} // namespace Mpiio
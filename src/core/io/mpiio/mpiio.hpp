@@ -56,6 +56,25 @@ void mpi_mpiio_common_write(const char *filename, unsigned fields,
  */
 void mpi_mpiio_common_read(const char *filename, unsigned fields);
 
+/** Write the complete state of all particles to a single file using
+ *  collective MPI-IO. To be called by all MPI processes. Aborts ESPResSo
+ *  if an error occurs.
+ *
+ * \param filename A null-terminated filename. The file must not exist.
+ * \param particles The local particles.
+ */
+void mpi_mpiio_checkpoint_write(const char *filename,
+                                const ParticleRange &particles);
+
+/** Read a file written by @ref mpi_mpiio_checkpoint_write and replace
+ *  all particles by its content. The file can be read on any number of
+ *  MPI processes, the particles are sent to the processes owning them.
+ *  To be called by all MPI processes. Aborts ESPResSo if an error occurs.
+ *
+ * \param filename A null-terminated filename.
+ */
+void mpi_mpiio_checkpoint_read(const char *filename);
+
 } // namespace Mpiio
 
 #endif
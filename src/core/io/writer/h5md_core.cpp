@@ -20,13 +20,17 @@
  */
 
 #include "h5md_core.hpp"
+#include "ParticleColumns.hpp"
 #include "bonded_interactions/bonded_interaction_data.hpp"
 #include "communication.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
 #include "version.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <numeric>
 #include <vector>
 
 namespace Writer {
@@ -68,7 +72,7 @@ std::vector<hsize_t> File::create_chunk_dims(hsize_t dim, hsize_t size,
   if (dim == 2)
     return std::vector<hsize_t>{chunk_size, size};
   if (dim == 1)
-    return std::vector<hsize_t>{size};
+    return std::vector<hsize_t>{chunk_size};
 
   throw std::runtime_error(
       "H5MD Error: datasets with this dimension are not implemented\n");
@@ -85,6 +89,24 @@ static std::vector<hsize_t> create_maxdims(hsize_t dim) {
       "H5MD Error: datasets with this dimension are not implemented\n");
 }
 
+/** The HDF5 library is only thread-safe if it was built with
+ *  --enable-threadsafe, which is not possible for parallel HDF5. All calls
+ *  which can overlap with the I/O thread of a file in asynchronous mode are
+ *  serialized with this lock, which is shared by all files.
+ */
+static std::mutex hdf5_mutex;
+
+/** Size of the chunk cache of datasets that are chunked in time. */
+static constexpr std::size_t chunk_cache_bytes = 64 * 1024 * 1024;
+/** Number of hash slots of the chunk cache, a prime number. */
+static constexpr std::size_t chunk_cache_slots = 12421;
+
+/** Number of decimal digits that have to be kept to represent values
+ *  with an absolute error of at most @p precision. */
+static int decimal_scale_factor(double precision) {
+  return static_cast<int>(std::ceil(-std::log10(precision)));
+}
+
 /* Initialize the file related variables after parameters have been set. */
 void File::InitFile() {
   m_backup_filename = m_filename + ".bak";
@@ -92,6 +114,25 @@ void File::InitFile() {
   // is in order to avoid  blocking by collective functions
   auto world = boost::mpi::communicator();
 
+  if (m_asynchronous)
+    m_write_ordered = true;
+  if (m_compression < 0 || m_compression > 9)
+    throw std::invalid_argument(
+        "H5MD Error: compression level has to be in [0, 9]");
+  if (m_chunk_frames < 1)
+    throw std::invalid_argument(
+        "H5MD Error: chunk_frames has to be a positive integer");
+  if (m_precision < 0.)
+    throw std::invalid_argument("H5MD Error: precision cannot be negative");
+
+  std::unique_lock<std::mutex> hdf5_lock(hdf5_mutex);
+  /* Filters require collective writes with the parallel driver. */
+  if (m_dxpl != H5P_DEFAULT)
+    H5Pclose(m_dxpl);
+  m_dxpl = H5Pcreate(H5P_DATASET_XFER);
+  if (!m_write_ordered && (m_compression > 0 || m_precision > 0.))
+    H5Pset_dxpl_mpio(m_dxpl, H5FD_MPIO_COLLECTIVE);
+
   if (m_write_ordered)
     m_hdf5_comm = world.split(world.rank(), 0);
   else
@@ -129,6 +170,14 @@ void File::InitFile() {
       throw left_backupfile();
     create_new_file(m_filename);
   }
+
+  hdf5_lock.unlock();
+
+  if (m_asynchronous && !m_io_thread.joinable()) {
+    for (int i = 0; i < 2; i++)
+      m_free_frames.emplace_back(new Frame);
+    m_io_thread = std::thread(&File::io_thread_loop, this);
+  }
 }
 
 void File::init_filestructure() {
@@ -149,19 +198,19 @@ void File::init_filestructure() {
   h5xx::datatype type_int = h5xx::datatype(H5T_NATIVE_INT);
 
   dataset_descriptors = {
-      // path, dim, type
-      {"particles/atoms/box/edges", 1, type_double},
-      {"particles/atoms/mass/value", 2, type_double},
-      {"particles/atoms/charge/value", 2, type_double},
-      {"particles/atoms/id/value", 2, type_int},
-      {"particles/atoms/id/time", 1, type_double},
-      {"particles/atoms/id/step", 1, type_int},
-      {"particles/atoms/species/value", 2, type_int},
-      {"particles/atoms/position/value", 3, type_double},
-      {"particles/atoms/velocity/value", 3, type_double},
-      {"particles/atoms/force/value", 3, type_double},
-      {"particles/atoms/image/value", 3, type_int},
-      {"connectivity/atoms", 2, type_int},
+      // path, dim, type, time series, quantizable
+      {"particles/atoms/box/edges", 1, type_double, false, false},
+      {"particles/atoms/mass/value", 2, type_double, true, false},
+      {"particles/atoms/charge/value", 2, type_double, true, false},
+      {"particles/atoms/id/value", 2, type_int, true, false},
+      {"particles/atoms/id/time", 1, type_double, true, false},
+      {"particles/atoms/id/step", 1, type_int, true, false},
+      {"particles/atoms/species/value", 2, type_int, true, false},
+      {"particles/atoms/position/value", 3, type_double, true, true},
+      {"particles/atoms/velocity/value", 3, type_double, true, true},
+      {"particles/atoms/force/value", 3, type_double, true, true},
+      {"particles/atoms/image/value", 3, type_int, true, false},
+      {"connectivity/atoms", 2, type_int, false, false},
   };
 }
 
@@ -176,13 +225,23 @@ void File::create_datasets(bool only_load) {
                                      // sure to call ExtendDataset before
                                      // writing to dataset
       // we deal now with a particle based property, change chunk. Important
-      // for IO performance!
+      // for IO performance! Time series are chunked over several time steps
+      // if requested, to speed up reading the trajectory of a particle.
       int chunk_size = (descr.dim > 1) ? 1000 : 1;
+      int chunk_frames = descr.time_series ? m_chunk_frames : 1;
 
       auto dims = create_dims(descr.dim, creation_size_dataset);
-      auto chunk_dims = create_chunk_dims(descr.dim, chunk_size, 1);
+      auto chunk_dims = create_chunk_dims(descr.dim, chunk_size, chunk_frames);
       auto maxdims = create_maxdims(descr.dim);
       auto storage = h5xx::policy::storage::chunked(chunk_dims);
+      if (descr.quantizable && m_precision > 0.) {
+        storage.add(h5xx::policy::filter::scaleoffset<double>(
+            decimal_scale_factor(m_precision)));
+      }
+      if (descr.time_series && m_compression > 0) {
+        storage.add(h5xx::policy::filter::shuffle());
+        storage.add(h5xx::policy::filter::deflate(m_compression));
+      }
       if (descr.type.get_type_id() == H5T_NATIVE_INT)
         storage.set(h5xx::policy::storage::fill_value(static_cast<int>(-10)));
       else if (descr.type.get_type_id() == H5T_NATIVE_DOUBLE)
@@ -194,8 +253,16 @@ void File::create_datasets(bool only_load) {
       auto dataspace = h5xx::dataspace(dims, maxdims);
       hid_t lcpl_id = H5Pcreate(H5P_LINK_CREATE);
       H5Pset_create_intermediate_group(lcpl_id, 1);
+      hid_t dapl_id = H5Pcreate(H5P_DATASET_ACCESS);
+      if (chunk_frames > 1) {
+        /* Partially written chunks are kept in memory until they are
+         * complete, instead of being read back for every time step. */
+        H5Pset_chunk_cache(dapl_id, chunk_cache_slots, chunk_cache_bytes, 1.);
+      }
       datasets[path] = h5xx::dataset(m_h5md_file, path, descr.type, dataspace,
-                                     storage, lcpl_id, H5P_DEFAULT);
+                                     storage, lcpl_id, dapl_id);
+      H5Pclose(dapl_id);
+      H5Pclose(lcpl_id);
     }
   }
   if (!only_load)
@@ -236,9 +303,14 @@ void File::create_links_for_time_and_step_datasets() {
                  "particles/atoms/charge/step", H5P_DEFAULT, H5P_DEFAULT);
 }
 
+/* In asynchronous mode, the file is written by a thread without MPI
+ * calls, so the sequential driver is used. */
 void File::load_file(const std::string &filename) {
-  m_h5md_file =
-      h5xx::file(filename, m_hdf5_comm, MPI_INFO_NULL, h5xx::file::out);
+  if (m_asynchronous)
+    m_h5md_file = h5xx::file(filename, h5xx::file::out);
+  else
+    m_h5md_file =
+        h5xx::file(filename, m_hdf5_comm, MPI_INFO_NULL, h5xx::file::out);
   bool only_load = true;
   create_datasets(only_load);
 }
@@ -248,8 +320,11 @@ void File::create_new_file(const std::string &filename) {
     this->WriteScript(filename);
   MPI_Barrier(m_hdf5_comm);
   /* Create a new h5xx file object. */
-  m_h5md_file =
-      h5xx::file(filename, m_hdf5_comm, MPI_INFO_NULL, h5xx::file::out);
+  if (m_asynchronous)
+    m_h5md_file = h5xx::file(filename, h5xx::file::out);
+  else
+    m_h5md_file =
+        h5xx::file(filename, m_hdf5_comm, MPI_INFO_NULL, h5xx::file::out);
 
   auto h5md_group = h5xx::group(m_h5md_file, "h5md");
   std::vector<int> h5md_version = {1, 1};
@@ -277,70 +352,86 @@ void File::create_new_file(const std::string &filename) {
   h5xx::write_dataset(datasets[path_edges], boxvec);
 }
 
+File::~File() {
+  if (m_io_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_io_mutex);
+      m_io_stop = true;
+    }
+    m_io_cv.notify_all();
+    m_io_thread.join();
+  }
+  /* Close the file here, the members are destroyed without the lock. */
+  std::lock_guard<std::mutex> hdf5_lock(hdf5_mutex);
+  datasets.clear();
+  dataset_descriptors.clear();
+  m_h5md_file.close();
+  if (m_dxpl != H5P_DEFAULT)
+    H5Pclose(m_dxpl);
+}
+
 void File::Close() {
+  if (m_asynchronous && this_node == 0)
+    wait_for_io();
   if (this_node == 0)
     boost::filesystem::remove(m_backup_filename);
 }
 
-void File::fill_arrays_for_h5md_write_with_particle_property(
-    int particle_index, int_array_3d &id, int_array_3d &typ,
-    double_array_3d &mass, double_array_3d &pos, int_array_3d &image,
-    double_array_3d &vel, double_array_3d &f, double_array_3d &charge,
-    Particle const &current_particle, int write_dat, int_array_3d &bond) {
-  bool write_species = write_dat & W_TYPE;
-  bool write_pos = write_dat & W_POS;
-  bool write_vel = write_dat & W_V;
-  bool write_force = write_dat & W_F;
-  bool write_mass = write_dat & W_MASS;
-  bool write_charge = write_dat & W_CHARGE;
-
-  id[0][particle_index][0] = current_particle.p.identity;
-  if (write_species)
-    typ[0][particle_index][0] = current_particle.p.type;
-  if (write_mass)
-    mass[0][particle_index][0] = current_particle.p.mass;
+void File::Frame::resize(int n) {
+  n_local = n;
+  id.resize(n);
+  type.resize(n);
+  mass.resize(n);
+  charge.resize(n);
+  pos.resize(3 * n);
+  image.resize(3 * n);
+  vel.resize(3 * n);
+  force.resize(3 * n);
+  bond.clear();
+}
+
+void File::fill_frame_with_particle_property(
+    Frame &frame, int particle_index, Particle const &current_particle) {
+  auto const write_dat = frame.write_dat;
+  auto const i = particle_index;
+
+  frame.id[i] = current_particle.p.identity;
+  if (write_dat & W_TYPE)
+    frame.type[i] = current_particle.p.type;
+  if (write_dat & W_MASS)
+    frame.mass[i] = current_particle.p.mass;
   /* store folded particle positions. */
-  if (write_pos) {
+  if (write_dat & W_POS) {
     Utils::Vector3d p = current_particle.r.p;
-    Utils::Vector3i i = current_particle.l.i;
-    fold_position(p, i, box_geo);
-
-    pos[0][particle_index][0] = p[0];
-    pos[0][particle_index][1] = p[1];
-    pos[0][particle_index][2] = p[2];
-    image[0][particle_index][0] = i[0];
-    image[0][particle_index][1] = i[1];
-    image[0][particle_index][2] = i[2];
-  }
+    Utils::Vector3i img = current_particle.l.i;
+    fold_position(p, img, box_geo);
 
-  if (write_vel) {
-    vel[0][particle_index][0] = current_particle.m.v[0];
-    vel[0][particle_index][1] = current_particle.m.v[1];
-    vel[0][particle_index][2] = current_particle.m.v[2];
+    std::copy(p.begin(), p.end(), frame.pos.begin() + 3 * i);
+    std::copy(img.begin(), img.end(), frame.image.begin() + 3 * i);
   }
-  if (write_force) {
-    f[0][particle_index][0] = current_particle.f.f[0];
-    f[0][particle_index][1] = current_particle.f.f[1];
-    f[0][particle_index][2] = current_particle.f.f[2];
+  if (write_dat & W_V) {
+    std::copy(current_particle.m.v.begin(), current_particle.m.v.end(),
+              frame.vel.begin() + 3 * i);
   }
-  if (write_charge) {
+  if (write_dat & W_F) {
+    std::copy(current_particle.f.f.begin(), current_particle.f.f.end(),
+              frame.force.begin() + 3 * i);
+  }
+  if (write_dat & W_CHARGE) {
 #ifdef ELECTROSTATICS
-    charge[0][particle_index][0] = current_particle.p.q;
+    frame.charge[i] = current_particle.p.q;
 #endif
   }
 
-  if (!m_already_wrote_bonds) {
-    int nbonds_local = bond.shape()[1];
+  if (frame.write_bonds) {
     for (auto it = current_particle.bl.begin();
          it != current_particle.bl.end();) {
 
       auto const n_partners = bonded_ia_params[*it++].num;
 
       if (1 == n_partners) {
-        bond.resize(boost::extents[1][nbonds_local + 1][2]);
-        bond[0][nbonds_local][0] = current_particle.p.identity;
-        bond[0][nbonds_local][1] = *it++;
-        nbonds_local++;
+        frame.bond.push_back(current_particle.p.identity);
+        frame.bond.push_back(*it++);
       } else {
         it += n_partners;
       }
@@ -348,81 +439,160 @@ void File::fill_arrays_for_h5md_write_with_particle_property(
   }
 }
 
+void File::fill_frame_ordered(Frame &frame, PartCfg &partCfg) {
+  auto const write_dat = frame.write_dat;
+  unsigned fields = 0;
+  if (write_dat & W_POS)
+    fields |= PARTICLE_FIELD_FOLDED_POSITION | PARTICLE_FIELD_IMAGE;
+  if (write_dat & W_V)
+    fields |= PARTICLE_FIELD_VELOCITY;
+  if (write_dat & W_F)
+    fields |= PARTICLE_FIELD_FORCE;
+  if (write_dat & W_TYPE)
+    fields |= PARTICLE_FIELD_TYPE;
+  if (write_dat & W_MASS)
+    fields |= PARTICLE_FIELD_MASS;
+  if (write_dat & W_CHARGE)
+    fields |= PARTICLE_FIELD_CHARGE;
+
+  /* Only the requested properties are sent, the particles of all nodes
+   * are then put in the order of their ids. */
+  auto const columns = mpi_gather_particle_columns(fields);
+  std::vector<int> order(columns.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&columns](int a, int b) { return columns.id[a] < columns.id[b]; });
+
+  frame.resize(static_cast<int>(columns.size()));
+  for (int i = 0; i < frame.n_local; i++) {
+    auto const j = order[i];
+    frame.id[i] = columns.id[j];
+    if (write_dat & W_TYPE)
+      frame.type[i] = columns.type[j];
+    if (write_dat & W_MASS)
+      frame.mass[i] = columns.mass[j];
+    if (write_dat & W_POS) {
+      std::copy(columns.pos[j].begin(), columns.pos[j].end(),
+                frame.pos.begin() + 3 * i);
+      std::copy(columns.image[j].begin(), columns.image[j].end(),
+                frame.image.begin() + 3 * i);
+    }
+    if (write_dat & W_V) {
+      std::copy(columns.v[j].begin(), columns.v[j].end(),
+                frame.vel.begin() + 3 * i);
+    }
+    if (write_dat & W_F) {
+      std::copy(columns.f[j].begin(), columns.f[j].end(),
+                frame.force.begin() + 3 * i);
+    }
+    if (write_dat & W_CHARGE)
+      frame.charge[i] = columns.q[j];
+  }
+
+  /* The bonds are only written once, so the full particles are only
+   * needed for the first frame. */
+  if (frame.write_bonds) {
+    for (auto const &p : partCfg) {
+      for (auto it = p.bl.begin(); it != p.bl.end();) {
+        auto const n_partners = bonded_ia_params[*it++].num;
+        if (1 == n_partners) {
+          frame.bond.push_back(p.p.identity);
+          frame.bond.push_back(*it++);
+        } else {
+          it += n_partners;
+        }
+      }
+    }
+  }
+}
+
 void File::Write(int write_dat, PartCfg &partCfg,
                  const ParticleRange &particles) {
-  int num_particles_to_be_written = 0;
-  int n_part = 0;
-  if (m_write_ordered && this_node == 0) {
-    num_particles_to_be_written = partCfg.size();
-    n_part = partCfg.size();
-  } else if (m_write_ordered && this_node != 0)
+  if (m_write_ordered && this_node != 0)
     return;
-  else if (!m_write_ordered) {
-    num_particles_to_be_written = particles.size();
-    n_part = boost::mpi::all_reduce(m_hdf5_comm, num_particles_to_be_written,
-                                    std::plus<int>());
+
+  std::unique_ptr<Frame> async_frame;
+  if (m_asynchronous) {
+    /* Wait for a free staging buffer. */
+    std::unique_lock<std::mutex> lock(m_io_mutex);
+    m_io_cv.wait(lock, [this]() {
+      return !m_free_frames.empty() || m_io_error;
+    });
+    if (m_io_error) {
+      lock.unlock();
+      wait_for_io();
+    }
+    async_frame = std::move(m_free_frames.back());
+    m_free_frames.pop_back();
   }
+  auto &frame = m_asynchronous ? *async_frame : m_frame;
 
-  bool write_species = write_dat & W_TYPE;
-  bool write_pos = write_dat & W_POS;
-  bool write_vel = write_dat & W_V;
-  bool write_force = write_dat & W_F;
-  bool write_mass = write_dat & W_MASS;
-  bool write_charge = write_dat & W_CHARGE;
-
-  double_array_3d pos(boost::extents[1][num_particles_to_be_written][3]);
-  double_array_3d vel(boost::extents[1][num_particles_to_be_written][3]);
-  double_array_3d f(boost::extents[1][num_particles_to_be_written][3]);
-  int_array_3d image(boost::extents[1][num_particles_to_be_written][3]);
-  int_array_3d id(boost::extents[1][num_particles_to_be_written][1]);
-  int_array_3d typ(boost::extents[1][num_particles_to_be_written][1]);
-  double_array_3d mass(boost::extents[1][num_particles_to_be_written][1]);
-  double_array_3d charge(boost::extents[1][num_particles_to_be_written][1]);
-  double_array_3d time(boost::extents[1][1][1]);
-  time[0][0][0] = sim_time;
-  int_array_3d step(boost::extents[1][1][1]);
-  step[0][0][0] = (int)std::round(sim_time / time_step);
-  int_array_3d bond(boost::extents[0][0][0]);
+  frame.write_dat = write_dat;
+  frame.time = sim_time;
+  frame.step = static_cast<int>(std::round(sim_time / time_step));
+  frame.write_bonds = !m_already_wrote_bonds;
+  m_already_wrote_bonds = true;
 
   if (m_write_ordered) {
-    if (this_node == 0) {
-      // loop over all particles
-      int particle_index = 0;
-      for (auto const &current_particle : partCfg) {
-        fill_arrays_for_h5md_write_with_particle_property(
-            particle_index++, id, typ, mass, pos, image, vel, f, charge,
-            current_particle, write_dat, bond);
-      }
-    }
+    fill_frame_ordered(frame, partCfg);
+    frame.prefix = 0;
+    frame.n_part = frame.n_local;
+    frame.prefix_bonds = 0;
+    frame.n_bonds_total = static_cast<int>(frame.bond.size() / 2);
   } else {
+    frame.resize(static_cast<int>(particles.size()));
     /* loop over all local cells. */
     int particle_index = 0;
-
     for (auto &current_particle : particles) {
-      fill_arrays_for_h5md_write_with_particle_property(
-          particle_index, id, typ, mass, pos, image, vel, f, charge,
-          current_particle, write_dat, bond);
-      particle_index++;
+      fill_frame_with_particle_property(frame, particle_index++,
+                                        current_particle);
     }
+
+    // calculate prefix for write of the current process
+    frame.prefix = 0;
+    MPI_Exscan(&frame.n_local, &frame.prefix, 1, MPI_INT, MPI_SUM,
+               m_hdf5_comm);
+    frame.n_part = boost::mpi::all_reduce(m_hdf5_comm, frame.n_local,
+                                          std::plus<int>());
+    if (frame.write_bonds) {
+      // communicate the total number of bonds to all processes since
+      // extending is a collective hdf5 function
+      int nbonds_local = static_cast<int>(frame.bond.size() / 2);
+      frame.prefix_bonds = 0;
+      MPI_Exscan(&nbonds_local, &frame.prefix_bonds, 1, MPI_INT, MPI_SUM,
+                 m_hdf5_comm);
+      MPI_Allreduce(&nbonds_local, &frame.n_bonds_total, 1, MPI_INT, MPI_SUM,
+                    m_hdf5_comm);
+    }
+  }
+
+  if (m_asynchronous) {
+    {
+      std::lock_guard<std::mutex> lock(m_io_mutex);
+      m_pending_frames.push_back(std::move(async_frame));
+    }
+    m_io_cv.notify_all();
+  } else {
+    std::lock_guard<std::mutex> hdf5_lock(hdf5_mutex);
+    WriteFrame(frame);
   }
+}
+
+void File::WriteFrame(Frame const &frame) {
+  auto const write_dat = frame.write_dat;
 
-  // calculate count and offset
-  int prefix = 0;
-  // calculate prefix for write of the current process
-  MPI_Exscan(&num_particles_to_be_written, &prefix, 1, MPI_INT, MPI_SUM,
-             m_hdf5_comm);
   hid_t ds = H5Dget_space(datasets["particles/atoms/id/value"].hid());
   hsize_t dims_id[2], maxdims_id[2];
   H5Sget_simple_extent_dims(ds, dims_id, maxdims_id);
   H5Sclose(ds);
 
   hsize_t offset_1d[1] = {dims_id[0]};
-  hsize_t offset_2d[2] = {dims_id[0], (hsize_t)prefix};
-  hsize_t offset_3d[3] = {dims_id[0], (hsize_t)prefix, 0};
+  hsize_t offset_2d[2] = {dims_id[0], (hsize_t)frame.prefix};
+  hsize_t offset_3d[3] = {dims_id[0], (hsize_t)frame.prefix, 0};
 
   hsize_t count_1d[1] = {1};
-  hsize_t count_2d[2] = {1, (hsize_t)num_particles_to_be_written};
-  hsize_t count_3d[3] = {1, (hsize_t)num_particles_to_be_written, 3};
+  hsize_t count_2d[2] = {1, (hsize_t)frame.n_local};
+  hsize_t count_3d[3] = {1, (hsize_t)frame.n_local, 3};
 
   // calculate the change of the extent for fluctuating particle numbers
   int old_max_n_part =
@@ -431,8 +601,8 @@ void File::Write(int write_dat, PartCfg &partCfg,
                                                // previous dimension, if we
                                                // append to an already existing
                                                // dataset
-  if (n_part > old_max_n_part) {
-    m_max_n_part = n_part;
+  if (frame.n_part > old_max_n_part) {
+    m_max_n_part = frame.n_part;
   } else {
     m_max_n_part = old_max_n_part;
   }
@@ -442,63 +612,92 @@ void File::Write(int write_dat, PartCfg &partCfg,
   std::vector<int> change_extent_2d = {1, extent_particle_number};
   std::vector<int> change_extent_3d = {1, extent_particle_number, 0};
 
-  if (!m_already_wrote_bonds) {
-    // communicate the total number of bonds to all processes since extending is
-    // a collective hdf5 function
-    int nbonds_local = bond.shape()[1];
-    int nbonds_total = nbonds_local;
-    int prefix_bonds = 0;
-    if (!m_write_ordered) {
-      MPI_Exscan(&nbonds_local, &prefix_bonds, 1, MPI_INT, MPI_SUM,
-                 m_hdf5_comm);
-      MPI_Allreduce(&nbonds_local, &nbonds_total, 1, MPI_INT, MPI_SUM,
-                    m_hdf5_comm);
-    }
-    hsize_t offset_bonds[2] = {(hsize_t)prefix_bonds, 0};
-    hsize_t count_bonds[2] = {(hsize_t)nbonds_local, 2};
-    std::vector<int> change_extent_bonds = {nbonds_total, 2};
-    WriteDataset(bond, "connectivity/atoms", change_extent_bonds, offset_bonds,
-                 count_bonds);
-    m_already_wrote_bonds = true;
+  if (frame.write_bonds) {
+    hsize_t offset_bonds[2] = {(hsize_t)frame.prefix_bonds, 0};
+    hsize_t count_bonds[2] = {(hsize_t)(frame.bond.size() / 2), 2};
+    std::vector<int> change_extent_bonds = {frame.n_bonds_total, 2};
+    WriteDataset(frame.bond.data(), "connectivity/atoms", change_extent_bonds,
+                 offset_bonds, count_bonds);
   }
 
-  WriteDataset(id, "particles/atoms/id/value", change_extent_2d, offset_2d,
-               count_2d);
-  WriteDataset(time, "particles/atoms/id/time", change_extent_1d, offset_1d,
-               count_1d);
-  WriteDataset(step, "particles/atoms/id/step", change_extent_1d, offset_1d,
-               count_1d);
+  WriteDataset(frame.id.data(), "particles/atoms/id/value", change_extent_2d,
+               offset_2d, count_2d);
+  WriteDataset(&frame.time, "particles/atoms/id/time", change_extent_1d,
+               offset_1d, count_1d);
+  WriteDataset(&frame.step, "particles/atoms/id/step", change_extent_1d,
+               offset_1d, count_1d);
 
-  if (write_species) {
-    WriteDataset(typ, "particles/atoms/species/value", change_extent_2d,
-                 offset_2d, count_2d);
+  if (write_dat & W_TYPE) {
+    WriteDataset(frame.type.data(), "particles/atoms/species/value",
+                 change_extent_2d, offset_2d, count_2d);
   }
-  if (write_mass) {
-    WriteDataset(mass, "particles/atoms/mass/value", change_extent_2d,
-                 offset_2d, count_2d);
+  if (write_dat & W_MASS) {
+    WriteDataset(frame.mass.data(), "particles/atoms/mass/value",
+                 change_extent_2d, offset_2d, count_2d);
   }
-  if (write_pos) {
-    WriteDataset(pos, "particles/atoms/position/value", change_extent_3d,
-                 offset_3d, count_3d);
-    WriteDataset(image, "particles/atoms/image/value", change_extent_3d,
-                 offset_3d, count_3d);
+  if (write_dat & W_POS) {
+    WriteDataset(frame.pos.data(), "particles/atoms/position/value",
+                 change_extent_3d, offset_3d, count_3d);
+    WriteDataset(frame.image.data(), "particles/atoms/image/value",
+                 change_extent_3d, offset_3d, count_3d);
   }
-  if (write_vel) {
-    WriteDataset(vel, "particles/atoms/velocity/value", change_extent_3d,
-                 offset_3d, count_3d);
+  if (write_dat & W_V) {
+    WriteDataset(frame.vel.data(), "particles/atoms/velocity/value",
+                 change_extent_3d, offset_3d, count_3d);
   }
-  if (write_force) {
-    WriteDataset(f, "particles/atoms/force/value", change_extent_3d, offset_3d,
-                 count_3d);
+  if (write_dat & W_F) {
+    WriteDataset(frame.force.data(), "particles/atoms/force/value",
+                 change_extent_3d, offset_3d, count_3d);
   }
-  if (write_charge) {
+  if (write_dat & W_CHARGE) {
 #ifdef ELECTROSTATICS
-    WriteDataset(charge, "particles/atoms/charge/value", change_extent_2d,
-                 offset_2d, count_2d);
+    WriteDataset(frame.charge.data(), "particles/atoms/charge/value",
+                 change_extent_2d, offset_2d, count_2d);
 #endif
   }
 }
 
+void File::io_thread_loop() {
+  std::unique_lock<std::mutex> lock(m_io_mutex);
+  while (true) {
+    m_io_cv.wait(lock,
+                 [this]() { return m_io_stop || !m_pending_frames.empty(); });
+    if (m_pending_frames.empty())
+      return;
+
+    auto frame = std::move(m_pending_frames.front());
+    m_pending_frames.pop_front();
+    m_io_busy = true;
+    lock.unlock();
+
+    std::exception_ptr error;
+    try {
+      std::lock_guard<std::mutex> hdf5_lock(hdf5_mutex);
+      WriteFrame(*frame);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    if (error && !m_io_error)
+      m_io_error = error;
+    m_free_frames.push_back(std::move(frame));
+    m_io_busy = false;
+    m_io_cv.notify_all();
+  }
+}
+
+void File::wait_for_io() {
+  std::unique_lock<std::mutex> lock(m_io_mutex);
+  m_io_cv.wait(lock,
+               [this]() { return m_pending_frames.empty() && !m_io_busy; });
+  if (m_io_error) {
+    auto error = m_io_error;
+    m_io_error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
 void File::ExtendDataset(const std::string &path,
                          const std::vector<int> &change_extent) {
   /* Until now the h5xx does not support dataset extending, so we
@@ -517,9 +716,7 @@ void File::ExtendDataset(const std::string &path,
   H5Dset_extent(dataset.hid(), dims.data()); // extend all dims is collective
 }
 
-/* data is assumed to be three dimensional */
-template <typename T>
-void File::WriteDataset(T &data, const std::string &path,
+void File::WriteDataset(const void *data, const std::string &path,
                         const std::vector<int> &change_extent, hsize_t *offset,
                         hsize_t *count) {
   ExtendDataset(path, change_extent);
@@ -534,8 +731,7 @@ void File::WriteDataset(T &data, const std::string &path,
   /* Create a temporary dataspace. */
   hid_t ds_new = H5Screate_simple(rank, count, maxdims.data());
   /* Finally write the data to the dataset. */
-  H5Dwrite(dataset.hid(), dataset.get_type(), ds_new, ds, H5P_DEFAULT,
-           data.origin());
+  H5Dwrite(dataset.hid(), dataset.get_type(), ds_new, ds, m_dxpl, data);
   H5Sclose(ds_new);
   H5Sclose(ds);
 }
@@ -579,10 +775,16 @@ void File::WriteScript(std::string const &filename) {
 
 void File::Flush() {
   if (m_write_ordered) {
-    if (this_node == 0)
+    if (this_node == 0) {
+      if (m_asynchronous)
+        wait_for_io();
+      std::lock_guard<std::mutex> hdf5_lock(hdf5_mutex);
       H5Fflush(m_h5md_file.hid(), H5F_SCOPE_GLOBAL);
-  } else
+    }
+  } else {
+    std::lock_guard<std::mutex> hdf5_lock(hdf5_mutex);
     H5Fflush(m_h5md_file.hid(), H5F_SCOPE_GLOBAL);
+  }
 }
 
 bool File::check_for_H5MD_structure(std::string const &filename) {
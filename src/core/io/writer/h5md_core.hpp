@@ -27,8 +27,15 @@
 #include <h5xx/h5xx.hpp>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "PartCfg.hpp"
 #include "ParticleRange.hpp"
@@ -49,7 +56,7 @@ public:
    * @brief Constructor of the File class.
    */
   File() = default;
-  ~File() = default;
+  ~File();
   /**
    * @brief Initialize the File object.
    */
@@ -83,12 +90,52 @@ public:
   // the dataset in the order of ids (possibly slower on output for many
   // particles).
   bool &write_ordered() { return m_write_ordered; };
+  // Returns the boolean value that describes whether the HDF5 output is
+  // done by a background thread on the head node, while the simulation
+  // continues. Implies ordered writing.
+  bool &asynchronous() { return m_asynchronous; };
+  // Returns the deflate level (0 to 9) of the particle datasets, 0 disables
+  // lossless compression.
+  int &compression() { return m_compression; };
+  // Returns the absolute precision to which positions, velocities and forces
+  // are stored, 0 stores them without loss.
+  double &precision() { return m_precision; };
+  // Returns the number of time steps stored in one chunk of the time series.
+  int &chunk_frames() { return m_chunk_frames; };
   /**
    * @brief Method to force flush to h5md file.
    */
   void Flush();
 
 private:
+  /**
+   * @brief Particle data of one time step, staged for writing.
+   *
+   * Vector-valued properties are stored row-major with 3 components.
+   */
+  struct Frame {
+    int write_dat = 0;
+    double time = 0.;
+    int step = 0;
+    /** Number of particles in the buffers. */
+    int n_local = 0;
+    /** Offset of the particles of this node in the datasets. */
+    int prefix = 0;
+    /** Number of particles of all nodes. */
+    int n_part = 0;
+    std::vector<int> id, type, image;
+    std::vector<double> mass, charge, pos, vel, force;
+    /** Whether the bonds are part of this frame. */
+    bool write_bonds = false;
+    /** Pairs of particle ids. */
+    std::vector<int> bond;
+    int prefix_bonds = 0;
+    int n_bonds_total = 0;
+
+    /** Resize the buffers, keeping their capacity. */
+    void resize(int n);
+  };
+
   boost::mpi::communicator m_hdf5_comm;
   bool m_already_wrote_bonds = false;
 
@@ -104,8 +151,7 @@ private:
    * particle
    * positions to the dataset.
    */
-  template <typename T>
-  void WriteDataset(T &data, const std::string &path,
+  void WriteDataset(const void *data, const std::string &path,
                     const std::vector<int> &change_extent, hsize_t *offset,
                     hsize_t *count);
 
@@ -122,14 +168,32 @@ private:
                                          hsize_t chunk_size);
 
   /*
-   * @brief Method to fill the arrays that are used by WriteDataset particle by
-   * particle.
-   */
-  void fill_arrays_for_h5md_write_with_particle_property(
-      int particle_index, int_array_3d &id, int_array_3d &typ,
-      double_array_3d &mass, double_array_3d &pos, int_array_3d &image,
-      double_array_3d &vel, double_array_3d &f, double_array_3d &charge,
-      Particle const &current_particle, int write_dat, int_array_3d &bond);
+   * @brief Method to fill the staging buffers particle by particle.
+   */
+  void fill_frame_with_particle_property(Frame &frame, int particle_index,
+                                         Particle const &current_particle);
+
+  /*
+   * @brief Method to fill the staging buffers with the particles of all
+   * nodes, ordered by id. Only call this on the head node.
+   */
+  void fill_frame_ordered(Frame &frame, PartCfg &partCfg);
+
+  /**
+   * @brief Method that extends the datasets and writes a staged frame.
+   */
+  void WriteFrame(Frame const &frame);
+
+  /**
+   * @brief Main loop of the I/O thread in asynchronous mode.
+   */
+  void io_thread_loop();
+
+  /**
+   * @brief Block until all staged frames are written, and rethrow
+   * errors of the I/O thread.
+   */
+  void wait_for_io();
   /*
    * @brief Method to write the simulation script to the dataset.
    */
@@ -175,6 +239,12 @@ private:
   std::string m_scriptname;
   int m_what;
   bool m_write_ordered;
+  bool m_asynchronous = false;
+  int m_compression = 0;
+  double m_precision = 0.;
+  int m_chunk_frames = 1;
+  /** Transfer properties of the dataset writes. */
+  hid_t m_dxpl = H5P_DEFAULT;
   std::string m_backup_filename;
   boost::filesystem::path m_absolute_script_path = "nullptr";
   h5xx::file m_h5md_file;
@@ -183,10 +253,28 @@ private:
     std::string path;
     hsize_t dim;
     h5xx::datatype type;
+    /** Whether the dataset grows with every time step. */
+    bool time_series;
+    /** Whether lossy compression may be applied. */
+    bool quantizable;
   };
   std::vector<std::string> group_names;
   std::vector<DatasetDescriptor> dataset_descriptors;
   std::unordered_map<std::string, h5xx::dataset> datasets;
+
+  /** Staging buffer of the synchronous mode. */
+  Frame m_frame;
+
+  /* State of the asynchronous mode. The frames are double-buffered:
+   * one can be filled while the other one is written. */
+  std::thread m_io_thread;
+  std::mutex m_io_mutex;
+  std::condition_variable m_io_cv;
+  std::deque<std::unique_ptr<Frame>> m_pending_frames;
+  std::vector<std::unique_ptr<Frame>> m_free_frames;
+  bool m_io_busy = false;
+  bool m_io_stop = false;
+  std::exception_ptr m_io_error;
 };
 
 struct incompatible_h5mdfile : public std::exception {
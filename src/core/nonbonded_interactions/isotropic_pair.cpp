@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Implementation of \ref isotropic_pair.hpp
+ */
+#include "nonbonded_interactions/isotropic_pair.hpp"
+
+#include <vector>
+
+namespace {
+/** All isotropic potentials which are compiled in. */
+std::vector<IsotropicPotential> compiled_potentials() {
+  return {
+#ifdef LENNARD_JONES
+      IsotropicPotential::lj,
+#endif
+#ifdef WCA
+      IsotropicPotential::wca,
+#endif
+#ifdef LENNARD_JONES_GENERIC
+      IsotropicPotential::ljgen,
+#endif
+#ifdef SMOOTH_STEP
+      IsotropicPotential::smooth_step,
+#endif
+#ifdef HERTZIAN
+      IsotropicPotential::hertzian,
+#endif
+#ifdef GAUSSIAN
+      IsotropicPotential::gaussian,
+#endif
+#ifdef BMHTF_NACL
+      IsotropicPotential::bmhtf,
+#endif
+#ifdef BUCKINGHAM
+      IsotropicPotential::buckingham,
+#endif
+#ifdef MORSE
+      IsotropicPotential::morse,
+#endif
+#ifdef SOFT_SPHERE
+      IsotropicPotential::soft_sphere,
+#endif
+#ifdef HAT
+      IsotropicPotential::hat,
+#endif
+#ifdef LJCOS
+      IsotropicPotential::ljcos,
+#endif
+#ifdef LJCOS2
+      IsotropicPotential::ljcos2,
+#endif
+#ifdef TABULATED
+      IsotropicPotential::tabulated,
+#endif
+  };
+}
+} // namespace
+
+double isotropic_pair_cutoff(IA_parameters const &ia_params,
+                             IsotropicPotential kind) {
+  switch (kind) {
+#ifdef LENNARD_JONES
+  case IsotropicPotential::lj:
+    return ia_params.lj.cut + ia_params.lj.offset;
+#endif
+#ifdef WCA
+  case IsotropicPotential::wca:
+    return ia_params.wca.cut;
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  case IsotropicPotential::ljgen:
+    return ia_params.ljgen.cut + ia_params.ljgen.offset;
+#endif
+#ifdef SMOOTH_STEP
+  case IsotropicPotential::smooth_step:
+    return ia_params.smooth_step.cut;
+#endif
+#ifdef HERTZIAN
+  case IsotropicPotential::hertzian:
+    return ia_params.hertzian.sig;
+#endif
+#ifdef GAUSSIAN
+  case IsotropicPotential::gaussian:
+    return ia_params.gaussian.cut;
+#endif
+#ifdef BMHTF_NACL
+  case IsotropicPotential::bmhtf:
+    return ia_params.bmhtf.cut;
+#endif
+#ifdef BUCKINGHAM
+  case IsotropicPotential::buckingham:
+    return ia_params.buckingham.cut;
+#endif
+#ifdef MORSE
+  case IsotropicPotential::morse:
+    return ia_params.morse.cut;
+#endif
+#ifdef SOFT_SPHERE
+  case IsotropicPotential::soft_sphere:
+    return ia_params.soft_sphere.cut + ia_params.soft_sphere.offset;
+#endif
+#ifdef HAT
+  case IsotropicPotential::hat:
+    return ia_params.hat.r;
+#endif
+#ifdef LJCOS
+  case IsotropicPotential::ljcos:
+    return ia_params.ljcos.cut + ia_params.ljcos.offset;
+#endif
+#ifdef LJCOS2
+  case IsotropicPotential::ljcos2:
+    return ia_params.ljcos2.cut + ia_params.ljcos2.offset;
+#endif
+#ifdef TABULATED
+  case IsotropicPotential::tabulated:
+    return ia_params.tab.cutoff();
+#endif
+  default:
+    return INACTIVE_CUTOFF;
+  }
+}
+
+std::vector<double>
+isotropic_pair_switching_points(IA_parameters const &ia_params,
+                                IsotropicPotential kind) {
+  switch (kind) {
+#ifdef LENNARD_JONES
+  case IsotropicPotential::lj:
+    return {ia_params.lj.min + ia_params.lj.offset};
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  case IsotropicPotential::ljgen:
+    return {ia_params.ljgen.offset};
+#endif
+#ifdef BUCKINGHAM
+  case IsotropicPotential::buckingham:
+    return {ia_params.buckingham.discont};
+#endif
+#ifdef SOFT_SPHERE
+  case IsotropicPotential::soft_sphere:
+    return {ia_params.soft_sphere.offset};
+#endif
+#ifdef LJCOS
+  case IsotropicPotential::ljcos:
+    return {ia_params.ljcos.rmin + ia_params.ljcos.offset};
+#endif
+#ifdef LJCOS2
+  case IsotropicPotential::ljcos2:
+    return {ia_params.ljcos2.offset + ia_params.ljcos2.rchange,
+            ia_params.ljcos2.offset + ia_params.ljcos2.rchange +
+                ia_params.ljcos2.w};
+#endif
+#ifdef TABULATED
+  case IsotropicPotential::tabulated:
+    return {ia_params.tab.minval};
+#endif
+  default:
+    return {};
+  }
+}
+
+void update_isotropic_potentials(IA_parameters &ia_params) {
+  auto &isotropic = ia_params.isotropic;
+  isotropic.size = 0;
+  for (auto const kind : compiled_potentials()) {
+    if (isotropic_pair_cutoff(ia_params, kind) > 0.) {
+      isotropic.kinds[isotropic.size++] = kind;
+    }
+  }
+}
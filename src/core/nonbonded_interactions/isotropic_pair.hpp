@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NB_IA_ISOTROPIC_PAIR_HPP
+#define CORE_NB_IA_ISOTROPIC_PAIR_HPP
+/** \file
+ *  Sum of all non-bonded pair potentials which only depend on the
+ *  distance and the particle types, i.e. all except Thole and Gay-Berne.
+ *  Every type pair keeps a compact list of its active isotropic
+ *  potentials, so that the kernels do not have to test all compiled-in
+ *  potentials for every pair. They can also be tabulated per type pair,
+ *  see \ref PairSplineTable.
+ *
+ *  Implementation in \ref isotropic_pair.cpp.
+ */
+
+#include "config.hpp"
+
+#include "nonbonded_interactions/bmhtf-nacl.hpp"
+#include "nonbonded_interactions/buckingham.hpp"
+#include "nonbonded_interactions/gaussian.hpp"
+#include "nonbonded_interactions/hat.hpp"
+#include "nonbonded_interactions/hertzian.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/ljcos.hpp"
+#include "nonbonded_interactions/ljcos2.hpp"
+#include "nonbonded_interactions/ljgen.hpp"
+#include "nonbonded_interactions/morse.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "nonbonded_interactions/nonbonded_tab.hpp"
+#include "nonbonded_interactions/smooth_step.hpp"
+#include "nonbonded_interactions/soft_sphere.hpp"
+#include "nonbonded_interactions/wca.hpp"
+
+#include <vector>
+
+/** @brief Set up the list of active isotropic potentials of a type pair.
+ *
+ *  A potential is active if its cutoff is positive. Has to be called
+ *  whenever the parameters of the type pair change.
+ */
+void update_isotropic_potentials(IA_parameters &ia_params);
+
+/** Cutoff of one of the isotropic potentials of a type pair. */
+double isotropic_pair_cutoff(IA_parameters const &ia_params,
+                             IsotropicPotential kind);
+
+/** Distances below the cutoff at which one of the isotropic potentials
+ *  of a type pair switches between two functional forms.
+ */
+std::vector<double> isotropic_pair_switching_points(
+    IA_parameters const &ia_params, IsotropicPotential kind);
+
+/** Force factor of one isotropic potential. */
+inline double isotropic_pair_force_factor(IA_parameters const &ia_params,
+                                          IsotropicPotential kind,
+                                          double dist) {
+  switch (kind) {
+#ifdef LENNARD_JONES
+  case IsotropicPotential::lj:
+    return lj_pair_force_factor(ia_params, dist);
+#endif
+#ifdef WCA
+  case IsotropicPotential::wca:
+    return wca_pair_force_factor(ia_params, dist);
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  case IsotropicPotential::ljgen:
+    return ljgen_pair_force_factor(ia_params, dist);
+#endif
+#ifdef SMOOTH_STEP
+  case IsotropicPotential::smooth_step:
+    return SmSt_pair_force_factor(ia_params, dist);
+#endif
+#ifdef HERTZIAN
+  case IsotropicPotential::hertzian:
+    return hertzian_pair_force_factor(ia_params, dist);
+#endif
+#ifdef GAUSSIAN
+  case IsotropicPotential::gaussian:
+    return gaussian_pair_force_factor(ia_params, dist);
+#endif
+#ifdef BMHTF_NACL
+  case IsotropicPotential::bmhtf:
+    return BMHTF_pair_force_factor(ia_params, dist);
+#endif
+#ifdef BUCKINGHAM
+  case IsotropicPotential::buckingham:
+    return buck_pair_force_factor(ia_params, dist);
+#endif
+#ifdef MORSE
+  case IsotropicPotential::morse:
+    return morse_pair_force_factor(ia_params, dist);
+#endif
+#ifdef SOFT_SPHERE
+  case IsotropicPotential::soft_sphere:
+    return soft_pair_force_factor(ia_params, dist);
+#endif
+#ifdef HAT
+  case IsotropicPotential::hat:
+    return hat_pair_force_factor(ia_params, dist);
+#endif
+#ifdef LJCOS
+  case IsotropicPotential::ljcos:
+    return ljcos_pair_force_factor(ia_params, dist);
+#endif
+#ifdef LJCOS2
+  case IsotropicPotential::ljcos2:
+    return ljcos2_pair_force_factor(ia_params, dist);
+#endif
+#ifdef TABULATED
+  case IsotropicPotential::tabulated:
+    return tabulated_pair_force_factor(ia_params, dist);
+#endif
+  default:
+    return 0.;
+  }
+}
+
+/** Energy of one isotropic potential. */
+inline double isotropic_pair_energy(IA_parameters const &ia_params,
+                                    IsotropicPotential kind, double dist) {
+  switch (kind) {
+#ifdef LENNARD_JONES
+  case IsotropicPotential::lj:
+    return lj_pair_energy(ia_params, dist);
+#endif
+#ifdef WCA
+  case IsotropicPotential::wca:
+    return wca_pair_energy(ia_params, dist);
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  case IsotropicPotential::ljgen:
+    return ljgen_pair_energy(ia_params, dist);
+#endif
+#ifdef SMOOTH_STEP
+  case IsotropicPotential::smooth_step:
+    return SmSt_pair_energy(ia_params, dist);
+#endif
+#ifdef HERTZIAN
+  case IsotropicPotential::hertzian:
+    return hertzian_pair_energy(ia_params, dist);
+#endif
+#ifdef GAUSSIAN
+  case IsotropicPotential::gaussian:
+    return gaussian_pair_energy(ia_params, dist);
+#endif
+#ifdef BMHTF_NACL
+  case IsotropicPotential::bmhtf:
+    return BMHTF_pair_energy(ia_params, dist);
+#endif
+#ifdef BUCKINGHAM
+  case IsotropicPotential::buckingham:
+    return buck_pair_energy(ia_params, dist);
+#endif
+#ifdef MORSE
+  case IsotropicPotential::morse:
+    return morse_pair_energy(ia_params, dist);
+#endif
+#ifdef SOFT_SPHERE
+  case IsotropicPotential::soft_sphere:
+    return soft_pair_energy(ia_params, dist);
+#endif
+#ifdef HAT
+  case IsotropicPotential::hat:
+    return hat_pair_energy(ia_params, dist);
+#endif
+#ifdef LJCOS
+  case IsotropicPotential::ljcos:
+    return ljcos_pair_energy(ia_params, dist);
+#endif
+#ifdef LJCOS2
+  case IsotropicPotential::ljcos2:
+    return ljcos2_pair_energy(ia_params, dist);
+#endif
+#ifdef TABULATED
+  case IsotropicPotential::tabulated:
+    return tabulated_pair_energy(ia_params, dist);
+#endif
+  default:
+    return 0.;
+  }
+}
+
+/** Force factor of the isotropic potentials, evaluated analytically.
+ *  Only the active potentials of the type pair are visited.
+ */
+inline double analytic_isotropic_pair_force_factor(
+    IA_parameters const &ia_params, double dist) {
+  double force_factor = 0;
+  for (auto const kind : ia_params.isotropic) {
+    force_factor += isotropic_pair_force_factor(ia_params, kind, dist);
+  }
+  return force_factor;
+}
+
+/** Energy of the isotropic potentials, evaluated analytically.
+ *  Only the active potentials of the type pair are visited.
+ */
+inline double analytic_isotropic_pair_energy(IA_parameters const &ia_params,
+                                             double dist) {
+  double ret = 0;
+  for (auto const kind : ia_params.isotropic) {
+    ret += isotropic_pair_energy(ia_params, kind, dist);
+  }
+  return ret;
+}
+
+/** Force factor of the isotropic potentials, from the spline table
+ *  of the type pair if there is one.
+ */
+inline double isotropic_pair_force_factor(IA_parameters const &ia_params,
+                                          double dist) {
+  auto const dist2 = dist * dist;
+  if (ia_params.spline_table.covers(dist2)) {
+    return ia_params.spline_table.force_factor(dist2);
+  }
+  return analytic_isotropic_pair_force_factor(ia_params, dist);
+}
+
+/** Energy of the isotropic potentials, from the spline table
+ *  of the type pair if there is one.
+ */
+inline double isotropic_pair_energy(IA_parameters const &ia_params,
+                                    double dist) {
+  auto const dist2 = dist * dist;
+  if (ia_params.spline_table.covers(dist2)) {
+    return ia_params.spline_table.energy(dist2);
+  }
+  return analytic_isotropic_pair_energy(ia_params, dist);
+}
+
+#endif
@@ -27,10 +27,13 @@
 #include "Particle.hpp"
 #include "TabulatedPotential.hpp"
 #include "dpd.hpp"
+#include "nonbonded_interactions/pair_spline_table.hpp"
 
 #include <utils/index.hpp>
 #include <utils/math/sqr.hpp>
 
+#include <array>
+
 /** Cutoff for deactivated interactions. Must be negative, so that even
  *  particles on top of each other don't interact by chance.
  */
@@ -181,6 +184,37 @@ struct Thole_Parameters {
   double q1q2;
 };
 
+/** Non-bonded potentials which only depend on the distance. */
+enum class IsotropicPotential : unsigned char {
+  lj,
+  wca,
+  ljgen,
+  smooth_step,
+  hertzian,
+  gaussian,
+  bmhtf,
+  buckingham,
+  morse,
+  soft_sphere,
+  hat,
+  ljcos,
+  ljcos2,
+  tabulated
+};
+
+/** The isotropic potentials which are active for a pair of particle
+ *  types, so that the force and energy kernels only visit these.
+ *  Set up by \ref update_isotropic_potentials.
+ */
+struct IsotropicPotentials {
+  static constexpr int max_size = 14;
+  std::array<IsotropicPotential, max_size> kinds;
+  int size = 0;
+
+  IsotropicPotential const *begin() const { return kinds.data(); }
+  IsotropicPotential const *end() const { return kinds.data() + size; }
+};
+
 /** Data structure containing the interaction parameters for non-bonded
  *  interactions.
  *  Access via <tt>get_ia_param(i, j)</tt> with
@@ -193,6 +227,9 @@ struct IA_parameters {
    */
   double max_cut = INACTIVE_CUTOFF;
 
+  /** Active isotropic potentials of this pair of particle types. */
+  IsotropicPotentials isotropic;
+
 #ifdef LENNARD_JONES
   LJ_Parameters lj;
 #endif
@@ -264,6 +301,9 @@ struct IA_parameters {
 #ifdef THOLE
   Thole_Parameters thole;
 #endif
+
+  /** Automatic tabulation of the isotropic potentials */
+  PairSplineTable spline_table;
 };
 
 extern std::vector<IA_parameters> ia_params;
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Implementation of \ref pair_spline_table.hpp
+ */
+#include "nonbonded_interactions/pair_spline_table.hpp"
+#include "communication.hpp"
+#include "nonbonded_interactions/isotropic_pair.hpp"
+
+#include <algorithm>
+#include <vector>
+
+bool update_pair_spline_table(IA_parameters &ia_params) {
+  auto max_r = INACTIVE_CUTOFF;
+  std::vector<double> kinks;
+  for (auto const kind : ia_params.isotropic) {
+    auto const cutoff = isotropic_pair_cutoff(ia_params, kind);
+    auto const points = isotropic_pair_switching_points(ia_params, kind);
+    max_r = std::max(max_r, cutoff);
+    kinks.push_back(cutoff);
+    kinks.insert(kinks.end(), points.begin(), points.end());
+  }
+
+  return ia_params.spline_table.fit(
+      [&ia_params](double dist) {
+        return analytic_isotropic_pair_force_factor(ia_params, dist);
+      },
+      [&ia_params](double dist) {
+        return analytic_isotropic_pair_energy(ia_params, dist);
+      },
+      std::move(kinks), max_r);
+}
+
+int pair_spline_table_set_params(int part_type_a, int part_type_b,
+                                 double min_r, double tolerance) {
+  IA_parameters *data = get_ia_param_safe(part_type_a, part_type_b);
+
+  if (!data)
+    return ES_ERROR;
+
+  data->spline_table.min_r = min_r;
+  data->spline_table.tolerance = tolerance;
+
+  /* broadcast interaction parameters, the table is built on the way */
+  mpi_bcast_ia_params(part_type_a, part_type_b);
+
+  /* a failed tabulation is disabled */
+  return (data->spline_table.tolerance == tolerance) ? ES_OK : ES_ERROR;
+}
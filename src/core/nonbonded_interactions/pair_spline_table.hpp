@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NB_IA_PAIR_SPLINE_TABLE_HPP
+#define CORE_NB_IA_PAIR_SPLINE_TABLE_HPP
+/** \file
+ *  Cubic spline tables for the automatic tabulation of the isotropic
+ *  pair potentials of a pair of particle types.
+ *
+ *  The tables are set up in \ref pair_spline_table.cpp.
+ */
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/** @brief Cubic spline table of a pair force factor and a pair energy
+ *  as functions of the squared distance.
+ *
+ *  Both functions are interpolated by cubic Hermite polynomials on
+ *  uniform grids in @f$ s = r^2 @f$, so that a lookup needs neither a
+ *  square root nor any transcendental function. The range is split into
+ *  segments at the distances where the functions are not smooth, e.g. at
+ *  the cutoffs of the individual potentials, and every segment gets its
+ *  own grid. The grids are refined until the interpolation error at the
+ *  centers of all intervals is below @ref tolerance times the larger of
+ *  1 and the magnitude of the exact value. Beyond the last segment, the
+ *  force and the energy are zero.
+ */
+struct PairSplineTable {
+  /** Smallest tabulated distance. Closer pairs are not covered. */
+  double min_r = 0.;
+  /** Interpolation error, 0 disables the tabulation. */
+  double tolerance = 0.;
+
+  /** Part of the table with a uniform grid in @f$ s @f$. */
+  struct Segment {
+    double begin = 0.;
+    double end = 0.;
+    double inv_step = 0.;
+    /** For every interval the four polynomial coefficients of the
+     *  force factor, followed by those of the energy.
+     */
+    std::vector<double> coefficients;
+
+    template <class Archive> void serialize(Archive &ar, long int) {
+      ar &begin &end &inv_step &coefficients;
+    }
+  };
+
+  /** Segments in increasing order, without gaps. */
+  std::vector<Segment> segments;
+
+  /** Largest number of intervals per segment. */
+  static constexpr std::size_t max_intervals = std::size_t{1} << 16;
+
+  bool empty() const { return segments.empty(); }
+
+  /** Whether pairs at squared distance @p dist2 can be evaluated with
+   *  the table.
+   */
+  bool covers(double dist2) const {
+    return not segments.empty() and dist2 >= segments.front().begin;
+  }
+
+  /** Interpolated force factor at squared distance @p dist2. */
+  double force_factor(double dist2) const { return evaluate(dist2, 0); }
+
+  /** Interpolated energy at squared distance @p dist2. */
+  double energy(double dist2) const { return evaluate(dist2, 4); }
+
+  /** @brief Tabulate a force factor and an energy.
+   *
+   *  The table covers the distances from @ref min_r to @p max_r.
+   *
+   *  @param force_factor Force factor as a function of the distance
+   *  @param energy       Energy as a function of the distance
+   *  @param kinks        Distances at which the functions are not smooth
+   *  @param max_r        Largest tabulated distance
+   *  @return false if the tolerance could not be reached with
+   *          @ref max_intervals intervals per segment. The table is
+   *          empty in this case.
+   */
+  template <class F, class E>
+  bool fit(F const &force_factor, E const &energy, std::vector<double> kinks,
+           double max_r) {
+    segments.clear();
+    if (tolerance <= 0. or min_r <= 0. or max_r <= min_r)
+      return true;
+
+    kinks.push_back(min_r);
+    kinks.push_back(max_r);
+    kinks.erase(std::remove_if(kinks.begin(), kinks.end(),
+                               [this, max_r](double r) {
+                                 return r < min_r or r > max_r;
+                               }),
+                kinks.end());
+    std::sort(kinks.begin(), kinks.end());
+    kinks.erase(std::unique(kinks.begin(), kinks.end(),
+                            [](double a, double b) {
+                              return b - a <= 1e-6 * b;
+                            }),
+                kinks.end());
+
+    for (std::size_t i = 0; i + 1 < kinks.size(); i++) {
+      Segment segment;
+      segment.begin = kinks[i] * kinks[i];
+      segment.end = kinks[i + 1] * kinks[i + 1];
+      if (not fit_segment(force_factor, energy, segment)) {
+        segments.clear();
+        return false;
+      }
+      segments.push_back(std::move(segment));
+    }
+    /* Close the gaps left by rounding. */
+    for (std::size_t i = 1; i < segments.size(); i++) {
+      segments[i].begin = segments[i - 1].end;
+    }
+
+    return true;
+  }
+
+private:
+  double evaluate(double s, int offset) const {
+    for (auto const &segment : segments) {
+      if (s < segment.end) {
+        auto const x = (s - segment.begin) * segment.inv_step;
+        auto const n_intervals = segment.coefficients.size() / 8;
+        auto const i =
+            std::min(static_cast<std::size_t>(x), n_intervals - 1);
+        auto const t = x - static_cast<double>(i);
+        auto const c = segment.coefficients.data() + 8 * i + offset;
+        return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+      }
+    }
+    return 0.;
+  }
+
+  /** @brief Cubic Hermite coefficients of @p f on @p n intervals.
+   *
+   *  The function is sampled slightly inside the segment at its ends,
+   *  since it may jump there, and extrapolated to the ends. The derivatives are taken by finite
+   *  differences, one-sided at the ends.
+   */
+  template <class G>
+  static void hermite(G const &f, double begin, double end, std::size_t n,
+                      int offset, std::vector<double> &coefficients) {
+    auto const h = (end - begin) / static_cast<double>(n);
+    auto const lo = begin + 1e-9 * end;
+    auto const hi = end - 1e-9 * end;
+    auto const delta = 1e-3 * h;
+    auto const g = [&f](double s) { return f(std::sqrt(s)); };
+
+    std::vector<double> values(n + 1), slopes(n + 1);
+    for (std::size_t k = 0; k <= n; k++) {
+      auto const knot = begin + static_cast<double>(k) * h;
+      auto const s = std::min(std::max(knot, lo), hi);
+      auto const value = g(s);
+      double slope;
+      if (s - delta < lo) {
+        slope = (-3. * value + 4. * g(s + delta) - g(s + 2. * delta)) /
+                (2. * delta);
+      } else if (s + delta > hi) {
+        slope =
+            (3. * value - 4. * g(s - delta) + g(s - 2. * delta)) / (2. * delta);
+      } else {
+        slope = (g(s + delta) - g(s - delta)) / (2. * delta);
+      }
+      /* extrapolate from the sampling point to the knot */
+      values[k] = value + slope * (knot - s);
+      slopes[k] = slope * h;
+    }
+
+    for (std::size_t k = 0; k < n; k++) {
+      auto const c = coefficients.data() + 8 * k + offset;
+      auto const dp = values[k + 1] - values[k];
+      c[0] = values[k];
+      c[1] = slopes[k];
+      c[2] = 3. * dp - 2. * slopes[k] - slopes[k + 1];
+      c[3] = -2. * dp + slopes[k] + slopes[k + 1];
+    }
+  }
+
+  /** Largest interpolation error of the coefficients at @p offset
+   *  at the centers of the intervals, relative to @ref tolerance.
+   */
+  template <class G>
+  double error(G const &f, Segment const &segment, int offset) const {
+    auto const n = segment.coefficients.size() / 8;
+    auto const h = (segment.end - segment.begin) / static_cast<double>(n);
+    double max_error = 0.;
+    for (std::size_t k = 0; k < n; k++) {
+      auto const exact = f(std::sqrt(segment.begin + (k + 0.5) * h));
+      auto const c = segment.coefficients.data() + 8 * k + offset;
+      auto const approx = c[0] + 0.5 * (c[1] + 0.5 * (c[2] + 0.5 * c[3]));
+      max_error = std::max(max_error, std::abs(approx - exact) /
+                                          std::max(1., std::abs(exact)));
+    }
+    return max_error / tolerance;
+  }
+
+  template <class F, class E>
+  bool fit_segment(F const &force_factor, E const &energy,
+                   Segment &segment) const {
+    for (std::size_t n = 16; n <= max_intervals; n *= 2) {
+      segment.inv_step = static_cast<double>(n) / (segment.end - segment.begin);
+      segment.coefficients.resize(8 * n);
+      hermite(force_factor, segment.begin, segment.end, n, 0,
+              segment.coefficients);
+      hermite(energy, segment.begin, segment.end, n, 4, segment.coefficients);
+      if (error(force_factor, segment, 0) <= 1. and
+          error(energy, segment, 4) <= 1.)
+        return true;
+    }
+    return false;
+  }
+
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &min_r &tolerance &segments;
+  }
+};
+
+struct IA_parameters;
+
+/** @brief Set the parameters of the automatic tabulation of a type pair.
+ *
+ *  The table is built on the head node when the parameters are
+ *  communicated to all nodes.
+ *
+ *  @param part_type_a  particle type for which the table is set up
+ *  @param part_type_b  particle type for which the table is set up
+ *  @param min_r        @copybrief PairSplineTable::min_r
+ *  @param tolerance    @copybrief PairSplineTable::tolerance
+ *  @retval ES_OK
+ *  @retval ES_ERROR if the tolerance cannot be reached, the tabulation
+ *          is disabled and a runtime error is raised in this case.
+ */
+int pair_spline_table_set_params(int part_type_a, int part_type_b,
+                                 double min_r, double tolerance);
+
+/** @brief Tabulate the current isotropic potentials of a type pair.
+ *
+ *  Has to be called whenever the potentials of the type pair change.
+ *
+ *  @return false if the tolerance could not be reached, the table is
+ *          empty then and the potentials are evaluated analytically.
+ */
+bool update_pair_spline_table(IA_parameters &ia_params);
+
+#endif
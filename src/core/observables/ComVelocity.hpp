@@ -20,19 +20,25 @@
 #define OBSERVABLES_COMVELOCITY_HPP
 
 #include "PidObservable.hpp"
+#include "ReduciblePidObservable.hpp"
 
 #include <vector>
 
 namespace Observables {
-class ComVelocity : public PidObservable {
+class ComVelocity : public ReduciblePidObservable<ComVelocity, PidObservable> {
 public:
-  using PidObservable::PidObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
   std::vector<size_t> shape() const override { return {3}; }
 
   std::vector<double>
   evaluate(Utils::Span<const Particle *const> particles) const override {
-    std::vector<double> res(n_values());
-    double total_mass = 0;
+    return finalize(evaluate_partial(particles));
+  }
+
+  /** Mass-weighted sum of the velocities and total mass. */
+  std::vector<double>
+  evaluate_partial(Utils::Span<const Particle *const> particles) const {
+    std::vector<double> res(4);
     for (auto p : particles) {
       if (p->p.is_virtual)
         continue;
@@ -40,13 +46,15 @@ public:
       res[0] += mass * p->m.v[0];
       res[1] += mass * p->m.v[1];
       res[2] += mass * p->m.v[2];
-      total_mass += mass;
+      res[3] += mass;
     }
-    res[0] /= total_mass;
-    res[1] /= total_mass;
-    res[2] /= total_mass;
     return res;
-  };
+  }
+
+  std::vector<double> finalize(std::vector<double> sum) const {
+    auto const total_mass = sum[3];
+    return {sum[0] / total_mass, sum[1] / total_mass, sum[2] / total_mass};
+  }
 };
 
 } // Namespace Observables
@@ -20,13 +20,17 @@
 #define OBSERVABLES_CYLINDRICALDENSITYPROFILE_HPP
 
 #include "CylindricalPidProfileObservable.hpp"
+#include "ReduciblePidObservable.hpp"
+#include "grid.hpp"
 #include <utils/Histogram.hpp>
 #include <utils/math/coordinate_transformation.hpp>
 
 namespace Observables {
-class CylindricalDensityProfile : public CylindricalPidProfileObservable {
+class CylindricalDensityProfile
+    : public ReduciblePidObservable<CylindricalDensityProfile,
+                                    CylindricalPidProfileObservable> {
 public:
-  using CylindricalPidProfileObservable::CylindricalPidProfileObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
   std::vector<double>
   evaluate(Utils::Span<const Particle *const> particles) const override {
     std::array<size_t, 3> n_bins{{n_r_bins, n_phi_bins, n_z_bins}};
@@ -20,13 +20,17 @@
 #define OBSERVABLES_CYLINDRICALFLUXDENSITYPROFILE_HPP
 
 #include "CylindricalPidProfileObservable.hpp"
+#include "ReduciblePidObservable.hpp"
+#include "grid.hpp"
 #include "integrate.hpp"
 #include <utils/Histogram.hpp>
 
 namespace Observables {
-class CylindricalFluxDensityProfile : public CylindricalPidProfileObservable {
+class CylindricalFluxDensityProfile
+    : public ReduciblePidObservable<CylindricalFluxDensityProfile,
+                                    CylindricalPidProfileObservable> {
 public:
-  using CylindricalPidProfileObservable::CylindricalPidProfileObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
 
   std::vector<double>
   evaluate(Utils::Span<const Particle *const> particles) const override {
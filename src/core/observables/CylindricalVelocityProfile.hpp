@@ -20,15 +20,25 @@
 #define OBSERVABLES_CYLINDRICALVELOCITYPROFILE_HPP
 
 #include "CylindricalPidProfileObservable.hpp"
+#include "ReduciblePidObservable.hpp"
+#include "grid.hpp"
 #include <utils/Histogram.hpp>
 
 namespace Observables {
-class CylindricalVelocityProfile : public CylindricalPidProfileObservable {
+class CylindricalVelocityProfile
+    : public ReduciblePidObservable<CylindricalVelocityProfile,
+                                    CylindricalPidProfileObservable> {
 public:
-  using CylindricalPidProfileObservable::CylindricalPidProfileObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
 
   std::vector<double>
   evaluate(Utils::Span<const Particle *const> particles) const override {
+    return finalize(evaluate_partial(particles));
+  }
+
+  /** Velocity histogram followed by the number of samples per bin. */
+  std::vector<double>
+  evaluate_partial(Utils::Span<const Particle *const> particles) const {
     std::array<size_t, 3> n_bins{{n_r_bins, n_phi_bins, n_z_bins}};
     std::array<std::pair<double, double>, 3> limits{
         {std::make_pair(min_r, max_r), std::make_pair(min_phi, max_phi),
@@ -42,11 +52,19 @@ public:
           Utils::transform_vector_cartesian_to_cylinder(p->m.v, axis, pos));
     }
 
-    auto hist_tmp = histogram.get_histogram();
-    auto tot_count = histogram.get_tot_count();
+    auto res = histogram.get_histogram();
+    auto const tot_count = histogram.get_tot_count();
+    res.insert(res.end(), tot_count.begin(), tot_count.end());
+    return res;
+  }
+
+  std::vector<double> finalize(std::vector<double> sum) const {
+    auto const n_bins = sum.size() / 2;
+    std::vector<double> hist_tmp(sum.begin(), sum.begin() + n_bins);
     for (size_t ind = 0; ind < hist_tmp.size(); ++ind) {
-      if (tot_count[ind] > 0) {
-        hist_tmp[ind] /= tot_count[ind];
+      auto const tot_count = sum[n_bins + ind];
+      if (tot_count > 0) {
+        hist_tmp[ind] /= tot_count;
       }
     }
     return hist_tmp;
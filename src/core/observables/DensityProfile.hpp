@@ -20,14 +20,17 @@
 #define OBSERVABLES_DENSITYPROFILE_HPP
 
 #include "PidProfileObservable.hpp"
+#include "ReduciblePidObservable.hpp"
+#include "grid.hpp"
 #include <utils/Histogram.hpp>
 #include <vector>
 
 namespace Observables {
 
-class DensityProfile : public PidProfileObservable {
+class DensityProfile
+    : public ReduciblePidObservable<DensityProfile, PidProfileObservable> {
 public:
-  using PidProfileObservable::PidProfileObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
 
   std::vector<double>
   evaluate(Utils::Span<const Particle *const> particles) const override {
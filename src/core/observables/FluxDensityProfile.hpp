@@ -20,13 +20,16 @@
 #define OBSERVABLES_FLUXDENSITYPROFILE_HPP
 
 #include "PidProfileObservable.hpp"
+#include "ReduciblePidObservable.hpp"
+#include "grid.hpp"
 
 #include <vector>
 
 namespace Observables {
-class FluxDensityProfile : public PidProfileObservable {
+class FluxDensityProfile
+    : public ReduciblePidObservable<FluxDensityProfile, PidProfileObservable> {
 public:
-  using PidProfileObservable::PidProfileObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
   std::vector<size_t> shape() const override {
     return {n_x_bins, n_y_bins, n_z_bins, 3};
   }
@@ -20,14 +20,17 @@
 #define OBSERVABLES_FORCEDENSITYPROFILE_HPP
 
 #include "PidProfileObservable.hpp"
+#include "ReduciblePidObservable.hpp"
+#include "grid.hpp"
 
 #include <vector>
 
 namespace Observables {
 
-class ForceDensityProfile : public PidProfileObservable {
+class ForceDensityProfile
+    : public ReduciblePidObservable<ForceDensityProfile, PidProfileObservable> {
 public:
-  using PidProfileObservable::PidProfileObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
   std::vector<size_t> shape() const override {
     return {n_x_bins, n_y_bins, n_z_bins, 3};
   }
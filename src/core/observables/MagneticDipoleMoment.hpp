@@ -20,14 +20,16 @@
 #define OBSERVABLES_MAGNETICDIPOLEMOMENT_HPP
 
 #include "PidObservable.hpp"
+#include "ReduciblePidObservable.hpp"
 
 #include <vector>
 
 namespace Observables {
 
-class MagneticDipoleMoment : public PidObservable {
+class MagneticDipoleMoment
+    : public ReduciblePidObservable<MagneticDipoleMoment, PidObservable> {
 public:
-  using PidObservable::PidObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
   std::vector<size_t> shape() const override { return {3}; }
 
   std::vector<double>
@@ -26,6 +26,10 @@
 
 namespace Observables {
 std::vector<double> PidObservable::operator()() const {
+  if (auto const result = evaluate_parallel()) {
+    return *result;
+  }
+
   std::vector<Particle> particles;
   particles.reserve(ids().size());
 
@@ -25,6 +25,9 @@
 
 #include <utils/Span.hpp>
 
+#include <boost/optional.hpp>
+#include <boost/serialization/vector.hpp>
+
 #include <vector>
 
 namespace Observables {
@@ -41,12 +44,26 @@ class PidObservable : virtual public Observable {
   virtual std::vector<double>
   evaluate(Utils::Span<const Particle *const> particles) const = 0;
 
+  /** Evaluate the observable on all nodes, without sending the
+   *  particle data to the head node.
+   *  @return The result, or nothing if the observable can only be
+   *          evaluated from the gathered particles.
+   */
+  virtual boost::optional<std::vector<double>> evaluate_parallel() const {
+    return {};
+  }
+
 public:
+  PidObservable() = default;
   explicit PidObservable(std::vector<int> ids) : m_ids(std::move(ids)) {}
   std::vector<double> operator()() const final;
 
   std::vector<int> &ids() { return m_ids; }
   std::vector<int> const &ids() const { return m_ids; }
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &m_ids;
+  }
 };
 
 } // Namespace Observables
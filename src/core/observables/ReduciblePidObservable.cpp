@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ReduciblePidObservable.hpp"
+
+#include "ComPosition.hpp"
+#include "ComVelocity.hpp"
+#include "Current.hpp"
+#include "CylindricalDensityProfile.hpp"
+#include "CylindricalFluxDensityProfile.hpp"
+#include "CylindricalVelocityProfile.hpp"
+#include "DensityProfile.hpp"
+#include "DipoleMoment.hpp"
+#include "FluxDensityProfile.hpp"
+#include "ForceDensityProfile.hpp"
+#include "MagneticDipoleMoment.hpp"
+#include "TotalForce.hpp"
+
+#include "cells.hpp"
+#include "grid.hpp"
+
+#include <boost/mpi/collectives/reduce.hpp>
+
+#include <functional>
+
+namespace Observables {
+namespace detail {
+std::vector<Particle> local_particles(std::vector<int> const &ids) {
+  std::vector<Particle> particles;
+  for (auto const id : ids) {
+    auto const p = (id >= 0) ? cell_structure.get_local_particle(id) : nullptr;
+    if (p and not p->l.ghost) {
+      particles.push_back(p->flat_copy());
+
+      auto &copy = particles.back();
+      copy.r.p += image_shift(copy.l.i, box_geo.length());
+      copy.l.i = {};
+    }
+  }
+
+  return particles;
+}
+
+std::vector<double> reduce_sum(std::vector<double> const &local) {
+  if (comm_cart.rank() == 0) {
+    std::vector<double> sum(local.size());
+    boost::mpi::reduce(comm_cart, local.data(), static_cast<int>(local.size()),
+                       sum.data(), std::plus<double>(), 0);
+    return sum;
+  }
+
+  boost::mpi::reduce(comm_cart, local.data(), static_cast<int>(local.size()),
+                     std::plus<double>(), 0);
+  return {};
+}
+} // namespace detail
+} // namespace Observables
+
+REGISTER_REDUCIBLE_OBSERVABLE(ComPosition)
+REGISTER_REDUCIBLE_OBSERVABLE(ComVelocity)
+REGISTER_REDUCIBLE_OBSERVABLE(Current)
+REGISTER_REDUCIBLE_OBSERVABLE(CylindricalDensityProfile)
+REGISTER_REDUCIBLE_OBSERVABLE(CylindricalFluxDensityProfile)
+REGISTER_REDUCIBLE_OBSERVABLE(CylindricalVelocityProfile)
+REGISTER_REDUCIBLE_OBSERVABLE(DensityProfile)
+REGISTER_REDUCIBLE_OBSERVABLE(DipoleMoment)
+REGISTER_REDUCIBLE_OBSERVABLE(FluxDensityProfile)
+REGISTER_REDUCIBLE_OBSERVABLE(ForceDensityProfile)
+REGISTER_REDUCIBLE_OBSERVABLE(MagneticDipoleMoment)
+REGISTER_REDUCIBLE_OBSERVABLE(TotalForce)
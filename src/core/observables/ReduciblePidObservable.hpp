@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBSERVABLES_REDUCIBLEPIDOBSERVABLE_HPP
+#define OBSERVABLES_REDUCIBLEPIDOBSERVABLE_HPP
+
+#include "Particle.hpp"
+#include "PidObservable.hpp"
+#include "communication.hpp"
+
+#include <utils/Span.hpp>
+
+#include <boost/optional.hpp>
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Observables {
+namespace detail {
+/** Copies of the particles in @p ids that are local to this node,
+ *  with unfolded positions. Duplicate ids yield duplicate copies.
+ */
+std::vector<Particle> local_particles(std::vector<int> const &ids);
+
+/** Sum of @p local over all nodes.
+ *  @return The sum on the head node, an empty vector otherwise.
+ */
+std::vector<double> reduce_sum(std::vector<double> const &local);
+} // namespace detail
+
+/** %Particle-based observable that is evaluated on all nodes in parallel.
+ *
+ *  The observable has to be a sum of contributions of the individual
+ *  particles, up to a final transformation. Every node computes the
+ *  contribution of its local particles with @c Derived::evaluate_partial(),
+ *  the contributions are summed on the head node and transformed by
+ *  @c Derived::finalize(). Only the parameters of the observable are
+ *  sent to the nodes and a single reduction is needed, instead of
+ *  gathering the particles on the head node.
+ *
+ *  By default, @c evaluate() is taken as the contribution and the sum is
+ *  returned as is, which is correct for histograms and sums over
+ *  the particles. @c Derived has to be default constructible and
+ *  serializable, and its callback has to be registered with
+ *  @ref REGISTER_REDUCIBLE_OBSERVABLE.
+ */
+template <class Derived, class Base>
+class ReduciblePidObservable : public Base {
+public:
+  using Base::Base;
+  ReduciblePidObservable() = default;
+
+  /** Contribution of a subset of the particles. */
+  std::vector<double>
+  evaluate_partial(Utils::Span<const Particle *const> particles) const {
+    return derived().evaluate(particles);
+  }
+
+  /** Result of the observable from the sum of all contributions. */
+  std::vector<double> finalize(std::vector<double> sum) const { return sum; }
+
+  /** Callback evaluating the contribution of the local particles. */
+  static void evaluate_local_slave(Derived const &observable) {
+    detail::reduce_sum(observable.evaluate_local());
+  }
+
+private:
+  Derived const &derived() const { return static_cast<Derived const &>(*this); }
+
+  /** Contribution of the local particles, followed by their number. */
+  std::vector<double> evaluate_local() const {
+    auto const particles = detail::local_particles(this->ids());
+    std::vector<const Particle *> particle_ptrs;
+    particle_ptrs.reserve(particles.size());
+    for (auto const &p : particles) {
+      particle_ptrs.push_back(&p);
+    }
+
+    auto result = derived().evaluate_partial(particle_ptrs);
+    result.push_back(static_cast<double>(particles.size()));
+    return result;
+  }
+
+  boost::optional<std::vector<double>> evaluate_parallel() const override {
+    mpi_call(evaluate_local_slave, derived());
+    auto sum = detail::reduce_sum(evaluate_local());
+
+    auto const n_found = static_cast<std::size_t>(sum.back());
+    sum.pop_back();
+    if (n_found != this->ids().size()) {
+      throw std::runtime_error("Not all particles of the observable exist.");
+    }
+
+    return derived().finalize(std::move(sum));
+  }
+};
+} // namespace Observables
+
+/** Register the callback of a @ref Observables::ReduciblePidObservable.
+ *  The macro should be used at global scope.
+ *
+ *  @param Obs Name of the observable class in namespace Observables
+ */
+#define REGISTER_REDUCIBLE_OBSERVABLE(Obs)                                     \
+  namespace Communication {                                                    \
+  static ::Communication::RegisterCallback                                     \
+      register_reducible_##Obs(&::Observables::Obs::evaluate_local_slave);     \
+  }
+
+#endif
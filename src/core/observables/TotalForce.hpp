@@ -20,13 +20,14 @@
 #define OBSERVABLES_TotalForce_HPP
 
 #include "PidObservable.hpp"
+#include "ReduciblePidObservable.hpp"
 
 #include <vector>
 
 namespace Observables {
-class TotalForce : public PidObservable {
+class TotalForce : public ReduciblePidObservable<TotalForce, PidObservable> {
 public:
-  using PidObservable::PidObservable;
+  using ReduciblePidObservable::ReduciblePidObservable;
   std::vector<size_t> shape() const override { return {3}; }
 
   std::vector<double>
@@ -51,7 +51,7 @@ public:
   bool decide(const Particle &p1, const Particle &p2) const override {
     return get_mi_vector(p1.r.p, p2.r.p, box_geo).norm() <= m_cut_off;
   };
-  double get_cut_off() { return m_cut_off; }
+  double get_cut_off() const { return m_cut_off; }
   void set_cut_off(double c) { m_cut_off = c; }
 
 private:
@@ -72,7 +72,7 @@ public:
     return (calc_non_bonded_pair_energy(p1, p2, ia_params, vec21,
                                         dist_betw_part)) >= m_cut_off;
   };
-  double get_cut_off() { return m_cut_off; }
+  double get_cut_off() const { return m_cut_off; }
   void set_cut_off(double c) { m_cut_off = c; }
 
 private:
@@ -86,7 +86,7 @@ public:
     return pair_bond_exists_on(p1, p2, m_bond_type) ||
            pair_bond_exists_on(p2, p1, m_bond_type);
   };
-  int get_bond_type() { return m_bond_type; };
+  int get_bond_type() const { return m_bond_type; };
   void set_bond_type(int t) { m_bond_type = t; }
 
 private:
@@ -42,6 +42,7 @@
 #include <utils/mpi/gatherv.hpp>
 
 #include <boost/algorithm/cxx11/copy_if.hpp>
+#include <boost/mpi/collectives/gather.hpp>
 #include <boost/mpi/collectives/scatter.hpp>
 #include <boost/range/algorithm.hpp>
 #include <boost/range/numeric.hpp>
@@ -49,6 +50,7 @@
 #include <boost/serialization/vector.hpp>
 #include <boost/variant.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <unordered_map>
 #include <unordered_set>
@@ -600,6 +602,672 @@ void prefetch_particle_data(Utils::Span<const int> in_ids) {
   }
 }
 
+int bulk_property_width(BulkProperty prop) {
+  switch (prop) {
+  case BULK_POSITION:
+  case BULK_VELOCITY:
+  case BULK_FORCE:
+    return 3;
+  default:
+    return 1;
+  }
+}
+
+namespace {
+void get_local_property(BulkProperty prop, Particle const &p, double *out) {
+  switch (prop) {
+  case BULK_POSITION: {
+    auto const pos = unfolded_position(p.r.p, p.l.i, box_geo.length());
+    std::copy(pos.begin(), pos.end(), out);
+    break;
+  }
+  case BULK_VELOCITY:
+    std::copy(p.m.v.begin(), p.m.v.end(), out);
+    break;
+  case BULK_FORCE:
+    std::copy(p.f.f.begin(), p.f.f.end(), out);
+    break;
+  case BULK_TYPE:
+    *out = p.p.type;
+    break;
+  case BULK_MOL_ID:
+    *out = p.p.mol_id;
+    break;
+  case BULK_CHARGE:
+    *out = p.p.q;
+    break;
+  case BULK_MASS:
+    *out = p.p.mass;
+    break;
+  }
+}
+
+void set_local_property(BulkProperty prop, Particle &p, double const *in) {
+  switch (prop) {
+  case BULK_POSITION:
+    p.r.p = {in[0], in[1], in[2]};
+    p.l.i = {};
+    fold_position(p.r.p, p.l.i, box_geo);
+    break;
+  case BULK_VELOCITY:
+    p.m.v = {in[0], in[1], in[2]};
+    break;
+  case BULK_FORCE:
+    p.f.f = {in[0], in[1], in[2]};
+    break;
+  case BULK_TYPE:
+    p.p.type = static_cast<int>(*in);
+    break;
+  case BULK_MOL_ID:
+    p.p.mol_id = static_cast<int>(*in);
+    break;
+  case BULK_CHARGE:
+#ifdef ELECTROSTATICS
+    p.p.q = *in;
+#endif
+    break;
+  case BULK_MASS:
+#ifdef MASS
+    p.p.mass = *in;
+#endif
+    break;
+  }
+}
+
+/** Ids of the particles local to this node. */
+std::vector<int> scatter_ids(std::vector<std::vector<int>> const &node_ids) {
+  std::vector<int> ids;
+  boost::mpi::scatter(comm_cart, node_ids, ids, 0);
+  return ids;
+}
+
+std::vector<double> get_local_particles_property(BulkProperty prop,
+                                                 std::vector<int> const &ids) {
+  auto const width = bulk_property_width(prop);
+  std::vector<double> values(width * ids.size());
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    auto const p = cell_structure.get_local_particle(ids[i]);
+    assert(p);
+    get_local_property(prop, *p, values.data() + width * i);
+  }
+  return values;
+}
+
+void set_local_particles_property(BulkProperty prop,
+                                  std::vector<int> const &ids,
+                                  std::vector<double> const &values) {
+  auto const width = bulk_property_width(prop);
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    auto const p = cell_structure.get_local_particle(ids[i]);
+    assert(p);
+    set_local_property(prop, *p, values.data() + width * i);
+  }
+  if (prop == BULK_POSITION)
+    cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
+  on_particle_change();
+}
+
+/** Group the ids per node, and remember the position of every id
+ *  in @p ids. */
+void group_ids_by_node(std::vector<int> const &ids,
+                       std::vector<std::vector<int>> &node_ids,
+                       std::vector<std::vector<std::size_t>> &node_index) {
+  node_ids.assign(comm_cart.size(), {});
+  node_index.assign(comm_cart.size(), {});
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    auto const pnode = get_particle_node(ids[i]);
+    node_ids[pnode].push_back(ids[i]);
+    node_index[pnode].push_back(i);
+  }
+}
+} // namespace
+
+void mpi_get_particles_property_slave(int prop) {
+  auto const ids = scatter_ids({});
+  boost::mpi::gather(
+      comm_cart,
+      get_local_particles_property(static_cast<BulkProperty>(prop), ids), 0);
+}
+
+REGISTER_CALLBACK(mpi_get_particles_property_slave)
+
+void mpi_set_particles_property_slave(int prop) {
+  auto const ids = scatter_ids({});
+  std::vector<double> values;
+  boost::mpi::scatter(comm_cart, values, 0);
+  set_local_particles_property(static_cast<BulkProperty>(prop), ids, values);
+}
+
+REGISTER_CALLBACK(mpi_set_particles_property_slave)
+
+std::vector<double> get_particles_property(BulkProperty prop,
+                                           std::vector<int> const &ids) {
+  std::vector<std::vector<int>> node_ids;
+  std::vector<std::vector<std::size_t>> node_index;
+  group_ids_by_node(ids, node_ids, node_index);
+
+  mpi_call(mpi_get_particles_property_slave, static_cast<int>(prop));
+  auto const local_ids = scatter_ids(node_ids);
+  std::vector<std::vector<double>> node_values;
+  boost::mpi::gather(comm_cart, get_local_particles_property(prop, local_ids),
+                     node_values, 0);
+
+  auto const width = bulk_property_width(prop);
+  std::vector<double> values(width * ids.size());
+  for (std::size_t node = 0; node < node_values.size(); ++node) {
+    for (std::size_t i = 0; i < node_index[node].size(); ++i) {
+      std::copy_n(node_values[node].begin() + width * i, width,
+                  values.begin() + width * node_index[node][i]);
+    }
+  }
+
+  return values;
+}
+
+void set_particles_property(BulkProperty prop, std::vector<int> const &ids,
+                            std::vector<double> const &values) {
+  auto const width = bulk_property_width(prop);
+  if (values.size() != width * ids.size())
+    throw std::invalid_argument("Wrong number of values for the particles.");
+#ifndef MASS
+  if (prop == BULK_MASS)
+    throw std::runtime_error("Feature MASS not compiled in.");
+#endif
+#ifndef ELECTROSTATICS
+  if (prop == BULK_CHARGE)
+    throw std::runtime_error("Feature ELECTROSTATICS not compiled in.");
+#endif
+
+  if (prop == BULK_TYPE) {
+    auto const max_type = std::max_element(values.begin(), values.end());
+    if (max_type != values.end())
+      make_particle_type_exist(static_cast<int>(*max_type));
+
+    if (type_list_enable) {
+      auto const old_types = get_particles_property(prop, ids);
+      for (std::size_t i = 0; i < ids.size(); ++i) {
+        auto const type = static_cast<int>(values[i]);
+        auto const old_type = static_cast<int>(old_types[i]);
+        if (type != old_type)
+          remove_id_from_map(ids[i], old_type);
+        add_id_to_type_map(ids[i], type);
+      }
+    }
+  }
+
+  std::vector<std::vector<int>> node_ids;
+  std::vector<std::vector<std::size_t>> node_index;
+  group_ids_by_node(ids, node_ids, node_index);
+
+  std::vector<std::vector<double>> node_values(node_ids.size());
+  for (std::size_t node = 0; node < node_ids.size(); ++node) {
+    for (auto const i : node_index[node]) {
+      node_values[node].insert(node_values[node].end(),
+                               values.begin() + width * i,
+                               values.begin() + width * (i + 1));
+    }
+  }
+
+  mpi_call(mpi_set_particles_property_slave, static_cast<int>(prop));
+  auto const local_ids = scatter_ids(node_ids);
+  std::vector<double> local_values;
+  boost::mpi::scatter(comm_cart, node_values, local_values, 0);
+  set_local_particles_property(prop, local_ids, local_values);
+}
+
+namespace {
+/** Node which will own a new particle at @p pos. */
+int new_particle_node(int id, Utils::Vector3d const &pos) {
+  if (cell_structure.type == CELL_STRUCTURE_NSQUARE)
+    return id % comm_cart.size();
+  return map_position_node_array(pos);
+}
+
+void place_local_new_particles(std::vector<int> const &props,
+                               std::vector<int> const &ids,
+                               std::vector<double> const &values) {
+  std::size_t stride = 3;
+  for (auto const prop : props)
+    stride += bulk_property_width(static_cast<BulkProperty>(prop));
+
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    Particle p;
+    p.p.identity = ids[i];
+    auto in = values.data() + stride * i;
+    set_local_property(BULK_POSITION, p, in);
+    in += 3;
+    for (auto const prop : props) {
+      set_local_property(static_cast<BulkProperty>(prop), p, in);
+      in += bulk_property_width(static_cast<BulkProperty>(prop));
+    }
+
+    /* If the particle is at the boundary of the local domain and was
+     * mapped to a neighbor due to round-off, it is sorted later. */
+    if (not cell_structure.add_local_particle(std::move(p)))
+      cell_structure.add_particle(std::move(p));
+  }
+  on_particle_change();
+}
+} // namespace
+
+void mpi_place_new_particles_slave(std::vector<int> const &props) {
+  auto const ids = scatter_ids({});
+  std::vector<double> values;
+  boost::mpi::scatter(comm_cart, values, 0);
+  place_local_new_particles(props, ids, values);
+}
+
+REGISTER_CALLBACK(mpi_place_new_particles_slave)
+
+void place_new_particles(std::vector<int> const &ids,
+                         std::vector<double> const &positions,
+                         std::vector<BulkProperty> const &props,
+                         std::vector<std::vector<double>> const &values) {
+  auto const n_part = ids.size();
+  if (positions.size() != 3 * n_part or values.size() != props.size())
+    throw std::invalid_argument("Wrong number of values for the particles.");
+  for (std::size_t j = 0; j < props.size(); ++j) {
+    if (props[j] == BULK_POSITION or
+        values[j].size() != bulk_property_width(props[j]) * n_part)
+      throw std::invalid_argument("Wrong number of values for the particles.");
+#ifndef MASS
+    if (props[j] == BULK_MASS)
+      throw std::runtime_error("Feature MASS not compiled in.");
+#endif
+#ifndef ELECTROSTATICS
+    if (props[j] == BULK_CHARGE)
+      throw std::runtime_error("Feature ELECTROSTATICS not compiled in.");
+#endif
+  }
+  {
+    std::unordered_set<int> unique_ids;
+    for (auto const id : ids) {
+      if (id < 0)
+        throw std::runtime_error("Invalid particle id!");
+      if (particle_exists(id) or not unique_ids.insert(id).second)
+        throw std::runtime_error("Particle " + std::to_string(id) +
+                                 " already exists.");
+    }
+  }
+  if (n_part == 0)
+    return;
+
+  for (std::size_t j = 0; j < props.size(); ++j) {
+    if (props[j] != BULK_TYPE)
+      continue;
+    make_particle_type_exist(
+        static_cast<int>(*boost::max_element(values[j])));
+    if (type_list_enable) {
+      for (std::size_t i = 0; i < n_part; ++i)
+        add_id_to_type_map(ids[i], static_cast<int>(values[j][i]));
+    }
+  }
+
+  /* Pack the ids and values per node, the values of a particle are
+   * its position followed by the properties in the order of props. */
+  std::vector<std::vector<int>> node_ids(comm_cart.size());
+  std::vector<std::vector<double>> node_values(comm_cart.size());
+  for (std::size_t i = 0; i < n_part; ++i) {
+    auto const pos = Utils::Vector3d(positions.begin() + 3 * i,
+                                     positions.begin() + 3 * (i + 1));
+    auto const node = new_particle_node(ids[i], pos);
+    node_ids[node].push_back(ids[i]);
+    auto &out = node_values[node];
+    out.insert(out.end(), pos.begin(), pos.end());
+    for (std::size_t j = 0; j < props.size(); ++j) {
+      auto const width = bulk_property_width(props[j]);
+      out.insert(out.end(), values[j].begin() + width * i,
+                 values[j].begin() + width * (i + 1));
+    }
+    particle_node[ids[i]] = node;
+  }
+
+  std::vector<int> const int_props(props.begin(), props.end());
+  mpi_call(mpi_place_new_particles_slave, int_props);
+  auto const local_ids = scatter_ids(node_ids);
+  std::vector<double> local_values;
+  boost::mpi::scatter(comm_cart, node_values, local_values, 0);
+  place_local_new_particles(int_props, local_ids, local_values);
+}
+
+namespace {
+void add_local_particles_bond(int bond_type, std::vector<int> const &ids,
+                              std::vector<int> const &partners) {
+  auto const n_partners = bonded_ia_params[bond_type].num;
+  std::vector<int> bond(1 + n_partners);
+  bond[0] = bond_type;
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    std::copy_n(partners.begin() + n_partners * i, n_partners,
+                bond.begin() + 1);
+    auto const p = cell_structure.get_local_particle(ids[i]);
+    assert(p);
+    add_bond(*p, bond);
+  }
+  on_particle_change();
+}
+} // namespace
+
+void mpi_add_particles_bond_slave(int bond_type) {
+  auto const ids = scatter_ids({});
+  std::vector<int> partners;
+  boost::mpi::scatter(comm_cart, partners, 0);
+  add_local_particles_bond(bond_type, ids, partners);
+}
+
+REGISTER_CALLBACK(mpi_add_particles_bond_slave)
+
+void add_particles_bond(int bond_type, std::vector<int> const &ids,
+                        std::vector<int> const &partners) {
+  if (bond_type < 0 or bond_type >= bonded_ia_params.size())
+    throw std::invalid_argument("The bond type " + std::to_string(bond_type) +
+                                " does not exist.");
+  auto const n_partners = bonded_ia_params[bond_type].num;
+  if (partners.size() != n_partners * ids.size())
+    throw std::invalid_argument("Bond of type " + std::to_string(bond_type) +
+                                " needs " + std::to_string(n_partners) +
+                                " partners.");
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    if (std::count(partners.begin() + n_partners * i,
+                   partners.begin() + n_partners * (i + 1), ids[i]))
+      throw std::invalid_argument("Bond partners include the particle " +
+                                  std::to_string(ids[i]) + " itself.");
+  }
+
+  std::vector<std::vector<int>> node_ids;
+  std::vector<std::vector<std::size_t>> node_index;
+  group_ids_by_node(ids, node_ids, node_index);
+
+  std::vector<std::vector<int>> node_partners(node_ids.size());
+  for (std::size_t node = 0; node < node_ids.size(); ++node) {
+    for (auto const i : node_index[node]) {
+      node_partners[node].insert(node_partners[node].end(),
+                                 partners.begin() + n_partners * i,
+                                 partners.begin() + n_partners * (i + 1));
+    }
+  }
+
+  mpi_call(mpi_add_particles_bond_slave, bond_type);
+  auto const local_ids = scatter_ids(node_ids);
+  std::vector<int> local_partners;
+  boost::mpi::scatter(comm_cart, node_partners, local_partners, 0);
+  add_local_particles_bond(bond_type, local_ids, local_partners);
+}
+
+namespace {
+using ParticleChange = ParticleChangeBatch::Change;
+
+/** Undo records and removed particles of a @ref ParticleChangeBatch
+ *  on one node. */
+struct ParticleChangeUndo {
+  std::vector<ParticleChange> changes;
+  std::vector<Particle> removed;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &changes &removed;
+  }
+};
+
+/** Particle @p id if it is owned by this node. */
+Particle *get_owned_particle(int id) {
+  auto const p = cell_structure.get_local_particle(id);
+  return (p and not p->l.ghost) ? p : nullptr;
+}
+
+void insert_new_particle(Particle &&p) {
+  /* If the particle is at the boundary of the local domain and was
+   * mapped to a neighbor due to round-off, it is sorted later. */
+  if (not cell_structure.add_local_particle(std::move(p)))
+    cell_structure.add_particle(std::move(p));
+}
+
+/** Change a property of a local particle and return the undo record. */
+ParticleChange change_local_particle(Particle &p, ParticleChange const &change) {
+  ParticleChange undo{change.kind, change.id, {}};
+  switch (change.kind) {
+  case ParticleChange::TYPE:
+    undo.value[0] = p.p.type;
+    p.p.type = static_cast<int>(change.value[0]);
+    break;
+  case ParticleChange::CHARGE:
+    undo.value[0] = p.p.q;
+#ifdef ELECTROSTATICS
+    p.p.q = change.value[0];
+#endif
+    break;
+  case ParticleChange::POSITION:
+    undo.value = unfolded_position(p.r.p, p.l.i, box_geo.length());
+    p.r.p = change.value;
+    p.l.i = {};
+    fold_position(p.r.p, p.l.i, box_geo);
+    break;
+  case ParticleChange::VELOCITY:
+    undo.value = p.m.v;
+    p.m.v = change.value;
+    break;
+  default:
+    assert(false);
+  }
+  return undo;
+}
+
+/** Apply the changes to the particles of this node.
+ *  @return The undo records in reverse order of the changes, and
+ *          the removed particles.
+ */
+ParticleChangeUndo
+apply_local_particle_changes(std::vector<ParticleChange> const &changes) {
+  ParticleChangeUndo undo;
+  for (auto const &change : changes) {
+    switch (change.kind) {
+    case ParticleChange::CREATE:
+      if (new_particle_node(change.id, change.value) == comm_cart.rank()) {
+        Particle p;
+        p.p.identity = change.id;
+        p.r.p = change.value;
+        fold_position(p.r.p, p.l.i, box_geo);
+        insert_new_particle(std::move(p));
+        undo.changes.push_back({ParticleChange::REMOVE, change.id, {}});
+      }
+      break;
+    case ParticleChange::REMOVE:
+      if (auto const p = get_owned_particle(change.id)) {
+        auto const index = static_cast<double>(undo.removed.size());
+        undo.changes.push_back(
+            {ParticleChange::RESTORE, change.id, {index, 0., 0.}});
+        undo.removed.push_back(*p);
+      }
+      /* Also removes the bonds of the local particles to it */
+      cell_structure.remove_particle(change.id);
+      break;
+    default:
+      if (auto const p = get_owned_particle(change.id))
+        undo.changes.push_back(change_local_particle(*p, change));
+    }
+  }
+  std::reverse(undo.changes.begin(), undo.changes.end());
+
+  on_particle_change();
+  cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
+
+  return undo;
+}
+
+void rollback_local_particle_changes(std::vector<ParticleChange> const &undo,
+                                     std::vector<Particle> const &removed) {
+  for (auto const &change : undo) {
+    switch (change.kind) {
+    case ParticleChange::REMOVE:
+      cell_structure.remove_particle(change.id);
+      break;
+    case ParticleChange::RESTORE: {
+      auto p = removed[static_cast<std::size_t>(change.value[0])];
+      if (new_particle_node(p.identity(), p.r.p) == comm_cart.rank())
+        insert_new_particle(std::move(p));
+      break;
+    }
+    default:
+      /* The particle may have been resorted to another node since the
+       * changes were applied, so its current owner restores it. */
+      if (auto const p = get_owned_particle(change.id))
+        change_local_particle(*p, change);
+    }
+  }
+
+  on_particle_change();
+  cell_structure.set_resort_particles(Cells::RESORT_GLOBAL);
+}
+} // namespace
+
+void mpi_apply_particle_changes_slave(
+    std::vector<ParticleChange> const &changes) {
+  boost::mpi::gather(comm_cart, apply_local_particle_changes(changes), 0);
+}
+
+REGISTER_CALLBACK(mpi_apply_particle_changes_slave)
+
+void mpi_rollback_particle_changes_slave(
+    std::vector<ParticleChange> const &undo,
+    std::vector<Particle> const &removed) {
+  rollback_local_particle_changes(undo, removed);
+}
+
+REGISTER_CALLBACK(mpi_rollback_particle_changes_slave)
+
+void ParticleChangeBatch::stage(Change::Kind kind, int p_id,
+                                Utils::Vector3d const &value) {
+  if (p_id < 0)
+    throw std::runtime_error("Invalid particle id!");
+  m_changes.push_back({kind, p_id, value});
+}
+
+void ParticleChangeBatch::set_type(int p_id, int type) {
+  make_particle_type_exist(type);
+  stage(Change::TYPE, p_id, {static_cast<double>(type), 0., 0.});
+}
+
+void ParticleChangeBatch::set_charge(int p_id, double q) {
+  stage(Change::CHARGE, p_id, {q, 0., 0.});
+}
+
+void ParticleChangeBatch::set_position(int p_id, Utils::Vector3d const &pos) {
+  stage(Change::POSITION, p_id, pos);
+}
+
+void ParticleChangeBatch::set_velocity(int p_id, Utils::Vector3d const &v) {
+  stage(Change::VELOCITY, p_id, v);
+}
+
+void ParticleChangeBatch::create_particle(int p_id,
+                                          Utils::Vector3d const &pos) {
+  stage(Change::CREATE, p_id, pos);
+}
+
+void ParticleChangeBatch::remove_particle(int p_id) {
+  stage(Change::REMOVE, p_id);
+}
+
+void ParticleChangeBatch::apply() {
+  mpi_call(mpi_apply_particle_changes_slave, m_changes);
+  std::vector<ParticleChangeUndo> node_undo;
+  boost::mpi::gather(comm_cart, apply_local_particle_changes(m_changes),
+                     node_undo, 0);
+
+  m_undo.clear();
+  m_removed.clear();
+  for (auto const &undo : node_undo) {
+    auto const offset = static_cast<double>(m_removed.size());
+    for (auto change : undo.changes) {
+      if (change.kind == Change::RESTORE)
+        change.value[0] += offset;
+      m_undo.push_back(change);
+    }
+    m_removed.insert(m_removed.end(), undo.removed.begin(),
+                     undo.removed.end());
+  }
+
+  /* Types of the particles before the changes, the undo records are in
+   * reverse order, so the record of the first change comes last. */
+  std::unordered_map<int, int> types;
+  for (auto const &change : m_undo) {
+    if (change.kind == Change::TYPE)
+      types[change.id] = static_cast<int>(change.value[0]);
+  }
+  for (auto const &p : m_removed) {
+    types.emplace(p.identity(), p.p.type);
+  }
+
+  /* Update the type map and the node index on the master node, changes
+   * of particles which do not exist have not been applied. */
+  m_type_map_changes.clear();
+  auto const update_type_map = [this](int id, int old_type, int new_type) {
+    if (not type_list_enable)
+      return;
+    if (old_type != -1)
+      remove_id_from_map(id, old_type);
+    if (new_type != -1)
+      add_id_to_type_map(id, new_type);
+    m_type_map_changes.push_back({id, old_type, new_type});
+  };
+  for (auto const &change : m_changes) {
+    switch (change.kind) {
+    case Change::CREATE:
+      types[change.id] = Particle{}.p.type;
+      update_type_map(change.id, -1, types[change.id]);
+      if (not particle_node.empty())
+        particle_node[change.id] = new_particle_node(change.id, change.value);
+      break;
+    case Change::REMOVE: {
+      auto const type = types.find(change.id);
+      if (type != types.end()) {
+        update_type_map(change.id, type->second, -1);
+        types.erase(type);
+      }
+      particle_node.erase(change.id);
+      break;
+    }
+    case Change::TYPE: {
+      auto const type = types.find(change.id);
+      if (type != types.end()) {
+        update_type_map(change.id, type->second,
+                        static_cast<int>(change.value[0]));
+        type->second = static_cast<int>(change.value[0]);
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  m_changes.clear();
+}
+
+void ParticleChangeBatch::rollback() {
+  mpi_call(mpi_rollback_particle_changes_slave, m_undo, m_removed);
+  rollback_local_particle_changes(m_undo, m_removed);
+
+  for (auto it = m_type_map_changes.rbegin(); it != m_type_map_changes.rend();
+       ++it) {
+    if (it->new_type != -1)
+      remove_id_from_map(it->id, it->new_type);
+    if (it->old_type != -1)
+      add_id_to_type_map(it->id, it->old_type);
+  }
+  if (not particle_node.empty()) {
+    for (auto const &change : m_undo) {
+      if (change.kind == Change::REMOVE)
+        particle_node.erase(change.id);
+    }
+    for (auto const &p : m_removed) {
+      particle_node[p.identity()] = new_particle_node(p.identity(), p.r.p);
+    }
+  }
+
+  m_undo.clear();
+  m_removed.clear();
+  m_type_map_changes.clear();
+}
+
 int place_particle(int part, const double *pos) {
   Utils::Vector3d p{pos[0], pos[1], pos[2]};
 
@@ -44,6 +44,7 @@
 #include <utils/Vector.hpp>
 
 #include <memory>
+#include <vector>
 
 /************************************************
  * defines
@@ -114,6 +115,177 @@ void invalidate_fetch_cache();
  */
 size_t fetch_cache_max_size();
 
+/** Particle properties that can be accessed in bulk with
+ *  @ref get_particles_property and @ref set_particles_property.
+ */
+enum BulkProperty : int {
+  /** Unfolded positions, 3 values per particle */
+  BULK_POSITION,
+  /** Velocities, 3 values per particle */
+  BULK_VELOCITY,
+  /** Forces, 3 values per particle */
+  BULK_FORCE,
+  BULK_TYPE,
+  BULK_MOL_ID,
+  BULK_CHARGE,
+  BULK_MASS
+};
+
+/** Number of values per particle of a @ref BulkProperty. */
+int bulk_property_width(BulkProperty prop);
+
+/**
+ * @brief Get a property of many particles at once.
+ *
+ * The ids are sent to the nodes owning the particles with
+ * a single scatter, and the values are collected with a single
+ * gather, instead of one request per particle. Call only on the
+ * master node.
+ *
+ * @param prop The property
+ * @param ids  Ids of the particles, which have to exist.
+ * @return The values of the particles, in the order of @p ids,
+ *         with @ref bulk_property_width values per particle.
+ */
+std::vector<double> get_particles_property(BulkProperty prop,
+                                           std::vector<int> const &ids);
+
+/**
+ * @brief Set a property of many particles at once.
+ *
+ * Call only on the master node.
+ *
+ * @param prop   The property
+ * @param ids    Ids of the particles, which have to exist.
+ * @param values New values of the particles, in the order of @p ids,
+ *               with @ref bulk_property_width values per particle.
+ */
+void set_particles_property(BulkProperty prop, std::vector<int> const &ids,
+                            std::vector<double> const &values);
+
+/**
+ * @brief Create many particles at once.
+ *
+ * The owning node of every particle is determined on the master node,
+ * and the particles are sent to their nodes with a single scatter and
+ * directly inserted into their cells, instead of one round trip per
+ * particle. Call only on the master node.
+ *
+ * @param ids       Ids of the new particles, which must not exist yet.
+ * @param positions Positions of the new particles, 3 values per particle.
+ * @param props     Further properties of the new particles.
+ * @param values    Values of the properties in @p props, in the format
+ *                  of @ref set_particles_property.
+ */
+void place_new_particles(std::vector<int> const &ids,
+                         std::vector<double> const &positions,
+                         std::vector<BulkProperty> const &props,
+                         std::vector<std::vector<double>> const &values);
+
+/**
+ * @brief Add a bond of the same type to many particles at once.
+ *
+ * The bonds are sent to the nodes owning the particles with a single
+ * scatter, instead of one round trip per bond. Call only on the master
+ * node.
+ *
+ * @param bond_type Type of the bond.
+ * @param ids       Ids of the particles which store the bonds, which
+ *                  have to exist.
+ * @param partners  Partners of the bonds, in the order of @p ids,
+ *                  with as many partners per particle as the bond type
+ *                  requires.
+ */
+void add_particles_bond(int bond_type, std::vector<int> const &ids,
+                        std::vector<int> const &partners);
+
+/**
+ * @brief Changes of particles which are applied and undone together.
+ *
+ * Changes are staged on the master node and sent to all nodes with a
+ * single broadcast by @ref apply, every node applies the changes of its
+ * own particles and the previous values are collected on the master node
+ * with a single gather. @ref rollback restores them with another
+ * broadcast, without fetching the particles. This is meant for Monte
+ * Carlo trial moves, which change a few particles and have to undo
+ * the changes if the move is rejected.
+ *
+ * The type map and the particle node index on the master node are kept
+ * up to date. Bonds of other particles to removed particles are not
+ * restored by @ref rollback. Call only on the master node.
+ */
+class ParticleChangeBatch {
+public:
+  /** Change the type of an existing or new particle. */
+  void set_type(int p_id, int type);
+  /** Change the charge of an existing or new particle. */
+  void set_charge(int p_id, double q);
+  /** Move an existing or new particle to an unfolded position. */
+  void set_position(int p_id, Utils::Vector3d const &pos);
+  /** Change the velocity of an existing or new particle. */
+  void set_velocity(int p_id, Utils::Vector3d const &v);
+  /** Create a particle of type 0 at @p pos, the id must not be in use. */
+  void create_particle(int p_id, Utils::Vector3d const &pos);
+  /** Remove an existing particle. */
+  void remove_particle(int p_id);
+
+  /** @brief Apply all staged changes.
+   *
+   *  The staged changes are cleared, and the previous values are kept
+   *  for @ref rollback until the next call of @ref apply.
+   */
+  void apply();
+  /** @brief Undo the changes of the last call of @ref apply. */
+  void rollback();
+  /** @brief Drop the staged changes without applying them. */
+  void discard() { m_changes.clear(); }
+
+  bool empty() const { return m_changes.empty(); }
+
+  /** Single change of a particle, or the undo record of a change. */
+  struct Change {
+    enum Kind : int {
+      TYPE,
+      CHARGE,
+      POSITION,
+      VELOCITY,
+      CREATE,
+      REMOVE,
+      /** Re-insert a removed particle, @c value[0] is its index in
+       *  the removed particles. */
+      RESTORE
+    };
+
+    int kind;
+    int id;
+    /** New value, type and charge are stored in the first component. */
+    Utils::Vector3d value;
+
+    template <class Archive> void serialize(Archive &ar, long int) {
+      ar &kind &id &value;
+    }
+  };
+
+private:
+  /** Change of the type map, a type of -1 stands for no type. */
+  struct TypeMapChange {
+    int id;
+    int old_type;
+    int new_type;
+  };
+
+  void stage(Change::Kind kind, int p_id, Utils::Vector3d const &value = {});
+
+  std::vector<Change> m_changes;
+  /** Type map changes of the last call of @ref apply. */
+  std::vector<TypeMapChange> m_type_map_changes;
+  /** Undo records of the last call of @ref apply, in the order in
+   *  which they have to be applied. */
+  std::vector<Change> m_undo;
+  /** Particles removed by the last call of @ref apply. */
+  std::vector<Particle> m_removed;
+};
+
 /** Call only on the master node.
  *  Move a particle to a new position.
  *  If it does not exist, it is created.
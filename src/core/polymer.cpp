@@ -36,10 +36,15 @@
 
 #include <utils/Vector.hpp>
 #include <utils/constants.hpp>
+#include <utils/index.hpp>
 #include <utils/math/vec_rotate.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 template <class RNG> static Utils::Vector3d random_position(RNG &rng) {
   Utils::Vector3d v;
@@ -59,22 +64,122 @@ template <class RNG> static Utils::Vector3d random_unit_vector(RNG &rng) {
   return v;
 }
 
+namespace {
+/** @brief Positions sorted into a grid of cells which are at least as
+ *  large as the minimum distance, such that collisions only have to be
+ *  searched for in the neighboring cells.
+ */
+class PositionGrid {
+public:
+  explicit PositionGrid(double min_distance) {
+    /* Limit the number of cells, so that the linear index fits into an int
+     * for tiny distances. */
+    auto constexpr max_cells_per_dim = 1024;
+    for (int i = 0; i < 3; i++) {
+      auto const n =
+          (min_distance > 0)
+              ? std::floor(box_geo.length()[i] / min_distance)
+              : 1.;
+      m_shape[i] = static_cast<int>(
+          std::max(1., std::min(n, static_cast<double>(max_cells_per_dim))));
+      m_cell_size[i] = box_geo.length()[i] / m_shape[i];
+    }
+  }
+
+  void insert(Utils::Vector3d const &pos) {
+    m_cells[linear_index(pos)].push_back(pos);
+  }
+
+  /** Remove the most recently inserted copy of @p pos. */
+  void erase(Utils::Vector3d const &pos) {
+    auto &cell = m_cells[linear_index(pos)];
+    auto const it = std::find(cell.rbegin(), cell.rend(), pos);
+    if (it != cell.rend()) {
+      cell.erase(std::next(it).base());
+    }
+  }
+
+  /** Whether there is a position closer than @p min_distance to @p pos,
+   *  the distance has to be at most the cell size. */
+  bool collides(Utils::Vector3d const &pos, double min_distance) const {
+    auto const center = cell_of(pos);
+
+    /* Neighbor cells, small grids can contain a cell more than once. */
+    std::array<int, 27> neighbors;
+    int n_neighbors = 0;
+    for (int i = -1; i <= 1; i++) {
+      for (int j = -1; j <= 1; j++) {
+        for (int k = -1; k <= 1; k++) {
+          Utils::Vector3i cell = center + Utils::Vector3i{i, j, k};
+          bool valid = true;
+          for (int d = 0; d < 3; d++) {
+            if (box_geo.periodic(d)) {
+              cell[d] = (cell[d] + m_shape[d]) % m_shape[d];
+            } else if (cell[d] < 0 or cell[d] >= m_shape[d]) {
+              valid = false;
+            }
+          }
+          if (valid)
+            neighbors[n_neighbors++] = Utils::get_linear_index(cell, m_shape);
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.begin() + n_neighbors);
+    auto const last =
+        std::unique(neighbors.begin(), neighbors.begin() + n_neighbors);
+
+    for (auto it = neighbors.begin(); it != last; ++it) {
+      auto const cell = m_cells.find(*it);
+      if (cell == m_cells.end())
+        continue;
+      for (auto const &m : cell->second) {
+        if (get_mi_vector(pos, m, box_geo).norm() < min_distance) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+private:
+  /** Cell of the folded position, positions outside of a non-periodic
+   *  box belong to the boundary cells. */
+  Utils::Vector3i cell_of(Utils::Vector3d const &pos) const {
+    auto const folded_pos = folded_position(pos, box_geo);
+    Utils::Vector3i cell;
+    for (int i = 0; i < 3; i++) {
+      auto const c = std::floor(folded_pos[i] / m_cell_size[i]);
+      cell[i] = static_cast<int>(
+          std::max(0., std::min(c, static_cast<double>(m_shape[i] - 1))));
+    }
+    return cell;
+  }
+
+  int linear_index(Utils::Vector3d const &pos) const {
+    return Utils::get_linear_index(cell_of(pos), m_shape);
+  }
+
+  Utils::Vector3i m_shape;
+  Utils::Vector3d m_cell_size;
+  /** Positions by linear cell index, only non-empty cells are stored */
+  std::unordered_map<int, std::vector<Utils::Vector3d>> m_cells;
+};
+} // namespace
+
 /** Determines whether a given position @p pos is valid, i.e., it doesn't
  *  collide with existing or buffered particles, nor with existing constraints
  *  (if @c respect_constraints).
  *  @param pos                   the trial position in question
- *  @param positions             buffered positions to respect
- *  @param partCfg               existing particles to respect
+ *  @param grid                  existing particles and buffered positions
  *  @param min_distance          threshold for the minimum distance between
  *                               trial position and buffered/existing particles
  *  @param respect_constraints   whether to respect constraints
  *  @return true if valid position, false if not.
  */
-static bool
-is_valid_position(Utils::Vector3d const &pos,
-                  std::vector<std::vector<Utils::Vector3d>> const &positions,
-                  PartCfg &partCfg, double const min_distance,
-                  int const respect_constraints) {
+static bool is_valid_position(Utils::Vector3d const &pos,
+                              PositionGrid const &grid,
+                              double const min_distance,
+                              int const respect_constraints) {
   // check if constraint is violated
   if (respect_constraints) {
     Utils::Vector3d const folded_pos = folded_position(pos, box_geo);
@@ -95,19 +200,9 @@ is_valid_position(Utils::Vector3d const &pos,
     }
   }
 
-  if (min_distance > 0) {
-    // check for collision with existing particles
-    if (distto(partCfg, pos, -1) < min_distance) {
-      return false;
-    }
-
-    for (auto const &p : positions) {
-      for (auto const &m : p) {
-        if (get_mi_vector(pos, m, box_geo).norm() < min_distance) {
-          return false;
-        }
-      }
-    }
+  // check for collision with existing particles and buffered positions
+  if (min_distance > 0 and grid.collides(pos, min_distance)) {
+    return false;
   }
   return true;
 }
@@ -128,15 +223,32 @@ draw_polymer_positions(PartCfg &partCfg, int const n_polymers,
     p.reserve(beads_per_chain);
   }
 
-  auto is_valid_pos = [&positions, &partCfg, min_distance,
+  PositionGrid grid(min_distance);
+  if (min_distance > 0) {
+    for (auto const &p : partCfg) {
+      grid.insert(p.r.p);
+    }
+  }
+
+  auto is_valid_pos = [&grid, min_distance,
                        respect_constraints](Utils::Vector3d const &v) {
-    return is_valid_position(v, positions, partCfg, min_distance,
-                             respect_constraints);
+    return is_valid_position(v, grid, min_distance, respect_constraints);
+  };
+  auto push_position = [&positions, &grid, min_distance](int p,
+                                                         Utils::Vector3d v) {
+    positions[p].push_back(v);
+    if (min_distance > 0)
+      grid.insert(v);
+  };
+  auto pop_position = [&positions, &grid, min_distance](int p) {
+    if (min_distance > 0)
+      grid.erase(positions[p].back());
+    positions[p].pop_back();
   };
 
   for (size_t p = 0; p < start_positions.size(); p++) {
     if (is_valid_pos(start_positions[p])) {
-      positions[p].push_back(start_positions[p]);
+      push_position(p, start_positions[p]);
     } else {
       throw std::runtime_error("Invalid start positions.");
     }
@@ -183,10 +295,10 @@ draw_polymer_positions(PartCfg &partCfg, int const n_polymers,
 
         if (pos) {
           /* Move on one position */
-          positions[p].push_back(*pos);
+          push_position(p, *pos);
         } else if (not positions[p].empty()) {
           /* Go back one position and try again */
-          positions[p].pop_back();
+          pop_position(p);
           rejections++;
           if (rejections > max_tries) {
             /* Give up for this try. */
@@ -21,16 +21,88 @@
 
 #include "reaction_ensemble.hpp"
 #include "Particle.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
 #include "energy.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
-#include "partCfg_global.hpp"
 
 #include <utils/constants.hpp>
 #include <utils/index.hpp>
 
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/operations.hpp>
+
+#include <cmath>
 #include <cstdio>
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+
+namespace {
+/** Cells of a grid of the box with the given shape which are occupied by
+ *  the local particles, see @ref CavityGrid.
+ */
+std::vector<int> local_occupied_cells(Utils::Vector3i const &shape,
+                                      double cavity_radius,
+                                      std::vector<int> const &ignored_ids) {
+  std::vector<int> occupied(shape[0] * shape[1] * shape[2], 0);
+  Utils::Vector3d cell_size;
+  for (int i = 0; i < 3; i++)
+    cell_size[i] = box_geo.length()[i] / shape[i];
+
+  // all points of a cell are within the cavity radius of a particle if the
+  // center of the cell is closer than this
+  auto const radius = cavity_radius - 0.5 * cell_size.norm();
+  if (radius <= 0.)
+    return occupied;
+
+  for (auto const &p : cell_structure.local_cells().particles()) {
+    if (std::find(ignored_ids.begin(), ignored_ids.end(), p.identity()) !=
+        ignored_ids.end())
+      continue;
+    auto const pos = folded_position(p.r.p, box_geo);
+    Utils::Vector3i lower, upper;
+    for (int i = 0; i < 3; i++) {
+      lower[i] = static_cast<int>(std::floor((pos[i] - radius) / cell_size[i]));
+      upper[i] = static_cast<int>(std::floor((pos[i] + radius) / cell_size[i]));
+      if (!box_geo.periodic(i)) {
+        lower[i] = std::max(lower[i], 0);
+        upper[i] = std::min(upper[i], shape[i] - 1);
+      }
+    }
+    Utils::Vector3i index;
+    for (index[0] = lower[0]; index[0] <= upper[0]; index[0]++) {
+      for (index[1] = lower[1]; index[1] <= upper[1]; index[1]++) {
+        for (index[2] = lower[2]; index[2] <= upper[2]; index[2]++) {
+          Utils::Vector3d center;
+          Utils::Vector3i folded_index;
+          for (int i = 0; i < 3; i++) {
+            center[i] = (index[i] + 0.5) * cell_size[i];
+            folded_index[i] = (index[i] % shape[i] + shape[i]) % shape[i];
+          }
+          if ((center - pos).norm2() < radius * radius)
+            occupied[Utils::get_linear_index(folded_index, shape)] = 1;
+        }
+      }
+    }
+  }
+  return occupied;
+}
+
+void mpi_occupied_cells_slave(Utils::Vector3i const &shape,
+                              double cavity_radius,
+                              std::vector<int> const &ignored_ids) {
+  auto const occupied = local_occupied_cells(shape, cavity_radius, ignored_ids);
+  boost::mpi::reduce(comm_cart, occupied.data(),
+                     static_cast<int>(occupied.size()),
+                     boost::mpi::maximum<int>(), 0);
+}
+
+} // namespace
+
+REGISTER_CALLBACK(mpi_occupied_cells_slave)
 
 namespace ReactionEnsemble {
 /**
@@ -68,6 +140,17 @@ template <typename T> bool is_in_list(T value, const std::vector<T> &list) {
   return false;
 }
 
+/**
+ * Ids of all particles touched by a reaction attempt, i.e. of the reactant
+ * particles and of the created product particles.
+ */
+std::vector<int> touched_particles(std::vector<int> const &reactant_p_ids,
+                                   std::vector<int> const &created_p_ids) {
+  auto p_ids = reactant_p_ids;
+  p_ids.insert(p_ids.end(), created_p_ids.begin(), created_p_ids.end());
+  return p_ids;
+}
+
 /** Save minimum and maximum energies as a function of the other collective
  *  variables under min_boundaries_energies, max_boundaries_energies
  */
@@ -246,26 +329,49 @@ bool ReactionAlgorithm::all_reactant_particles_exist(int reaction_id) {
 }
 
 /**
- * Stores the particle property of a random particle of the provided type into
- * the provided vector
+ * Randomly selects the reactant particles of a reaction without modifying
+ * them, reactant_coefficients[i] distinct particles of reactant_types[i] for
+ * every reactant.
  */
-void ReactionAlgorithm::append_particle_property_of_random_particle(
-    int type, std::vector<StoredParticleProperty> &list_of_particles) {
-  int random_index_in_type_map = i_random(number_of_particles_with_type(type));
-  int p_id = get_random_p_id(type, random_index_in_type_map);
-  StoredParticleProperty property_of_part = {p_id, charges_of_types[type],
-                                             type};
-  list_of_particles.push_back(property_of_part);
+std::vector<int> ReactionAlgorithm::choose_reactant_particles(
+    SingleReaction const &current_reaction) {
+  std::vector<int> p_ids;
+  for (int i = 0; i < current_reaction.reactant_types.size(); i++) {
+    auto const type = current_reaction.reactant_types[i];
+    for (int j = 0; j < current_reaction.reactant_coefficients[i]; j++) {
+      int p_id;
+      do {
+        p_id = get_random_p_id(type,
+                               i_random(number_of_particles_with_type(type)));
+      } while (is_in_list(p_id, p_ids));
+      p_ids.push_back(p_id);
+    }
+  }
+  return p_ids;
 }
 
 /**
- *Performs a trial reaction move
+ *Performs a trial reaction move with the reactant particles chosen by
+ *choose_reactant_particles()
  */
 void ReactionAlgorithm::make_reaction_attempt(
-    SingleReaction &current_reaction,
+    SingleReaction &current_reaction, std::vector<int> const &reactant_p_ids,
     std::vector<StoredParticleProperty> &changed_particles_properties,
     std::vector<int> &p_ids_created_particles,
     std::vector<StoredParticleProperty> &hidden_particles_properties) {
+  m_reused_p_ids.clear();
+  m_max_created_p_id = -1;
+  m_trial_changes_applied = false;
+  m_created_positions.clear();
+
+  auto next_reactant = reactant_p_ids.begin();
+  auto const store_property_of_next_reactant =
+      [&](int type, std::vector<StoredParticleProperty> &list_of_particles) {
+        StoredParticleProperty property_of_part = {
+            *next_reactant++, charges_of_types[type], type};
+        list_of_particles.push_back(property_of_part);
+      };
+
   // create or hide particles of types with corresponding types in reaction
   for (int i = 0; i < std::min(current_reaction.product_types.size(),
                                current_reaction.reactant_types.size());
@@ -275,8 +381,8 @@ void ReactionAlgorithm::make_reaction_attempt(
     for (int j = 0; j < std::min(current_reaction.product_coefficients[i],
                                  current_reaction.reactant_coefficients[i]);
          j++) {
-      append_particle_property_of_random_particle(
-          current_reaction.reactant_types[i], changed_particles_properties);
+      store_property_of_next_reactant(current_reaction.reactant_types[i],
+                                      changed_particles_properties);
       replace_particle(changed_particles_properties.back().p_id,
                        current_reaction.product_types[i]);
     }
@@ -299,8 +405,8 @@ void ReactionAlgorithm::make_reaction_attempt(
       for (int j = 0; j < current_reaction.reactant_coefficients[i] -
                               current_reaction.product_coefficients[i];
            j++) {
-        append_particle_property_of_random_particle(
-            current_reaction.reactant_types[i], hidden_particles_properties);
+        store_property_of_next_reactant(current_reaction.reactant_types[i],
+                                        hidden_particles_properties);
         hide_particle(hidden_particles_properties.back().p_id,
                       current_reaction.reactant_types[i]);
       }
@@ -316,8 +422,8 @@ void ReactionAlgorithm::make_reaction_attempt(
         current_reaction.reactant_types.size()) {
       // hide superfluous reactant_types particles
       for (int j = 0; j < current_reaction.reactant_coefficients[i]; j++) {
-        append_particle_property_of_random_particle(
-            current_reaction.reactant_types[i], hidden_particles_properties);
+        store_property_of_next_reactant(current_reaction.reactant_types[i],
+                                        hidden_particles_properties);
         hide_particle(hidden_particles_properties.back().p_id,
                       current_reaction.reactant_types[i]);
       }
@@ -329,30 +435,104 @@ void ReactionAlgorithm::make_reaction_attempt(
       }
     }
   }
+
+  // reject overlapping configurations before the changes are sent to the
+  // nodes and before any energy is calculated
+  auto positions = m_created_positions;
+  std::vector<int> hidden_p_ids;
+  for (auto const &property : hidden_particles_properties) {
+    auto const &pos = get_particle_data(property.p_id).r.p;
+    // the reverse move can only insert particles into free cells
+    if (m_cavity_grid.active() and not m_cavity_grid.is_free(pos))
+      particle_inside_exclusion_radius_touched = true;
+    positions.push_back(pos);
+    hidden_p_ids.push_back(property.p_id);
+  }
+  if (positions_overlap(positions, hidden_p_ids))
+    particle_inside_exclusion_radius_touched = true;
 }
 
 /**
- * Restores the previously stored particle properties. This function is invoked
- * when a reaction attempt is rejected.
+ * Sends the changes of the current trial move to the nodes.
  */
-void ReactionAlgorithm::restore_properties(
-    std::vector<StoredParticleProperty> &property_list,
-    const int number_of_saved_properties) {
-  // this function restores all properties of all particles provided in the
-  // property list, the format of the property list is (p_id,charge,type)
-  // repeated for each particle that occurs in that list
-  for (auto &i : property_list) {
-    int type = i.type;
-#ifdef ELECTROSTATICS
-    // set charge
-    double charge = i.charge;
-    set_particle_q(i.p_id, charge);
-#endif
-    // set type
-    set_particle_type(i.p_id, type);
+void ReactionAlgorithm::apply_trial_changes() {
+  m_trial_changes.apply();
+  m_trial_changes_applied = true;
+}
+
+/**
+ * Undoes the changes of the last trial move. This function is invoked
+ * when a trial move is rejected.
+ */
+void ReactionAlgorithm::reject_trial_changes() {
+  if (m_trial_changes_applied) {
+    m_trial_changes.rollback();
+  } else {
+    m_trial_changes.discard();
+  }
+  m_trial_changes_applied = false;
+  // the ids of the created particles which filled holes in the id range are
+  // free again
+  m_empty_p_ids_smaller_than_max_seen_particle.insert(
+      m_empty_p_ids_smaller_than_max_seen_particle.end(),
+      m_reused_p_ids.begin(), m_reused_p_ids.end());
+  m_reused_p_ids.clear();
+}
+
+/**
+ * Checks whether positions are closer to each other or to another particle
+ * than the exclusion radius, or the cavity radius if the current move uses
+ * the cavity bias. Only the cells around the positions are searched.
+ */
+bool ReactionAlgorithm::positions_overlap(
+    std::vector<Utils::Vector3d> const &positions,
+    std::vector<int> const &ignored_ids) const {
+  auto const radius = m_cavity_grid.active()
+                          ? std::max(exclusion_radius, cavity_radius)
+                          : exclusion_radius;
+  if (radius <= 0. or positions.empty())
+    return false;
+
+  for (int i = 0; i < positions.size(); i++) {
+    for (int j = i + 1; j < positions.size(); j++) {
+      if (get_mi_vector(positions[i], positions[j], box_geo).norm() < radius)
+        return true;
+    }
+  }
+  return mpi_particles_within_distance(positions, ignored_ids, radius);
+}
+
+/**
+ * Insertions without reactants and deletions without products use the cavity
+ * bias, if a cavity radius is set and the particles are inserted into the
+ * whole box.
+ */
+bool ReactionAlgorithm::uses_cavity_bias(
+    SingleReaction const &current_reaction) const {
+  return cavity_radius > 0. and not box_is_cylindric_around_z_axis and
+         not box_has_wall_constraints and
+         (current_reaction.reactant_types.empty() or
+          current_reaction.product_types.empty());
+}
+
+void ReactionAlgorithm::update_cavity_grid(
+    SingleReaction const &current_reaction,
+    std::vector<int> const &reactant_p_ids) {
+  if (uses_cavity_bias(current_reaction)) {
+    // the free cells are the ones of the configuration without the
+    // reactants, which is the same for a move and its reverse move
+    m_cavity_grid.update(cavity_radius, reactant_p_ids);
+  } else {
+    m_cavity_grid.clear();
   }
 }
 
+double ReactionAlgorithm::insertion_volume() const {
+  if (m_cavity_grid.active())
+    return volume * m_cavity_grid.free_fraction();
+  return volume;
+}
+
 /**
  * Calculates the expression in the acceptance probability in the reaction
  * ensemble
@@ -367,8 +547,9 @@ double ReactionEnsemble::calculate_acceptance_probability(
 
   const double beta = 1.0 / temperature;
   // calculate Boltzmann factor
-  return std::pow(volume, current_reaction.nu_bar) * current_reaction.gamma *
-         factorial_expr * exp(-beta * (E_pot_new - E_pot_old));
+  return std::pow(insertion_volume(), current_reaction.nu_bar) *
+         current_reaction.gamma * factorial_expr *
+         exp(-beta * (E_pot_new - E_pot_old));
 }
 
 std::map<int, int>
@@ -437,39 +618,44 @@ bool ReactionAlgorithm::generic_oneway_reaction(int reaction_id) {
     return reaction_is_accepted;
   }
 
-  // calculate potential energy
-  const double E_pot_old =
-      calculate_current_potential_energy_of_system(); // only consider potential
-                                                      // energy since we assume
-                                                      // that the kinetic part
-                                                      // drops out in the
-                                                      // process of calculating
-                                                      // ensemble averages
-                                                      // (kinetic part may be
-                                                      // separated and crossed
-                                                      // out)
-
-  // find reacting molecules in reactants and save their properties for later
-  // recreation if step is not accepted
-  // do reaction
+  // find reacting molecules in reactants, they are only modified by the
+  // reaction attempt
+  auto const reactant_p_ids = choose_reactant_particles(current_reaction);
+
   // save old particle_numbers
   std::map<int, int> old_particle_numbers =
       save_old_particle_numbers(reaction_id);
 
+  // prepare the reaction, overlapping configurations are detected before
+  // the changes are applied
+  update_cavity_grid(current_reaction, reactant_p_ids);
   std::vector<int> p_ids_created_particles;
   std::vector<StoredParticleProperty> hidden_particles_properties;
   std::vector<StoredParticleProperty> changed_particles_properties;
-  const int number_of_saved_properties =
-      3; // save p_id, charge and type of the reactant particle, only thing we
-         // need to hide the particle and recover it
-  make_reaction_attempt(current_reaction, changed_particles_properties,
-                        p_ids_created_particles, hidden_particles_properties);
+  make_reaction_attempt(current_reaction, reactant_p_ids,
+                        changed_particles_properties, p_ids_created_particles,
+                        hidden_particles_properties);
+
+  // calculate the potential energy of the interactions which are changed by
+  // the reaction. Only potential energy differences enter the acceptance
+  // probability, since we assume that the kinetic part drops out in the
+  // process of calculating ensemble averages (kinetic part may be separated
+  // and crossed out). Overlapping configurations are rejected without
+  // calculating any energy.
+  double E_pot_old = 0.0;
+  if (!particle_inside_exclusion_radius_touched)
+    E_pot_old =
+        calculate_potential_energy_contribution_of_particles(reactant_p_ids);
+
+  // do reaction, the changes are undone if the step is not accepted
+  apply_trial_changes();
 
   double E_pot_new;
   if (particle_inside_exclusion_radius_touched)
     E_pot_new = std::numeric_limits<double>::max();
   else
-    E_pot_new = calculate_current_potential_energy_of_system();
+    E_pot_new = calculate_potential_energy_contribution_of_particles(
+        touched_particles(reactant_p_ids, p_ids_created_particles));
 
   int new_state_index = -1; // save new_state_index for Wang-Landau algorithm
   int accepted_state = -1;  // for Wang-Landau algorithm
@@ -489,40 +675,17 @@ bool ReactionAlgorithm::generic_oneway_reaction(int reaction_id) {
     accepted_state = new_state_index;
 
     // delete hidden reactant_particles (remark: don't delete changed particles)
-    // extract ids of to be deleted particles
-    auto len_hidden_particles_properties =
-        static_cast<int>(hidden_particles_properties.size());
-    std::vector<int> to_be_deleted_hidden_ids(len_hidden_particles_properties);
-    std::vector<int> to_be_deleted_hidden_types(
-        len_hidden_particles_properties);
-    for (int i = 0; i < len_hidden_particles_properties; i++) {
-      auto p_id = static_cast<int>(hidden_particles_properties[i].p_id);
-      to_be_deleted_hidden_ids[i] = p_id;
-      to_be_deleted_hidden_types[i] = hidden_particles_properties[i].type;
-      set_particle_type(p_id,
-                        hidden_particles_properties[i]
-                            .type); // change back type otherwise the
-      // bookkeeping algorithm is not working
-    }
-
-    for (int i = 0; i < len_hidden_particles_properties; i++) {
-      delete_particle(to_be_deleted_hidden_ids[i]); // delete particle
+    for (auto const &hidden_particle_property : hidden_particles_properties) {
+      delete_particle(hidden_particle_property.p_id);
     }
     current_reaction.accepted_moves += 1;
     reaction_is_accepted = true;
   } else {
     // reject
     accepted_state = old_state_index;
-    // reverse reaction
-    // 1) delete created product particles
-    for (int p_ids_created_particle : p_ids_created_particles) {
-      delete_particle(p_ids_created_particle);
-    }
-    // 2) restore previously hidden reactant particles
-    restore_properties(hidden_particles_properties, number_of_saved_properties);
-    // 3) restore previously changed reactant particles
-    restore_properties(changed_particles_properties,
-                       number_of_saved_properties);
+    // reverse reaction: delete created product particles and restore
+    // previously hidden and changed reactant particles
+    reject_trial_changes();
     reaction_is_accepted = false;
   }
   on_end_reaction(accepted_state);
@@ -551,9 +714,9 @@ int ReactionAlgorithm::calculate_nu_bar(
  * especially means that the particle type and the particle charge are changed.
  */
 void ReactionAlgorithm::replace_particle(int p_id, int desired_type) {
-  set_particle_type(p_id, desired_type);
+  m_trial_changes.set_type(p_id, desired_type);
 #ifdef ELECTROSTATICS
-  set_particle_q(p_id, charges_of_types[desired_type]);
+  m_trial_changes.set_charge(p_id, charges_of_types[desired_type]);
 #endif
 }
 
@@ -574,18 +737,12 @@ void ReactionAlgorithm::replace_particle(int p_id, int desired_type) {
  * like the one above).
  */
 void ReactionAlgorithm::hide_particle(int p_id, int previous_type) {
-
-  auto part = get_particle_data(p_id);
-  double d_min = distto(partCfg(), part.r.p, p_id);
-  if (d_min < exclusion_radius)
-    particle_inside_exclusion_radius_touched = true;
-
 #ifdef ELECTROSTATICS
   // set charge
-  set_particle_q(p_id, 0.0);
+  m_trial_changes.set_charge(p_id, 0.0);
 #endif
   // set type
-  set_particle_type(p_id, non_interacting_type);
+  m_trial_changes.set_type(p_id, non_interacting_type);
 }
 
 /**
@@ -649,6 +806,26 @@ Utils::Vector3d ReactionAlgorithm::get_random_position_in_box() {
   return out_pos;
 }
 
+/**
+ * Draws a random position in a free cell of the cavity grid, if the cavity
+ * bias is used, otherwise in the whole box.
+ */
+Utils::Vector3d ReactionAlgorithm::get_random_insertion_position() {
+  if (!m_cavity_grid.active())
+    return get_random_position_in_box();
+
+  if (m_cavity_grid.n_free_cells() == 0) {
+    // there is no cavity, the insertion is rejected
+    particle_inside_exclusion_radius_touched = true;
+    return get_random_position_in_box();
+  }
+  auto const free_cell = i_random(m_cavity_grid.n_free_cells());
+  Utils::Vector3d offset;
+  for (int i = 0; i < 3; i++)
+    offset[i] = m_uniform_real_distribution(m_generator);
+  return m_cavity_grid.position(free_cell, offset);
+}
+
 /**
  * Writes a random position inside the central box into the provided array.
  * Additionally it proposes points with a small radii more often than a uniform
@@ -683,7 +860,8 @@ std::vector<double> ReactionAlgorithm::
 }
 
 /**
- * Creates a particle at the end of the observed particle id range.
+ * Creates a particle at the end of the observed particle id range. The
+ * particle is only created when the changes of the trial move are applied.
  */
 int ReactionAlgorithm::create_particle(int desired_type) {
   int p_id;
@@ -693,40 +871,37 @@ int ReactionAlgorithm::create_particle(int desired_type) {
         std::end(m_empty_p_ids_smaller_than_max_seen_particle));
     p_id = *p_id_iter;
     m_empty_p_ids_smaller_than_max_seen_particle.erase(p_id_iter);
+    m_reused_p_ids.push_back(p_id);
   } else {
-    p_id = get_maximal_particle_id() + 1;
+    // particles created earlier in this trial move do not exist yet
+    p_id = std::max(get_maximal_particle_id(), m_max_created_p_id) + 1;
+    m_max_created_p_id = p_id;
   }
-  Utils::Vector3d pos_vec;
 
   // create random velocity vector according to Maxwell Boltzmann distribution
   // for components
-  double vel[3];
+  Utils::Vector3d vel;
   // we use mass=1 for all particles, think about adapting this
   vel[0] = std::sqrt(temperature) * m_normal_distribution(m_generator);
   vel[1] = std::sqrt(temperature) * m_normal_distribution(m_generator);
   vel[2] = std::sqrt(temperature) * m_normal_distribution(m_generator);
-#ifdef ELECTROSTATICS
-  double charge = charges_of_types[desired_type];
-#endif
 
-  pos_vec = get_random_position_in_box();
-  place_particle(p_id, pos_vec.data());
+  auto const pos_vec = get_random_insertion_position();
+  m_created_positions.push_back(pos_vec);
+  m_trial_changes.create_particle(p_id, pos_vec);
   // set type
-  set_particle_type(p_id, desired_type);
+  m_trial_changes.set_type(p_id, desired_type);
 #ifdef ELECTROSTATICS
   // set charge
-  set_particle_q(p_id, charge);
+  m_trial_changes.set_charge(p_id, charges_of_types[desired_type]);
 #endif
   // set velocities
-  set_particle_v(p_id, vel);
-  double d_min = distto(partCfg(), pos_vec, p_id);
-  if (d_min < exclusion_radius) {
-    // setting of a minimal distance is allowed to avoid overlapping
-    // configurations if there is a repulsive potential. States with
-    // very high energies have a probability of almost zero and
-    // therefore do not contribute to ensemble averages.
-    particle_inside_exclusion_radius_touched = true;
-  }
+  m_trial_changes.set_velocity(p_id, vel);
+  // setting of a minimal distance is allowed to avoid overlapping
+  // configurations if there is a repulsive potential. States with
+  // very high energies have a probability of almost zero and
+  // therefore do not contribute to ensemble averages. This is checked
+  // by positions_overlap() before the particle is created.
   return p_id;
 }
 
@@ -760,6 +935,8 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
   m_tried_configurational_MC_moves += 1;
   bool got_accepted = false;
   particle_inside_exclusion_radius_touched = false;
+  // the particles are moved in the whole box
+  m_cavity_grid.clear();
 
   int old_state_index = -1;
   if (use_wang_landau) {
@@ -776,13 +953,8 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
     return got_accepted;
   }
 
-  const double E_pot_old = calculate_current_potential_energy_of_system();
-
-  std::vector<double> particle_positions(3 *
-                                         particle_number_of_type_to_be_changed);
   std::vector<int> p_id_s_changed_particles;
 
-  // save old_position
   int random_index_in_type_map = i_random(number_of_particles_with_type(type));
   int p_id = get_random_p_id(type, random_index_in_type_map);
   for (int i = 0; i < particle_number_of_type_to_be_changed; i++) {
@@ -793,42 +965,49 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
           type, random_index_in_type_map); // check whether you already touched
                                            // this p_id, then reassign
     }
-
-    auto part = get_particle_data(p_id);
-
-    particle_positions[3 * i] = part.r.p[0];
-    particle_positions[3 * i + 1] = part.r.p[1];
-    particle_positions[3 * i + 2] = part.r.p[2];
     p_id_s_changed_particles.push_back(p_id);
   }
 
-  // propose new positions
+  // propose new positions, the old positions are restored by
+  // reject_trial_changes()
+  auto const masses =
+      get_particles_property(BULK_MASS, p_id_s_changed_particles);
+  std::vector<Utils::Vector3d> new_positions;
   for (int i = 0; i < particle_number_of_type_to_be_changed; i++) {
     p_id = p_id_s_changed_particles[i];
     // change particle position
     auto const new_pos = get_random_position_in_box();
-    double vel[3];
-    auto const &p = get_particle_data(p_id);
+    Utils::Vector3d vel;
     vel[0] =
-        std::sqrt(temperature / p.p.mass) * m_normal_distribution(m_generator);
+        std::sqrt(temperature / masses[i]) * m_normal_distribution(m_generator);
     vel[1] =
-        std::sqrt(temperature / p.p.mass) * m_normal_distribution(m_generator);
+        std::sqrt(temperature / masses[i]) * m_normal_distribution(m_generator);
     vel[2] =
-        std::sqrt(temperature / p.p.mass) * m_normal_distribution(m_generator);
-    set_particle_v(p_id, vel);
+        std::sqrt(temperature / masses[i]) * m_normal_distribution(m_generator);
+    m_trial_changes.set_velocity(p_id, vel);
     // new_pos=get_random_position_in_box_enhanced_proposal_of_small_radii();
     // //enhanced proposal of small radii
-    place_particle(p_id, new_pos.data());
-    double d_min = distto(partCfg(), new_pos, p_id);
-    if (d_min < exclusion_radius)
-      particle_inside_exclusion_radius_touched = true;
+    m_trial_changes.set_position(p_id, new_pos);
+    new_positions.push_back(new_pos);
   }
+  m_reused_p_ids.clear();
+  // overlapping configurations are rejected without calculating any energy
+  particle_inside_exclusion_radius_touched =
+      positions_overlap(new_positions, p_id_s_changed_particles);
+
+  // only the interactions of the moved particles change
+  double E_pot_old = 0.0;
+  if (!particle_inside_exclusion_radius_touched)
+    E_pot_old = calculate_potential_energy_contribution_of_particles(
+        p_id_s_changed_particles);
+  apply_trial_changes();
 
   double E_pot_new;
   if (particle_inside_exclusion_radius_touched)
     E_pot_new = std::numeric_limits<double>::max();
   else
-    E_pot_new = calculate_current_potential_energy_of_system();
+    E_pot_new = calculate_potential_energy_contribution_of_particles(
+        p_id_s_changed_particles);
 
   double beta = 1.0 / temperature;
 
@@ -875,9 +1054,8 @@ bool ReactionAlgorithm::do_global_mc_move_for_particles_of_type(
     if (use_wang_landau) {
       on_mc_reject(old_state_index);
     }
-    // create particles again at the positions they were
-    for (int i = 0; i < particle_number_of_type_to_be_changed; i++)
-      place_particle(p_id_s_changed_particles[i], &particle_positions[3 * i]);
+    // move particles back to the positions they were
+    reject_trial_changes();
   }
   return got_accepted;
 }
@@ -1188,8 +1366,8 @@ double WangLandauReactionEnsemble::calculate_acceptance_probability(
   } else {
     double factorial_expr =
         calculate_factorial_expression(current_reaction, old_particle_numbers);
-    bf = std::pow(volume, current_reaction.nu_bar) * current_reaction.gamma *
-         factorial_expr;
+    bf = std::pow(insertion_volume(), current_reaction.nu_bar) *
+         current_reaction.gamma * factorial_expr;
   }
 
   if (!do_energy_reweighting) {
@@ -1547,6 +1725,26 @@ void WangLandauReactionEnsemble::remove_bins_that_have_not_been_sampled() {
   used_bins -= removed_bins;
 }
 
+/**
+ * Writes a file via a temporary file, such that other walkers reading the
+ * file never see a partially written file. Floating point numbers are
+ * written with full precision, such that they can be read back exactly.
+ */
+template <typename F>
+void write_file_atomically(const std::string &filename, F &&write) {
+  auto const temporary_filename = filename + ".tmp";
+  std::ofstream outfile(temporary_filename);
+  if (!outfile.is_open()) {
+    throw std::runtime_error("Exception opening " + temporary_filename);
+  }
+  outfile << std::setprecision(std::numeric_limits<double>::max_digits10);
+  write(outfile);
+  outfile.close();
+  if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+    throw std::runtime_error("Exception writing " + filename);
+  }
+}
+
 /**
  * Writes the Wang-Landau parameter, the histogram and the potential to a file.
  * You can restart a Wang-Landau simulation using this information.
@@ -1555,51 +1753,60 @@ void WangLandauReactionEnsemble::remove_bins_that_have_not_been_sampled() {
  */
 int WangLandauReactionEnsemble::write_wang_landau_checkpoint(
     const std::string &identifier) {
-  std::ofstream outfile;
-
   // write current Wang-Landau parameters (wang_landau_parameter,
   // monte_carlo_trial_moves, flat_index_of_current_state)
-  outfile.open(std::string("checkpoint_wang_landau_parameters_") + identifier);
-  outfile << wang_landau_parameter << " " << monte_carlo_trial_moves << " "
-          << get_flattened_index_wang_landau_of_current_state() << "\n";
-  outfile.close();
+  write_file_atomically(
+      std::string("checkpoint_wang_landau_parameters_") + identifier,
+      [this](std::ofstream &outfile) {
+        outfile << wang_landau_parameter << " " << monte_carlo_trial_moves
+                << " " << get_flattened_index_wang_landau_of_current_state()
+                << "\n";
+      });
 
   // write histogram
-  outfile.open(std::string("checkpoint_wang_landau_histogram_") + identifier);
-  for (int i = 0; i < wang_landau_potential.size(); i++) {
-    outfile << histogram[i] << "\n";
-  }
-  outfile.close();
+  write_file_atomically(
+      std::string("checkpoint_wang_landau_histogram_") + identifier,
+      [this](std::ofstream &outfile) {
+        for (int i : histogram) {
+          outfile << i << "\n";
+        }
+      });
   // write Wang-Landau potential
-  outfile.open(std::string("checkpoint_wang_landau_potential_") + identifier);
-  for (double i : wang_landau_potential) {
-    outfile << i << "\n";
-  }
-  outfile.close();
+  write_file_atomically(
+      std::string("checkpoint_wang_landau_potential_") + identifier,
+      [this](std::ofstream &outfile) {
+        for (double i : wang_landau_potential) {
+          outfile << i << "\n";
+        }
+      });
   return 0;
 }
 
 /**
- *Loads the Wang-Landau checkpoint
+ *Reads a Wang-Landau checkpoint
  */
-int WangLandauReactionEnsemble::load_wang_landau_checkpoint(
-    const std::string &identifier) {
+WangLandauReactionEnsemble::WangLandauCheckpoint
+WangLandauReactionEnsemble::read_wang_landau_checkpoint(
+    const std::string &identifier) const {
+  WangLandauCheckpoint checkpoint{wang_landau_parameter,
+                                  monte_carlo_trial_moves,
+                                  {},
+                                  {}};
   std::ifstream infile;
 
-  // restore Wang-Landau parameters
+  // read Wang-Landau parameters
   infile.open(std::string("checkpoint_wang_landau_parameters_") + identifier);
   if (infile.is_open()) {
 
     double wang_landau_parameter_entry;
     int wang_landau_monte_carlo_trial_moves_entry;
     int flat_index_of_state_at_checkpointing;
-    int line = 0;
     while (infile >> wang_landau_parameter_entry >>
            wang_landau_monte_carlo_trial_moves_entry >>
            flat_index_of_state_at_checkpointing) {
-      wang_landau_parameter = wang_landau_parameter_entry;
-      monte_carlo_trial_moves = wang_landau_monte_carlo_trial_moves_entry;
-      line += 1;
+      checkpoint.wang_landau_parameter = wang_landau_parameter_entry;
+      checkpoint.monte_carlo_trial_moves =
+          wang_landau_monte_carlo_trial_moves_entry;
     }
     infile.close();
   } else {
@@ -1608,14 +1815,12 @@ int WangLandauReactionEnsemble::load_wang_landau_checkpoint(
                              identifier);
   }
 
-  // restore histogram
+  // read histogram
   infile.open(std::string("checkpoint_wang_landau_histogram_") + identifier);
   if (infile.is_open()) {
     int hist_entry;
-    int line = 0;
     while (infile >> hist_entry) {
-      histogram[line] = hist_entry;
-      line += 1;
+      checkpoint.histogram.push_back(hist_entry);
     }
     infile.close();
   } else {
@@ -1624,14 +1829,12 @@ int WangLandauReactionEnsemble::load_wang_landau_checkpoint(
                              identifier);
   }
 
-  // restore Wang-Landau potential
+  // read Wang-Landau potential
   infile.open(std::string("checkpoint_wang_landau_potential_") + identifier);
   if (infile.is_open()) {
     double wang_landau_potential_entry;
-    int line = 0;
     while (infile >> wang_landau_potential_entry) {
-      wang_landau_potential[line] = wang_landau_potential_entry;
-      line += 1;
+      checkpoint.wang_landau_potential.push_back(wang_landau_potential_entry);
     }
     infile.close();
   } else {
@@ -1640,6 +1843,32 @@ int WangLandauReactionEnsemble::load_wang_landau_checkpoint(
                              identifier);
   }
 
+  if (checkpoint.histogram.size() != histogram.size() or
+      checkpoint.wang_landau_potential.size() != wang_landau_potential.size()) {
+    throw std::runtime_error("The Wang-Landau checkpoint " + identifier +
+                             " does not match the collective variables");
+  }
+
+  return checkpoint;
+}
+
+/**
+ *Loads the Wang-Landau checkpoint
+ */
+int WangLandauReactionEnsemble::load_wang_landau_checkpoint(
+    const std::string &identifier) {
+  auto checkpoint = read_wang_landau_checkpoint(identifier);
+  wang_landau_parameter = checkpoint.wang_landau_parameter;
+  monte_carlo_trial_moves = checkpoint.monte_carlo_trial_moves;
+  histogram = checkpoint.histogram;
+  wang_landau_potential = checkpoint.wang_landau_potential;
+
+  // the loaded state is the reference for merges with other walkers
+  m_merged_wang_landau_parameter = checkpoint.wang_landau_parameter;
+  m_merged_monte_carlo_trial_moves = checkpoint.monte_carlo_trial_moves;
+  m_merged_histogram = std::move(checkpoint.histogram);
+  m_merged_wang_landau_potential = std::move(checkpoint.wang_landau_potential);
+
   // possible task: restore state in which the system was when the checkpoint
   // was written. However as long as checkpointing and restoring the system form
   // the checkpoint is rare this should not matter statistically.
@@ -1647,6 +1876,96 @@ int WangLandauReactionEnsemble::load_wang_landau_checkpoint(
   return 0;
 }
 
+WangLandauReactionEnsemble::WangLandauCheckpoint
+WangLandauReactionEnsemble::merged_state() const {
+  if (!m_merged_wang_landau_potential.empty()) {
+    return {m_merged_wang_landau_parameter, m_merged_monte_carlo_trial_moves,
+            m_merged_histogram, m_merged_wang_landau_potential};
+  }
+
+  // nothing has been sampled yet in the allowed bins
+  WangLandauCheckpoint initial{initial_wang_landau_parameter, 0, histogram,
+                               wang_landau_potential};
+  for (int i = 0; i < histogram.size(); i++) {
+    if (histogram[i] >= 0) {
+      initial.histogram[i] = 0;
+      initial.wang_landau_potential[i] = 0.0;
+    }
+  }
+  return initial;
+}
+
+/**
+ *Combines the Wang-Landau estimates of this and of other walkers
+ */
+void WangLandauReactionEnsemble::merge_wang_landau_walkers(
+    const std::vector<std::string> &identifiers) {
+  auto const reference = merged_state();
+
+  std::vector<WangLandauCheckpoint> walkers = {{wang_landau_parameter,
+                                                monte_carlo_trial_moves,
+                                                histogram,
+                                                wang_landau_potential}};
+  for (auto const &identifier : identifiers) {
+    walkers.push_back(read_wang_landau_checkpoint(identifier));
+  }
+
+  // all walkers continue with the smallest Wang-Landau parameter. Walkers
+  // which refined it since the previous merge have reset their histogram,
+  // only their visits count for the flatness of the combined histogram.
+  double smallest_wang_landau_parameter = wang_landau_parameter;
+  for (auto const &walker : walkers) {
+    smallest_wang_landau_parameter = std::min(smallest_wang_landau_parameter,
+                                              walker.wang_landau_parameter);
+  }
+  bool const refined =
+      !m_system_is_in_1_over_t_regime &&
+      smallest_wang_landau_parameter < reference.wang_landau_parameter;
+
+  double minimum_wang_landau_potential = std::numeric_limits<double>::max();
+  for (int i = 0; i < histogram.size(); i++) {
+    if (histogram[i] < 0)
+      continue; // not in the range of the collective variables
+    double potential = reference.wang_landau_potential[i];
+    int visits = refined ? 0 : reference.histogram[i];
+    for (auto const &walker : walkers) {
+      if (walker.histogram[i] < 0)
+        continue;
+      potential +=
+          walker.wang_landau_potential[i] - reference.wang_landau_potential[i];
+      if (!refined) {
+        visits += walker.histogram[i] - reference.histogram[i];
+      } else if (walker.wang_landau_parameter ==
+                 smallest_wang_landau_parameter) {
+        visits += walker.histogram[i];
+      }
+    }
+    wang_landau_potential[i] = potential;
+    histogram[i] = visits;
+    minimum_wang_landau_potential =
+        std::min(minimum_wang_landau_potential, potential);
+  }
+  // only differences of the Wang-Landau potential matter, shift the minimum
+  // to zero to keep the allowed entries non-negative
+  for (int i = 0; i < histogram.size(); i++) {
+    if (histogram[i] >= 0)
+      wang_landau_potential[i] -= minimum_wang_landau_potential;
+  }
+
+  int trial_moves = reference.monte_carlo_trial_moves;
+  for (auto const &walker : walkers) {
+    trial_moves +=
+        walker.monte_carlo_trial_moves - reference.monte_carlo_trial_moves;
+  }
+  monte_carlo_trial_moves = trial_moves;
+  wang_landau_parameter = smallest_wang_landau_parameter;
+
+  m_merged_wang_landau_parameter = wang_landau_parameter;
+  m_merged_monte_carlo_trial_moves = monte_carlo_trial_moves;
+  m_merged_histogram = histogram;
+  m_merged_wang_landau_potential = wang_landau_potential;
+}
+
 int ConstantpHEnsemble::get_random_valid_p_id() {
   int random_p_id = i_random(get_maximal_particle_id() + 1);
   // draw random p_ids till we draw a pid which exists
@@ -1722,37 +2041,50 @@ double ConstantpHEnsemble::calculate_acceptance_probability(
 }
 
 std::pair<double, double>
-WidomInsertion::measure_excess_chemical_potential(int reaction_id) {
+WidomInsertion::measure_excess_chemical_potential(int reaction_id,
+                                                  int number_of_insertions) {
   if (!all_reactant_particles_exist(reaction_id))
     throw std::runtime_error("Trying to remove some non-existing particles "
                              "from the system via the inverse Widom scheme.");
 
   SingleReaction &current_reaction = reactions[reaction_id];
-  const double E_pot_old = calculate_current_potential_energy_of_system();
-
-  // make reaction attempt
-  std::vector<int> p_ids_created_particles;
-  std::vector<StoredParticleProperty> hidden_particles_properties;
-  std::vector<StoredParticleProperty> changed_particles_properties;
-  const int number_of_saved_properties =
-      3; // save p_id, charge and type of the reactant particle, only thing we
-         // need to hide the particle and recover it
-  make_reaction_attempt(current_reaction, changed_particles_properties,
-                        p_ids_created_particles, hidden_particles_properties);
-  const double E_pot_new = calculate_current_potential_energy_of_system();
-  // reverse reaction attempt
-  // reverse reaction
-  // 1) delete created product particles
-  for (int p_ids_created_particle : p_ids_created_particles) {
-    delete_particle(p_ids_created_particle);
-  }
-  // 2) restore previously hidden reactant particles
-  restore_properties(hidden_particles_properties, number_of_saved_properties);
-  // 3) restore previously changed reactant particles
-  restore_properties(changed_particles_properties, number_of_saved_properties);
-  std::vector<double> exponential = {
-      exp(-1.0 / temperature * (E_pot_new - E_pot_old))};
-  current_reaction.accumulator_exponentials(exponential);
+  for (int i = 0; i < number_of_insertions; i++) {
+    particle_inside_exclusion_radius_touched = false;
+    auto const reactant_p_ids = choose_reactant_particles(current_reaction);
+    // the configuration does not change, the free cells for insertions
+    // are only searched once
+    if (i == 0 or !reactant_p_ids.empty())
+      update_cavity_grid(current_reaction, reactant_p_ids);
+
+    // make reaction attempt
+    std::vector<int> p_ids_created_particles;
+    std::vector<StoredParticleProperty> hidden_particles_properties;
+    std::vector<StoredParticleProperty> changed_particles_properties;
+    make_reaction_attempt(current_reaction, reactant_p_ids,
+                          changed_particles_properties,
+                          p_ids_created_particles, hidden_particles_properties);
+
+    // insertions which overlap with other particles have a negligible
+    // Boltzmann factor
+    double boltzmann_factor = 0.0;
+    if (!particle_inside_exclusion_radius_touched) {
+      const double E_pot_old =
+          calculate_potential_energy_contribution_of_particles(reactant_p_ids);
+      apply_trial_changes();
+      const double E_pot_new =
+          calculate_potential_energy_contribution_of_particles(
+              touched_particles(reactant_p_ids, p_ids_created_particles));
+      boltzmann_factor = exp(-1.0 / temperature * (E_pot_new - E_pot_old));
+      // insertions into the free cells only sample a fraction of the volume
+      if (m_cavity_grid.active())
+        boltzmann_factor *= std::pow(m_cavity_grid.free_fraction(),
+                                     current_reaction.nu_bar);
+    }
+    // reverse reaction attempt
+    reject_trial_changes();
+    std::vector<double> exponential = {boltzmann_factor};
+    current_reaction.accumulator_exponentials(exponential);
+  }
 
   std::pair<double, double> result = std::make_pair(
       -temperature *
@@ -1800,4 +2132,133 @@ calculate_factorial_expression(SingleReaction &current_reaction,
   }
   return factorial_expr;
 }
+void CavityGrid::update(double cavity_radius,
+                        std::vector<int> const &ignored_ids) {
+  // at most 128 cells per direction to limit the memory
+  for (int i = 0; i < 3; i++) {
+    m_shape[i] = std::min(
+        128, std::max(1, static_cast<int>(std::ceil(
+                             box_geo.length()[i] * std::sqrt(3.0) /
+                             cavity_radius))));
+    m_cell_size[i] = box_geo.length()[i] / m_shape[i];
+  }
+
+  mpi_call(mpi_occupied_cells_slave, m_shape, cavity_radius, ignored_ids);
+  auto const local_occupied =
+      local_occupied_cells(m_shape, cavity_radius, ignored_ids);
+  m_occupied.resize(local_occupied.size());
+  boost::mpi::reduce(comm_cart, local_occupied.data(),
+                     static_cast<int>(local_occupied.size()),
+                     m_occupied.data(), boost::mpi::maximum<int>(), 0);
+
+  m_free_cells.clear();
+  for (int i = 0; i < m_occupied.size(); i++) {
+    if (!m_occupied[i])
+      m_free_cells.push_back(i);
+  }
+}
+
+void CavityGrid::clear() {
+  m_occupied.clear();
+  m_free_cells.clear();
+}
+
+double CavityGrid::free_fraction() const {
+  return static_cast<double>(m_free_cells.size()) /
+         static_cast<double>(m_occupied.size());
+}
+
+bool CavityGrid::is_free(Utils::Vector3d const &pos) const {
+  auto const folded_pos = folded_position(pos, box_geo);
+  Utils::Vector3i index;
+  for (int i = 0; i < 3; i++) {
+    index[i] = std::min(
+        m_shape[i] - 1,
+        std::max(0, static_cast<int>(folded_pos[i] / m_cell_size[i])));
+  }
+  return !m_occupied[Utils::get_linear_index(index, m_shape)];
+}
+
+Utils::Vector3d CavityGrid::position(int free_cell,
+                                     Utils::Vector3d const &offset) const {
+  // cells are stored in column-major order
+  auto const linear_index = m_free_cells[free_cell];
+  Utils::Vector3i const index = {linear_index % m_shape[0],
+                                 (linear_index / m_shape[0]) % m_shape[1],
+                                 linear_index / (m_shape[0] * m_shape[1])};
+  Utils::Vector3d pos;
+  for (int i = 0; i < 3; i++)
+    pos[i] = (index[i] + offset[i]) * m_cell_size[i];
+  return pos;
+}
+
+ReplicaExchange::ReplicaExchange(Ladder ladder, std::vector<double> values,
+                                 int seed)
+    : m_ladder(ladder), m_values(std::move(values)),
+      m_generator(Random::mt19937(std::seed_seq({seed, seed, seed}))),
+      m_uniform_real_distribution(0.0, 1.0) {
+  if (m_values.size() < 2) {
+    throw std::runtime_error("Replica exchange needs at least two rungs");
+  }
+  m_rung_of_replica.resize(m_values.size());
+  std::iota(m_rung_of_replica.begin(), m_rung_of_replica.end(), 0);
+  m_tried_exchanges.resize(m_values.size() - 1, 0);
+  m_accepted_exchanges.resize(m_values.size() - 1, 0);
+}
+
+double ReplicaExchange::acceptance_probability(double value_i,
+                                               double observable_i,
+                                               double value_j,
+                                               double observable_j) const {
+  double ln_bf;
+  if (m_ladder == Ladder::TEMPERATURE) {
+    // observables are the potential energies
+    ln_bf = (1.0 / value_i - 1.0 / value_j) * (observable_i - observable_j);
+  } else {
+    // observables are the numbers of dissociated acid particles, the
+    // weight of a configuration is proportional to 10^(N pH)
+    ln_bf = log(10) * (value_i - value_j) * (observable_j - observable_i);
+  }
+  return std::min(1.0, exp(ln_bf));
+}
+
+std::vector<int> const &
+ReplicaExchange::attempt_exchanges(std::vector<double> const &observables) {
+  if (observables.size() != m_rung_of_replica.size()) {
+    throw std::runtime_error(
+        "Replica exchange needs one observable per replica");
+  }
+
+  std::vector<int> replica_of_rung(m_rung_of_replica.size());
+  for (int replica = 0; replica < m_rung_of_replica.size(); replica++) {
+    replica_of_rung[m_rung_of_replica[replica]] = replica;
+  }
+
+  for (int rung = m_rounds % 2; rung + 1 < m_values.size(); rung += 2) {
+    auto const replica_i = replica_of_rung[rung];
+    auto const replica_j = replica_of_rung[rung + 1];
+    auto const bf =
+        acceptance_probability(m_values[rung], observables[replica_i],
+                               m_values[rung + 1], observables[replica_j]);
+    m_tried_exchanges[rung] += 1;
+    if (m_uniform_real_distribution(m_generator) < bf) {
+      std::swap(m_rung_of_replica[replica_i], m_rung_of_replica[replica_j]);
+      m_accepted_exchanges[rung] += 1;
+    }
+  }
+  m_rounds += 1;
+
+  return m_rung_of_replica;
+}
+
+std::vector<double> ReplicaExchange::get_acceptance_rates() const {
+  std::vector<double> rates(m_tried_exchanges.size(), 0.0);
+  for (int rung = 0; rung < rates.size(); rung++) {
+    if (m_tried_exchanges[rung] > 0)
+      rates[rung] = static_cast<double>(m_accepted_exchanges[rung]) /
+                    static_cast<double>(m_tried_exchanges[rung]);
+  }
+  return rates;
+}
+
 } // namespace ReactionEnsemble
@@ -24,8 +24,11 @@
 #include "random.hpp"
 
 #include <map>
+#include <random>
 #include <string>
 #include <utils/Accumulator.hpp>
+#include <utils/Vector.hpp>
+#include <vector>
 
 namespace ReactionEnsemble {
 
@@ -108,6 +111,46 @@ private:
   }
 };
 
+/** @brief Coarse grid of the cells of the box which are free for insertions.
+ *
+ *  A cell is occupied if all of its points are closer than the cavity
+ *  radius to a particle, insertion positions are only drawn from the free
+ *  cells. The cell size is at most the cavity radius over
+ *  @f$ \sqrt{3} @f$, such that a cell is occupied if its center is closer
+ *  than half the cavity radius to a particle.
+ */
+class CavityGrid {
+public:
+  /** @brief Find the free cells of the current configuration.
+   *
+   *  Has to be called on the master node.
+   *
+   *  @param cavity_radius Radius around the particles
+   *  @param ignored_ids   Particles which are not considered
+   */
+  void update(double cavity_radius, std::vector<int> const &ignored_ids);
+  void clear();
+  bool active() const { return !m_occupied.empty(); }
+
+  /** Fraction of the volume of the box in the free cells. */
+  double free_fraction() const;
+  /** Whether a position lies in a free cell. */
+  bool is_free(Utils::Vector3d const &pos) const;
+  int n_free_cells() const { return static_cast<int>(m_free_cells.size()); }
+  /** @brief Position in a free cell.
+   *
+   *  @param free_cell Index of the free cell
+   *  @param offset    Position inside the cell in units of the cell size
+   */
+  Utils::Vector3d position(int free_cell, Utils::Vector3d const &offset) const;
+
+private:
+  Utils::Vector3i m_shape = {};
+  Utils::Vector3d m_cell_size = {};
+  std::vector<int> m_occupied;
+  std::vector<int> m_free_cells;
+};
+
 /** Base class for reaction ensemble methods */
 class ReactionAlgorithm {
 
@@ -137,6 +180,12 @@ public:
   double slab_start_z = -10.0;
   double slab_end_z = -10.0;
   int non_interacting_type = 100;
+  /** Particles are only inserted into the cells of a @ref CavityGrid with
+   *  this radius, and insertions closer than this radius to a particle are
+   *  rejected before any energy is calculated. This is used for insertions
+   *  without reactants and deletions without products, zero disables it.
+   */
+  double cavity_radius = 0.0;
 
   int m_accepted_configurational_MC_moves = 0;
   int m_tried_configurational_MC_moves = 0;
@@ -178,13 +227,27 @@ protected:
   virtual void on_mc_reject(int &old_state_index){};
   virtual int on_mc_use_WL_get_new_state() { return -10; };
 
+  std::vector<int>
+  choose_reactant_particles(SingleReaction const &current_reaction);
   void make_reaction_attempt(
-      SingleReaction &current_reaction,
+      SingleReaction &current_reaction, std::vector<int> const &reactant_p_ids,
       std::vector<StoredParticleProperty> &changed_particles_properties,
       std::vector<int> &p_ids_created_particles,
       std::vector<StoredParticleProperty> &hidden_particles_properties);
-  void restore_properties(std::vector<StoredParticleProperty> &property_list,
-                          int number_of_saved_properties);
+  void apply_trial_changes();
+  void reject_trial_changes();
+  bool positions_overlap(std::vector<Utils::Vector3d> const &positions,
+                         std::vector<int> const &ignored_ids) const;
+  bool uses_cavity_bias(SingleReaction const &current_reaction) const;
+  /** Find the free cells for the insertions of a trial move, or disable
+   *  the cavity bias if the reaction does not use it. */
+  void update_cavity_grid(SingleReaction const &current_reaction,
+                          std::vector<int> const &reactant_p_ids);
+  /** Volume which enters the acceptance probability of insertions and
+   *  deletions, the volume of the free cells for cavity-biased moves. */
+  double insertion_volume() const;
+  /// free cells for the insertions of the current trial move
+  CavityGrid m_cavity_grid;
 
   /**
    * @brief draws a random integer from the uniform distribution in the range
@@ -200,6 +263,17 @@ protected:
 
 private:
   std::mt19937 m_generator;
+  /// changes of the particles in the current trial move
+  ParticleChangeBatch m_trial_changes;
+  /// ids of created particles which were taken from
+  /// m_empty_p_ids_smaller_than_max_seen_particle in the current trial move
+  std::vector<int> m_reused_p_ids;
+  /// largest id of a new particle created in the current trial move
+  int m_max_created_p_id = -1;
+  /// whether the changes of the current trial move have been applied
+  bool m_trial_changes_applied = false;
+  /// positions of the particles created in the current trial move
+  std::vector<Utils::Vector3d> m_created_positions;
   std::normal_distribution<double> m_normal_distribution;
   std::uniform_real_distribution<double> m_uniform_real_distribution;
 
@@ -217,9 +291,6 @@ private:
   int create_particle(int desired_type);
   void hide_particle(int p_id, int previous_type);
 
-  void append_particle_property_of_random_particle(
-      int type, std::vector<StoredParticleProperty> &list_of_particles);
-
   virtual double calculate_acceptance_probability(
       SingleReaction &current_reaction, double E_pot_old, double E_pot_new,
       std::map<int, int> &old_particle_numbers, int old_state_index,
@@ -229,6 +300,7 @@ private:
 
   void add_types_to_index(std::vector<int> &type_list);
   Utils::Vector3d get_random_position_in_box();
+  Utils::Vector3d get_random_insertion_position();
   std::vector<double>
   get_random_position_in_box_enhanced_proposal_of_small_radii();
 };
@@ -296,7 +368,36 @@ public:
   void write_wang_landau_results_to_file(
       const std::string &full_path_to_output_filename);
 
+  /** @brief Share the density of states with other walkers.
+   *
+   *  Multiple walkers sample the same collective variables in independent
+   *  simulations, e.g. in separate jobs, and periodically combine their
+   *  estimates of the density of states. Every walker writes its checkpoint
+   *  with @ref write_wang_landau_checkpoint and then merges the checkpoints
+   *  of all other walkers. The increments of the Wang-Landau potential, the
+   *  histogram and the number of trial moves since the previous merge are
+   *  added up, such that all walkers continue from the same estimate.
+   *
+   *  @param identifiers Checkpoint identifiers of the other walkers
+   */
+  void merge_wang_landau_walkers(const std::vector<std::string> &identifiers);
+
 private:
+  struct WangLandauCheckpoint {
+    double wang_landau_parameter;
+    int monte_carlo_trial_moves;
+    std::vector<int> histogram;
+    std::vector<double> wang_landau_potential;
+  };
+  WangLandauCheckpoint
+  read_wang_landau_checkpoint(const std::string &identifier) const;
+  /** State of the walker after the previous merge, or the initial state. */
+  WangLandauCheckpoint merged_state() const;
+  std::vector<int> m_merged_histogram;
+  std::vector<double> m_merged_wang_landau_potential;
+  double m_merged_wang_landau_parameter = -10.0;
+  int m_merged_monte_carlo_trial_moves = 0;
+
   void on_reaction_entry(int &old_state_index) override;
   void
   on_reaction_rejection_directly_after_entry(int &old_state_index) override;
@@ -392,7 +493,64 @@ private:
 class WidomInsertion : public ReactionAlgorithm {
 public:
   WidomInsertion(int seed) : ReactionAlgorithm(seed) {}
-  std::pair<double, double> measure_excess_chemical_potential(int reaction_id);
+  std::pair<double, double>
+  measure_excess_chemical_potential(int reaction_id, int number_of_insertions);
+};
+
+/** @brief Replica exchange over a temperature or pH ladder.
+ *
+ *  Every replica is an independent simulation at one rung of the ladder.
+ *  Instead of configurations, the ladder values are exchanged between
+ *  replicas, so that only one observable per replica has to be
+ *  communicated: the potential energy for a temperature ladder and the
+ *  number of dissociated acid particles for a pH ladder. Neighboring rungs
+ *  are swapped with the Metropolis probability, alternately starting at the
+ *  even and the odd rungs. The decisions only depend on the seed and on the
+ *  observables, hence every replica can run its own driver and obtains the
+ *  same assignment of rungs to replicas.
+ */
+class ReplicaExchange {
+public:
+  enum class Ladder { TEMPERATURE, PH };
+
+  /**
+   * @param ladder Kind of the ladder
+   * @param values Temperatures or pH values of the rungs
+   * @param seed   Seed, has to be the same for all replicas
+   */
+  ReplicaExchange(Ladder ladder, std::vector<double> values, int seed);
+
+  /** @brief Attempt to swap neighboring rungs.
+   *
+   *  @param observables Observable of every replica
+   *  @return Rung of every replica after the exchanges.
+   */
+  std::vector<int> const &
+  attempt_exchanges(std::vector<double> const &observables);
+
+  /** Probability to swap the rungs of two replicas. */
+  double acceptance_probability(double value_i, double observable_i,
+                                double value_j, double observable_j) const;
+
+  std::vector<double> const &values() const { return m_values; }
+  /** Rung of every replica. */
+  std::vector<int> const &rungs() const { return m_rung_of_replica; }
+  /** Ladder value of a replica. */
+  double value_of_replica(int replica) const {
+    return m_values.at(m_rung_of_replica.at(replica));
+  }
+  /** Acceptance rate of the swaps between rung @p i and <tt>i + 1</tt>. */
+  std::vector<double> get_acceptance_rates() const;
+
+private:
+  Ladder m_ladder;
+  std::vector<double> m_values;
+  std::vector<int> m_rung_of_replica;
+  std::vector<int> m_tried_exchanges;
+  std::vector<int> m_accepted_exchanges;
+  int m_rounds = 0;
+  std::mt19937 m_generator;
+  std::uniform_real_distribution<double> m_uniform_real_distribution;
 };
 
 //////////////////////////////////////////////////////////////////free functions
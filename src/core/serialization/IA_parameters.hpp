@@ -34,6 +34,11 @@ void load(Archive &ar, IA_parameters &p,
 
   new (&(p.tab)) TabulatedPotential(std::move(tab));
 #endif
+
+  PairSplineTable spline_table;
+  ar >> spline_table;
+
+  new (&(p.spline_table)) PairSplineTable(std::move(spline_table));
 }
 
 template <typename Archive>
@@ -44,6 +49,8 @@ void save(Archive &ar, IA_parameters const &p,
 #ifdef TABULATED
   ar << p.tab;
 #endif
+
+  ar << p.spline_table;
 }
 
 template <class Archive>
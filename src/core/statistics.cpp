@@ -27,10 +27,14 @@
 #include "statistics.hpp"
 
 #include "Particle.hpp"
+#include "ParticleColumns.hpp"
+#include "algorithm/link_cell.hpp"
 #include "bonded_interactions/bonded_interaction_data.hpp"
+#include "cells.hpp"
 #include "communication.hpp"
 #include "energy.hpp"
 #include "errorhandling.hpp"
+#include "ghosts.hpp"
 #include "grid.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "integrate.hpp"
@@ -45,7 +49,15 @@
 #include <utils/constants.hpp>
 #include <utils/contains.hpp>
 
+#include <boost/iterator/indirect_iterator.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <complex>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 
 /** Previous particle configurations (needed for offline analysis and
@@ -116,15 +128,18 @@ Utils::Vector3d calc_linear_momentum(int include_particles,
   return linear_momentum;
 }
 
-Utils::Vector3d centerofmass(PartCfg &partCfg, int type) {
+Utils::Vector3d centerofmass(int type) {
+  auto const parts = mpi_gather_particle_columns(
+      PARTICLE_FIELD_POSITION | PARTICLE_FIELD_TYPE | PARTICLE_FIELD_MASS |
+      PARTICLE_FIELD_VIRTUAL);
   Utils::Vector3d com{};
   double mass = 0.0;
 
-  for (auto const &p : partCfg) {
-    if ((p.p.type == type) || (type == -1))
-      if (not p.p.is_virtual) {
-        com += p.r.p * p.p.mass;
-        mass += p.p.mass;
+  for (std::size_t i = 0; i < parts.size(); i++) {
+    if ((parts.type[i] == type) || (type == -1))
+      if (not parts.is_virtual[i]) {
+        com += parts.pos[i] * parts.mass[i];
+        mass += parts.mass[i];
       }
   }
   com /= mass;
@@ -152,7 +167,7 @@ void momentofinertiamatrix(PartCfg &partCfg, int type, double *MofImatrix) {
   for (i = 0; i < 9; i++)
     MofImatrix[i] = 0.;
 
-  auto const com = centerofmass(partCfg, type);
+  auto const com = centerofmass(type);
   for (auto const &p : partCfg) {
     if (type == p.p.type and (not p.p.is_virtual)) {
       count++;
@@ -172,8 +187,9 @@ void momentofinertiamatrix(PartCfg &partCfg, int type, double *MofImatrix) {
   MofImatrix[7] = MofImatrix[5];
 }
 
-IntList nbhood(PartCfg &partCfg, const Utils::Vector3d &pos, double r_catch,
+IntList nbhood(const Utils::Vector3d &pos, double r_catch,
                const Utils::Vector3i &planedims) {
+  auto const parts = mpi_gather_particle_columns(PARTICLE_FIELD_POSITION);
   IntList ids;
 
   auto const r2 = r_catch * r_catch;
@@ -181,21 +197,24 @@ IntList nbhood(PartCfg &partCfg, const Utils::Vector3d &pos, double r_catch,
 
   Utils::Vector3d d;
 
-  for (auto const &p : partCfg) {
+  for (std::size_t i = 0; i < parts.size(); i++) {
     if ((planedims[0] + planedims[1] + planedims[2]) == 3) {
-      d = get_mi_vector(pt, p.r.p, box_geo);
+      d = get_mi_vector(pt, parts.pos[i], box_geo);
     } else {
       /* Calculate the in plane distance */
       for (int j = 0; j < 3; j++) {
-        d[j] = planedims[j] * (p.r.p[j] - pt[j]);
+        d[j] = planedims[j] * (parts.pos[i][j] - pt[j]);
       }
     }
 
     if (d.norm2() < r2) {
-      ids.push_back(p.p.identity);
+      ids.push_back(parts.id[i]);
     }
   }
 
+  /* particles are gathered in arbitrary order */
+  std::sort(ids.begin(), ids.end());
+
   return ids;
 }
 
@@ -277,65 +296,182 @@ void calc_part_distribution(PartCfg &partCfg, int const *p1_types, int n_p1,
     dist[i] /= (double)cnt;
 }
 
-void calc_rdf(PartCfg &partCfg, std::vector<int> const &p1_types,
-              std::vector<int> const &p2_types, double r_min, double r_max,
-              int r_bins, std::vector<double> &rdf) {
-  calc_rdf(partCfg, &p1_types[0], p1_types.size(), &p2_types[0],
-           p2_types.size(), r_min, r_max, r_bins, &rdf[0]);
+namespace {
+/** Number of occurrences of each particle type in @p types. */
+std::vector<int> type_multiplicities(std::vector<int> const &types) {
+  std::vector<int> multiplicities;
+  for (auto const type : types) {
+    if (type < 0)
+      continue;
+    if (type >= static_cast<int>(multiplicities.size()))
+      multiplicities.resize(type + 1);
+    multiplicities[type]++;
+  }
+  return multiplicities;
 }
 
-void calc_rdf(PartCfg &partCfg, int const *p1_types, int n_p1,
-              int const *p2_types, int n_p2, double r_min, double r_max,
-              int r_bins, double *rdf) {
-  long int cnt = 0;
-  int ind;
-  bool mixed_flag = false;
-  if (n_p1 == n_p2) {
-    for (int i = 0; i < n_p1; i++)
-      if (p1_types[i] != p2_types[i])
-        mixed_flag = true;
+int multiplicity(std::vector<int> const &multiplicities, int type) {
+  return (type >= 0 and type < static_cast<int>(multiplicities.size()))
+             ? multiplicities[type]
+             : 0;
+}
+
+/** Sum of @p local over all nodes, valid on the master node. */
+std::vector<double> reduce_sum(std::vector<double> const &local) {
+  std::vector<double> sum(local.size());
+  if (this_node == 0) {
+    boost::mpi::reduce(comm_cart, local.data(), static_cast<int>(local.size()),
+                       sum.data(), std::plus<double>(), 0);
   } else {
-    mixed_flag = true;
+    boost::mpi::reduce(comm_cart, local.data(), static_cast<int>(local.size()),
+                       std::plus<double>(), 0);
   }
+  return sum;
+}
 
-  auto const bin_width = (r_max - r_min) / (double)r_bins;
-  auto const inv_bin_width = 1.0 / bin_width;
-  for (int i = 0; i < r_bins; i++)
-    rdf[i] = 0.0;
-  /* particle loop: p1_types */
-  for (auto it = partCfg.begin(); it != partCfg.end(); ++it) {
-    for (int t1 = 0; t1 < n_p1; t1++) {
-      if (it->p.type == p1_types[t1]) {
-        /* distinguish mixed and identical rdf's */
-        auto jt = mixed_flag ? partCfg.begin() : std::next(it);
+/**
+ * @brief Unnormalized pair distance histogram of the particles on this node.
+ *
+ * Each pair is weighted by how often the types of its particles occur
+ * in the type lists. If @p r_max is not larger than
+ * @ref cells_neighbor_range, the pairs are found with the cell system,
+ * otherwise the positions of all particles are gathered on all nodes and
+ * the rows of the pair matrix are distributed round-robin over the nodes.
+ *
+ * @return The histogram, followed by the sum of the multiplicities of
+ *         the local particles in @p p1_types and in @p p2_types, and
+ *         of the squared multiplicities in @p p1_types.
+ */
+std::vector<double> calc_rdf_local(std::vector<int> const &p1_types,
+                                   std::vector<int> const &p2_types,
+                                   double r_min, double r_max, int r_bins) {
+  cells_update_ghosts(GHOSTTRANS_POSITION | GHOSTTRANS_PROPRTS);
+
+  auto const m1 = type_multiplicities(p1_types);
+  auto const m2 = type_multiplicities(p2_types);
+  auto const mixed_flag = (p1_types != p2_types);
+
+  auto const inv_bin_width = r_bins / (r_max - r_min);
+  std::vector<double> result(r_bins + 3);
+  auto add_pair = [&](double dist, double weight) {
+    if (dist > r_min && dist < r_max) {
+      auto const ind = static_cast<int>((dist - r_min) * inv_bin_width);
+      if (ind < r_bins)
+        result[ind] += weight;
+    }
+  };
 
-        /* particle loop: p2_types */
-        for (; jt != partCfg.end(); ++jt) {
-          for (int t2 = 0; t2 < n_p2; t2++) {
-            if (jt->p.type == p2_types[t2]) {
-              auto const dist = get_mi_vector(it->r.p, jt->r.p, box_geo).norm();
-              if (dist > r_min && dist < r_max) {
-                ind = (int)((dist - r_min) * inv_bin_width);
-                rdf[ind]++;
-              }
-              cnt++;
-            }
-          }
+  for (auto const &p : cell_structure.local_cells().particles()) {
+    auto const n1 = multiplicity(m1, p.p.type);
+    result[r_bins + 0] += n1;
+    result[r_bins + 1] += multiplicity(m2, p.p.type);
+    result[r_bins + 2] += n1 * n1;
+  }
+
+  if (r_max <= cells_neighbor_range()) {
+    auto const r_max2 = r_max * r_max;
+    auto pair_kernel = [&](Particle const &p1, Particle const &p2,
+                           double dist2) {
+      if (dist2 >= r_max2)
+        return;
+      auto const t1 = p1.p.type;
+      auto const t2 = p2.p.type;
+      auto const weight =
+          mixed_flag ? multiplicity(m1, t1) * multiplicity(m2, t2) +
+                           multiplicity(m1, t2) * multiplicity(m2, t1)
+                     : multiplicity(m1, t1) * multiplicity(m1, t2);
+      if (weight != 0)
+        add_pair(std::sqrt(dist2), weight);
+    };
+
+    switch (cell_structure.type) {
+    case CELL_STRUCTURE_DOMDEC:
+      Algorithm::link_cell(
+          boost::make_indirect_iterator(cell_structure.m_local_cells.begin()),
+          boost::make_indirect_iterator(cell_structure.m_local_cells.end()),
+          Utils::NoOp{}, pair_kernel,
+          [](Particle const &p1, Particle const &p2) {
+            return (p1.r.p - p2.r.p).norm2();
+          });
+      break;
+    case CELL_STRUCTURE_NSQUARE:
+      Algorithm::link_cell(
+          boost::make_indirect_iterator(cell_structure.m_local_cells.begin()),
+          boost::make_indirect_iterator(cell_structure.m_local_cells.end()),
+          Utils::NoOp{}, pair_kernel,
+          [](Particle const &p1, Particle const &p2) {
+            return get_mi_vector(p1.r.p, p2.r.p, box_geo).norm2();
+          });
+      break;
+    }
+  } else {
+    auto const parts = all_gather_particle_columns(
+        PARTICLE_FIELD_FOLDED_POSITION | PARTICLE_FIELD_TYPE);
+    auto const n_part = parts.size();
+
+    for (std::size_t i = this_node; i < n_part; i += n_nodes) {
+      auto const n1 = multiplicity(m1, parts.type[i]);
+      if (n1 == 0)
+        continue;
+      /* distinguish mixed and identical rdf's */
+      for (auto j = mixed_flag ? 0 : i + 1; j < n_part; ++j) {
+        auto const n2 = multiplicity(m2, parts.type[j]);
+        if (n2 != 0) {
+          auto const dist =
+              get_mi_vector(parts.pos[i], parts.pos[j], box_geo).norm();
+          add_pair(dist, n1 * n2);
         }
       }
     }
   }
+
+  return result;
+}
+} // namespace
+
+void mpi_calc_rdf_slave(std::vector<int> const &p1_types,
+                        std::vector<int> const &p2_types, double r_min,
+                        double r_max, int r_bins) {
+  reduce_sum(calc_rdf_local(p1_types, p2_types, r_min, r_max, r_bins));
+}
+
+REGISTER_CALLBACK(mpi_calc_rdf_slave)
+
+void calc_rdf(std::vector<int> const &p1_types,
+              std::vector<int> const &p2_types, double r_min, double r_max,
+              int r_bins, std::vector<double> &rdf) {
+  calc_rdf(p1_types.data(), p1_types.size(), p2_types.data(), p2_types.size(),
+           r_min, r_max, r_bins, rdf.data());
+}
+
+void calc_rdf(int const *p1_types, int n_p1, int const *p2_types, int n_p2,
+              double r_min, double r_max, int r_bins, double *rdf) {
+  std::vector<int> const p1(p1_types, p1_types + n_p1);
+  std::vector<int> const p2(p2_types, p2_types + n_p2);
+
+  mpi_call(mpi_calc_rdf_slave, p1, p2, r_min, r_max, r_bins);
+  auto const sum = reduce_sum(calc_rdf_local(p1, p2, r_min, r_max, r_bins));
+
+  /* number of pairs, including those outside of the range */
+  auto const n1 = sum[r_bins + 0];
+  auto const n2 = sum[r_bins + 1];
+  auto const n1_sqr = sum[r_bins + 2];
+  auto const cnt = (p1 != p2) ? n1 * n2 : 0.5 * (n1 * n1 - n1_sqr);
+
+  for (int i = 0; i < r_bins; i++)
+    rdf[i] = 0.0;
   if (cnt == 0)
     return;
 
   /* normalization */
+  auto const bin_width = (r_max - r_min) / (double)r_bins;
   auto const volume = box_geo.volume();
   for (int i = 0; i < r_bins; i++) {
     auto const r_in = i * bin_width + r_min;
     auto const r_out = r_in + bin_width;
     auto const bin_volume = (4.0 / 3.0) * Utils::pi() *
                             ((r_out * r_out * r_out) - (r_in * r_in * r_in));
-    rdf[i] *= volume / (bin_volume * cnt);
+    rdf[i] = sum[i] * volume / (bin_volume * cnt);
   }
 }
 
@@ -417,13 +553,90 @@ void calc_rdf_av(PartCfg &partCfg, int const *p1_types, int n_p1,
   }
 }
 
-std::vector<double> calc_structurefactor(PartCfg &partCfg, int const *p_types,
-                                         int n_types, int order) {
+namespace {
+/** Wave vectors of the structure factor, in units of 2PI/L. */
+std::vector<Utils::Vector3i> structurefactor_wave_vectors(int order) {
+  auto const order2 = order * order;
+  std::vector<Utils::Vector3i> wave_vectors;
+  for (int i = 0; i <= order; i++) {
+    for (int j = -order; j <= order; j++) {
+      for (int k = -order; k <= order; k++) {
+        auto const n = i * i + j * j + k * k;
+        if ((n <= order2) && (n >= 1)) {
+          wave_vectors.push_back({i, j, k});
+        }
+      }
+    }
+  }
+  return wave_vectors;
+}
+
+/**
+ * @brief Partial sums of the structure factor of the particles on this node.
+ *
+ * The phase factors exp(i q r) are built from powers of the phase factor
+ * of the smallest wave vector in each direction, so that only three
+ * complex exponentials are evaluated per particle.
+ *
+ * @return The real parts of the sums over the particles for each wave
+ *         vector, followed by the imaginary parts and the number of
+ *         particles.
+ */
+std::vector<double> calc_structurefactor_local(std::vector<int> const &p_types,
+                                               int order) {
+  auto const types = type_multiplicities(p_types);
+  auto const wave_vectors = structurefactor_wave_vectors(order);
+  auto const n_wave_vectors = wave_vectors.size();
+  auto const twoPI_L = 2 * Utils::pi() / box_geo.length()[0];
+
+  std::vector<double> result(2 * n_wave_vectors + 1);
+  /* powers -order...order of the phase factor in each direction */
+  std::array<std::vector<std::complex<double>>, 3> phases;
+  for (auto &phase : phases)
+    phase.resize(2 * order + 1);
+
+  for (auto const &p : cell_structure.local_cells().particles()) {
+    auto const weight = multiplicity(types, p.p.type);
+    if (weight == 0)
+      continue;
+
+    auto const pos = unfolded_position(p.r.p, p.l.i, box_geo.length());
+    for (int d = 0; d < 3; d++) {
+      auto &phase = phases[d];
+      auto const unit = std::polar(1.0, twoPI_L * pos[d]);
+      phase[order] = 1.0;
+      for (int n = 1; n <= order; n++) {
+        phase[order + n] = phase[order + n - 1] * unit;
+        phase[order - n] = std::conj(phase[order + n]);
+      }
+    }
+
+    for (std::size_t w = 0; w < n_wave_vectors; w++) {
+      auto const &q = wave_vectors[w];
+      auto const phase = phases[0][order + q[0]] * phases[1][order + q[1]] *
+                         phases[2][order + q[2]];
+      result[w] += weight * phase.real();
+      result[n_wave_vectors + w] += weight * phase.imag();
+    }
+    result[2 * n_wave_vectors] += weight;
+  }
+
+  return result;
+}
+} // namespace
+
+void mpi_calc_structurefactor_slave(std::vector<int> const &p_types,
+                                    int order) {
+  reduce_sum(calc_structurefactor_local(p_types, order));
+}
+
+REGISTER_CALLBACK(mpi_calc_structurefactor_slave)
+
+std::vector<double> calc_structurefactor(int const *p_types, int n_types,
+                                         int order) {
   auto const order2 = order * order;
   std::vector<double> ff;
   ff.resize(2 * order2);
-  ff[2 * order2] = 0;
-  auto const twoPI_L = 2 * Utils::pi() / box_geo.length()[0];
 
   if ((n_types < 0) || (n_types > max_seen_particle_type)) {
     fprintf(stderr, "WARNING: Wrong number of particle types!");
@@ -435,38 +648,20 @@ std::vector<double> calc_structurefactor(PartCfg &partCfg, int const *p_types,
     fflush(nullptr);
     errexit();
   } else {
-    for (int qi = 0; qi < 2 * order2; qi++) {
-      ff[qi] = 0.0;
-    }
-    for (int i = 0; i <= order; i++) {
-      for (int j = -order; j <= order; j++) {
-        for (int k = -order; k <= order; k++) {
-          auto const n = i * i + j * j + k * k;
-          if ((n <= order2) && (n >= 1)) {
-            double C_sum = 0.0, S_sum = 0.0;
-            for (auto const &p : partCfg) {
-              for (int t = 0; t < n_types; t++) {
-                if (p.p.type == p_types[t]) {
-                  auto const qr =
-                      twoPI_L * (Utils::Vector3i{{i, j, k}} * p.r.p);
-                  C_sum += cos(qr);
-                  S_sum += sin(qr);
-                }
-              }
-            }
-            ff[2 * n - 2] += C_sum * C_sum + S_sum * S_sum;
-            ff[2 * n - 1]++;
-          }
-        }
-      }
-    }
-    int n = 0;
-    for (auto const &p : partCfg) {
-      for (int t = 0; t < n_types; t++) {
-        if (p.p.type == p_types[t])
-          n++;
-      }
+    std::vector<int> const types(p_types, p_types + n_types);
+    mpi_call(mpi_calc_structurefactor_slave, types, order);
+    auto const sum = reduce_sum(calc_structurefactor_local(types, order));
+
+    auto const wave_vectors = structurefactor_wave_vectors(order);
+    auto const n_wave_vectors = wave_vectors.size();
+    for (std::size_t w = 0; w < n_wave_vectors; w++) {
+      auto const n = wave_vectors[w].norm2();
+      auto const C_sum = sum[w];
+      auto const S_sum = sum[n_wave_vectors + w];
+      ff[2 * n - 2] += C_sum * C_sum + S_sum * S_sum;
+      ff[2 * n - 1]++;
     }
+    auto const n = sum[2 * n_wave_vectors];
     for (int qi = 0; qi < order2; qi++)
       if (ff[2 * qi + 1] != 0)
         ff[2 * qi] /= n * ff[2 * qi + 1];
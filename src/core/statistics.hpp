@@ -59,14 +59,14 @@ int get_n_part_conf();
 double mindist(PartCfg &, IntList const &set1, IntList const &set2);
 
 /** Find all particles within a given radius @p r_catch around a position.
- *  @param partCfg    @copybrief PartCfg
+ *  Only the particle positions are gathered on the master node.
  *  @param pos        position of sphere center
  *  @param r_catch    the sphere radius
  *  @param planedims  orientation of coordinate system
  *
  *  @return List of ids close to @p pos.
  */
-IntList nbhood(PartCfg &partCfg, const Utils::Vector3d &pos, double r_catch,
+IntList nbhood(const Utils::Vector3d &pos, double r_catch,
                const Utils::Vector3i &planedims);
 
 /** Calculate minimal distance to point.
@@ -116,8 +116,10 @@ void calc_part_distribution(PartCfg &, int const *p1_types, int n_p1,
  *  in the @p p2_types list. The range is given by @p r_min and @p r_max and
  *  the distribution function is binned into @p r_bin bins, which are
  *  equidistant. The result is stored in the array @p rdf.
+ *  The pairs are found in parallel with the cell system if @p r_max does not
+ *  exceed its range, otherwise by an all-pairs loop distributed over the
+ *  nodes.
  *
- *  @param partCfg  @copybrief PartCfg
  *  @param p1_types list with types of particles to find the distribution for.
  *  @param n_p1     length of @p p1_types.
  *  @param p2_types list with types of particles the others are distributed
@@ -128,10 +130,9 @@ void calc_part_distribution(PartCfg &, int const *p1_types, int n_p1,
  *  @param r_bins   Number of bins.
  *  @param rdf      Array to store the result (size: @p r_bins).
  */
-void calc_rdf(PartCfg &partCfg, int const *p1_types, int n_p1,
-              int const *p2_types, int n_p2, double r_min, double r_max,
-              int r_bins, double *rdf);
-void calc_rdf(PartCfg &partCfg, std::vector<int> const &p1_types,
+void calc_rdf(int const *p1_types, int n_p1, int const *p2_types, int n_p2,
+              double r_min, double r_max, int r_bins, double *rdf);
+void calc_rdf(std::vector<int> const &p1_types,
               std::vector<int> const &p2_types, double r_min, double r_max,
               int r_bins, std::vector<double> &rdf);
 
@@ -175,13 +176,14 @@ void calc_rdf_av(PartCfg &partCfg, std::vector<int> const &p1_types,
  *  nonzero, the first is meaningful. This means the q=1 entries are sf[0]=S(1)
  *  and sf[1]=1. For q=7, there are no possible wave vectors, so
  *  sf[2*(7-1)]=sf[2*(7-1)+1]=0.
+ *  The sums over the particles are computed in parallel on all nodes.
  *
  *  @param p_types   list with types of particles to be analyzed
  *  @param n_types   length of @p p_types
  *  @param order     the maximum wave vector length in 2PI/L
  */
-std::vector<double> calc_structurefactor(PartCfg &, int const *p_types,
-                                         int n_types, int order);
+std::vector<double> calc_structurefactor(int const *p_types, int n_types,
+                                         int order);
 
 std::vector<std::vector<double>> modify_stucturefactor(int order,
                                                        double const *sf);
@@ -189,7 +191,7 @@ std::vector<std::vector<double>> modify_stucturefactor(int order,
 /** Calculate the center of mass of a special type of the current configuration.
  *  \param part_type  type of the particle
  */
-Utils::Vector3d centerofmass(PartCfg &, int part_type);
+Utils::Vector3d centerofmass(int part_type);
 
 /** Calculate the angular momentum of a special type of the current
  *  configuration.
@@ -21,13 +21,20 @@
 /** \file
  *  Implementation of tuning.hpp.
  */
+#include "tuning.hpp"
+#include "cells.hpp"
 #include "communication.hpp"
 #include "domain_decomposition.hpp"
 #include "errorhandling.hpp"
 #include "global.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <deque>
 #include <limits>
+#include <memory>
 #include <sys/resource.h>
 #include <sys/time.h>
 #include <utils/statistics/RunningAverage.hpp>
@@ -124,3 +131,215 @@ void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
   skin = 0.5 * (a + b);
   mpi_bcast_parameter(FIELD_SKIN);
 }
+
+namespace {
+/** @brief State of the online tuning, only used on the head node. */
+class OnlineTuner {
+public:
+  explicit OnlineTuner(OnlineTuningParameters const &params)
+      : m_params(params) {}
+
+  OnlineTuningParameters const &params() const { return m_params; }
+
+  int steps_left() const { return m_params.chunk_steps - m_steps; }
+
+  void update(int steps, double time, int verlet_updates) {
+    m_steps += steps;
+    m_time += time;
+    m_verlet_updates += verlet_updates;
+
+    if (m_steps < m_params.chunk_steps)
+      return;
+
+    auto const time_per_step = m_time / m_steps;
+    auto const verlet_reuse =
+        (m_verlet_updates > 0) ? static_cast<double>(m_steps) / m_verlet_updates
+                               : static_cast<double>(m_steps);
+    m_steps = 0;
+    m_time = 0.;
+    m_verlet_updates = 0;
+
+    end_of_chunk(time_per_step, verlet_reuse);
+  }
+
+private:
+  enum class Trial { NONE, SKIN_UP, SKIN_DOWN, TOGGLE_VERLET_LISTS };
+
+  void end_of_chunk(double time_per_step, double verlet_reuse) {
+    /* A trial configuration was timed: keep it if it is faster
+     * by more than the hysteresis, otherwise go back. */
+    if (m_trial != Trial::NONE) {
+      if (time_per_step < (1. - m_params.hysteresis) * m_reference) {
+        m_reference = time_per_step;
+        plan_trials(verlet_reuse, m_trial);
+      } else {
+        revert(m_trial);
+      }
+      next_trial();
+      return;
+    }
+
+    /* First chunk, or the current configuration is converged:
+     * try again if the timings drifted or after a while. */
+    auto const first_chunk = (m_reference <= 0.);
+    auto const drifted = std::fabs(time_per_step - m_converged) >
+                         2. * m_params.hysteresis * m_converged;
+    m_reference = time_per_step;
+    if (first_chunk or drifted or ++m_idle_chunks >= m_params.idle_chunks) {
+      plan_trials(verlet_reuse, Trial::NONE);
+      next_trial();
+    }
+  }
+
+  /** Order of the trials: after a successful change of the skin, the skin
+   *  is changed further in the same direction. Otherwise a larger skin is
+   *  tried first if the Verlet lists are rebuilt often, a smaller one if
+   *  not. Switching the Verlet lists is tried last.
+   */
+  void plan_trials(double verlet_reuse, Trial accepted) {
+    m_trials.clear();
+
+    if (accepted == Trial::SKIN_UP or accepted == Trial::SKIN_DOWN) {
+      m_trials.push_back(accepted);
+    } else if (verlet_reuse < min_verlet_reuse) {
+      m_trials.push_back(Trial::SKIN_UP);
+      m_trials.push_back(Trial::SKIN_DOWN);
+    } else {
+      m_trials.push_back(Trial::SKIN_DOWN);
+      m_trials.push_back(Trial::SKIN_UP);
+    }
+
+    if (m_params.tune_verlet_lists and
+        accepted != Trial::TOGGLE_VERLET_LISTS) {
+      m_trials.push_back(Trial::TOGGLE_VERLET_LISTS);
+    }
+  }
+
+  /** Apply the next possible trial, or keep the current configuration
+   *  if none is left.
+   */
+  void next_trial() {
+    while (not m_trials.empty()) {
+      auto const trial = m_trials.front();
+      m_trials.pop_front();
+      if (apply(trial)) {
+        m_trial = trial;
+        return;
+      }
+    }
+
+    m_trial = Trial::NONE;
+    m_converged = m_reference;
+    m_idle_chunks = 0;
+  }
+
+  double max_skin() const {
+    auto const max_cut = maximal_cutoff();
+    auto const max_range =
+        (cell_structure.type == CELL_STRUCTURE_DOMDEC)
+            ? *boost::min_element(local_geo.length())
+            : 0.5 * *boost::min_element(box_geo.length());
+    auto const max_permissible_skin = std::nextafter(max_range - max_cut, 0.);
+
+    return (m_params.max_skin > 0.)
+               ? std::min(m_params.max_skin, max_permissible_skin)
+               : max_permissible_skin;
+  }
+
+  static void set_skin(double new_skin) {
+    skin = new_skin;
+    skin_set = true;
+    mpi_bcast_parameter(FIELD_SKIN);
+  }
+
+  static void toggle_verlet_lists() {
+    cell_structure.use_verlet_list = not cell_structure.use_verlet_list;
+    mpi_bcast_cell_structure(cell_structure.type);
+  }
+
+  bool apply(Trial trial) {
+    m_previous_skin = skin;
+
+    switch (trial) {
+    case Trial::SKIN_UP: {
+      auto const new_skin =
+          std::min((skin > 0.) ? skin * (1. + m_params.skin_step)
+                               : m_params.skin_step * maximal_cutoff(),
+                   max_skin());
+      if (new_skin <= skin)
+        return false;
+      set_skin(new_skin);
+      return true;
+    }
+    case Trial::SKIN_DOWN: {
+      auto const new_skin =
+          std::max(skin * (1. - m_params.skin_step), m_params.min_skin);
+      if (new_skin >= skin)
+        return false;
+      set_skin(new_skin);
+      return true;
+    }
+    case Trial::TOGGLE_VERLET_LISTS:
+      toggle_verlet_lists();
+      return true;
+    case Trial::NONE:
+      break;
+    }
+
+    return false;
+  }
+
+  void revert(Trial trial) {
+    if (trial == Trial::TOGGLE_VERLET_LISTS) {
+      toggle_verlet_lists();
+    } else {
+      set_skin(m_previous_skin);
+    }
+  }
+
+  /** Below this number of steps per Verlet list rebuild, a larger
+   *  skin is tried first. */
+  static constexpr double min_verlet_reuse = 10.;
+
+  OnlineTuningParameters m_params;
+
+  /* timings of the current chunk */
+  int m_steps = 0;
+  double m_time = 0.;
+  int m_verlet_updates = 0;
+
+  /** time per step of the current configuration */
+  double m_reference = 0.;
+  /** time per step when the tuning converged */
+  double m_converged = 0.;
+  int m_idle_chunks = 0;
+
+  Trial m_trial = Trial::NONE;
+  std::deque<Trial> m_trials;
+  double m_previous_skin = 0.;
+};
+
+std::unique_ptr<OnlineTuner> online_tuner;
+} // namespace
+
+void online_tuning_enable(OnlineTuningParameters const &params) {
+  online_tuner = std::make_unique<OnlineTuner>(params);
+}
+
+void online_tuning_disable() { online_tuner.reset(); }
+
+bool online_tuning_enabled() { return static_cast<bool>(online_tuner); }
+
+OnlineTuningParameters const &online_tuning_parameters() {
+  static const OnlineTuningParameters default_params{};
+  return online_tuner ? online_tuner->params() : default_params;
+}
+
+int online_tuning_steps_left() {
+  return online_tuner ? online_tuner->steps_left() : INT_MAX;
+}
+
+void online_tuning_update(int steps, double time, int verlet_updates) {
+  if (online_tuner)
+    online_tuner->update(steps, time, verlet_updates);
+}
@@ -59,4 +59,64 @@ double diffTime();
 void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
                bool adjust_max_skin);
 
+/** @brief Parameters of the online tuning of the cell system. */
+struct OnlineTuningParameters {
+  /** Number of integration steps per timed chunk */
+  int chunk_steps = 100;
+  /** Smallest skin to try */
+  double min_skin = 0.;
+  /** Largest skin to try, 0 for the largest skin the cell system allows */
+  double max_skin = 0.;
+  /** Relative change of the skin per trial */
+  double skin_step = 0.2;
+  /** Minimal relative speedup for a change to be kept */
+  double hysteresis = 0.05;
+  /** Number of chunks between the trials once converged */
+  int idle_chunks = 20;
+  /** Whether to also try switching the Verlet lists on or off */
+  bool tune_verlet_lists = true;
+};
+
+/** @brief Enable the online tuning of the skin and the Verlet lists.
+ *
+ *  During the integration, the steps are timed in chunks of
+ *  @ref OnlineTuningParameters::chunk_steps. Between the chunks, the skin
+ *  (and with it the cell grid of the domain decomposition) is changed
+ *  in small steps, and the Verlet lists are switched on or off. A change
+ *  is kept if it speeds up the integration by more than
+ *  @ref OnlineTuningParameters::hysteresis, otherwise it is reverted.
+ *  Once no change helps, the configuration is kept and only checked
+ *  again after @ref OnlineTuningParameters::idle_chunks chunks, or as
+ *  soon as the time per step drifts, e.g. because the density or the
+ *  temperature of the system changes. The Verlet list rebuild frequency
+ *  decides whether a larger or a smaller skin is tried first.
+ *
+ *  Only to be called on the head node.
+ */
+void online_tuning_enable(OnlineTuningParameters const &params);
+
+/** @brief Disable the online tuning, the current configuration is kept. */
+void online_tuning_disable();
+
+/** @brief Whether the online tuning is enabled. */
+bool online_tuning_enabled();
+
+/** @brief Parameters of the online tuning. */
+OnlineTuningParameters const &online_tuning_parameters();
+
+/** @brief Number of steps until the end of the current chunk,
+ *  or @c INT_MAX if the online tuning is disabled.
+ */
+int online_tuning_steps_left();
+
+/** @brief Record integrated steps for the online tuning.
+ *
+ *  At the end of a chunk, this may change the skin or the cell system.
+ *
+ *  @param steps          Number of integrated steps
+ *  @param time           Wall time of the integration in seconds
+ *  @param verlet_updates Number of Verlet list rebuilds
+ */
+void online_tuning_update(int steps, double time, int verlet_updates);
+
 #endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Correlator engine test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "accumulators/CorrelatorEngine.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <string>
+#include <vector>
+
+using Accumulators::CorrelationParameters;
+using Accumulators::CorrelatorEngine;
+
+namespace {
+CorrelationParameters parameters(int tau_lin, std::string const &operation) {
+  CorrelationParameters params;
+  params.tau_lin = tau_lin;
+  params.hierarchy_depth = 6;
+  params.dim_A = 3;
+  params.dim_B = 3;
+  params.corr_operation = operation;
+  params.compress1 = "linear";
+  params.compress2 = "linear";
+  return params;
+}
+
+/** Lags of the rows of the result, in units of the update interval. */
+std::vector<int> lags(int tau_lin, int hierarchy_depth) {
+  std::vector<int> tau;
+  for (int k = 0; k < tau_lin + 1; k++) {
+    tau.push_back(k);
+  }
+  for (int j = 1; j < hierarchy_depth; j++) {
+    for (int k = 0; k < tau_lin / 2; k++) {
+      tau.push_back((k + tau_lin / 2 + 1) * (1 << j));
+    }
+  }
+  return tau;
+}
+
+/** Average of the correlation estimates in a row of the result. */
+double estimate(CorrelatorEngine const &engine, int row, int component) {
+  return engine.sums()[row][component] / engine.sweeps()[row];
+}
+} // namespace
+
+/* The linear compression of positions moving with a constant velocity
+ * gives the positions at the mean times, so the squared distances of
+ * all pairs in the hierarchy are exactly the ones at the lag of the row,
+ * also for the values compressed by finalize(). */
+BOOST_AUTO_TEST_CASE(finalize_square_distance) {
+  Utils::Vector3d const v = {0.3, -0.2, 0.7};
+  for (int tau_lin : {10, 16}) {
+    auto const params = parameters(tau_lin, "square_distance_componentwise");
+    auto const tau = lags(tau_lin, params.hierarchy_depth);
+    for (int n_updates = 1; n_updates < 600; n_updates++) {
+      CorrelatorEngine engine(params,
+                              Accumulators::correlation_slice(params, 0, 1));
+      for (int t = 0; t < n_updates; t++) {
+        auto const x = v * t;
+        engine.update(x.data(), x.data(), {});
+      }
+      engine.finalize({});
+
+      for (int row = 0; row < engine.n_result(); row++) {
+        if (engine.sweeps()[row] == 0)
+          continue;
+        for (int k = 0; k < 3; k++) {
+          BOOST_REQUIRE_CLOSE(estimate(engine, row, k),
+                              v[k] * v[k] * tau[row] * tau[row], 1e-8);
+        }
+      }
+    }
+  }
+}
+
+/* Every row of the tensor product of constant values is their outer
+ * product, before and after finalize(). */
+BOOST_AUTO_TEST_CASE(tensor_product) {
+  Utils::Vector3d const a = {0.3, -0.2, 0.7};
+  auto const params = parameters(10, "tensor_product");
+  CorrelatorEngine engine(params,
+                          Accumulators::correlation_slice(params, 0, 1));
+  BOOST_REQUIRE_EQUAL(engine.dim_corr(), 9);
+  for (int t = 0; t < 300; t++) {
+    engine.update(a.data(), a.data(), {});
+  }
+
+  for (bool finalized : {false, true}) {
+    if (finalized)
+      engine.finalize({});
+    for (int row = 0; row < engine.n_result(); row++) {
+      if (engine.sweeps()[row] == 0)
+        continue;
+      for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+          BOOST_CHECK_CLOSE(estimate(engine, row, 3 * i + j), a[i] * a[j],
+                            1e-12);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE FFT correlator test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "accumulators/FFTCorrelator.hpp"
+
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Accumulators::FFTCorrelator;
+
+namespace {
+std::vector<double> series(int n_frames, int dim, double phase) {
+  std::vector<double> values(n_frames * dim);
+  for (int t = 0; t < n_frames; t++) {
+    for (int k = 0; k < dim; k++) {
+      values[t * dim + k] =
+          std::sin(0.37 * t + phase * (k + 1)) + 0.01 * t * (k - 1);
+    }
+  }
+  return values;
+}
+
+/** Direct evaluation of a correlation in the layout of the result. */
+std::vector<double>
+direct_correlation(std::vector<double> const &A, std::vector<double> const &B,
+                   int dim_A, int dim_B, int n_lags, int dim_corr,
+                   std::function<void(double const *, double const *, double *)>
+                       operation) {
+  auto const n_frames = static_cast<int>(A.size()) / dim_A;
+  std::vector<double> result(n_lags * (2 + dim_corr), 0.);
+  for (int tau = 0; tau < n_lags; tau++) {
+    auto row = result.data() + tau * (2 + dim_corr);
+    row[0] = tau;
+    for (int t = 0; t + tau < n_frames; t++) {
+      row[1] += 1.;
+      operation(A.data() + t * dim_A, B.data() + (t + tau) * dim_B, row + 2);
+    }
+    for (int k = 0; k < dim_corr; k++) {
+      if (row[1] > 0.)
+        row[2 + k] /= row[1];
+    }
+  }
+  return result;
+}
+
+void check_close(std::vector<double> const &a, std::vector<double> const &b) {
+  BOOST_REQUIRE_EQUAL(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); i++) {
+    BOOST_CHECK_SMALL(a[i] - b[i], 1e-10);
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(operations) {
+  int const dim = 3;
+  auto const A = series(53, dim, 0.1);
+  auto const B = series(53, dim, 0.7);
+
+  auto const componentwise = [](double const *a, double const *b, double *c) {
+    for (int k = 0; k < dim; k++)
+      c[k] += a[k] * b[k];
+  };
+  auto const scalar = [](double const *a, double const *b, double *c) {
+    for (int k = 0; k < dim; k++)
+      c[0] += a[k] * b[k];
+  };
+  auto const square_distance = [](double const *a, double const *b,
+                                   double *c) {
+    for (int k = 0; k < dim; k++)
+      c[k] += (a[k] - b[k]) * (a[k] - b[k]);
+  };
+  auto const tensor = [](double const *a, double const *b, double *c) {
+    for (int i = 0; i < dim; i++)
+      for (int j = 0; j < 2; j++)
+        c[i * 2 + j] += a[i] * b[j];
+  };
+
+  /* Lag times shorter and longer than the series, so that
+   * both complete and incomplete blocks are covered. */
+  for (int n_lags : {1, 7, 16, 53, 60}) {
+    FFTCorrelator cw(1, 1., n_lags, "componentwise_product", dim, dim);
+    cw.add_frames(A, B);
+    check_close(cw.get_correlation(),
+                direct_correlation(A, B, dim, dim, n_lags, dim, componentwise));
+
+    FFTCorrelator sp(1, 1., n_lags, "scalar_product", dim, dim);
+    sp.add_frames(A, B);
+    check_close(sp.get_correlation(),
+                direct_correlation(A, B, dim, dim, n_lags, 1, scalar));
+
+    FFTCorrelator sd(1, 1., n_lags, "square_distance_componentwise", dim,
+                     dim);
+    sd.add_frames(A, {});
+    check_close(sd.get_correlation(), direct_correlation(A, A, dim, dim, n_lags,
+                                                         dim, square_distance));
+
+    auto const B2 = series(53, 2, 0.3);
+    FFTCorrelator tp(1, 1., n_lags, "tensor_product", dim, 2);
+    tp.add_frames(A, B2);
+    check_close(tp.get_correlation(),
+                direct_correlation(A, B2, dim, 2, n_lags, dim * 2, tensor));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(chunks_and_state) {
+  int const dim = 2;
+  int const n_lags = 10;
+  auto const A = series(95, dim, 0.2);
+
+  FFTCorrelator reference(1, 0.5, n_lags, "square_distance_componentwise",
+                          dim, dim);
+  reference.add_frames(A, {});
+
+  /* Adding the frames in chunks of arbitrary size gives the same result */
+  FFTCorrelator chunked(1, 0.5, n_lags, "square_distance_componentwise", dim,
+                        dim);
+  std::size_t begin = 0;
+  for (std::size_t chunk : {3, 17, 10, 1, 40, 24}) {
+    auto const end = std::min(begin + chunk * dim, A.size());
+    chunked.add_frames({A.begin() + begin, A.begin() + end}, {});
+    begin = end;
+  }
+  BOOST_CHECK_EQUAL(chunked.n_frames(), 95);
+  check_close(chunked.get_correlation(), reference.get_correlation());
+
+  /* The state can be restored */
+  FFTCorrelator restored(1, 0.5, n_lags, "square_distance_componentwise", dim,
+                         dim);
+  restored.set_internal_state(chunked.get_internal_state());
+  check_close(restored.get_correlation(), reference.get_correlation());
+  BOOST_CHECK_EQUAL(restored.get_correlation()[n_lags * (2 + dim) - 2 - dim],
+                    (n_lags - 1) * 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(errors) {
+  BOOST_CHECK_THROW(FFTCorrelator(1, 1., 10, "fcs_acf", 3, 3),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(FFTCorrelator(1, 1., 10, "scalar_product", 3, 2),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(FFTCorrelator(1, 0., 10, "scalar_product", 3, 3),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(FFTCorrelator(1, 1., 0, "scalar_product", 3, 3),
+                    std::runtime_error);
+
+  FFTCorrelator corr(1, 1., 10, "tensor_product", 3, 2);
+  BOOST_CHECK_THROW(corr.add_frames({1., 2.}, {}), std::runtime_error);
+  BOOST_CHECK_THROW(corr.add_frames({1., 2., 3.}, {}), std::runtime_error);
+  BOOST_CHECK_THROW(corr.add_frames({1., 2., 3.}, {1., 2., 3., 4.}),
+                    std::runtime_error);
+  BOOST_CHECK_THROW(corr.update(), std::runtime_error);
+}
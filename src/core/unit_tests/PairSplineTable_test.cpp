@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE PairSplineTable test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "nonbonded_interactions/pair_spline_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+/* Buckingham-like repulsion and dispersion, with a cutoff at 3 and a
+ * switch to a different functional form at 0.8. */
+double force_factor(double r) {
+  if (r >= 3.)
+    return 0.;
+  if (r < 0.8)
+    return 5. / r;
+  return (20. * std::exp(-2. * r) - 6. / std::pow(r, 7)) / r;
+}
+
+double energy(double r) {
+  if (r >= 3.)
+    return 0.;
+  if (r < 0.8)
+    return 1. - 5. * r;
+  return 10. * std::exp(-2. * r) - 1. / std::pow(r, 6) + 0.01;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(accuracy) {
+  PairSplineTable table;
+  table.min_r = 0.5;
+  table.tolerance = 1e-6;
+
+  BOOST_REQUIRE(table.fit(force_factor, energy, {0.8, 3.}, 3.));
+  BOOST_CHECK_EQUAL(table.segments.size(), 2);
+
+  BOOST_CHECK(not table.covers(0.49 * 0.49));
+  BOOST_CHECK(table.covers(0.5 * 0.5));
+
+  for (double r = 0.5; r < 3.; r += 0.001) {
+    auto const s = r * r;
+    BOOST_CHECK_SMALL(
+        (table.force_factor(s) - force_factor(r)) /
+            std::max(1., std::abs(force_factor(r))),
+        2e-6);
+    BOOST_CHECK_SMALL((table.energy(s) - energy(r)) /
+                          std::max(1., std::abs(energy(r))),
+                      2e-6);
+  }
+
+  /* Beyond the cutoff */
+  BOOST_CHECK_EQUAL(table.force_factor(9.), 0.);
+  BOOST_CHECK_EQUAL(table.energy(10.), 0.);
+}
+
+BOOST_AUTO_TEST_CASE(refinement) {
+  PairSplineTable coarse, fine;
+  coarse.min_r = fine.min_r = 0.9;
+  coarse.tolerance = 1e-3;
+  fine.tolerance = 1e-9;
+
+  BOOST_REQUIRE(coarse.fit(force_factor, energy, {}, 3.));
+  BOOST_REQUIRE(fine.fit(force_factor, energy, {}, 3.));
+  BOOST_CHECK_LT(coarse.segments.front().coefficients.size(),
+                 fine.segments.front().coefficients.size());
+}
+
+BOOST_AUTO_TEST_CASE(failure) {
+  PairSplineTable table;
+  table.min_r = 0.5;
+  table.tolerance = 1e-6;
+
+  /* The switch at 0.8 is not announced, so the tolerance
+   * cannot be reached. */
+  BOOST_CHECK(not table.fit(force_factor, energy, {}, 3.));
+  BOOST_CHECK(table.empty());
+  BOOST_CHECK(not table.covers(1.));
+}
+
+BOOST_AUTO_TEST_CASE(disabled) {
+  PairSplineTable table;
+  table.min_r = 0.5;
+
+  BOOST_CHECK(table.fit(force_factor, energy, {0.8}, 3.));
+  BOOST_CHECK(table.empty());
+}
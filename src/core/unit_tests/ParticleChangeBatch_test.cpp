@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE ParticleChangeBatch test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "communication.hpp"
+#include "particle_data.hpp"
+
+#include <utils/Vector.hpp>
+
+namespace {
+void check_particle(int id, int type, Utils::Vector3d const &pos) {
+  BOOST_REQUIRE(particle_exists(id));
+  /* The particle is fetched from the node in the particle node index */
+  auto const &p = get_particle_data(id);
+  BOOST_CHECK_EQUAL(p.p.type, type);
+  BOOST_CHECK_SMALL((p.r.p - pos).norm(), 1e-12);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(apply_and_rollback) {
+  Utils::Vector3d const pos0 = {0.1, 0.2, 0.3};
+  Utils::Vector3d const pos1 = {0.9, 0.8, 0.7};
+  Utils::Vector3d const pos2 = {0.6, 0.1, 0.4};
+  Utils::Vector3d const new_pos0 = {0.7, 0.6, 0.9};
+  place_particle(0, pos0.data());
+  set_particle_type(0, 1);
+  place_particle(1, pos1.data());
+  set_particle_type(1, 2);
+  for (int type = 0; type < 4; type++)
+    init_type_map(type);
+
+  ParticleChangeBatch batch;
+  batch.set_type(0, 3);
+  batch.set_position(0, new_pos0);
+  batch.remove_particle(1);
+  batch.create_particle(2, pos2);
+  batch.set_type(2, 1);
+  BOOST_CHECK(not batch.empty());
+
+  /* Nothing changes before the batch is applied */
+  check_particle(0, 1, pos0);
+  check_particle(1, 2, pos1);
+  BOOST_CHECK(not particle_exists(2));
+
+  batch.apply();
+  BOOST_CHECK(batch.empty());
+  check_particle(0, 3, new_pos0);
+  BOOST_CHECK(not particle_exists(1));
+  check_particle(2, 1, pos2);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(0), 0);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(1), 1);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(2), 0);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(3), 1);
+  BOOST_CHECK_EQUAL(get_random_p_id(1, 0), 2);
+
+  /* The removed particle is restored with its properties */
+  batch.rollback();
+  check_particle(0, 1, pos0);
+  check_particle(1, 2, pos1);
+  BOOST_CHECK(not particle_exists(2));
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(0), 0);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(1), 1);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(2), 1);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(3), 0);
+  BOOST_CHECK_EQUAL(get_random_p_id(1, 0), 0);
+  BOOST_CHECK_EQUAL(get_random_p_id(2, 0), 1);
+
+  /* A second rollback does not undo anything */
+  batch.rollback();
+  check_particle(0, 1, pos0);
+  check_particle(1, 2, pos1);
+
+  /* Discarded changes are not applied */
+  batch.set_type(0, 2);
+  batch.discard();
+  batch.apply();
+  check_particle(0, 1, pos0);
+
+  /* Changes of several batches of the same particle */
+  batch.set_type(1, 0);
+  batch.apply();
+  batch.remove_particle(1);
+  batch.apply();
+  BOOST_CHECK(not particle_exists(1));
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(0), 0);
+  batch.rollback();
+  check_particle(1, 0, pos1);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(0), 1);
+  BOOST_CHECK_EQUAL(number_of_particles_with_type(2), 0);
+
+  remove_all_particles();
+}
+
+int main(int argc, char **argv) {
+  mpi_init();
+
+  /* The other nodes only execute the callbacks of the head node */
+  if (this_node != 0) {
+    mpi_loop();
+    return 0;
+  }
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
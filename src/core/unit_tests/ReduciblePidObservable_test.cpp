@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* The observables that are evaluated on all nodes are sent to them in
+ * the packed archives of the callbacks, so all their parameters have to
+ * survive a serialization round trip. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE Reducible observables serialization test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Particle.hpp"
+#include "observables/ComPosition.hpp"
+#include "observables/ComVelocity.hpp"
+#include "observables/Current.hpp"
+#include "observables/CylindricalDensityProfile.hpp"
+#include "observables/CylindricalFluxDensityProfile.hpp"
+#include "observables/CylindricalVelocityProfile.hpp"
+#include "observables/DensityProfile.hpp"
+#include "observables/DipoleMoment.hpp"
+#include "observables/FluxDensityProfile.hpp"
+#include "observables/ForceDensityProfile.hpp"
+#include "observables/MagneticDipoleMoment.hpp"
+#include "observables/TotalForce.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+/** Particles in the unit box with random properties. */
+std::vector<Particle> random_particles(int n) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(0., 1.);
+  auto const random_vector = [&]() {
+    return Utils::Vector3d{dist(gen), dist(gen), dist(gen)};
+  };
+
+  std::vector<Particle> particles(n);
+  for (int i = 0; i < n; i++) {
+    auto &p = particles[i];
+    p.p.identity = i;
+    p.r.p = random_vector();
+    p.m.v = random_vector() - Utils::Vector3d::broadcast(0.5);
+    p.f.f = random_vector() - Utils::Vector3d::broadcast(0.5);
+#ifdef MASS
+    p.p.mass = 0.5 + dist(gen);
+#endif
+#ifdef ELECTROSTATICS
+    p.p.q = dist(gen) - 0.5;
+#endif
+#ifdef DIPOLES
+    p.p.dipm = dist(gen);
+#endif
+  }
+  return particles;
+}
+
+/** Round trip of @p observable through a packed archive. */
+template <class Obs> Obs round_trip(Obs const &observable) {
+  boost::mpi::communicator world;
+  boost::mpi::packed_oarchive::buffer_type buff;
+  boost::mpi::packed_oarchive(world, buff) << observable;
+
+  Obs result;
+  boost::mpi::packed_iarchive(world, buff) >> result;
+  return result;
+}
+
+/** The copy measures the same particles with the same result. */
+template <class Obs> void check_round_trip(Obs const &observable) {
+  auto const particles = random_particles(50);
+  std::vector<const Particle *> particle_ptrs;
+  for (auto const &p : particles) {
+    particle_ptrs.push_back(&p);
+  }
+
+  auto const copy = round_trip(observable);
+  BOOST_CHECK(copy.ids() == observable.ids());
+  BOOST_CHECK(copy.shape() == observable.shape());
+
+  auto const expected = observable.evaluate(particle_ptrs);
+  auto const result = copy.evaluate(particle_ptrs);
+  BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+  for (std::size_t i = 0; i < result.size(); i++) {
+    BOOST_CHECK_EQUAL(result[i], expected[i]);
+  }
+}
+
+std::vector<int> const ids = {7, 3, 11, 3, 42};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(sums) {
+  using namespace Observables;
+  check_round_trip(ComPosition(ids));
+  check_round_trip(ComVelocity(ids));
+  check_round_trip(Current(ids));
+  check_round_trip(DipoleMoment(ids));
+  check_round_trip(MagneticDipoleMoment(ids));
+  check_round_trip(TotalForce(ids));
+}
+
+BOOST_AUTO_TEST_CASE(profiles) {
+  using namespace Observables;
+  /* different numbers of bins and limits in all directions */
+  check_round_trip(DensityProfile(ids, 2, 3, 4, 0.1, 0.2, 0.05, 0.9, 0.7, 0.8));
+  check_round_trip(
+      FluxDensityProfile(ids, 4, 2, 3, 0.2, 0.1, 0.05, 0.8, 0.9, 0.7));
+  check_round_trip(
+      ForceDensityProfile(ids, 3, 4, 2, 0.05, 0.2, 0.1, 0.7, 0.8, 0.9));
+}
+
+BOOST_AUTO_TEST_CASE(cylindrical_profiles) {
+  using namespace Observables;
+  Utils::Vector3d const center = {0.4, 0.55, 0.5};
+  Utils::Vector3d const axis = {0., 1., 0.};
+  check_round_trip(CylindricalDensityProfile(ids, center, axis, 3, 4, 2, 0.05,
+                                             -3., -0.4, 0.6, 2.5, 0.45));
+  check_round_trip(CylindricalFluxDensityProfile(
+      ids, center, axis, 4, 2, 3, 0.1, -2.5, -0.45, 0.5, 3., 0.4));
+  check_round_trip(CylindricalVelocityProfile(ids, center, axis, 2, 3, 4, 0.,
+                                              -3., -0.5, 0.55, 3., 0.5));
+}
+
+int main(int argc, char **argv) {
+  boost::mpi::environment mpi_env(argc, argv);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
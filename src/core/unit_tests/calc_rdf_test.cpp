@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Radial distribution function from the cell system and from all pairs,
+ * after the particles moved since the last resort. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE RDF test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "global.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
+#include "statistics.hpp"
+#include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesOff.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr double box_length = 10.;
+constexpr int n_random_particles = 200;
+
+/** RDF of all particles up to at most @p r_max with bins of width 0.05. */
+std::vector<double> rdf(double r_max) {
+  auto const r_bins = static_cast<int>(std::floor(r_max / 0.05));
+  std::vector<double> result(r_bins);
+  calc_rdf({0}, {0}, 0., r_bins * 0.05, r_bins, result);
+  return result;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(cell_system_and_all_pairs_agree) {
+  /* the cells of the head node start at the origin */
+  auto const cell_size = cell_structure.max_range[0];
+  BOOST_REQUIRE_GT(cells_neighbor_range(), 0.);
+
+  /* the first particle leaves its cell towards the second one, which is
+   * two cells away, without moving far enough to be resorted */
+  {
+    Utils::Vector3d const pos0 = {2. * cell_size - 0.05, 0.5, 0.5};
+    Utils::Vector3d const pos1 = {3. * cell_size + 0.05, 0.5, 0.5};
+    Utils::Vector3d v = {1., 0., 0.};
+    place_particle(0, pos0.data());
+    set_particle_v(0, v.data());
+    place_particle(1, pos1.data());
+  }
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> position(0., box_length);
+  std::uniform_real_distribution<double> velocity(-0.5, 0.5);
+  for (int i = 2; i < n_random_particles + 2; i++) {
+    Utils::Vector3d const pos = {position(gen), position(gen), position(gen)};
+    Utils::Vector3d v = {velocity(gen), velocity(gen), velocity(gen)};
+    place_particle(i, pos.data());
+    set_particle_v(i, v.data());
+  }
+
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  BOOST_REQUIRE_EQUAL(mpi_integrate(18, 0), 0);
+
+  /* the histograms up to the range of the cell system, and up to the cell
+   * size, agree with the ones from all pairs */
+  for (auto const r_max : {cells_neighbor_range(), cell_size}) {
+    auto const short_range = rdf(r_max);
+    auto const long_range = rdf(2. * r_max);
+    BOOST_REQUIRE_GT(long_range.size(), short_range.size());
+    for (std::size_t i = 0; i < short_range.size(); i++) {
+      BOOST_CHECK_SMALL(short_range[i] - long_range[i], 1e-10);
+    }
+  }
+
+  remove_all_particles();
+}
+
+int main(int argc, char **argv) {
+  mpi_init();
+
+#ifdef VIRTUAL_SITES
+  set_virtual_sites(std::make_shared<VirtualSitesOff>());
+#endif
+
+  /* The other nodes only execute the callbacks of the head node */
+  if (this_node != 0) {
+    mpi_loop();
+    return 0;
+  }
+
+  rescale_boxl(3, box_length);
+  skin = 0.4;
+  skin_set = true;
+  mpi_bcast_parameter(FIELD_SKIN);
+  /* cells much larger than the skin */
+  min_global_cut = 1.;
+  mpi_bcast_parameter(FIELD_MIN_GLOBAL_CUT);
+  mpi_set_time_step(0.01);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
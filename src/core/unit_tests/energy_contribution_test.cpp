@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Energy differences of local moves from the energy contribution of the
+ * moved particles, compared to the total energies. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE Energy contribution test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "bonded_interactions/harmonic.hpp"
+#include "communication.hpp"
+#include "constraints.hpp"
+#include "constraints/ShapeBasedConstraint.hpp"
+#include "energy.hpp"
+#include "global.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "particle_data.hpp"
+#include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesOff.hpp"
+
+#include <shapes/Wall.hpp>
+#include <utils/Vector.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+/** Type of the particles */
+constexpr int particle_type = 0;
+/** Type of the wall constraint */
+constexpr int wall_type = 1;
+
+/** Energy difference of moving particles, from the total energies and
+ *  from the contribution of the moved particles.
+ */
+std::pair<double, double>
+energy_differences(std::vector<int> const &ids,
+                   std::vector<Utils::Vector3d> const &new_positions) {
+  auto const total_old = calculate_current_potential_energy_of_system();
+  auto const local_old =
+      calculate_potential_energy_contribution_of_particles(ids);
+  for (int i = 0; i < ids.size(); i++) {
+    place_particle(ids[i], new_positions[i].data());
+  }
+  auto const total_new = calculate_current_potential_energy_of_system();
+  auto const local_new =
+      calculate_potential_energy_contribution_of_particles(ids);
+
+  return {total_new - total_old, local_new - local_old};
+}
+} // namespace
+
+#ifdef LENNARD_JONES
+BOOST_AUTO_TEST_CASE(pair_bonded_and_constraint_contributions) {
+  lennard_jones_set_params(particle_type, particle_type, 1., 0.1, 0.25, 0.,
+                           0., 0.);
+  lennard_jones_set_params(particle_type, wall_type, 1., 0.1, 0.25, 0., 0.,
+                           0.);
+  harmonic_set_params(0, 10., 0.15, 0.);
+
+  std::vector<Utils::Vector3d> const positions = {
+      {0.15, 0.20, 0.50}, {0.30, 0.25, 0.45}, {0.20, 0.40, 0.55},
+      {0.45, 0.30, 0.50}, {0.62, 0.35, 0.48}, {0.85, 0.55, 0.50},
+      {0.08, 0.50, 0.55}};
+  for (int i = 0; i < positions.size(); i++) {
+    place_particle(i, positions[i].data());
+    set_particle_type(i, particle_type);
+  }
+  /* a chain over the node boundary and a bond over the periodic one */
+  for (int i = 1; i < 5; i++) {
+    int const bond[] = {0, i - 1};
+    add_particle_bond(i, bond);
+  }
+  {
+    int const bond[] = {0, 5};
+    add_particle_bond(6, bond);
+  }
+
+  /* every kind of interaction contributes */
+  auto const e_pair = calculate_potential_energy_contribution_of_particles({3});
+  BOOST_CHECK_NE(e_pair, 0.);
+  auto const e_wall = calculate_potential_energy_contribution_of_particles({0});
+  BOOST_CHECK_NE(e_wall, 0.);
+  auto const e_bond = calculate_potential_energy_contribution_of_particles({6});
+  BOOST_CHECK_NE(e_bond, 0.);
+
+  /* single particle moves */
+  for (int id = 0; id < positions.size(); id++) {
+    auto const new_pos = positions[id] + Utils::Vector3d{0.02, -0.015, 0.01};
+    auto const delta = energy_differences({id}, {new_pos});
+    BOOST_CHECK_CLOSE(delta.first, delta.second, 1e-6);
+  }
+
+  /* moves of several interacting particles, including a pair which
+   * must not be counted twice */
+  {
+    auto const delta = energy_differences(
+        {1, 2, 3}, {{0.28, 0.22, 0.47}, {0.19, 0.37, 0.52}, {0.43, 0.33, 0.5}});
+    BOOST_CHECK_CLOSE(delta.first, delta.second, 1e-6);
+  }
+  {
+    auto const delta = energy_differences(
+        {0, 5, 6}, {{0.12, 0.22, 0.48}, {0.88, 0.52, 0.5}, {0.1, 0.47, 0.6}});
+    BOOST_CHECK_CLOSE(delta.first, delta.second, 1e-6);
+  }
+
+  remove_all_particles();
+}
+
+BOOST_AUTO_TEST_CASE(bonds_stored_with_other_particles) {
+  lennard_jones_set_params(particle_type, particle_type, 1., 0.1, 0.25, 0.,
+                           0., 0.);
+  lennard_jones_set_params(particle_type, wall_type, 1., 0.1, 0.25, 0., 0.,
+                           0.);
+  harmonic_set_params(0, 10., 0.15, 0.);
+  /* many cells, so that only the cells around the particles are searched */
+  rescale_boxl(3, 5.);
+
+  /* a chain through the center of the box, over the boundaries of up to 8
+   * nodes, and one over the periodic boundaries in two directions */
+  std::vector<Utils::Vector3d> positions;
+  for (int i = 0; i < 5; i++) {
+    positions.emplace_back(Utils::Vector3d::broadcast(2.46 + (i - 2) * 0.085));
+  }
+  positions.push_back({4.90, 4.95, 2.00});
+  positions.push_back({0.05, 4.95, 2.00});
+  positions.push_back({0.05, 0.10, 2.02});
+  for (int i = 0; i < positions.size(); i++) {
+    place_particle(i, positions[i].data());
+    set_particle_type(i, particle_type);
+  }
+  /* all bonds of particles 1, 3 and 6 are stored with their partners */
+  for (auto const &pair : std::vector<std::pair<int, int>>{
+           {0, 1}, {2, 1}, {2, 3}, {4, 3}, {5, 6}, {7, 6}}) {
+    int const bond[] = {0, pair.second};
+    add_particle_bond(pair.first, bond);
+  }
+
+  auto const e_bond = calculate_potential_energy_contribution_of_particles({6});
+  BOOST_CHECK_NE(e_bond, 0.);
+
+  for (int id = 0; id < positions.size(); id++) {
+    auto const new_pos = positions[id] + Utils::Vector3d{0.02, -0.015, 0.01};
+    auto const delta = energy_differences({id}, {new_pos});
+    BOOST_CHECK_CLOSE(delta.first, delta.second, 1e-6);
+  }
+  {
+    auto const delta = energy_differences(
+        {1, 6}, {{2.38, 2.36, 2.39}, {4.98, 4.97, 1.99}});
+    BOOST_CHECK_CLOSE(delta.first, delta.second, 1e-6);
+  }
+
+  remove_all_particles();
+  rescale_boxl(3, 1.);
+}
+#endif
+
+int main(int argc, char **argv) {
+  mpi_init();
+
+#ifdef VIRTUAL_SITES
+  set_virtual_sites(std::make_shared<VirtualSitesOff>());
+#endif
+
+  /* The constraints are not communicated, every node sets them up */
+  auto wall = std::make_shared<Shapes::Wall>();
+  wall->set_normal({1., 0., 0.});
+  wall->d() = 0.;
+  auto constraint = std::make_shared<Constraints::ShapeBasedConstraint>();
+  constraint->set_shape(wall);
+  constraint->set_type(wall_type);
+  constraint->penetrable() = true;
+  Constraints::constraints.add(constraint);
+
+  /* The other nodes only execute the callbacks of the head node */
+  if (this_node != 0) {
+    mpi_loop();
+    return 0;
+  }
+
+  skin = 0.1;
+  skin_set = true;
+  mpi_bcast_parameter(FIELD_SKIN);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
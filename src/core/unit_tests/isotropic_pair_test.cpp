@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE isotropic pair potentials test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config.hpp"
+#include "nonbonded_interactions/isotropic_pair.hpp"
+
+#include <cmath>
+
+BOOST_AUTO_TEST_CASE(no_active_potentials) {
+  IA_parameters ia_params;
+  update_isotropic_potentials(ia_params);
+
+  BOOST_CHECK_EQUAL(ia_params.isotropic.size, 0);
+  BOOST_CHECK_EQUAL(isotropic_pair_force_factor(ia_params, 0.5), 0.);
+  BOOST_CHECK_EQUAL(isotropic_pair_energy(ia_params, 0.5), 0.);
+}
+
+#if defined(LENNARD_JONES) && defined(WCA)
+BOOST_AUTO_TEST_CASE(dispatch) {
+  IA_parameters ia_params;
+  ia_params.lj.eps = 1.2;
+  ia_params.lj.sig = 1.;
+  ia_params.lj.cut = 2.5;
+  ia_params.lj.shift = 0.01;
+  update_isotropic_potentials(ia_params);
+
+  BOOST_REQUIRE_EQUAL(ia_params.isotropic.size, 1);
+  BOOST_CHECK(ia_params.isotropic.kinds[0] == IsotropicPotential::lj);
+
+  for (double r = 0.8; r < 3.; r += 0.1) {
+    BOOST_CHECK_EQUAL(isotropic_pair_force_factor(ia_params, r),
+                      lj_pair_force_factor(ia_params, r));
+    BOOST_CHECK_EQUAL(isotropic_pair_energy(ia_params, r),
+                      lj_pair_energy(ia_params, r));
+  }
+
+  ia_params.wca.eps = 0.5;
+  ia_params.wca.sig = 1.;
+  ia_params.wca.cut = std::pow(2., 1. / 6.);
+  update_isotropic_potentials(ia_params);
+
+  BOOST_REQUIRE_EQUAL(ia_params.isotropic.size, 2);
+  BOOST_CHECK(ia_params.isotropic.kinds[1] == IsotropicPotential::wca);
+  BOOST_CHECK_EQUAL(isotropic_pair_cutoff(ia_params, IsotropicPotential::wca),
+                    ia_params.wca.cut);
+
+  for (double r = 0.8; r < 3.; r += 0.1) {
+    BOOST_CHECK_CLOSE(isotropic_pair_force_factor(ia_params, r),
+                      lj_pair_force_factor(ia_params, r) +
+                          wca_pair_force_factor(ia_params, r),
+                      1e-12);
+  }
+
+  /* deactivated by the cutoff */
+  ia_params.lj.cut = 0.;
+  update_isotropic_potentials(ia_params);
+  BOOST_REQUIRE_EQUAL(ia_params.isotropic.size, 1);
+  BOOST_CHECK(ia_params.isotropic.kinds[0] == IsotropicPotential::wca);
+}
+#endif
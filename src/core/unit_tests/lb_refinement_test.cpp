@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Propagation of the CPU LB fluid with a refined patch. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE LB refinement test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "communication.hpp"
+#include "global.hpp"
+#include "grid.hpp"
+#include "grid_based_algorithms/lb.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+#include "grid_based_algorithms/lb_interpolation.hpp"
+#include "integrate.hpp"
+#include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesOff.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+/** Number of coarse nodes in each direction */
+constexpr int grid_size = 12;
+constexpr double density = 1.;
+constexpr double viscosity = 0.1;
+/** The patch and the layer around it are local on the head node for any
+ *  decomposition of the box onto two ranks */
+Utils::Vector3i const patch_begin = {1, 1, 1};
+Utils::Vector3i const patch_end = {5, 5, 5};
+
+/** Reset the fluid to rest. */
+void reset_fluid(Utils::Vector3d const &ext_force_density) {
+  lb_lbfluid_remove_refined_patch();
+  lb_lbfluid_set_ext_force_density(ext_force_density);
+  lb_lbfluid_set_density(density);
+}
+
+void propagate(int n_steps) {
+  BOOST_REQUIRE_EQUAL(mpi_integrate(n_steps, 0), 0);
+}
+
+/** Set up a shear wave and return the x velocity on the nodes
+ *  <tt>(3, 3, z)</tt> after some steps. */
+std::vector<double> shear_wave(bool refined) {
+  reset_fluid({});
+  for (int z = 0; z < grid_size; z++) {
+    /* equilibrium populations, the stress is given without the pressure */
+    auto const j = 0.01 * density *
+                   std::sin(2. * Utils::pi() * (z + 0.5) / grid_size);
+    auto const population =
+        lb_get_population_from_density_momentum_density_stress(
+            density, {j, 0., 0.}, {j * j / density, 0., 0., 0., 0., 0.});
+    for (int y = 0; y < grid_size; y++) {
+      for (int x = 0; x < grid_size; x++) {
+        lb_lbnode_set_pop({x, y, z}, population);
+      }
+    }
+  }
+  if (refined) {
+    lb_lbfluid_set_refined_patch(patch_begin, patch_end);
+  }
+
+  propagate(40);
+
+  std::vector<double> velocities;
+  for (int z = 0; z < grid_size; z++) {
+    velocities.push_back(lb_lbnode_get_velocity({3, 3, z})[0]);
+  }
+  return velocities;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(uniform_force) {
+  Utils::Vector3d const ext_force_density = {1e-3, -2e-4, 5e-4};
+  reset_fluid(ext_force_density);
+  lb_lbfluid_set_refined_patch(patch_begin, patch_end);
+
+  int const n_steps = 10;
+  propagate(n_steps);
+
+  /* the force is applied uniformly on both lattices, the node velocity
+   * includes half of the force of the last step. The stress which the
+   * forcing scheme adds to the populations is not transferred exactly
+   * between the lattices, which results in deviations of second order in
+   * the force. */
+  auto const expected = (n_steps + 0.5) * ext_force_density / density;
+  auto const tol = 1e-5 * expected.norm();
+  for (int z = 0; z < grid_size; z++) {
+    for (int y = 0; y < grid_size; y++) {
+      for (int x = 0; x < grid_size; x++) {
+        Utils::Vector3i const node{x, y, z};
+        BOOST_CHECK_SMALL(lb_lbnode_get_density(node) - density, tol);
+        BOOST_CHECK_SMALL((lb_lbnode_get_velocity(node) - expected).norm(),
+                          tol);
+      }
+    }
+  }
+
+  /* the interpolation on the fine and the coarse lattice agree */
+  auto const u_fine = lb_lbfluid_get_interpolated_velocity({3.1, 2.7, 3.4});
+  auto const u_coarse = lb_lbfluid_get_interpolated_velocity({8.1, 8.7, 9.4});
+  BOOST_CHECK_SMALL((u_fine - n_steps * ext_force_density / density).norm(),
+                    tol);
+  BOOST_CHECK_SMALL((u_fine - u_coarse).norm(), tol);
+}
+
+BOOST_AUTO_TEST_CASE(point_force) {
+  reset_fluid({});
+  lb_lbfluid_set_refined_patch(patch_begin, patch_end);
+
+  /* the head node holds the patch and spreads the force on the fine
+   * lattice */
+  Utils::Vector3d const pos = {3.2, 2.9, 3.1};
+  Utils::Vector3d const force_density = {0.01, 0.02, -0.03};
+  for (auto const order :
+       {InterpolationOrder::linear, InterpolationOrder::quadratic}) {
+    lb_lbinterpolation_set_interpolation_order(order);
+    lb_lbfluid_set_density(density);
+    lb_lbinterpolation_add_force_density(pos, force_density);
+
+    /* the force is applied within one coarse step */
+    propagate(1);
+    auto const momentum = lb_lbfluid_calc_fluid_momentum();
+    BOOST_CHECK_SMALL((momentum - force_density).norm(), 1e-12);
+    auto const u = lb_lbfluid_get_interpolated_velocity(pos);
+    BOOST_CHECK_GT(u * force_density, 0.);
+  }
+  lb_lbinterpolation_set_interpolation_order(InterpolationOrder::linear);
+}
+
+BOOST_AUTO_TEST_CASE(shear_wave_decay) {
+  /* the wave crossing the patch decays as without refinement, up to the
+   * interpolation error at the interface of the lattices */
+  auto const reference = shear_wave(false);
+  auto const refined = shear_wave(true);
+  for (int z = 0; z < grid_size; z++) {
+    BOOST_CHECK_SMALL(refined[z] - reference[z], 2e-4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(invalid_patch) {
+  reset_fluid({});
+  /* empty region */
+  BOOST_CHECK_THROW(lb_lbfluid_set_refined_patch({1, 1, 1}, {1, 5, 5}),
+                    std::invalid_argument);
+  /* the layer around the patch crosses the periodic boundary */
+  BOOST_CHECK_THROW(lb_lbfluid_set_refined_patch({0, 1, 1}, {4, 5, 5}),
+                    std::runtime_error);
+  /* the patch is split between the ranks */
+  if (n_nodes > 1) {
+    BOOST_CHECK_THROW(lb_lbfluid_set_refined_patch({4, 4, 4}, {8, 8, 8}),
+                      std::runtime_error);
+  }
+}
+
+int main(int argc, char **argv) {
+  mpi_init();
+
+#ifdef VIRTUAL_SITES
+  set_virtual_sites(std::make_shared<VirtualSitesOff>());
+#endif
+
+  /* The other nodes only execute the callbacks of the head node */
+  if (this_node != 0) {
+    mpi_loop();
+    return 0;
+  }
+
+  rescale_boxl(3, grid_size);
+  skin = 0.4;
+  skin_set = true;
+  mpi_bcast_parameter(FIELD_SKIN);
+  mpi_set_time_step(1.);
+
+  lb_lbfluid_set_lattice_switch(ActiveLB::CPU);
+  lb_lbfluid_set_agrid(1.);
+  lb_lbfluid_set_tau(1.);
+  lb_lbfluid_set_density(density);
+  lb_lbfluid_set_viscosity(viscosity);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Overlap checks of positions with particles that moved since the last
+ * resort of the cell system. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE Particles within distance test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "global.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
+#include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesOff.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <memory>
+
+BOOST_AUTO_TEST_CASE(moved_particle) {
+  /* the cells of the head node start at the origin */
+  auto const cell_size = cell_structure.max_range[0];
+  BOOST_REQUIRE_GT(cells_neighbor_range(), 0.);
+
+  /* the particle leaves its cell towards the position, but does not
+   * move far enough to be resorted */
+  Utils::Vector3d const start = {2. * cell_size - 0.05, 0.5, 0.5};
+  Utils::Vector3d velocity = {1., 0., 0.};
+  place_particle(0, start.data());
+  set_particle_v(0, velocity.data());
+  BOOST_REQUIRE_EQUAL(mpi_integrate(0, 0), 0);
+  BOOST_REQUIRE_EQUAL(mpi_integrate(18, 0), 0);
+
+  /* the position is two cells away from the cell the particle is stored
+   * in, but closer than the cell size to the particle */
+  Utils::Vector3d const pos = {3. * cell_size + 0.05, 0.5, 0.5};
+  auto const distance = cell_size - 0.08;
+  BOOST_CHECK(mpi_particles_within_distance({pos}, {}, distance + 0.01));
+  BOOST_CHECK(not mpi_particles_within_distance({pos}, {}, distance - 0.01));
+  BOOST_CHECK(not mpi_particles_within_distance({pos}, {0}, distance + 0.01));
+
+  remove_all_particles();
+}
+
+int main(int argc, char **argv) {
+  mpi_init();
+
+#ifdef VIRTUAL_SITES
+  set_virtual_sites(std::make_shared<VirtualSitesOff>());
+#endif
+
+  /* The other nodes only execute the callbacks of the head node */
+  if (this_node != 0) {
+    mpi_loop();
+    return 0;
+  }
+
+  rescale_boxl(3, 10.);
+  skin = 0.4;
+  skin_set = true;
+  mpi_bcast_parameter(FIELD_SKIN);
+  /* cells much larger than the skin */
+  min_global_cut = 1.;
+  mpi_bcast_parameter(FIELD_MIN_GLOBAL_CUT);
+  mpi_set_time_step(0.01);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
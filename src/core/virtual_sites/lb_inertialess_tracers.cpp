@@ -91,8 +91,10 @@ void IBM_ForcesIntoFluid_CPU() {
  */
 void IBM_UpdateParticlePositions(ParticleRange particles) {
   // Get velocities
-  if (lattice_switch == ActiveLB::CPU)
+  if (lattice_switch == ActiveLB::CPU) {
+    lb_update_halo_populations();
     ParticleVelocitiesFromLB_CPU();
+  }
 #ifdef CUDA
   if (lattice_switch == ActiveLB::GPU)
     ParticleVelocitiesFromLB_GPU(particles);
@@ -235,6 +235,12 @@ class Correlator(ScriptInterfaceHelper):
         Three floats which are passed as arguments to the correlation
         function.  Currently it is only used by ``"fcs_acf"``.
         Other correlation operations will ignore these values.
+
+    distributed : :obj:`bool`, optional
+        Compute the correlation in parallel on all MPI ranks, every rank
+        storing and correlating a block of the components of the
+        observables. Useful for observables with many components.
+        Default is ``False``.
     """
 
     _so_name = "Accumulators::Correlator"
@@ -260,6 +266,130 @@ class Correlator(ScriptInterfaceHelper):
         return res.reshape((self.n_result, 2 + self.dim_corr))
 
 
+@script_interface_register
+class FFTCorrelator(ScriptInterfaceHelper):
+
+    """
+    Calculates correlations at full time resolution with FFT.
+
+    In contrast to :class:`Correlator`, the correlation is computed for
+    all lag times up to ``tau_max`` at the sampling interval, using the
+    Wiener-Khinchin theorem. The frames are processed in blocks of
+    ``tau_max / dt + 1`` frames and only two blocks are kept in memory, so
+    that the cost per frame grows only logarithmically with ``tau_max``.
+
+    Frames can be taken from observables during the integration, like
+    with :class:`Correlator`, or be added afterwards from stored data
+    with :meth:`add_frames`, :meth:`add_time_series` or
+    :meth:`add_dataset`.
+
+    Parameters
+    ----------
+    obs1 : :class:`espressomd.observables.Observable`, optional
+        The observable :math:`A` to be correlated with :math:`B` (``obs2``).
+        If ``obs2`` is omitted, autocorrelation of ``obs1`` is calculated.
+    obs2 : :class:`espressomd.observables.Observable`, optional
+        The observable :math:`B`.
+    dim_A : :obj:`int`, optional
+        Number of components of :math:`A`, required without ``obs1``.
+    dim_B : :obj:`int`, optional
+        Number of components of :math:`B`, defaults to ``dim_A``.
+    corr_operation : :obj:`str`
+        One of ``"componentwise_product"``, ``"tensor_product"``,
+        ``"scalar_product"`` or ``"square_distance_componentwise"``,
+        see :class:`Correlator`.
+    tau_max : :obj:`float`
+        Maximal lag time, rounded to a multiple of ``dt``.
+    delta_N : :obj:`int`, optional
+        Number of timesteps between subsequent samples for the auto
+        update mechanism. Default is 1.
+    dt : :obj:`float`, optional
+        Time between subsequent frames. Default is ``delta_N``
+        times the time step.
+
+    """
+
+    _so_name = "Accumulators::FFTCorrelator"
+    _so_bind_methods = ("update",)
+    _so_creation_policy = "LOCAL"
+
+    def result(self):
+        """
+        Returns
+        -------
+
+        numpy.ndarray
+            The correlation as a 2d-array, in the same layout as
+            :meth:`Correlator.result`: the lag times, the number of
+            pairs of frames, and the components of the correlation.
+        """
+        res = np.array(self.call_method("get_correlation"))
+        return res.reshape((self.n_lags, 2 + self.dim_corr))
+
+    def add_frames(self, A, B=None):
+        """
+        Add frames of :math:`A` and :math:`B`.
+
+        Parameters
+        ----------
+        A : array_like
+            Frames of :math:`A`, the first axis is the time.
+        B : array_like, optional
+            Frames of :math:`B`, if omitted :math:`A` is correlated
+            with itself.
+        """
+        A = np.asarray(A, dtype=float)
+        args = {"A": A.reshape(A.shape[0], -1).flatten()}
+        if B is not None:
+            B = np.asarray(B, dtype=float)
+            if B.shape[0] != A.shape[0]:
+                raise ValueError(
+                    "A and B must have the same number of frames")
+            args["B"] = B.reshape(B.shape[0], -1).flatten()
+        self.call_method("add_frames", **args)
+
+    def add_time_series(self, A, B=None):
+        """
+        Add all frames recorded by :class:`TimeSeries` accumulators.
+
+        Parameters
+        ----------
+        A : :class:`TimeSeries`
+            Frames of :math:`A`.
+        B : :class:`TimeSeries`, optional
+            Frames of :math:`B`, if omitted :math:`A` is correlated
+            with itself.
+        """
+        if B is None:
+            self.call_method("add_time_series", A=A)
+        else:
+            self.call_method("add_time_series", A=A, B=B)
+
+    def add_dataset(self, A, B=None, chunk_frames=1024):
+        """
+        Add frames from datasets which are read in chunks, e.g. the
+        ``value`` datasets of time-dependent elements of an H5MD file
+        opened with h5py. Only ``chunk_frames`` frames are held in memory
+        at a time.
+
+        Parameters
+        ----------
+        A : array_like
+            Frames of :math:`A`, sliceable along the first axis.
+        B : array_like, optional
+            Frames of :math:`B`, if omitted :math:`A` is correlated
+            with itself.
+        chunk_frames : :obj:`int`, optional
+            Number of frames to read at a time.
+        """
+        if B is not None and len(B) != len(A):
+            raise ValueError("A and B must have the same number of frames")
+        for begin in range(0, len(A), chunk_frames):
+            end = min(begin + chunk_frames, len(A))
+            self.add_frames(A[begin:end],
+                            None if B is None else B[begin:end])
+
+
 @script_interface_register
 class AutoUpdateAccumulators(ScriptObjectRegistry):
 
@@ -62,18 +62,18 @@ cdef extern from "statistics.hpp":
     ctypedef struct Observable_stat_non_bonded:
         pass
 
-    cdef vector[double] calc_structurefactor(PartCfg & , int * p_types, int n_types, int order)
+    cdef vector[double] calc_structurefactor(int * p_types, int n_types, int order)
     cdef vector[vector[double]] modify_stucturefactor(int order, double * sf)
     cdef double mindist(PartCfg &, const List[int] & set1, const List[int] & set2)
-    cdef List[int] nbhood(PartCfg &, const Vector3d & pos, double r_catch, const Vector3i & planedims)
+    cdef List[int] nbhood(const Vector3d & pos, double r_catch, const Vector3i & planedims)
     cdef double * obsstat_bonded(Observable_stat * stat, int j)
     cdef double * obsstat_nonbonded(Observable_stat * stat, int i, int j)
     cdef double * obsstat_nonbonded_inter(Observable_stat_non_bonded * stat, int i, int j)
     cdef double * obsstat_nonbonded_intra(Observable_stat_non_bonded * stat, int i, int j)
     cdef vector[double] calc_linear_momentum(int include_particles, int include_lbfluid)
-    cdef vector[double] centerofmass(PartCfg &, int part_type)
+    cdef vector[double] centerofmass(int part_type)
 
-    void calc_rdf(PartCfg &, vector[int] p1_types, vector[int] p2_types,
+    void calc_rdf(vector[int] p1_types, vector[int] p2_types,
                   double r_min, double r_max, int r_bins, vector[double] rdf)
 
     void calc_rdf_av(PartCfg &, vector[int] p1_types, vector[int] p2_types,
@@ -147,7 +147,7 @@ class Analysis:
         if p_type < 0 or p_type >= analyze.max_seen_particle_type:
             raise ValueError("Particle type {} does not exist!".format(p_type))
 
-        return analyze.centerofmass(analyze.partCfg(), p_type)
+        return analyze.centerofmass(p_type)
 
     def nbhood(self, pos=None, r_catch=None, plane='3d'):
         """
@@ -195,7 +195,7 @@ class Analysis:
         for i in range(3):
             c_pos[i] = pos[i]
 
-        ids = analyze.nbhood(analyze.partCfg(), c_pos, r_catch, planedims)
+        ids = analyze.nbhood(c_pos, r_catch, planedims)
 
         return create_nparray_from_int_list(ids)
 
@@ -705,8 +705,7 @@ class Analysis:
 
         p_types = create_int_list_from_python_object(sf_types)
 
-        sf = analyze.calc_structurefactor(analyze.partCfg(), p_types.e,
-                                          p_types.n, sf_order)
+        sf = analyze.calc_structurefactor(p_types.e, p_types.n, sf_order)
 
         return np.transpose(analyze.modify_stucturefactor(sf_order, sf.data()))
 
@@ -776,8 +775,7 @@ class Analysis:
         cdef vector[int] p2_types = type_list_b
 
         if rdf_type == 'rdf':
-            analyze.calc_rdf(analyze.partCfg(), p1_types,
-                             p2_types, r_min, r_max, r_bins, rdf)
+            analyze.calc_rdf(p1_types, p2_types, r_min, r_max, r_bins, rdf)
         elif rdf_type == '<rdf>':
             analyze.calc_rdf_av(
                 analyze.partCfg(), p1_types, p2_types, r_min,
@@ -43,6 +43,20 @@ cdef extern from "cells.hpp":
 cdef extern from "tuning.hpp":
     cdef void c_tune_skin "tune_skin" (double min_skin, double max_skin, double tol, int int_steps, bool adjust_max_skin)
 
+    ctypedef struct OnlineTuningParameters:
+        int chunk_steps
+        double min_skin
+        double max_skin
+        double skin_step
+        double hysteresis
+        int idle_chunks
+        bool tune_verlet_lists
+
+    void online_tuning_enable(const OnlineTuningParameters & params)
+    void online_tuning_disable()
+    bool online_tuning_enabled()
+    const OnlineTuningParameters & online_tuning_parameters()
+
 cdef extern from "domain_decomposition.hpp":
     ctypedef struct  DomainDecomposition:
         int cell_grid[3]
@@ -86,6 +86,7 @@ cdef class CellSystem:
         s["max_num_cells"] = max_num_cells
         s["min_num_cells"] = min_num_cells
         s["fully_connected"] = dd.fully_connected
+        s["online_tuning"] = online_tuning_enabled()
 
         return s
 
@@ -249,3 +250,66 @@ cdef class CellSystem:
         c_tune_skin(min_skin, max_skin, tol, int_steps, adjust_max_skin)
         handle_errors("Error during tune_skin")
         return self.skin
+
+    def enable_online_tuning(self, chunk_steps=100, min_skin=0.,
+                             max_skin=0., skin_step=0.2, hysteresis=0.05,
+                             idle_chunks=20, tune_verlet_lists=True):
+        """
+        Tunes the skin and the use of Verlet lists during the integration.
+        The integration steps are timed in chunks, between which the skin
+        is changed in small steps, or the Verlet lists are switched on or
+        off. A change is kept if it makes the integration faster, otherwise
+        it is reverted. Once converged, the configuration is checked again
+        after ``idle_chunks`` chunks, or as soon as the time per step
+        changes, e.g. because the density or the temperature of the
+        system drifts. With domain decomposition, the cell grid follows
+        the skin.
+
+        Parameters
+        -----------
+        chunk_steps : :obj:`int`, optional
+            Number of integration steps per timed chunk.
+        min_skin : :obj:`float`, optional
+            Minimum skin to try.
+        max_skin : :obj:`float`, optional
+            Maximum skin to try, ``0`` for the largest skin the cell
+            system allows.
+        skin_step : :obj:`float`, optional
+            Relative change of the skin per trial.
+        hysteresis : :obj:`float`, optional
+            Minimal relative speedup for a change to be kept.
+        idle_chunks : :obj:`int`, optional
+            Number of chunks between the trials once converged.
+        tune_verlet_lists : :obj:`bool`, optional
+            Whether to also try switching the Verlet lists on or off.
+
+        """
+        if chunk_steps < 1:
+            raise ValueError("chunk_steps must be > 0")
+        if min_skin < 0 or max_skin < 0:
+            raise ValueError("min_skin and max_skin must be >= 0")
+        if max_skin > 0 and max_skin < min_skin:
+            raise ValueError("max_skin must be >= min_skin")
+        if not 0 < skin_step < 1:
+            raise ValueError("skin_step must be between 0 and 1")
+        if hysteresis < 0:
+            raise ValueError("hysteresis must be >= 0")
+        if idle_chunks < 0:
+            raise ValueError("idle_chunks must be >= 0")
+
+        cdef OnlineTuningParameters params
+        params.chunk_steps = chunk_steps
+        params.min_skin = min_skin
+        params.max_skin = max_skin
+        params.skin_step = skin_step
+        params.hysteresis = hysteresis
+        params.idle_chunks = idle_chunks
+        params.tune_verlet_lists = tune_verlet_lists
+        online_tuning_enable(params)
+
+    def disable_online_tuning(self):
+        """
+        Stops the online tuning, the current skin and cell system are kept.
+
+        """
+        online_tuning_disable()
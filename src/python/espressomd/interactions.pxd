@@ -45,6 +45,14 @@ cdef extern from "dpd.hpp":
         int wf
         double pref
 
+cdef extern from "nonbonded_interactions/pair_spline_table.hpp":
+    cdef struct PairSplineTable:
+        double min_r
+        double tolerance
+
+    int pair_spline_table_set_params(int part_type_a, int part_type_b,
+                                     double min_r, double tolerance)
+
 cdef extern from "nonbonded_interactions/nonbonded_interaction_data.hpp":
     cdef struct LJ_Parameters:
         double eps
@@ -187,6 +195,8 @@ cdef extern from "nonbonded_interactions/nonbonded_interaction_data.hpp":
 
         Thole_Parameters thole
 
+        PairSplineTable spline_table
+
     cdef IA_parameters * get_ia_param(int i, int j)
     cdef IA_parameters * get_ia_param_safe(int i, int j)
     cdef string ia_params_get_state()
@@ -20,7 +20,7 @@ from libcpp.string cimport string
 import collections
 
 include "myconfig.pxi"
-from .utils import requires_experimental_features, is_valid_type
+from .utils import requires_experimental_features, is_valid_type, handle_errors
 from .utils cimport check_type_or_throw_except
 
 
@@ -1572,6 +1572,7 @@ class NonBondedInteractionHandle:
     dpd = None
     hat = None
     thole = None
+    spline_tabulation = None
 
     def __init__(self, _type1, _type2):
         if not (is_valid_type(_type1, int) and is_valid_type(_type2, int)):
@@ -1616,6 +1617,7 @@ class NonBondedInteractionHandle:
             self.hat = HatInteraction(_type1, _type2)
         IF THOLE:
             self.thole = TholeInteraction(_type1, _type2)
+        self.spline_tabulation = SplineTabulation(_type1, _type2)
 
 
 cdef class NonBondedInteractions:
@@ -2195,6 +2197,73 @@ IF THOLE:
         def required_keys(self):
             return {"scaling_coeff", "q1q2"}
 
+cdef class SplineTabulation(NonBondedInteraction):
+
+    def validate_params(self):
+        if self._params["tolerance"] < 0:
+            raise ValueError("Spline tabulation tolerance has to be >=0")
+        if self._params["tolerance"] > 0 and self._params["min_r"] <= 0:
+            raise ValueError("Spline tabulation min_r has to be >0")
+        return True
+
+    def _get_params_from_es_core(self):
+        cdef IA_parameters * ia_params
+        ia_params = get_ia_param_safe(self._part_types[0],
+                                      self._part_types[1])
+        return {
+            "min_r": ia_params.spline_table.min_r,
+            "tolerance": ia_params.spline_table.tolerance
+        }
+
+    def is_active(self):
+        return (self._params["tolerance"] > 0)
+
+    def set_params(self, **kwargs):
+        """Tabulate the isotropic interactions of the type pair.
+
+        All active interactions which only depend on the distance are
+        combined into one cubic spline table in the squared distance,
+        which replaces their evaluation for distances above ``min_r``.
+        The table follows any later change of these interactions.
+        Thole and Gay-Berne are always evaluated directly.
+
+        Parameters
+        ----------
+        min_r : :obj:`float`
+            Smallest tabulated distance, closer pairs are evaluated
+            directly.
+        tolerance : :obj:`float`
+            Largest interpolation error of force and energy, relative
+            to their magnitude where that is larger than 1. A value of
+            0 disables the tabulation.
+
+        """
+        super().set_params(**kwargs)
+
+    def _set_params_in_es_core(self):
+        self.validate_params()
+        failed = pair_spline_table_set_params(self._part_types[0],
+                                              self._part_types[1],
+                                              self._params["min_r"],
+                                              self._params["tolerance"])
+        handle_errors(
+            "Could not tabulate the interactions within the tolerance")
+        if failed:
+            raise Exception(
+                "Could not tabulate the interactions within the tolerance")
+
+    def default_params(self):
+        return {"min_r": 0., "tolerance": 0.}
+
+    def type_name(self):
+        return "SplineTabulation"
+
+    def valid_keys(self):
+        return {"min_r", "tolerance"}
+
+    def required_keys(self):
+        return {"min_r", "tolerance"}
+
 IF ROTATION:
 
     @requires_experimental_features("No test coverage")
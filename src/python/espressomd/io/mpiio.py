@@ -99,5 +99,59 @@ class Mpiio:
         self._instance.call_method(
             "read", prefix=prefix, pos=positions, vel=velocities, typ=types, bond=bonds)
 
+    def write_checkpoint(self, filename=None):
+        """MPI-IO checkpoint write.
+
+        Outputs the complete state of all particles, including bonds and
+        exclusions, to a single binary file using collective MPI-IO.
+        The file starts with a header and a table of the stored columns.
+
+        .. note::
+            Do not read the file on a machine with a different architecture
+            or with a different set of features!
+
+        Parameters
+        ----------
+        filename : :obj:`str`
+            Name of the file, which must not exist.
+
+        Raises
+        ------
+        ValueError
+            If no filename was given.
+        """
+        if filename is None:
+            raise ValueError(
+                "Need to supply output file via 'filename' kwarg.")
+
+        self._instance.call_method("write_checkpoint", filename=filename)
+
+    def read_checkpoint(self, filename=None):
+        """MPI-IO checkpoint read.
+
+        Replaces all particles by the particles of a file written by
+        :meth:`write_checkpoint`. In contrast to :meth:`read`, the file
+        can be read on any number of processes.
+
+        .. note::
+            The simulation is aborted if the file is not a checkpoint or
+            was written with a different set of features.
+
+        Parameters
+        ----------
+        filename : :obj:`str`
+            Name of the file.
+
+        Raises
+        ------
+        ValueError
+            If no filename was given.
+        """
+        if filename is None:
+            raise ValueError(
+                "Need to supply input file via 'filename' kwarg.")
+
+        self._instance.call_method("read_checkpoint", filename=filename)
+
 
 mpiio = Mpiio()
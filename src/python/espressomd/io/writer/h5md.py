@@ -57,11 +57,26 @@ else:
         write_ordered : :obj:`bool`, optional
                         If particle properties should be ordered according to
                         ids.
+        asynchronous : :obj:`bool`, optional
+                       If the file should be written by a background thread
+                       on the head node, so that the simulation can continue
+                       while the data is written. Implies ``write_ordered``.
+        compression : :obj:`int`, optional
+                      Deflate level (0 to 9) of the particle datasets,
+                      0 disables compression.
+        precision : :obj:`float`, optional
+                    Absolute precision to which positions, velocities and
+                    forces are stored, 0 stores them without loss.
+        chunk_frames : :obj:`int`, optional
+                       Number of time steps stored in one chunk of the
+                       particle datasets.
 
         """
 
-        def __init__(self, write_ordered=True, **kwargs):
-            self.valid_params = ['filename', "write_ordered"]
+        def __init__(self, write_ordered=True, asynchronous=False,
+                     compression=0, precision=0., chunk_frames=1, **kwargs):
+            self.valid_params = ['filename', "write_ordered", "asynchronous",
+                                 "compression", "precision", "chunk_frames"]
             if 'filename' not in kwargs:
                 raise ValueError("'filename' parameter missing.")
             self.what = {'write_pos': 1 << 0,
@@ -89,7 +104,11 @@ else:
             self.h5md_instance.set_params(filename=kwargs['filename'],
                                           what=self.what_bin,
                                           scriptname=sys.argv[0],
-                                          write_ordered=write_ordered)
+                                          write_ordered=write_ordered,
+                                          asynchronous=asynchronous,
+                                          compression=compression,
+                                          precision=precision,
+                                          chunk_frames=chunk_frames)
             self.h5md_instance.call_method("init_file")
 
         def get_params(self):
@@ -43,6 +43,13 @@ cdef extern from "grid_based_algorithms/lb_interface.hpp" namespace "ActiveLB":
     cdef ActiveLB CPU
     cdef ActiveLB GPU
 
+cdef extern from "grid_based_algorithms/lb_constants.hpp":
+    cdef enum LBVTKField:
+        LB_VTK_DENSITY
+        LB_VTK_VELOCITY
+        LB_VTK_STRESS
+        LB_VTK_BOUNDARY
+
 cdef extern from "grid_based_algorithms/lb_interface.hpp":
 
     cdef enum ActiveLB:
@@ -64,9 +71,12 @@ cdef extern from "grid_based_algorithms/lb_interface.hpp":
     void lb_lbfluid_set_bulk_viscosity(double c_bulk_visc) except +
     double lb_lbfluid_get_bulk_viscosity() except +
     void lb_lbfluid_sanity_checks() except +
+    void lb_lbfluid_set_refined_patch(const Vector3i & begin, const Vector3i & end) except +
+    void lb_lbfluid_remove_refined_patch() except +
     void lb_lbfluid_print_vtk_velocity(string filename) except +
     void lb_lbfluid_print_vtk_velocity(string filename, vector[int] bb1, vector[int] bb2) except +
     void lb_lbfluid_print_vtk_boundary(string filename) except +
+    void lb_lbfluid_write_vtk(string basename, int fields, vector[int] bb1, vector[int] bb2, int stride) except +
     void lb_lbfluid_print_velocity(string filename) except +
     void lb_lbfluid_print_boundary(string filename) except +
     void lb_lbfluid_save_checkpoint(string filename, bool binary) except +
@@ -189,6 +189,47 @@ cdef class HydrodynamicInteraction(Actor):
     def print_vtk_boundary(self, path):
         lb_lbfluid_print_vtk_boundary(utils.to_char_pointer(path))
 
+    def write_vtk(self, path, observables=("density", "velocity"),
+                  bb1=None, bb2=None, stride=1):
+        """
+        Write fluid fields in parallel to binary VTK image data files.
+
+        Every MPI rank writes its part of the region to ``path_<rank>.vti``,
+        the pieces are collected in the index file ``path.pvti``.
+
+        Parameters
+        ----------
+        path : :obj:`str`
+            Output path without file extension.
+        observables : list of :obj:`str`
+            Fields to write, any of ``'density'``, ``'velocity'``,
+            ``'stress'`` and ``'boundary'``.
+        bb1, bb2 : (3,) array_like of :obj:`int`, optional
+            Corners of the region of interest (node indices, inclusive).
+            The full lattice is written if omitted.
+        stride : :obj:`int`, optional
+            Write only every ``stride``-th node in each direction.
+
+        """
+        field_flags = {"density": LB_VTK_DENSITY,
+                       "velocity": LB_VTK_VELOCITY,
+                       "stress": LB_VTK_STRESS,
+                       "boundary": LB_VTK_BOUNDARY}
+        cdef int fields = 0
+        for observable in observables:
+            if observable not in field_flags:
+                raise ValueError(
+                    "Unknown observable '{}', has to be one of {}".format(
+                        observable, sorted(field_flags.keys())))
+            fields |= field_flags[observable]
+        cdef vector[int] bb1_vec = [-1, -1, -1]
+        cdef vector[int] bb2_vec = [-1, -1, -1]
+        if bb1 is not None and bb2 is not None:
+            bb1_vec = bb1
+            bb2_vec = bb2
+        lb_lbfluid_write_vtk(
+            utils.to_char_pointer(path), fields, bb1_vec, bb2_vec, stride)
+
     def print_velocity(self, path):
         lb_lbfluid_print_velocity(utils.to_char_pointer(path))
 
@@ -320,6 +361,42 @@ cdef class LBFluid(HydrodynamicInteraction):
         self._set_lattice_switch()
         self._set_params_in_es_core()
 
+    def set_refined_patch(self, begin, end):
+        """Cover a region of the fluid with a lattice of half the grid
+        spacing.
+
+        The refined lattice is initialized from the current state of the
+        fluid. Only one patch can be set, a new one replaces the old one.
+
+        Parameters
+        ----------
+        begin : (3,) array_like of :obj:`int`
+            Index of the first node of the region.
+        end : (3,) array_like of :obj:`int`
+            Index of the node after the last one of the region.
+
+        Raises
+        ------
+        ValueError
+            If the region is empty or not within the lattice.
+        RuntimeError
+            If the region and one layer of nodes around it are not in
+            the local domain of a single MPI rank.
+
+        """
+        cdef Vector3i c_begin
+        cdef Vector3i c_end
+        for i in range(3):
+            c_begin[i] = begin[i]
+            c_end[i] = end[i]
+        lb_lbfluid_set_refined_patch(c_begin, c_end)
+
+    def remove_refined_patch(self):
+        """Remove the refined patch set by :meth:`set_refined_patch`.
+
+        """
+        lb_lbfluid_remove_refined_patch()
+
 IF CUDA:
     cdef class LBFluidGPU(HydrodynamicInteraction):
         """
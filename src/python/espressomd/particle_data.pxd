@@ -192,6 +192,21 @@ cdef extern from "particle_data.hpp":
     int get_maximal_particle_id()
     int get_n_part()
 
+    ctypedef enum BulkProperty:
+        BULK_POSITION
+        BULK_VELOCITY
+        BULK_FORCE
+        BULK_TYPE
+        BULK_MOL_ID
+        BULK_CHARGE
+        BULK_MASS
+
+    int bulk_property_width(BulkProperty prop)
+    vector[double] get_particles_property(BulkProperty prop, const vector[int] & ids) except +
+    void set_particles_property(BulkProperty prop, const vector[int] & ids, const vector[double] & values) except +
+    void place_new_particles(const vector[int] & ids, const vector[double] & positions, const vector[BulkProperty] & props, const vector[vector[double]] & values) except +
+    void add_particles_bond(int bond_type, const vector[int] & ids, const vector[int] & partners) except +
+
 cdef extern from "virtual_sites.hpp":
     IF VIRTUAL_SITES_RELATIVE == 1:
         void vs_relate_to(int part_num, int relate_to)
@@ -1522,6 +1522,88 @@ cdef class ParticleHandle:
 
             rotate_particle(self._id, a, angle)
 
+
+# Properties of ParticleSlice which are accessed with one collective
+# operation for all particles instead of particle by particle
+_bulk_properties = {"pos": BULK_POSITION,
+                    "v": BULK_VELOCITY,
+                    "f": BULK_FORCE,
+                    "type": BULK_TYPE,
+                    "mol_id": BULK_MOL_ID}
+IF ELECTROSTATICS:
+    _bulk_properties["q"] = BULK_CHARGE
+IF MASS:
+    _bulk_properties["mass"] = BULK_MASS
+
+
+def _get_particles_property(ids, attribute):
+    """
+    Get a property of many particles at once, see
+    :data:`_bulk_properties`. Returns an array with one row per particle.
+
+    """
+    cdef BulkProperty prop = _bulk_properties[attribute]
+    cdef vector[int] c_ids = ids
+    cdef vector[double] values = get_particles_property(prop, c_ids)
+    cdef int width = bulk_property_width(prop)
+    cdef double[:] view
+    cdef size_t i
+    res = np.empty(values.size())
+    view = res
+    for i in range(values.size()):
+        view[i] = values[i]
+
+    if width > 1:
+        res = res.reshape((-1, width))
+    if prop in (BULK_TYPE, BULK_MOL_ID):
+        res = res.astype(int)
+    return res
+
+
+cdef vector[double] _bulk_property_values(attribute, values, n_part) except *:
+    """
+    Check the values of a property of :data:`_bulk_properties` for
+    ``n_part`` particles and flatten them. ``values`` has to contain
+    either one value for all particles, or one value per particle.
+
+    """
+    cdef BulkProperty prop = _bulk_properties[attribute]
+    cdef int width = bulk_property_width(prop)
+    cdef vector[double] c_values
+    cdef double[:] view
+    cdef size_t i
+
+    shape = (n_part, width) if width > 1 else (n_part,)
+    if np.shape(values) not in (shape[1:], shape):
+        raise Exception(
+            "Shape of value (%s) does not broadcast to shape of attribute (%s)." % (
+                np.shape(values), shape[1:]))
+    if prop in (BULK_TYPE, BULK_MOL_ID):
+        if not np.issubdtype(np.asarray(values).dtype, np.integer) or np.any(
+                np.asarray(values) < 0):
+            raise ValueError("{} must be an integer >= 0".format(attribute))
+    values = np.array(np.broadcast_to(values, shape), dtype=float).ravel()
+    if prop == BULK_POSITION and not np.all(np.isfinite(values)):
+        raise ValueError("invalid particle position")
+
+    c_values.resize(len(values))
+    view = values
+    for i in range(len(values)):
+        c_values[i] = view[i]
+    return c_values
+
+
+def _set_particles_property(ids, attribute, values):
+    """
+    Set a property of many particles at once, see
+    :data:`_bulk_properties`.
+
+    """
+    cdef vector[int] c_ids = ids
+    set_particles_property(_bulk_properties[attribute], c_ids,
+                           _bulk_property_values(attribute, values, len(ids)))
+
+
 cdef class _ParticleSliceImpl:
     """Handles slice inputs.
 
@@ -1823,16 +1905,7 @@ cdef class ParticleList:
             if particle_exists(P["id"]):
                 raise Exception("Particle %d already exists." % P["id"])
 
-        # Prevent setting of contradicting attributes
-        IF DIPOLES:
-            if 'dip' in P and 'dipm' in P:
-                raise ValueError("Contradicting attributes: dip and dipm. Setting \
-dip is sufficient as the length of the vector defines the scalar dipole moment.")
-            IF ROTATION:
-                if 'dip' in P and 'quat' in P:
-                    raise ValueError("Contradicting attributes: dip and quat. \
-Setting dip overwrites the rotation of the particle around the dipole axis. \
-Set quat and scalar dipole moment (dipm) instead.")
+        self._check_contradicting_attributes(P)
 
         # The ParticleList[]-getter ist not valid yet, as the particle
         # doesn't yet exist. Hence, the setting of position has to be
@@ -1855,6 +1928,18 @@ Set quat and scalar dipole moment (dipm) instead.")
 
         return self[id]
 
+    def _check_contradicting_attributes(self, P):
+        # Prevent setting of contradicting attributes
+        IF DIPOLES:
+            if 'dip' in P and 'dipm' in P:
+                raise ValueError("Contradicting attributes: dip and dipm. Setting \
+dip is sufficient as the length of the vector defines the scalar dipole moment.")
+            IF ROTATION:
+                if 'dip' in P and 'quat' in P:
+                    raise ValueError("Contradicting attributes: dip and quat. \
+Setting dip overwrites the rotation of the particle around the dipole axis. \
+Set quat and scalar dipole moment (dipm) instead.")
+
     def _place_new_particles(self, Ps):
         # Check if all entries have the same length
         n_parts = len(Ps["pos"])
@@ -1867,16 +1952,34 @@ Set quat and scalar dipole moment (dipm) instead.")
         if not "id" in Ps:
             first_id = get_maximal_particle_id() + 1
             Ps["id"] = range(first_id, first_id + n_parts)
-
-        # Place the particles
-        for i in range(n_parts):
-            P = {}
-            for k in Ps:
-                P[k] = Ps[k][i]
-            self._place_new_particle(P)
+        self._check_contradicting_attributes(Ps)
+
+        # Create the particles with the properties that can be set in
+        # bulk in one step, and set the remaining ones per particle
+        cdef vector[int] ids
+        cdef vector[BulkProperty] props
+        cdef vector[vector[double]] values
+        for pid in Ps["id"]:
+            if not is_valid_type(pid, int):
+                raise TypeError(
+                    "Particle id must be an integer but got " + str(pid))
+            ids.push_back(pid)
+        for k in Ps:
+            if k not in ("id", "pos") and k in _bulk_properties:
+                props.push_back(_bulk_properties[k])
+                values.push_back(_bulk_property_values(k, Ps[k], n_parts))
+        place_new_particles(
+            ids, _bulk_property_values("pos", Ps["pos"], n_parts),
+            props, values)
+
+        for k in Ps:
+            if k in ("id", "pos") or k in _bulk_properties:
+                continue
+            for i in range(n_parts):
+                self[ids[i]].update({k: Ps[k][i]})
 
         # Return slice of added particles
-        return self[Ps["id"]]
+        return self[list(Ps["id"])]
 
     # Iteration over all existing particles
     def __iter__(self):
@@ -2098,6 +2201,11 @@ def _add_particle_slice_properties():
             raise AttributeError(
                 "Cannot set properties of an empty ParticleSlice")
 
+        if attribute in _bulk_properties:
+            _set_particles_property(
+                particle_slice.id_selection, attribute, values)
+            return
+
         # Special attributes
         if attribute == "bonds":
             nlvl = nesting_level(values)
@@ -2173,6 +2281,10 @@ def _add_particle_slice_properties():
         if N == 0:
             return np.empty(0, dtype=type(None))
 
+        if attribute in _bulk_properties:
+            return _get_particles_property(
+                particle_slice.id_selection, attribute)
+
         # get first slice member to determine its type
         target = getattr(ParticleHandle(
             particle_slice.id_selection[0]), attribute)
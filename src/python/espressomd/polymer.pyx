@@ -24,6 +24,7 @@ from .system import System
 from .interactions import BondedInteraction
 from .utils cimport make_Vector3d, check_type_or_throw_except
 from .utils import array_locked
+from .particle_data cimport add_particles_bond
 
 
 def validate_params(_params, default):
@@ -170,6 +171,73 @@ def linear_polymer_positions(**kwargs):
     return np.array(positions)
 
 
+def setup_linear_polymers(system=None, positions=None, bond=None,
+                          start_id='auto', type=0):
+    """
+    Places linear polymers in the system. All particles are created with a
+    single call, and the bonds between adjacent monomers with another one,
+    which is much faster than adding particles and bonds one by one.
+
+    Parameters
+    ----------
+    system : :class:`espressomd.system.System`, required
+        System to which the particles will be added.
+    positions : array_like :obj:`float`, required
+        Monomer positions of shape (n_polymers, beads_per_chain, 3), e.g.
+        from :func:`linear_polymer_positions`.
+    bond : :class:`espressomd.interactions.BondedInteraction`, optional
+        Pair bond between adjacent monomers, which is stored on the
+        monomer with the higher id. If omitted, no bonds are created.
+    start_id : :obj:`int` or ``'auto'``, optional
+        Id of the first monomer of the first polymer, the monomers have
+        contiguous ids. If ``'auto'``, particle ids will start after the
+        highest id of particles already in the system.
+    type : :obj:`int`, optional
+        Type of the monomers. Defaults to 0.
+
+    Returns
+    -------
+    :class:`espressomd.particle_data.ParticleSlice`
+        The new particles.
+
+    """
+    cdef vector[int] bond_ids
+    cdef vector[int] partners
+
+    if not isinstance(system, System):
+        raise TypeError(
+            "System argument must be an instance of an espressomd System")
+    if bond is not None:
+        if not isinstance(bond, BondedInteraction):
+            raise TypeError(
+                "bond argument must be an instance of espressomd.interaction.BondedInteraction")
+        if bond._bond_id == -1:
+            raise Exception(
+                "The bonded interaction has not yet been added to the list of active bonds in ESPResSo.")
+    positions = np.array(positions, dtype=float)
+    if positions.ndim != 3 or positions.shape[2] != 3:
+        raise ValueError(
+            "positions has to be a numpy array with shape (n_polymers, beads_per_chain, 3)")
+    if start_id == 'auto':
+        start_id = system.part.highest_particle_id + 1
+    check_type_or_throw_except(
+        start_id, 1, int, "start_id must be one int or 'auto'")
+    check_type_or_throw_except(type, 1, int, "type must be one int")
+
+    n_polymers, beads_per_chain = positions.shape[:2]
+    ids = np.arange(start_id, start_id + n_polymers * beads_per_chain)
+    particles = system.part.add(id=ids, pos=positions.reshape((-1, 3)),
+                                type=[type] * len(ids))
+
+    if bond is not None and beads_per_chain > 1:
+        ids = ids.reshape((n_polymers, beads_per_chain))
+        bond_ids = ids[:, 1:].flatten()
+        partners = ids[:, :-1].flatten()
+        add_particles_bond(bond._bond_id, bond_ids, partners)
+
+    return particles
+
+
 def setup_diamond_polymer(system=None, bond=None, MPC=0, 
                           dist_cM=1, val_cM=0.0, val_nodes=0.0, 
                           start_id='auto', no_bonds=False, 
@@ -58,6 +58,7 @@ cdef extern from "reaction_ensemble.hpp" namespace "ReactionEnsemble":
         double slab_start_z
         double slab_end_z
         int non_interacting_type
+        double cavity_radius
 
     cdef cppclass CReactionEnsemble "ReactionEnsemble::ReactionEnsemble"(CReactionAlgorithm):
         CReactionEnsemble(int seed)
@@ -76,8 +77,9 @@ cdef extern from "reaction_ensemble.hpp" namespace "ReactionEnsemble":
         void add_new_CV_potential_energy(string filename, double delta_CV)
         int update_maximum_and_minimum_energies_at_current_state()
         void write_out_preliminary_energy_run_results(string filename)
-        int write_wang_landau_checkpoint(string identifier)
-        int load_wang_landau_checkpoint(string identifier)
+        int write_wang_landau_checkpoint(string identifier) except +
+        int load_wang_landau_checkpoint(string identifier) except +
+        void merge_wang_landau_walkers(vector[string] identifiers) except +
         void write_wang_landau_results_to_file(string full_path_to_output_filename)
 
     cdef cppclass CConstantpHEnsemble "ReactionEnsemble::ConstantpHEnsemble"(CReactionAlgorithm):
@@ -86,4 +88,19 @@ cdef extern from "reaction_ensemble.hpp" namespace "ReactionEnsemble":
 
     cdef cppclass CWidomInsertion "ReactionEnsemble::WidomInsertion"(CReactionAlgorithm):
         CWidomInsertion(int seed)
-        pair[double, double] measure_excess_chemical_potential(int reaction_id) except +
+        pair[double, double] measure_excess_chemical_potential(int reaction_id, int number_of_insertions) except +
+
+    cdef enum Ladder "ReactionEnsemble::ReplicaExchange::Ladder":
+        pass
+
+    cdef cppclass CReplicaExchange "ReactionEnsemble::ReplicaExchange":
+        CReplicaExchange(Ladder ladder, vector[double] values, int seed) except +
+        const vector[int] & attempt_exchanges(const vector[double] & observables) except +
+        const vector[double] & values()
+        const vector[int] & rungs()
+        double value_of_replica(int replica) except +
+        vector[double] get_acceptance_rates()
+
+cdef extern from "reaction_ensemble.hpp" namespace "ReactionEnsemble::ReplicaExchange::Ladder":
+    cdef Ladder TEMPERATURE
+    cdef Ladder PH
@@ -16,6 +16,7 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 include "myconfig.pxi"
 from libcpp.vector cimport vector
+from libcpp.string cimport string
 from libcpp.memory cimport unique_ptr
 from cython.operator cimport dereference as deref
 import numpy as np
@@ -52,12 +53,21 @@ cdef class ReactionAlgorithm:
         therefore they can be neglected.
     seed : :obj:`int`
         Initial counter value (or seed) of the Mersenne Twister RNG.
+    cavity_radius : :obj:`float`, optional
+        Insertions without reactants and deletions without products are
+        biased to the cavities of the system: new particles are only placed
+        into the cells of a coarse grid which are not completely within this
+        distance of a particle, and insertions closer than this distance to
+        a particle are rejected before any energy is calculated. The
+        acceptance probability accounts for the volume of the free cells.
+        This is only valid if the Boltzmann factor of such close insertions
+        is negligible. Zero (default) disables the cavity bias.
     """
     cdef object _params
     cdef CReactionAlgorithm * RE
 
     def _valid_keys(self):
-        return "temperature", "exclusion_radius", "seed"
+        return "temperature", "exclusion_radius", "seed", "cavity_radius"
 
     def _required_keys(self):
         return "temperature", "exclusion_radius", "seed"
@@ -73,6 +83,7 @@ cdef class ReactionAlgorithm:
         if(deref(self.RE).volume < 0):
             deref(self.RE).set_cuboid_reaction_ensemble_volume()
         deref(self.RE).exclusion_radius = self._params["exclusion_radius"]
+        deref(self.RE).cavity_radius = self._params.get("cavity_radius", 0.0)
 
     def set_cylindrical_constraint_in_z_direction(self, center_x, center_y,
                                                   radius_of_cylinder):
@@ -647,23 +658,54 @@ cdef class WangLandauReactionEnsemble(ReactionAlgorithm):
     def _valid_keys_set_wang_landau_parameters(self):
         return "final_wang_landau_parameter", "full_path_to_output_filename", "do_not_sample_reaction_partition_function"
 
-    def load_wang_landau_checkpoint(self):
+    def load_wang_landau_checkpoint(self, identifier="checkpoint"):
         """
         Loads the dumped Wang-Landau potential file.
 
+        Parameters
+        ----------
+        identifier : :obj:`str`, optional
+            Suffix of the checkpoint files.
+
         """
-        checkpoint_name = "checkpoint".encode("utf-8")
-        deref(self.WLRptr).load_wang_landau_checkpoint(checkpoint_name)
+        deref(self.WLRptr).load_wang_landau_checkpoint(
+            identifier.encode("utf-8"))
 
-    def write_wang_landau_checkpoint(self):
+    def write_wang_landau_checkpoint(self, identifier="checkpoint"):
         """
         Dumps the Wang-Landau potential to a checkpoint file. Can be used to
         checkpoint the Wang-Landau histogram, potential, parameter and the
         number of executed trial moves.
 
+        Parameters
+        ----------
+        identifier : :obj:`str`, optional
+            Suffix of the checkpoint files.
+
+        """
+        deref(self.WLRptr).write_wang_landau_checkpoint(
+            identifier.encode("utf-8"))
+
+    def merge_wang_landau_walkers(self, identifiers):
+        """
+        Combines the Wang-Landau potential and histogram of this walker with
+        the ones of other walkers, which sample the same collective variables
+        in independent simulations. The other walkers have to write their
+        checkpoints with :meth:`write_wang_landau_checkpoint` before. The
+        contributions of all walkers since the previous merge are added up,
+        such that all walkers continue from the same estimate of the density
+        of states.
+
+        Parameters
+        ----------
+        identifiers : list of :obj:`str`
+            Checkpoint identifiers of the other walkers.
+
         """
-        checkpoint_name = "checkpoint".encode("utf-8")
-        deref(self.WLRptr).write_wang_landau_checkpoint(checkpoint_name)
+        cdef vector[string] c_identifiers
+        for identifier in identifiers:
+            c_identifiers.push_back(identifier.encode("utf-8"))
+        deref(self.WLRptr).merge_wang_landau_walkers(c_identifiers)
 
     def update_maximum_and_minimum_energies_at_current_state(self):
         """
@@ -735,7 +777,7 @@ cdef class WidomInsertion(ReactionAlgorithm):
         return "temperature", "seed"
 
     def _valid_keys(self):
-        return "temperature", "seed"
+        return "temperature", "seed", "cavity_radius"
 
     def _valid_keys_add(self):
         return "reactant_types", "reactant_coefficients", "product_types", "product_coefficients", "default_charges", "check_for_electroneutrality"
@@ -766,7 +808,8 @@ cdef class WidomInsertion(ReactionAlgorithm):
 
         self._set_params_in_es_core()
 
-    def measure_excess_chemical_potential(self, reaction_id=0):
+    def measure_excess_chemical_potential(
+            self, reaction_id=0, number_of_insertions=1):
         """
         Measures the excess chemical potential in a homogeneous system for
         the provided ``reaction_id``. Please define the insertion moves
@@ -776,8 +819,113 @@ cdef class WidomInsertion(ReactionAlgorithm):
         the excess chemical potential. The error estimate assumes that
         your samples are uncorrelated.
 
+        Parameters
+        ----------
+        reaction_id : :obj:`int`, optional
+            Insertion to measure.
+        number_of_insertions : :obj:`int`, optional
+            Number of test insertions into the current configuration. With a
+            ``cavity_radius``, the cavities are only searched once for all
+            of them.
+
         """
         if(reaction_id < 0 or reaction_id > (deref(self.WidomInsertionPtr).reactions.size() + 1) / 2):  # make inverse widom scheme (deletion of particles) inaccessible
             raise ValueError("This reaction is not present")
+        if number_of_insertions < 1:
+            raise ValueError("number_of_insertions has to be positive")
         return deref(self.WidomInsertionPtr).measure_excess_chemical_potential(
-            int(2 * reaction_id))  # make inverse widom scheme (deletion of particles) inaccessible. The deletion reactions are the odd reaction_ids
+            int(2 * reaction_id), int(number_of_insertions))  # make inverse widom scheme (deletion of particles) inaccessible. The deletion reactions are the odd reaction_ids
+
+
+cdef class ReplicaExchange:
+    """
+    Replica exchange over a ladder of temperatures or pH values.
+
+    Every replica is an independent simulation, e.g. with a
+    :class:`ReactionEnsemble` or :class:`ConstantpHEnsemble`, at one rung of
+    the ladder. Instead of configurations, the ladder values are swapped
+    between replicas of neighboring rungs, hence only one observable per
+    replica has to be exchanged: the potential energy for a temperature
+    ladder and the number of dissociated acid particles for a pH ladder.
+    The decisions only depend on the seed and on the observables, so every
+    replica can run its own instance of this class with the same seed and
+    obtains the same assignment of rungs.
+
+    Parameters
+    ----------
+    ladder : :obj:`str`
+        ``"temperature"`` or ``"pH"``.
+    values : array_like of :obj:`float`
+        Temperatures or pH values of the rungs, at least two.
+    seed : :obj:`int`
+        Seed of the random number generator, has to be the same for all
+        replicas.
+
+    """
+
+    cdef unique_ptr[CReplicaExchange] REXptr
+
+    def __init__(self, ladder, values, seed):
+        cdef Ladder c_ladder
+        if ladder == "temperature":
+            c_ladder = TEMPERATURE
+        elif ladder == "pH":
+            c_ladder = PH
+        else:
+            raise ValueError(
+                "ladder has to be either 'temperature' or 'pH', got " + str(ladder))
+        self.REXptr.reset(new CReplicaExchange(
+            c_ladder, [float(v) for v in values], int(seed)))
+
+    def attempt_exchanges(self, observables):
+        """
+        Attempts to swap the ladder values of replicas on neighboring rungs,
+        alternately starting at the even and at the odd rungs.
+
+        Parameters
+        ----------
+        observables : array_like of :obj:`float`
+            Potential energy or number of dissociated acid particles of
+            every replica.
+
+        Returns
+        -------
+        :obj:`ndarray` of :obj:`int`
+            Rung of every replica after the exchanges.
+
+        """
+        return np.array(deref(self.REXptr).attempt_exchanges(
+            [float(o) for o in observables]))
+
+    def value_of_replica(self, replica):
+        """
+        Returns the temperature or pH value the replica has to use.
+
+        """
+        return deref(self.REXptr).value_of_replica(int(replica))
+
+    property rungs:
+        """
+        Rung of every replica.
+
+        """
+
+        def __get__(self):
+            return np.array(deref(self.REXptr).rungs())
+
+    property values:
+        """
+        Temperatures or pH values of the rungs.
+
+        """
+
+        def __get__(self):
+            return np.array(deref(self.REXptr).values())
+
+    def get_acceptance_rates(self):
+        """
+        Returns the acceptance rates of the exchanges between rung ``i`` and
+        rung ``i + 1``.
+
+        """
+        return np.array(deref(self.REXptr).get_acceptance_rates())
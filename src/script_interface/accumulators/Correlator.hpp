@@ -55,7 +55,8 @@ public:
          {"dim_corr", m_correlator, &CoreCorr::dim_corr},
          {"obs1", as_const(m_obs1)},
          {"obs2", as_const(m_obs2)},
-         {"n_result", m_correlator, &CoreCorr::n_result}});
+         {"n_result", m_correlator, &CoreCorr::n_result},
+         {"distributed", m_correlator, &CoreCorr::distributed}});
   }
 
   void construct(VariantMap const &args) override {
@@ -72,7 +73,8 @@ public:
         get_value_or<std::string>(args, "compress1", ""),
         get_value_or<std::string>(args, "compress2", ""),
         get_value<std::string>(args, "corr_operation"), m_obs1->observable(),
-        m_obs2->observable(), get_value_or<Utils::Vector3d>(args, "args", {}));
+        m_obs2->observable(), get_value_or<Utils::Vector3d>(args, "args", {}),
+        get_value_or<bool>(args, "distributed", false));
   }
 
   std::shared_ptr<::Accumulators::Correlator> correlator() {
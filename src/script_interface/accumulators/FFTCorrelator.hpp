@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRIPT_INTERFACE_ACCUMULATORS_FFT_CORRELATOR_HPP
+#define SCRIPT_INTERFACE_ACCUMULATORS_FFT_CORRELATOR_HPP
+
+#include "AccumulatorBase.hpp"
+#include "TimeSeries.hpp"
+#include "script_interface/ScriptInterface.hpp"
+#include "script_interface/auto_parameters/AutoParameters.hpp"
+
+#include "core/accumulators/FFTCorrelator.hpp"
+#include "core/integrate.hpp"
+#include "script_interface/observables/Observable.hpp"
+
+#include "utils/as_const.hpp"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace ScriptInterface {
+namespace Accumulators {
+
+class FFTCorrelator : public AccumulatorBase {
+  using CoreCorr = ::Accumulators::FFTCorrelator;
+
+public:
+  FFTCorrelator() {
+    using Utils::as_const;
+    add_parameters(
+        {{"corr_operation", m_correlator, &CoreCorr::correlation_operation},
+         {"dt", m_correlator, &CoreCorr::dt},
+         {"tau_max", AutoParameter::read_only,
+          [this]() { return (m_correlator->n_lags() - 1) * m_correlator->dt(); }},
+         {"n_lags", m_correlator, &CoreCorr::n_lags},
+         {"dim_A", as_const(m_dim_A)},
+         {"dim_B", as_const(m_dim_B)},
+         {"dim_corr", m_correlator, &CoreCorr::dim_corr},
+         {"n_frames", AutoParameter::read_only,
+          [this]() { return static_cast<int>(m_correlator->n_frames()); }},
+         {"obs1", as_const(m_obs1)},
+         {"obs2", as_const(m_obs2)}});
+  }
+
+  void construct(VariantMap const &args) override {
+    if (args.count("obs1"))
+      set_from_args(m_obs1, args, "obs1");
+    if (args.count("obs2"))
+      set_from_args(m_obs2, args, "obs2");
+    if (not m_obs2)
+      m_obs2 = m_obs1;
+
+    if (m_obs1) {
+      m_dim_A = m_obs1->observable()->n_values();
+      m_dim_B = m_obs2->observable()->n_values();
+    } else {
+      m_dim_A = get_value<int>(args, "dim_A");
+      m_dim_B = get_value_or<int>(args, "dim_B", m_dim_A);
+    }
+
+    auto const delta_N = get_value_or<int>(args, "delta_N", 1);
+    auto const dt = get_value_or<double>(args, "dt", delta_N * time_step);
+    if (dt <= 0.) {
+      throw std::runtime_error("dt must be > 0");
+    }
+    auto const n_lags = static_cast<int>(
+        std::lround(get_value<double>(args, "tau_max") / dt) + 1);
+
+    m_correlator = std::make_shared<CoreCorr>(
+        delta_N, dt, n_lags, get_value<std::string>(args, "corr_operation"),
+        m_dim_A, m_dim_B, m_obs1 ? m_obs1->observable() : nullptr,
+        m_obs2 ? m_obs2->observable() : nullptr);
+  }
+
+  Variant call_method(std::string const &method,
+                      VariantMap const &parameters) override {
+    if (method == "update")
+      m_correlator->update();
+    if (method == "add_frames")
+      m_correlator->add_frames(
+          get_value<std::vector<double>>(parameters, "A"),
+          get_value_or<std::vector<double>>(parameters, "B", {}));
+    if (method == "add_time_series") {
+      auto const A = get_value<std::shared_ptr<TimeSeries>>(parameters, "A");
+      auto const B =
+          get_value_or<std::shared_ptr<TimeSeries>>(parameters, "B", nullptr);
+      auto const &series_A = A->time_series()->time_series();
+      if (B and B->time_series()->time_series().size() != series_A.size()) {
+        throw std::runtime_error(
+            "Both time series must have the same number of frames");
+      }
+      for (std::size_t i = 0; i < series_A.size(); i++) {
+        m_correlator->add_frames(
+            series_A[i], B ? B->time_series()->time_series()[i]
+                           : std::vector<double>{});
+      }
+    }
+    if (method == "get_correlation")
+      return m_correlator->get_correlation();
+
+    return {};
+  }
+
+  Variant get_state() const override {
+    std::vector<Variant> state(2);
+    state[0] = ScriptInterfaceBase::get_state();
+    state[1] = m_correlator->get_internal_state();
+
+    return state;
+  }
+
+  std::shared_ptr<::Accumulators::AccumulatorBase> accumulator() override {
+    return std::static_pointer_cast<::Accumulators::AccumulatorBase>(
+        m_correlator);
+  }
+
+  std::shared_ptr<const ::Accumulators::AccumulatorBase>
+  accumulator() const override {
+    return std::static_pointer_cast<::Accumulators::AccumulatorBase>(
+        m_correlator);
+  }
+
+private:
+  void set_state(Variant const &state) override {
+    auto const &state_vec = boost::get<std::vector<Variant>>(state);
+
+    ScriptInterfaceBase::set_state(state_vec.at(0));
+    m_correlator->set_internal_state(boost::get<std::string>(state_vec.at(1)));
+  }
+
+  std::shared_ptr<CoreCorr> m_correlator;
+
+  std::shared_ptr<Observables::Observable> m_obs1;
+  std::shared_ptr<Observables::Observable> m_obs2;
+  int m_dim_A = 0;
+  int m_dim_B = 0;
+};
+
+} // namespace Accumulators
+} /* namespace ScriptInterface */
+
+#endif
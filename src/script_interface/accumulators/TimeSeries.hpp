@@ -44,6 +44,10 @@ public:
           m_obs->observable(), get_value_or<int>(params, "delta_N", 1));
   }
 
+  std::shared_ptr<::Accumulators::TimeSeries> time_series() {
+    return m_accumulator;
+  }
+
   Variant call_method(std::string const &method,
                       VariantMap const &parameters) override {
     if (method == "update") {
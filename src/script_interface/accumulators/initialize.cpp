@@ -22,6 +22,7 @@
 
 #include "AutoUpdateAccumulators.hpp"
 #include "Correlator.hpp"
+#include "FFTCorrelator.hpp"
 #include "MeanVarianceCalculator.hpp"
 #include "TimeSeries.hpp"
 
@@ -42,6 +43,9 @@ void initialize() {
 
   ScriptInterface::register_new<ScriptInterface::Accumulators::Correlator>(
       "Accumulators::Correlator");
+
+  ScriptInterface::register_new<ScriptInterface::Accumulators::FFTCorrelator>(
+      "Accumulators::FFTCorrelator");
 }
 } /* namespace Accumulators */
 } /* namespace ScriptInterface */
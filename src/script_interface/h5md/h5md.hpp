@@ -38,7 +38,11 @@ public:
     add_parameters({{"filename", m_h5md->filename()},
                     {"scriptname", m_h5md->scriptname()},
                     {"what", m_h5md->what()},
-                    {"write_ordered", m_h5md->write_ordered()}});
+                    {"write_ordered", m_h5md->write_ordered()},
+                    {"asynchronous", m_h5md->asynchronous()},
+                    {"compression", m_h5md->compression()},
+                    {"precision", m_h5md->precision()},
+                    {"chunk_frames", m_h5md->chunk_frames()}});
   };
 
   Variant call_method(const std::string &name,
@@ -40,6 +40,15 @@ public:
 
   Variant call_method(const std::string &name,
                       const VariantMap &parameters) override {
+    if (name == "write_checkpoint" or name == "read_checkpoint") {
+      auto const filename = get_value<std::string>(parameters.at("filename"));
+      if (name == "write_checkpoint")
+        Mpiio::mpi_mpiio_checkpoint_write(
+            filename.c_str(), cell_structure.local_cells().particles());
+      else
+        Mpiio::mpi_mpiio_checkpoint_read(filename.c_str());
+      return {};
+    }
 
     auto pref = get_value<std::string>(parameters.at("prefix"));
     auto pos = get_value<bool>(parameters.at("pos"));
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_MATH_FFT_HPP
+#define UTILS_MATH_FFT_HPP
+
+#include "utils/constants.hpp"
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Utils {
+
+/** Smallest power of two that is not smaller than @p n. */
+inline std::size_t next_pow2(std::size_t n) {
+  std::size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+/**
+ * @brief Radix-2 complex fast Fourier transform of a fixed length.
+ *
+ * The twiddle factors and the bit reversal permutation are computed
+ * once, so that many transforms of the same length are cheap.
+ * This is a small self-contained implementation for analysis, which
+ * does not depend on FFTW.
+ */
+class FFT {
+public:
+  /** @param n Length of the transforms, has to be a power of two. */
+  explicit FFT(std::size_t n = 1) : m_n(n), m_twiddles(n / 2), m_reversed(n) {
+    if (n == 0 or (n & (n - 1)) != 0) {
+      throw std::invalid_argument("FFT length has to be a power of two.");
+    }
+
+    for (std::size_t k = 0; k < n / 2; k++) {
+      auto const phi = -2. * pi() * static_cast<double>(k) / n;
+      m_twiddles[k] = {std::cos(phi), std::sin(phi)};
+    }
+
+    std::size_t bits = 0;
+    while ((std::size_t{1} << bits) < n)
+      bits++;
+    for (std::size_t i = 0; i < n; i++) {
+      std::size_t r = 0;
+      for (std::size_t b = 0; b < bits; b++) {
+        r |= ((i >> b) & 1u) << (bits - 1 - b);
+      }
+      m_reversed[i] = r;
+    }
+  }
+
+  std::size_t size() const { return m_n; }
+
+  /** @brief In-place forward transform,
+   *  @f$ X_k = \sum_j x_j e^{-2\pi i jk/n} @f$.
+   */
+  void forward(std::complex<double> *data) const { transform(data, false); }
+
+  /** @brief In-place inverse transform without normalization,
+   *  @f$ x_j = \sum_k X_k e^{2\pi i jk/n} @f$.
+   */
+  void backward(std::complex<double> *data) const { transform(data, true); }
+
+private:
+  void transform(std::complex<double> *data, bool inverse) const {
+    for (std::size_t i = 0; i < m_n; i++) {
+      if (i < m_reversed[i])
+        std::swap(data[i], data[m_reversed[i]]);
+    }
+
+    for (std::size_t len = 2; len <= m_n; len <<= 1) {
+      auto const half = len / 2;
+      auto const stride = m_n / len;
+      for (std::size_t start = 0; start < m_n; start += len) {
+        for (std::size_t k = 0; k < half; k++) {
+          auto w = m_twiddles[k * stride];
+          if (inverse)
+            w = std::conj(w);
+          auto const u = data[start + k];
+          auto const v = data[start + k + half] * w;
+          data[start + k] = u + v;
+          data[start + k + half] = u - v;
+        }
+      }
+    }
+  }
+
+  std::size_t m_n;
+  std::vector<std::complex<double>> m_twiddles;
+  std::vector<std::size_t> m_reversed;
+};
+
+} // namespace Utils
+
+#endif
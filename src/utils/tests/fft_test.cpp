@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2010-2019 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE Utils::FFT test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "utils/constants.hpp"
+#include "utils/math/fft.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(next_pow2) {
+  BOOST_CHECK_EQUAL(Utils::next_pow2(0), 1);
+  BOOST_CHECK_EQUAL(Utils::next_pow2(1), 1);
+  BOOST_CHECK_EQUAL(Utils::next_pow2(5), 8);
+  BOOST_CHECK_EQUAL(Utils::next_pow2(64), 64);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_length) {
+  BOOST_CHECK_THROW(Utils::FFT(0), std::invalid_argument);
+  BOOST_CHECK_THROW(Utils::FFT(12), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(dft) {
+  std::size_t const n = 32;
+  Utils::FFT const fft(n);
+
+  std::vector<std::complex<double>> x(n);
+  for (std::size_t j = 0; j < n; j++) {
+    x[j] = {std::sin(0.3 * j) + 0.1 * j, std::cos(1.7 * j)};
+  }
+
+  auto X = x;
+  fft.forward(X.data());
+
+  for (std::size_t k = 0; k < n; k++) {
+    std::complex<double> expected = 0.;
+    for (std::size_t j = 0; j < n; j++) {
+      auto const phi = -2. * Utils::pi() * static_cast<double>(j * k) / n;
+      expected += x[j] * std::complex<double>(std::cos(phi), std::sin(phi));
+    }
+    BOOST_CHECK_SMALL(std::abs(X[k] - expected), 1e-10);
+  }
+
+  /* The inverse transform recovers the input up to a factor n */
+  fft.backward(X.data());
+  for (std::size_t j = 0; j < n; j++) {
+    BOOST_CHECK_SMALL(std::abs(X[j] / static_cast<double>(n) - x[j]), 1e-12);
+  }
+}
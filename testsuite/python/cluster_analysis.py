@@ -113,6 +113,103 @@ class ClusterAnalysis(ut.TestCase):
         visited_sizes = sorted(visited_sizes)
         self.assertEqual(visited_sizes, [2, 4])
 
+    def test_zz_many_clusters(self):
+        # Compare to a search over all pairs of particles
+        self.es.part.clear()
+        n_part = 200
+        cut_off = 0.07
+        pos = np.random.random((n_part, 3))
+        self.es.part.add(id=np.arange(n_part), pos=pos)
+        self.cs.pair_criterion = DistanceCriterion(cut_off=cut_off)
+        self.cs.run_for_all_pairs()
+
+        dist = pos[:, np.newaxis, :] - pos[np.newaxis, :, :]
+        dist -= np.rint(dist)
+        neighbors = np.linalg.norm(dist, axis=2) <= cut_off
+        np.fill_diagonal(neighbors, False)
+        visited = np.zeros(n_part, dtype=bool)
+        ref_clusters = []
+        for i in np.flatnonzero(np.any(neighbors, axis=1)):
+            if visited[i]:
+                continue
+            visited[i] = True
+            cluster = []
+            stack = [i]
+            while stack:
+                j = stack.pop()
+                cluster.append(j)
+                for k in np.flatnonzero(neighbors[j] & ~visited):
+                    visited[k] = True
+                    stack.append(k)
+            ref_clusters.append(sorted(cluster))
+
+        clusters = sorted(c.particle_ids() for _, c in self.cs.clusters)
+        self.assertEqual(clusters, sorted(ref_clusters))
+
+        for cid, c in self.cs.clusters:
+            pids = c.particle_ids()
+            for pid in pids:
+                self.assertEqual(self.cs.cid_for_particle(pid), cid)
+            dist = pos[pids] - pos[pids[0]]
+            dist -= np.rint(dist)
+            com = np.mean(dist, axis=0)
+            rg = np.sqrt(np.mean(np.sum((dist - com)**2, axis=1)))
+            self.assertAlmostEqual(c.radius_of_gyration(), rg, delta=1E-8)
+            np.testing.assert_allclose(
+                np.fmod(c.center_of_mass() - pos[pids[0]] - com + 1.5, 1.),
+                0.5, atol=1E-8)
+
+    def test_zz_boundary_pairs(self):
+        # Pairs across the domain boundaries of up to 8 nodes, and across
+        # the periodic boundaries. Each pair is only found by one node.
+        self.es.part.clear()
+        offsets = [(0.5, 0.25, 0.25), (0.25, 0.5, 0.25), (0.25, 0.25, 0.5),
+                   (0.99, 0.75, 0.75), (0.75, 0.99, 0.75), (0.75, 0.75, 0.99)]
+        for i, center in enumerate(offsets):
+            axis = i % 3
+            for sign in (-1, 1):
+                pos = np.array(center)
+                pos[axis] += sign * 0.02
+                self.es.part.add(id=len(self.es.part), pos=pos)
+        self.cs.pair_criterion = DistanceCriterion(cut_off=0.05)
+        self.cs.run_for_all_pairs()
+
+        clusters = sorted(c.particle_ids() for _, c in self.cs.clusters)
+        self.assertEqual(clusters, [[2 * i, 2 * i + 1]
+                                    for i in range(len(offsets))])
+        for _, c in self.cs.clusters:
+            self.assertEqual(c.size(), 2)
+
+    def test_zz_moved_particles(self):
+        # Pairs of particles that moved out of their cells since the last
+        # resort of the cell system are found up to the cut-off.
+        self.es.part.clear()
+        self.es.time_step = 0.01
+        self.es.cell_system.skin = 0.1
+        min_global_cut = self.es.min_global_cut
+        self.es.min_global_cut = 0.1
+        cell_size = self.es.cell_system.get_state()['cell_size'][0]
+        self.assertGreaterEqual(1. / cell_size, 4)
+        # the first particle moves by less than half the skin towards the
+        # second one, which is stored two cells away
+        self.es.part.add(id=0, pos=(2 * cell_size - 0.02, 0.5, 0.5),
+                         v=(1, 0, 0))
+        self.es.part.add(id=1, pos=(3 * cell_size + 0.01, 0.5, 0.5))
+        self.es.integrator.run(0)
+        self.es.integrator.run(4)
+        distance = cell_size - 0.01
+        self.assertAlmostEqual(self.es.distance(self.es.part[0],
+                                                self.es.part[1]),
+                               distance, delta=1E-8)
+
+        self.cs.pair_criterion = DistanceCriterion(cut_off=distance + 0.005)
+        self.cs.run_for_all_pairs()
+        clusters = sorted(c.particle_ids() for _, c in self.cs.clusters)
+        self.assertEqual(clusters, [[0, 1]])
+
+        self.es.min_global_cut = min_global_cut
+        self.es.part.clear()
+
     def test_zz_single_cluster_analysis(self):
         self.es.part.clear()
         # Place particles on a line (crossing periodic boundaries)
@@ -143,7 +143,7 @@ class CollisionDetection(ut.TestCase):
         self.assertEqual(len(self.s.part), expected_np)
 
         # At the end of test, this list should be empty
-        parts_not_accounted_for = list(range(expected_np))
+        parts_not_accounted_for = [p.id for p in self.s.part]
 
         # We traverse particles. We look for a vs with a bond to find the other vs.
         # From the two vs we find the two non-virtual particles
@@ -364,7 +364,7 @@ class CollisionDetection(ut.TestCase):
         self.assertEqual(len(self.s.part), expected_np)
 
         # At the end of test, this list should be empty
-        parts_not_accounted_for = list(range(expected_np))
+        parts_not_accounted_for = [p.id for p in self.s.part]
 
         # We traverse particles. We look for a vs, get base particle from there
         # and partner particle via bonds
@@ -627,6 +627,32 @@ class CollisionDetection(ut.TestCase):
         self.verify_triangle_binding(cutoff, self.s.bonded_inter[2], res)
         self.s.time_step = self.time_step
 
+    def test_bind_three_particles_across_nodes(self):
+        # The colliding pair is on one side of the node boundary at x=0.5,
+        # the third particle on the other side. It is already bonded to
+        # both, so the only collision is between two particles of the
+        # same node.
+        self.s.part.clear()
+        self.s.part.add(id=0, pos=(0.45, 0.25, 0.25))
+        self.s.part.add(id=1, pos=(0.45, 0.33, 0.25))
+        self.s.part.add(id=2, pos=(0.52, 0.29, 0.25),
+                        bonds=((self.H, 0), (self.H, 1)))
+
+        res = 181
+        for i in range(0, res, 1):
+            self.s.bonded_inter[i + 2] = AngleHarmonic(
+                bend=1, phi0=float(i) / (res - 1) * np.pi)
+        cutoff = 0.11
+        self.s.collision_detection.set_params(
+            mode="bind_three_particles", bond_centers=self.H,
+            bond_three_particles=2, three_particle_binding_angle_resolution=res, distance=cutoff)
+
+        self.s.time_step = 1E-6
+        self.s.integrator.run(1, recalc_forces=True)
+        self.verify_triangle_binding(cutoff, self.s.bonded_inter[2], res)
+        self.s.time_step = self.time_step
+        self.s.collision_detection.set_params(mode="off")
+
     def verify_triangle_binding(self, distance, first_bond, angle_res):
         # Gather pairs
         n = len(self.s.part)
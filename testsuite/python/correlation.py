@@ -59,6 +59,150 @@ class CorrelatorTest(ut.TestCase):
             self.assertAlmostEqual(corr[i, 3], 4 * t * t, places=3)
             self.assertAlmostEqual(corr[i, 4], 9 * t * t, places=3)
 
+    def check_reference(self, result, reference):
+        # rows of the lags that were sampled
+        rows = result[:, 1] > 0
+        self.assertGreater(np.sum(rows), 0.9 * len(result))
+        np.testing.assert_allclose(
+            result[rows, 2:], reference(result[rows, 0]),
+            rtol=1e-10, atol=1e-10)
+
+    def test_distributed(self):
+        s = self.system
+        s.part.clear()
+        s.auto_update_accumulators.clear()
+        s.time_step = 0.01
+        s.thermostat.turn_off()
+        v = np.random.random((4, 3))
+        s.part.add(pos=np.zeros((4, 3)), v=v)
+        v = v.flatten()
+
+        ops = ("componentwise_product", "square_distance_componentwise",
+               "tensor_product", "scalar_product")
+        obs = espressomd.observables.ParticlePositions(ids=range(4))
+        vel = espressomd.observables.ParticleVelocities(ids=range(4))
+        correlators = {}
+        for op in ops:
+            for distributed in (False, True):
+                corr = espressomd.accumulators.Correlator(
+                    obs1=obs, tau_lin=10, tau_max=2.0, delta_N=1,
+                    corr_operation=op, compress1="linear",
+                    distributed=distributed)
+                s.auto_update_accumulators.add(corr)
+                correlators[op, distributed] = corr
+            corr = espressomd.accumulators.Correlator(
+                obs1=vel, tau_lin=10, tau_max=2.0, delta_N=1,
+                corr_operation=op, compress1="linear", distributed=True)
+            s.auto_update_accumulators.add(corr)
+            correlators[op, "velocities"] = corr
+
+        # correlations of the constant velocities for all lags, and the
+        # mean squared displacement of the positions
+        references = {
+            "componentwise_product": lambda tau: np.tile(v * v, (len(tau), 1)),
+            "square_distance_componentwise":
+                lambda tau: np.zeros((len(tau), len(v))),
+            "tensor_product":
+                lambda tau: np.tile(np.outer(v, v).flatten(), (len(tau), 1)),
+            "scalar_product": lambda tau: np.full((len(tau), 1), v.dot(v))}
+
+        def msd(tau):
+            return np.outer(tau, v)**2
+
+        s.integrator.run(500)
+
+        for op in ops:
+            local = correlators[op, False]
+            distributed = correlators[op, True]
+            velocities = correlators[op, "velocities"]
+            self.assertTrue(distributed.distributed)
+            np.testing.assert_allclose(
+                distributed.result(), local.result(), rtol=1e-12)
+            self.check_reference(velocities.result(), references[op])
+            if op == "square_distance_componentwise":
+                self.check_reference(distributed.result(), msd)
+
+            C_unpickled = pickle.loads(pickle.dumps(distributed))
+            np.testing.assert_array_equal(
+                C_unpickled.result(), distributed.result())
+
+            # the values left in the hierarchy are compressed in the
+            # same pairs as during the updates
+            n_sweeps = velocities.result()[:, 1]
+            local.finalize()
+            distributed.finalize()
+            velocities.finalize()
+            np.testing.assert_allclose(
+                distributed.result(), local.result(), rtol=1e-12)
+            self.check_reference(velocities.result(), references[op])
+            if op == "square_distance_componentwise":
+                self.check_reference(distributed.result(), msd)
+            self.assertGreater(np.sum(velocities.result()[:, 1]),
+                               np.sum(n_sweeps))
+
+        s.auto_update_accumulators.clear()
+
+    def test_fft(self):
+        s = self.system
+        s.part.clear()
+        s.auto_update_accumulators.clear()
+        s.time_step = 0.01
+        s.thermostat.turn_off()
+        s.part.add(pos=np.zeros((2, 3)), v=[[1, 2, 3], [-1, 0, 0.5]])
+
+        obs = espressomd.observables.ParticlePositions(ids=(0, 1))
+        msd = espressomd.accumulators.FFTCorrelator(
+            obs1=obs, tau_max=0.5, delta_N=2,
+            corr_operation="square_distance_componentwise")
+        series = espressomd.accumulators.TimeSeries(obs=obs, delta_N=2)
+        s.auto_update_accumulators.add(msd)
+        s.auto_update_accumulators.add(series)
+        s.integrator.run(400)
+
+        self.assertEqual(msd.n_lags, 26)
+        self.assertEqual(msd.n_frames, 200)
+        res = msd.result()
+        np.testing.assert_allclose(res[:, 0], 0.02 * np.arange(26))
+        np.testing.assert_array_equal(res[:, 1], 200 - np.arange(26))
+        v = np.array(s.part[:].v).flatten()
+        for tau, row in zip(res[:, 0], res):
+            np.testing.assert_allclose(row[2:], (v * tau)**2, atol=1e-8)
+
+        # post-processing of a stored time series and of arrays
+        data = series.time_series().reshape(200, -1)
+        for op in ("componentwise_product", "scalar_product",
+                   "square_distance_componentwise"):
+            corr = espressomd.accumulators.FFTCorrelator(
+                dim_A=6, tau_max=10, dt=1, corr_operation=op)
+            corr.add_time_series(series)
+            chunked = espressomd.accumulators.FFTCorrelator(
+                dim_A=6, tau_max=10, dt=1, corr_operation=op)
+            chunked.add_dataset(data, chunk_frames=7)
+
+            direct = []
+            for tau in range(11):
+                a, b = data[:200 - tau], data[tau:]
+                if op == "componentwise_product":
+                    direct.append(np.mean(a * b, axis=0))
+                elif op == "scalar_product":
+                    direct.append([np.mean(np.sum(a * b, axis=1))])
+                else:
+                    direct.append(np.mean((a - b)**2, axis=0))
+            np.testing.assert_allclose(
+                corr.result()[:, 2:], direct, rtol=1e-8, atol=1e-10)
+            np.testing.assert_allclose(
+                chunked.result(), corr.result(), rtol=1e-10, atol=1e-12)
+
+            C_unpickled = pickle.loads(pickle.dumps(chunked))
+            np.testing.assert_array_equal(
+                C_unpickled.result(), chunked.result())
+
+        with self.assertRaises(RuntimeError):
+            espressomd.accumulators.FFTCorrelator(
+                obs1=obs, tau_max=0.5, corr_operation="fcs_acf")
+
+        s.auto_update_accumulators.clear()
+
 
 if __name__ == "__main__":
     ut.main()
@@ -69,6 +69,27 @@ class CommonTests(ut.TestCase):
             os.remove('test.h5')
         cls.py_file = cls.py_pos = cls.py_vel = cls.py_f = cls.py_id = cls.py_img = None
 
+    @classmethod
+    def write_and_read(cls, **kwargs):
+        """
+        Write the particles with the given writer parameters and open the
+        file for reading.
+        """
+        from espressomd.io.writer import h5md
+        h5 = h5md.H5md(filename="test.h5", write_pos=True, write_vel=True,
+                       write_force=True, write_species=True, write_mass=True,
+                       **kwargs)
+        h5.write()
+        h5.flush()
+        h5.close()
+        cls.py_file = h5py.File("test.h5", 'r')
+        cls.py_pos = cls.py_file['particles/atoms/position/value'][0]
+        cls.py_img = cls.py_file['particles/atoms/image/value'][0]
+        cls.py_vel = cls.py_file['particles/atoms/velocity/value'][0]
+        cls.py_f = cls.py_file['particles/atoms/force/value'][0]
+        cls.py_id = cls.py_file['particles/atoms/id/value'][0]
+        cls.py_bonds = cls.py_file['connectivity/atoms']
+
     def test_metadata(self):
         """Test if the H5MD metadata has been written properly."""
         self.assertEqual(self.py_file['h5md'].attrs['version'][0], 1)
@@ -129,26 +150,7 @@ class H5mdTestOrdered(CommonTests):
 
     @classmethod
     def setUpClass(cls):
-        write_ordered = True
-        from espressomd.io.writer import h5md
-        h5 = h5md.H5md(
-            filename="test.h5",
-            write_pos=True,
-            write_vel=True,
-            write_force=True,
-            write_species=True,
-            write_mass=True,
-            write_ordered=write_ordered)
-        h5.write()
-        h5.flush()
-        h5.close()
-        cls.py_file = h5py.File("test.h5", 'r')
-        cls.py_pos = cls.py_file['particles/atoms/position/value'][0]
-        cls.py_img = cls.py_file['particles/atoms/image/value'][0]
-        cls.py_vel = cls.py_file['particles/atoms/velocity/value'][0]
-        cls.py_f = cls.py_file['particles/atoms/force/value'][0]
-        cls.py_id = cls.py_file['particles/atoms/id/value'][0]
-        cls.py_bonds = cls.py_file['connectivity/atoms']
+        cls.write_and_read(write_ordered=True)
 
     @classmethod
     def tearDownClass(cls):
@@ -169,35 +171,102 @@ class H5mdTestUnordered(CommonTests):
 
     @classmethod
     def setUpClass(cls):
-        write_ordered = False
-        from espressomd.io.writer import h5md
-        h5 = h5md.H5md(
-            filename="test.h5",
-            write_pos=True,
-            write_vel=True,
-            write_force=True,
-            write_species=True,
-            write_mass=True,
-            write_ordered=write_ordered)
-        h5.write()
-        h5.flush()
-        h5.close()
-        cls.py_file = h5py.File("test.h5", 'r')
-        cls.py_pos = cls.py_file['particles/atoms/position/value'][0]
-        cls.py_img = cls.py_file['particles/atoms/image/value'][0]
-        cls.py_vel = cls.py_file['particles/atoms/velocity/value'][0]
-        cls.py_f = cls.py_file['particles/atoms/force/value'][0]
-        cls.py_id = cls.py_file['particles/atoms/id/value'][0]
-        cls.py_bonds = cls.py_file['connectivity/atoms']
+        cls.write_and_read(write_ordered=False)
 
     @classmethod
     def tearDownClass(cls):
         os.remove("test.h5")
 
 
+@utx.skipIfMissingFeatures(['H5MD'])
+class H5mdTestAsynchronous(H5mdTestOrdered):
+
+    """
+    Test the core implementation of writing hdf5 files from a background
+    thread.
+    """
+
+    @classmethod
+    def setUpClass(cls):
+        cls.write_and_read(asynchronous=True)
+
+
+@utx.skipIfMissingFeatures(['H5MD'])
+class H5mdTestCompressed(H5mdTestOrdered):
+
+    """
+    Test the core implementation of writing compressed hdf5 files with
+    reduced precision.
+    """
+
+    precision = 1e-4
+
+    @classmethod
+    def setUpClass(cls):
+        # values with more digits than the precision, without moving the
+        # particles to other periodic images
+        np.random.seed(42)
+        cls.ref_pos = np.array([3 * [float(i)] for i in range(npart)]) \
+            + np.random.uniform(0., 0.4, (npart, 3))
+        cls.ref_vel = np.random.uniform(-2., 2., (npart, 3))
+        cls.ref_f = np.random.uniform(-0.5, 0.5, (npart, 3))
+        for i in range(npart):
+            cls.system.part[i].pos = cls.ref_pos[i]
+            cls.system.part[i].v = cls.ref_vel[i]
+            if espressomd.has_features(['EXTERNAL_FORCES']):
+                cls.system.part[i].ext_force = cls.ref_f[i]
+        cls.system.integrator.run(steps=0)
+        cls.write_and_read(compression=6, precision=cls.precision,
+                           chunk_frames=10)
+
+    @classmethod
+    def tearDownClass(cls):
+        super().tearDownClass()
+        for i in range(npart):
+            cls.system.part[i].pos = 3 * [float(i)]
+            cls.system.part[i].v = [1.0, 2.0, 3.0]
+            if espressomd.has_features(['EXTERNAL_FORCES']):
+                cls.system.part[i].ext_force = [0.1, 0.2, 0.3]
+        cls.system.integrator.run(steps=0)
+
+    def assert_rounded(self, ref, values):
+        """
+        Test if the values are rounded to the precision, but not further.
+        """
+        values = np.array([x for (_, x) in sorted(zip(self.py_id, values))])
+        error = np.abs(values - ref)
+        self.assertLessEqual(np.max(error), self.precision)
+        self.assertGreater(np.max(error), 0.)
+
+    def test_pos(self):
+        """Test if positions have been written within the precision."""
+        self.assert_rounded(np.fmod(self.ref_pos, self.box_l), self.py_pos)
+
+    def test_vel(self):
+        """Test if velocities have been written within the precision."""
+        self.assert_rounded(self.ref_vel, self.py_vel)
+
+    @utx.skipIfMissingFeatures(['EXTERNAL_FORCES'])
+    def test_f(self):
+        """Test if forces have been written within the precision."""
+        self.assert_rounded(self.ref_f, self.py_f)
+
+    def test_filters(self):
+        """Test if the datasets are compressed and chunked in time."""
+        dset = self.py_file['particles/atoms/position/value']
+        self.assertEqual(dset.compression, 'gzip')
+        self.assertEqual(dset.compression_opts, 6)
+        self.assertTrue(dset.shuffle)
+        self.assertTrue(dset.scaleoffset)
+        self.assertEqual(dset.chunks[0], 10)
+
+
 if __name__ == "__main__":
     suite = ut.TestSuite()
     suite.addTests(ut.TestLoader().loadTestsFromTestCase(H5mdTestUnordered))
     suite.addTests(ut.TestLoader().loadTestsFromTestCase(H5mdTestOrdered))
+    suite.addTests(
+        ut.TestLoader().loadTestsFromTestCase(H5mdTestAsynchronous))
+    suite.addTests(ut.TestLoader().loadTestsFromTestCase(H5mdTestCompressed))
     result = ut.TextTestRunner(verbosity=4).run(suite)
     sys.exit(not result.wasSuccessful())
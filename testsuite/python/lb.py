@@ -342,6 +342,12 @@ class TestLB:
         np.testing.assert_allclose(
             np.copy(self.system.part[0].f), -self.params['friction'] * (v_part - v_fluid), atol=1E-6)
 
+    @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
+    def test_viscous_coupling_higher_order_interpolation(self):
+        self.interpolation = True
+        self.test_viscous_coupling()
+        self.interpolation = False
+
     @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
     def test_ext_force_density(self):
         ext_force_density = [2.3, 1.2, 0.1]
@@ -431,12 +437,6 @@ class TestLBGPU(TestLB, ut.TestCase):
         self.lb_class = espressomd.lb.LBFluidGPU
         self.params.update({"mom_prec": 1E-3, "mass_prec_per_node": 1E-5})
 
-    @utx.skipIfMissingFeatures("EXTERNAL_FORCES")
-    def test_viscous_coupling_higher_order_interpolation(self):
-        self.interpolation = True
-        self.test_viscous_coupling()
-        self.interpolation = False
-
 
 if __name__ == "__main__":
     ut.main()
@@ -0,0 +1,112 @@
+# Copyright (C) 2010-2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+import unittest as ut
+import os
+import re
+import numpy as np
+
+import espressomd
+import espressomd.lb
+
+"""
+Check the parallel VTK output of the CPU lattice-Boltzmann fluid.
+"""
+
+AGRID = .5
+LB_PARAMS = {'agrid': AGRID,
+             'dens': 0.85,
+             'visc': 1.1,
+             'tau': 0.01,
+             'ext_force_density': [0.1, 0.2, 0.3]}
+
+
+def read_pieces(basename):
+    """Assemble the cell data of all pieces referenced by a .pvti file."""
+    with open(basename + '.pvti') as f:
+        index = f.read()
+    whole_extent = [int(x) for x in re.search(
+        r'<PImageData WholeExtent="([^"]*)"', index).group(1).split()]
+    shape = [whole_extent[2 * i + 1] - whole_extent[2 * i] for i in range(3)]
+    arrays = {}
+    for name, n_comp in re.findall(
+            r'<PDataArray type="Float32" Name="(\w+)" NumberOfComponents="(\d+)"', index):
+        arrays[name] = np.full(shape + [int(n_comp)], np.nan)
+    dirname = os.path.dirname(basename)
+    for extent, source in re.findall(
+            r'<Piece Extent="([^"]*)" Source="([^"]*)"', index):
+        extent = [int(x) for x in extent.split()]
+        with open(os.path.join(dirname, source), 'rb') as f:
+            content = f.read()
+        data = content[content.index(b'<AppendedData encoding="raw">'):]
+        data = data[data.index(b'_') + 1:]
+        piece_shape = [extent[2 * i + 1] - extent[2 * i] for i in range(3)]
+        for name in re.findall(rb'<DataArray type="Float32" Name="(\w+)"',
+                               content):
+            name = name.decode()
+            n_bytes = int(np.frombuffer(data[:8], dtype=np.uint64)[0])
+            values = np.frombuffer(data[8:8 + n_bytes], dtype=np.float32)
+            data = data[8 + n_bytes:]
+            n_comp = arrays[name].shape[-1]
+            values = values.reshape(piece_shape[::-1] + [n_comp])
+            arrays[name][extent[0]:extent[1], extent[2]:extent[3],
+                         extent[4]:extent[5]] = values.transpose(2, 1, 0, 3)
+    return arrays
+
+
+class LBVTK(ut.TestCase):
+    system = espressomd.System(box_l=[3.0, 4.0, 5.0])
+    system.time_step = LB_PARAMS['tau']
+    system.cell_system.skin = 0.4 * AGRID
+    lbf = espressomd.lb.LBFluid(**LB_PARAMS)
+    system.actors.add(lbf)
+    system.integrator.run(10)
+    basename = os.path.join(os.getcwd(), 'lb_vtk_test')
+
+    def tearDown(self):
+        for f in os.listdir(os.getcwd()):
+            if f.startswith('lb_vtk_test'):
+                os.remove(f)
+
+    def check_region(self, bb1, bb2, stride):
+        self.lbf.write_vtk(self.basename, ['density', 'velocity', 'stress'],
+                           bb1, bb2, stride)
+        arrays = read_pieces(self.basename)
+        for name in ('density', 'velocity', 'stress'):
+            self.assertFalse(np.any(np.isnan(arrays[name])))
+        for i, x in enumerate(range(bb1[0], bb2[0] + 1, stride)):
+            for j, y in enumerate(range(bb1[1], bb2[1] + 1, stride)):
+                for k, z in enumerate(range(bb1[2], bb2[2] + 1, stride)):
+                    node = self.lbf[x, y, z]
+                    np.testing.assert_allclose(
+                        arrays['density'][i, j, k, 0], node.density, rtol=1e-6)
+                    np.testing.assert_allclose(
+                        arrays['velocity'][i, j, k], node.velocity,
+                        rtol=1e-5, atol=1e-6)
+                    np.testing.assert_allclose(
+                        arrays['stress'][i, j, k].reshape(3, 3), node.stress,
+                        rtol=1e-5, atol=1e-6)
+
+    def test_full_lattice(self):
+        shape = self.lbf.shape
+        self.check_region([0, 0, 0], [s - 1 for s in shape], 1)
+
+    def test_region_and_stride(self):
+        self.check_region([1, 0, 2], [5, 6, 8], 2)
+
+
+if __name__ == '__main__':
+    ut.main()
@@ -38,10 +38,11 @@ nbonds = 100
 filename = "testdata.mpiio"
 exts = ["head", "pref", "id", "type", "pos", "vel", "boff", "bond"]
 filenames = [filename + "." + ext for ext in exts]
+checkpoint_filename = filename + ".chk"
 
 
 def clean_files():
-    for f in filenames:
+    for f in filenames + [checkpoint_filename]:
         if os.path.isfile(f):
             os.remove(f)
 
@@ -134,6 +135,16 @@ class MPIIOTest(ut.TestCase):
 
         self.check_sample_system()
 
+    def test_checkpoint(self):
+        espressomd.io.mpiio.mpiio.write_checkpoint(checkpoint_filename)
+
+        self.assertTrue(os.path.isfile(checkpoint_filename))
+
+        self.s.part.clear()
+        espressomd.io.mpiio.mpiio.read_checkpoint(checkpoint_filename)
+
+        self.check_sample_system()
+
 
 if __name__ == '__main__':
     ut.main()
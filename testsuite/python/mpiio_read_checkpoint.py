@@ -0,0 +1,67 @@
+#
+# Copyright (C) 2013-2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Reads the MPI-IO checkpoint written by mpiio_write_checkpoint.py on a
+different number of MPI ranks.
+"""
+
+import espressomd
+import espressomd.io
+from espressomd.interactions import HarmonicBond
+import numpy as np
+import os
+import pickle
+import unittest as ut
+
+checkpoint_filename = "@CMAKE_CURRENT_BINARY_DIR@/mpiio_n_to_m.chk"
+reference_filename = checkpoint_filename + ".ref"
+n_bond_types = 10
+
+
+class MPIIOReadCheckpoint(ut.TestCase):
+
+    s = espressomd.System(box_l=[10, 10, 10])
+    for i in range(n_bond_types):
+        s.bonded_inter[i] = HarmonicBond(k=1, r_0=i)
+
+    @classmethod
+    def tearDownClass(cls):
+        for f in (checkpoint_filename, reference_filename):
+            if os.path.isfile(f):
+                os.remove(f)
+
+    def test_read_checkpoint(self):
+        with open(reference_filename, "rb") as f:
+            reference = pickle.load(f)
+
+        espressomd.io.mpiio.mpiio.read_checkpoint(checkpoint_filename)
+
+        self.assertEqual(len(self.s.part), len(reference["id"]))
+        for i, pid in enumerate(reference["id"]):
+            p = self.s.part[int(pid)]
+            self.assertEqual(p.type, reference["type"][i])
+            np.testing.assert_array_equal(np.copy(p.pos), reference["pos"][i])
+            np.testing.assert_array_equal(np.copy(p.v), reference["v"][i])
+            bonds = [(int(b[0].params["r_0"]), b[1]) for b in p.bonds]
+            self.assertEqual(bonds, reference["bonds"][i])
+
+
+if __name__ == '__main__':
+    ut.main()
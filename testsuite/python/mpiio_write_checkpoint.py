@@ -0,0 +1,80 @@
+#
+# Copyright (C) 2013-2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Writes an MPI-IO checkpoint and the particles it contains, which are
+read by mpiio_read_checkpoint.py on a different number of MPI ranks.
+"""
+
+import espressomd
+import espressomd.io
+from espressomd.interactions import HarmonicBond
+import numpy as np
+import os
+import pickle
+import unittest as ut
+
+checkpoint_filename = "@CMAKE_CURRENT_BINARY_DIR@/mpiio_n_to_m.chk"
+reference_filename = checkpoint_filename + ".ref"
+n_part = 500
+n_bond_types = 10
+
+
+class MPIIOWriteCheckpoint(ut.TestCase):
+
+    s = espressomd.System(box_l=[10, 10, 10])
+    for i in range(n_bond_types):
+        s.bonded_inter[i] = HarmonicBond(k=1, r_0=i)
+
+    def test_write_checkpoint(self):
+        for f in (checkpoint_filename, reference_filename):
+            if os.path.isfile(f):
+                os.remove(f)
+
+        # particles all over the box, so that every rank writes a part
+        np.random.seed(42)
+        reference = {
+            "id": np.random.permutation(2 * n_part)[:n_part],
+            "type": np.random.randint(0, 10, n_part),
+            "pos": 10 * np.random.random((n_part, 3)),
+            "v": np.random.random((n_part, 3))}
+        reference["bonds"] = []
+        for i in range(n_part):
+            # bonds to other particles, which need not exist yet
+            n_bonds = np.random.randint(0, 4)
+            partners = (i + np.random.randint(1, n_part, n_bonds)) % n_part
+            reference["bonds"].append(
+                [(int(b), int(reference["id"][j])) for b, j in zip(
+                    np.random.randint(0, n_bond_types, n_bonds), partners)])
+
+        for i in range(n_part):
+            p = self.s.part.add(id=int(reference["id"][i]),
+                                type=int(reference["type"][i]),
+                                pos=reference["pos"][i], v=reference["v"][i])
+            for b, partner in reference["bonds"][i]:
+                p.add_bond((self.s.bonded_inter[b], partner))
+
+        espressomd.io.mpiio.mpiio.write_checkpoint(checkpoint_filename)
+        self.assertTrue(os.path.isfile(checkpoint_filename))
+        with open(reference_filename, "wb") as f:
+            pickle.dump(reference, f)
+
+
+if __name__ == '__main__':
+    ut.main()
@@ -0,0 +1,101 @@
+#
+# Copyright (C) 2013-2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["BUCKINGHAM", "LENNARD_JONES"])
+class PairSplineTabulationTest(ut.TestCase):
+    system = espressomd.System(box_l=[10.0, 10.0, 10.0])
+    system.cell_system.skin = 0.
+    system.time_step = .01
+
+    def setUp(self):
+        self.system.part.add(id=0, pos=[1., 1., 1.], type=0)
+        self.system.part.add(id=1, pos=[1., 1., 1.], type=1)
+        ia = self.system.non_bonded_inter[0, 1]
+        ia.buckingham.set_params(a=1500., b=3.5, c=20., d=0., discont=0.7,
+                                 cutoff=3.2, shift=0.01)
+        ia.lennard_jones.set_params(epsilon=0.3, sigma=1.1, cutoff=2.5,
+                                    shift="auto")
+
+    def tearDown(self):
+        self.system.non_bonded_inter.reset()
+        self.system.part.clear()
+
+    def sample(self, distances):
+        energies = []
+        forces = []
+        for r in distances:
+            self.system.part[1].pos = [1. + r, 1., 1.]
+            self.system.integrator.run(recalc_forces=True, steps=0)
+            energies.append(self.system.analysis.energy()["non_bonded"])
+            forces.append(np.copy(self.system.part[1].f))
+        return np.array(energies), np.array(forces)
+
+    def assert_close(self, a, b, tolerance):
+        np.testing.assert_array_less(
+            np.abs(a - b) / np.maximum(1., np.abs(b)), tolerance)
+
+    def test_accuracy(self):
+        distances = np.linspace(0.3, 3.5, 500)
+        E_ref, f_ref = self.sample(distances)
+
+        tabulation = self.system.non_bonded_inter[0, 1].spline_tabulation
+        tabulation.set_params(min_r=0.5, tolerance=1e-7)
+        self.assertEqual(tabulation.get_params(),
+                         {"min_r": 0.5, "tolerance": 1e-7})
+        E_tab, f_tab = self.sample(distances)
+
+        self.assert_close(E_tab, E_ref, 2e-7)
+        self.assert_close(f_tab[:, 0], f_ref[:, 0], 2e-7)
+        np.testing.assert_array_equal(f_tab[:, 1:], 0.)
+        # below min_r, the potentials are evaluated directly
+        np.testing.assert_array_equal(E_tab[distances < 0.5],
+                                      E_ref[distances < 0.5])
+        # beyond the cutoffs, there is no interaction
+        np.testing.assert_array_equal(E_tab[distances >= 3.2], 0.)
+
+    def test_update(self):
+        ia = self.system.non_bonded_inter[0, 1]
+        ia.spline_tabulation.set_params(min_r=0.5, tolerance=1e-7)
+
+        # the table follows the potentials
+        ia.lennard_jones.set_params(epsilon=0.)
+        distances = np.linspace(0.6, 3.5, 100)
+        E_tab, f_tab = self.sample(distances)
+        ia.spline_tabulation.set_params(tolerance=0.)
+        E_ref, f_ref = self.sample(distances)
+        self.assert_close(E_tab, E_ref, 2e-7)
+        self.assert_close(f_tab[:, 0], f_ref[:, 0], 2e-7)
+
+    def test_unreachable_tolerance(self):
+        tabulation = self.system.non_bonded_inter[0, 1].spline_tabulation
+        with self.assertRaises(Exception):
+            tabulation.set_params(min_r=0.5, tolerance=1e-17)
+        self.assertEqual(tabulation.get_params()["tolerance"], 0.)
+
+        with self.assertRaises(ValueError):
+            tabulation.set_params(min_r=0., tolerance=1e-6)
+
+
+if __name__ == "__main__":
+    ut.main()
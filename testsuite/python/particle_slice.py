@@ -100,6 +100,30 @@ class ParticleSliceTest(ut.TestCase):
         self.assertEqual(qs[0], -1)
         self.assertEqual(qs[1], 1)
 
+    def test_bulk_properties(self):
+        ids = [3, 0, 2]
+        v = np.array([[1., 2., 3.], [4., 5., 6.], [7., 8., 9.]])
+        self.system.part[ids].v = v
+        for i, pid in enumerate(ids):
+            np.testing.assert_array_equal(np.copy(self.system.part[pid].v),
+                                          v[i])
+        np.testing.assert_array_equal(self.system.part[ids].v, v)
+
+        self.system.part[ids].pos = [[1., 1., 1.], [0., 0., 12.], [2., 3., 4.]]
+        np.testing.assert_array_equal(
+            np.copy(self.system.part[0].pos), [0., 0., 12.])
+        np.testing.assert_array_equal(
+            np.copy(self.system.part[0].image_box), [0, 0, 1])
+
+        self.system.part[ids].type = [5, 6, 7]
+        self.assertEqual(self.system.part[3].type, 5)
+        self.assertEqual(self.system.part[2].type, 7)
+        np.testing.assert_array_equal(self.system.part[:].type, [6, 0, 7, 5])
+        with self.assertRaises(ValueError):
+            self.system.part[ids].type = [1, -1, 1]
+        with self.assertRaises(ValueError):
+            self.system.part[ids].pos = [np.nan, 0., 0.]
+
     def test_bonds(self):
 
         fene = espressomd.interactions.FeneBond(k=1, d_r_max=1, r_0=1)
@@ -373,6 +397,19 @@ class ParticleSliceTest(ut.TestCase):
         self.assertEqual(self.system.part[0].type, 0)
         self.assertEqual(self.system.part[1].type, 1)
 
+        self.system.part.clear()
+        self.system.part.add(id=[5, 2], pos=([1, 1, 1], [2, 2, 12]),
+                             v=([1, 2, 3], [4, 5, 6]), mol_id=(3, 4))
+        np.testing.assert_array_equal(
+            np.copy(self.system.part[2].pos), [2, 2, 12])
+        np.testing.assert_array_equal(np.copy(self.system.part[5].v), [1, 2, 3])
+        self.assertEqual(self.system.part[2].mol_id, 4)
+        with self.assertRaises(RuntimeError):
+            self.system.part.add(id=[7, 2], pos=([1, 1, 1], [2, 2, 2]))
+        with self.assertRaises(RuntimeError):
+            self.system.part.add(id=[7, 7], pos=([1, 1, 1], [2, 2, 2]))
+        self.assertFalse(self.system.part.exists(7))
+
     def test_empty(self):
         np.testing.assert_array_equal(self.system.part[0:0].pos, np.empty(0))
 
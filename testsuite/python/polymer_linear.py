@@ -18,6 +18,7 @@ import unittest as ut
 import numpy as np
 import random
 import espressomd
+import espressomd.interactions
 from espressomd import polymer
 import espressomd.shapes
 
@@ -198,6 +199,55 @@ class LinearPolymerPositions(ut.TestCase):
                 respect_constraints=True, seed=self.seed)
         self.system.constraints.remove(wall_constraint)
 
+    def test_min_dist_existing_particles(self):
+        """
+        Check that existing particles are respected.
+
+        """
+        min_distance = 1.
+        existing = np.random.random((50, 3)) * self.box_l
+        self.system.part.add(pos=existing)
+
+        positions = polymer.linear_polymer_positions(
+            n_polymers=10, beads_per_chain=20, bond_length=1.6,
+            min_distance=min_distance, seed=self.seed)
+        self.system.part.clear()
+
+        for pos in positions.reshape((-1, 3)):
+            dist = existing - pos
+            dist -= np.rint(dist / self.box_l) * self.box_l
+            self.assertGreaterEqual(
+                np.min(np.linalg.norm(dist, axis=1)), min_distance)
+
+    def test_setup_linear_polymers(self):
+        """
+        Check that particles and bonds are created.
+
+        """
+        num_poly = 4
+        num_mono = 6
+        bond_length = 0.9
+        bond = espressomd.interactions.HarmonicBond(k=1, r_0=bond_length)
+        self.system.bonded_inter.add(bond)
+        positions = polymer.linear_polymer_positions(
+            n_polymers=num_poly, beads_per_chain=num_mono,
+            bond_length=bond_length, seed=self.seed)
+
+        self.system.part.add(id=2, pos=(0, 0, 0))
+        polymer.setup_linear_polymers(
+            system=self.system, positions=positions, bond=bond, type=3)
+        self.assertEqual(len(self.system.part), num_poly * num_mono + 1)
+        for i in range(num_poly):
+            for j in range(num_mono):
+                p = self.system.part[3 + i * num_mono + j]
+                np.testing.assert_allclose(np.copy(p.pos), positions[i, j])
+                self.assertEqual(p.type, 3)
+                if j == 0:
+                    self.assertEqual(p.bonds, ())
+                else:
+                    self.assertEqual(p.bonds, ((bond, p.id - 1),))
+        self.system.part.clear()
+
 
 if __name__ == "__main__":
     ut.main()
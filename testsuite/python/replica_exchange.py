@@ -0,0 +1,83 @@
+#
+# Copyright (C) 2019 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Testmodule for the replica exchange driver of the reaction methods.
+"""
+import unittest as ut
+import numpy as np
+from espressomd import reaction_ensemble
+
+
+class ReplicaExchangeTest(ut.TestCase):
+
+    def test_invalid_parameters(self):
+        with self.assertRaises(ValueError):
+            reaction_ensemble.ReplicaExchange("pressure", [1., 2.], 42)
+        with self.assertRaises(RuntimeError):
+            reaction_ensemble.ReplicaExchange("temperature", [1.], 42)
+        rex = reaction_ensemble.ReplicaExchange("temperature", [1., 2.], 42)
+        with self.assertRaises(RuntimeError):
+            rex.attempt_exchanges([0.])
+
+    def test_temperature_ladder(self):
+        temperatures = [1., 1.5, 2., 3.]
+        rex = reaction_ensemble.ReplicaExchange(
+            "temperature", temperatures, 42)
+        np.testing.assert_array_equal(rex.rungs, [0, 1, 2, 3])
+        np.testing.assert_array_equal(rex.values, temperatures)
+        # the colder replica has the higher energy: swaps are always accepted
+        rungs = rex.attempt_exchanges([3., 2., 1., 0.])
+        np.testing.assert_array_equal(rungs, [1, 0, 3, 2])
+        self.assertEqual(rex.value_of_replica(0), 1.5)
+        # odd round: only rungs 1 and 2 are considered
+        rungs = rex.attempt_exchanges([3., 2., 1., 0.])
+        np.testing.assert_array_equal(rungs, [2, 0, 3, 1])
+        np.testing.assert_array_equal(
+            rex.get_acceptance_rates(), [1., 1., 1.])
+
+    def test_pH_ladder(self):
+        pH = [4., 5., 6.]
+        rex = reaction_ensemble.ReplicaExchange("pH", pH, 42)
+        # more dissociated acids at the lower pH: swaps are always accepted
+        rex.attempt_exchanges([10, 5, 0])
+        np.testing.assert_array_equal(rex.rungs, [1, 0, 2])
+        # a swap against the pH gradient is accepted with probability
+        # 10^(-(delta pH)(delta N)), which vanishes here
+        rex.attempt_exchanges([0, 0, 100])
+        np.testing.assert_array_equal(rex.rungs, [1, 0, 2])
+        np.testing.assert_array_almost_equal(
+            rex.get_acceptance_rates(), [1., 0.])
+
+    def test_acceptance_rate(self):
+        # the acceptance rate of swaps converges to the Metropolis probability
+        temperatures = [1., 2.]
+        rex = reaction_ensemble.ReplicaExchange(
+            "temperature", temperatures, 42)
+        n_rounds = 4000
+        for _ in range(n_rounds):
+            # the energies follow the rungs, the swap costs exp(-0.5)
+            energies = [0., 1.] if rex.rungs[0] == 0 else [1., 0.]
+            rex.attempt_exchanges(energies)
+        # only every second round attempts a swap of the two rungs
+        self.assertAlmostEqual(
+            rex.get_acceptance_rates()[0], np.exp(-0.5), delta=0.05)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -17,6 +17,7 @@
 
 import unittest as ut
 import unittest_decorators as utx
+import numpy as np
 import espressomd
 
 
@@ -40,6 +41,50 @@ class TuneSkin(ut.TestCase):
                 tol=0.05,
                 int_steps=3)
 
+    def test_online_tuning(self):
+        system = self.system
+        for x in np.arange(0., 1.2, 0.3):
+            for y in np.arange(0., 2.4, 0.3):
+                for z in np.arange(0., 1.5, 0.3):
+                    system.part.add(pos=[x, y, z],
+                                    v=0.1 * (np.random.random(3) - 0.5))
+        system.cell_system.skin = 0.1
+
+        with self.assertRaises(ValueError):
+            system.cell_system.enable_online_tuning(chunk_steps=0)
+        with self.assertRaises(ValueError):
+            system.cell_system.enable_online_tuning(skin_step=1.)
+        with self.assertRaises(ValueError):
+            system.cell_system.enable_online_tuning(min_skin=0.2, max_skin=0.1)
+        self.assertFalse(system.cell_system.get_state()["online_tuning"])
+
+        system.cell_system.enable_online_tuning(
+            chunk_steps=10, min_skin=0.05, max_skin=0.2, idle_chunks=2)
+        self.assertTrue(system.cell_system.get_state()["online_tuning"])
+        # Runs of at most one chunk each, the first steps of a run are only
+        # timed if the forces are not recalculated.
+        configurations = set()
+        for _ in range(20):
+            system.integrator.run(10)
+            self.assertGreaterEqual(system.cell_system.skin, 0.05)
+            self.assertLessEqual(system.cell_system.skin, 0.2)
+            configurations.add(
+                (system.cell_system.skin,
+                 system.cell_system.get_state()["use_verlet_list"]))
+        self.assertGreater(len(configurations), 1)
+
+        system.cell_system.disable_online_tuning()
+        self.assertFalse(system.cell_system.get_state()["online_tuning"])
+        skin = system.cell_system.skin
+        use_verlet_list = system.cell_system.get_state()["use_verlet_list"]
+        system.integrator.run(100)
+        self.assertEqual(system.cell_system.skin, skin)
+        self.assertEqual(
+            system.cell_system.get_state()["use_verlet_list"], use_verlet_list)
+
+        system.part.clear()
+        system.cell_system.set_domain_decomposition(use_verlet_lists=True)
+
     def test_works_with_adjustment(self):
         self.system.cell_system.tune_skin(
             min_skin=0.1,
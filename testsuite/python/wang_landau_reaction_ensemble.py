@@ -150,6 +150,74 @@ class ReactionEnsembleTest(ut.TestCase):
         new_checkpoint = np.loadtxt(filename)
         npt.assert_almost_equal(new_checkpoint, modified_checkpoint)
 
+    def _make_walker(self):
+        walker = reaction_ensemble.WangLandauReactionEnsemble(
+            temperature=self.temperature, exclusion_radius=0, seed=42)
+        walker.add_reaction(
+            gamma=self.K_diss, reactant_types=[0], reactant_coefficients=[1],
+            product_types=[1, 2], product_coefficients=[1, 1],
+            default_charges={0: 0, 1: -1, 2: +1})
+        walker.add_collective_variable_degree_of_association(
+            associated_type=0, min=0, max=1, corresponding_acid_types=[0, 1])
+        walker.set_wang_landau_parameters(
+            final_wang_landau_parameter=0.5 * 1e-2,
+            do_not_sample_reaction_partition_function=True,
+            full_path_to_output_filename="WL_potential_merged.dat")
+        return walker
+
+    def _write_walker_checkpoint(self, identifier, wang_landau_parameter,
+                                 trial_moves, histogram, potential):
+        np.savetxt("checkpoint_wang_landau_parameters_" + identifier,
+                   [[wang_landau_parameter, trial_moves, 0]], fmt="%.17g")
+        np.savetxt("checkpoint_wang_landau_histogram_" + identifier,
+                   histogram, fmt="%d")
+        np.savetxt("checkpoint_wang_landau_potential_" + identifier,
+                   potential, fmt="%.17g")
+
+    def _read_walker_checkpoint(self, identifier):
+        parameters = np.loadtxt(
+            "checkpoint_wang_landau_parameters_" + identifier)
+        histogram = np.loadtxt(
+            "checkpoint_wang_landau_histogram_" + identifier)
+        potential = np.loadtxt(
+            "checkpoint_wang_landau_potential_" + identifier)
+        return parameters[0], parameters[1], histogram, potential
+
+    def test_wang_landau_merge_walkers(self):
+        # one acid particle: the degree of association has two bins
+        self._write_walker_checkpoint("walker_b", 1., 10, [3, 5], [2., 3.])
+        self._write_walker_checkpoint("walker_c", 1., 4, [1, 0], [0.5, 0.])
+
+        # the visits and the potential of the walkers are added up, the
+        # potential is shifted to a minimum of zero
+        walker = self._make_walker()
+        walker.merge_wang_landau_walkers(["walker_b", "walker_c"])
+        walker.write_wang_landau_checkpoint("merged")
+        parameter, trial_moves, histogram, potential = \
+            self._read_walker_checkpoint("merged")
+        self.assertEqual(parameter, 1.)
+        self.assertEqual(trial_moves, 14)
+        npt.assert_array_equal(histogram, [4, 5])
+        npt.assert_array_almost_equal(potential, [0., 0.5])
+
+        # a walker which refined the Wang-Landau parameter has reset its
+        # histogram, only its visits count for the combined histogram
+        self._write_walker_checkpoint("walker_b", 0.5, 10, [3, 5], [2., 3.])
+        walker = self._make_walker()
+        walker.merge_wang_landau_walkers(["walker_b", "walker_c"])
+        walker.write_wang_landau_checkpoint("merged")
+        parameter, trial_moves, histogram, potential = \
+            self._read_walker_checkpoint("merged")
+        self.assertEqual(parameter, 0.5)
+        self.assertEqual(trial_moves, 14)
+        npt.assert_array_equal(histogram, [3, 5])
+        npt.assert_array_almost_equal(potential, [0., 0.5])
+
+        # checkpoints of walkers with other collective variables are rejected
+        self._write_walker_checkpoint("walker_c", 1., 4, [1, 0, 2], [0.] * 3)
+        with self.assertRaises(RuntimeError):
+            walker.merge_wang_landau_walkers(["walker_c"])
+
     def test_wang_landau_output_checkpoint(self):
         filenames = ["checkpoint_wang_landau_potential_checkpoint",
                      "checkpoint_wang_landau_histogram_checkpoint"]
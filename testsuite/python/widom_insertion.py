@@ -89,6 +89,9 @@ class WidomInsertionTest(ut.TestCase):
             product_coefficients=[1],
             default_charges={self.TYPE_HA: self.CHARGE_HA})
 
+    def tearDown(self):
+        self.system.part.clear()
+
     def test_widom_insertion(self):
         num_samples = 100000
         for _ in range(num_samples):
@@ -107,6 +110,23 @@ class WidomInsertionTest(ut.TestCase):
             + "  target_mu_ex: " + str(self.target_mu_ex)
         )
 
+    def test_widom_insertion_cavity_bias(self):
+        # the Boltzmann factor of insertions closer than the cavity radius
+        # is negligible, such that the cavity bias does not change the result
+        widom = reaction_ensemble.WidomInsertion(
+            temperature=self.TEMPERATURE, seed=2, cavity_radius=0.8)
+        widom.add_reaction(
+            reactant_types=[],
+            reactant_coefficients=[],
+            product_types=[self.TYPE_HA],
+            product_coefficients=[1],
+            default_charges={self.TYPE_HA: self.CHARGE_HA})
+        mu_ex = widom.measure_excess_chemical_potential(
+            0, number_of_insertions=100000)
+        self.assertEqual(len(self.system.part), 1)
+        self.assertLess(abs(mu_ex[0] - self.target_mu_ex),
+                        4 * mu_ex[1] + 1e-3)
+
 
 if __name__ == "__main__":
     ut.main()